@@ -0,0 +1,540 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file placement_bench.c
+ *
+ * Benchmark of the placement pipeline.
+ *
+ * Every stage is timed for every node count and density in
+ * a child process of its own, so that peak RSS is per
+ * configuration and a stage running for too long can be
+ * killed. Node sets are generated from a fixed seed, the
+ * same for every repetition. Density is given as the
+ * expected number of neighbors per node, from which the
+ * transmit power is derived. Allocations are counted by
+ * wrapping malloc() and friends at link time (see Makefile).
+ * The metrics counters of the last repetition are reported
+ * along with the timings.
+ *
+ * Results are written as JSON:
+ *
+ *     placement_bench [-n 100,1000,...] [-d 8,32] [-s stage,...]
+ *                     [-r reps] [-t timeout] [-S seed] [-o file]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/shortest_path_tree.h"
+#include "../src/rnp_misc.h"
+#include "../src/sptirp.h"
+#include "../src/simulation.h"
+#include "../src/neighbor.h"
+#include "../src/bfs.h"
+
+#define MAX_SIZES      32
+#define MAX_DEGREES    8
+#define MAX_REPS       100
+#define MAX_SNS        64
+#define PI             3.14159265358979323846
+
+typedef enum {
+    ST_INIT, ST_INIT_BULK, ST_SPT, ST_BFS_TREE,
+    ST_FEASIBILITY, ST_SPTIRP, ST_SIMULATE, ST_COUNT
+} stage_t;
+
+static const char* stage_names[ST_COUNT] = {
+    "ALGraph_Init", "Neighbor_InitGraph", "ALGraph_ShortestPathTree",
+    "ALGraph_BFSTree", "check_feasibility", "SPTiRP", "simulate"
+};
+
+/* @struct
+ * Outcome of one configuration, sent back by the child.
+ */
+typedef struct {
+    int        status;
+    double     median_ms;
+    double     p95_ms;
+    double     allocs;
+    double     alloc_bytes;
+    long       peak_rss_kb;
+    double     power;
+    uint64_t   counters[METRIC_COUNT];
+} result_t;
+
+enum { RES_OK, RES_FAILED, RES_TIMEOUT, RES_SKIPPED };
+static const char* status_names[] = {"ok", "failed", "timeout", "skipped"};
+
+/* @struct
+ * Input of a stage: the node set and, depending on the
+ * stage, the graph and tree built from it.
+ */
+typedef struct {
+    p_sll        nodes;
+    pt_ALGraph   pg;
+    pt_ALGraph   spt;
+    gqrm_id_t    dsts[MAX_SNS];
+    size_t       n_dsts;
+} fixture_t;
+
+static size_t  alloc_count;
+static size_t  alloc_bytes;
+
+extern void* __real_malloc(size_t);
+extern void* __real_calloc(size_t, size_t);
+extern void* __real_realloc(void*, size_t);
+
+void*
+__wrap_malloc(size_t size)
+{
+    __sync_fetch_and_add(&alloc_count, 1);
+    __sync_fetch_and_add(&alloc_bytes, size);
+    return __real_malloc(size);
+}
+
+void*
+__wrap_calloc(size_t n, size_t size)
+{
+    __sync_fetch_and_add(&alloc_count, 1);
+    __sync_fetch_and_add(&alloc_bytes, n * size);
+    return __real_calloc(n, size);
+}
+
+void*
+__wrap_realloc(void* p, size_t size)
+{
+    __sync_fetch_and_add(&alloc_count, 1);
+    __sync_fetch_and_add(&alloc_bytes, size);
+    return __real_realloc(p, size);
+}
+
+static size_t   parse_list(const char*, double*, size_t);
+static double   now_ms(void);
+static double   power_for_degree(size_t, double);
+static ds_stat  fixture_setup(fixture_t*, stage_t, size_t, double, unsigned);
+static void     fixture_clear(fixture_t*);
+static void     node_clear(sll_data_t*);
+static ds_stat  run_stage(fixture_t*, stage_t);
+static void     run_config(stage_t, size_t, double, size_t, unsigned, int);
+static result_t spawn_config(stage_t, size_t, double, size_t, unsigned, unsigned);
+static int      double_cmp(const void*, const void*);
+
+int main(int argc, char* argv[])
+{
+    double      sizes[MAX_SIZES] = {100, 300, 1000, 3000, 10000, 30000, 100000};
+    double      degrees[MAX_DEGREES] = {8, 32};
+    size_t      n_sizes = 7, n_degrees = 2, reps = 5, i, j, k, c;
+    unsigned    timeout = 60, seed = 20160901;
+    int         stages[ST_COUNT], opt, first = 1;
+    char*       tok;
+    FILE*       out = stdout;
+    result_t    res[ST_COUNT][MAX_DEGREES][MAX_SIZES];
+
+    for (k = 0; k < ST_COUNT; k++)
+        stages[k] = 1;
+    while ((opt = getopt(argc, argv, "n:d:s:r:t:S:o:")) != -1) {
+        switch (opt) {
+        case 'n':
+            n_sizes = parse_list(optarg, sizes, MAX_SIZES);
+            break;
+        case 'd':
+            n_degrees = parse_list(optarg, degrees, MAX_DEGREES);
+            break;
+        case 's':
+            for (k = 0; k < ST_COUNT; k++)
+                stages[k] = 0;
+            for (tok = strtok(optarg, ","); tok; tok = strtok(NULL, ","))
+                for (k = 0; k < ST_COUNT; k++)
+                    if (strcmp(tok, stage_names[k]) == 0)
+                        stages[k] = 1;
+            break;
+        case 'r':
+            reps = (size_t)atoi(optarg);
+            break;
+        case 't':
+            timeout = (unsigned)atoi(optarg);
+            break;
+        case 'S':
+            seed = (unsigned)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            if ((out = fopen(optarg, "w")) == NULL) {
+                perror(optarg);
+                exit(-1);
+            }
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n sizes] [-d degrees] [-s stages] "
+                    "[-r reps] [-t timeout] [-S seed] [-o file]\n", argv[0]);
+            exit(-1);
+        }
+    }
+    if (n_sizes == 0 || n_degrees == 0 || reps == 0 || reps > MAX_REPS)
+        exit(-1);
+
+    for (k = 0; k < ST_COUNT; k++) {
+        if (!stages[k])
+            continue;
+        for (j = 0; j < n_degrees; j++)
+            for (i = 0; i < n_sizes; i++) {
+                /* a stage too slow for a size is too slow for larger ones */
+                if (i > 0 && (res[k][j][i - 1].status == RES_TIMEOUT ||
+                              res[k][j][i - 1].status == RES_SKIPPED)) {
+                    res[k][j][i].status = RES_SKIPPED;
+                    continue;
+                }
+                fprintf(stderr, "%s n=%g degree=%g\n", stage_names[k], sizes[i], degrees[j]);
+                res[k][j][i] = spawn_config((stage_t)k, (size_t)sizes[i], degrees[j],
+                                            reps, seed, timeout);
+            }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"placement\",\n");
+    fprintf(out, "  \"seed\": %u,\n  \"reps\": %ld,\n  \"timeout_s\": %u,\n",
+            seed, reps, timeout);
+    fprintf(out, "  \"neighbor_kernel\": \"%s\",\n  \"results\": [", Neighbor_KernelName());
+    for (k = 0; k < ST_COUNT; k++) {
+        if (!stages[k])
+            continue;
+        for (j = 0; j < n_degrees; j++)
+            for (i = 0; i < n_sizes; i++) {
+                fprintf(out, "%s\n    {\"stage\": \"%s\", \"nodes\": %ld, \"degree\": %g, "
+                        "\"status\": \"%s\"", first ? "" : ",", stage_names[k],
+                        (size_t)sizes[i], degrees[j], status_names[res[k][j][i].status]);
+                first = 0;
+                if (res[k][j][i].status == RES_OK) {
+                    fprintf(out, ", \"power\": %.3f, \"median_ms\": %.3f, \"p95_ms\": %.3f, "
+                            "\"allocs\": %.0f, \"alloc_bytes\": %.0f, \"peak_rss_kb\": %ld",
+                            res[k][j][i].power, res[k][j][i].median_ms, res[k][j][i].p95_ms,
+                            res[k][j][i].allocs, res[k][j][i].alloc_bytes,
+                            res[k][j][i].peak_rss_kb);
+                    fprintf(out, ", \"metrics\": {");
+                    for (c = 0; c < METRIC_COUNT; c++)
+                        fprintf(out, "%s\"%s\": %llu", c ? ", " : "",
+                                Metrics_CounterName(c),
+                                (unsigned long long)res[k][j][i].counters[c]);
+                    fprintf(out, "}");
+                }
+                fprintf(out, "}");
+            }
+    }
+
+    /* empirical exponent of the time between successive sizes */
+    fprintf(out, "\n  ],\n  \"scaling\": [");
+    first = 1;
+    for (k = 0; k < ST_COUNT; k++) {
+        if (!stages[k])
+            continue;
+        for (j = 0; j < n_degrees; j++)
+            for (i = 1; i < n_sizes; i++) {
+                if (res[k][j][i - 1].status != RES_OK || res[k][j][i].status != RES_OK ||
+                    res[k][j][i - 1].median_ms <= 0.0 || sizes[i] == sizes[i - 1])
+                    continue;
+                fprintf(out, "%s\n    {\"stage\": \"%s\", \"degree\": %g, \"from\": %ld, "
+                        "\"to\": %ld, \"exponent\": %.3f}", first ? "" : ",",
+                        stage_names[k], degrees[j], (size_t)sizes[i - 1], (size_t)sizes[i],
+                        log(res[k][j][i].median_ms / res[k][j][i - 1].median_ms) /
+                        log(sizes[i] / sizes[i - 1]));
+                first = 0;
+            }
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
+
+/* 
+ * Run one configuration in a child process and collect its
+ * result through a pipe. The child is killed by SIGALRM after
+ * "timeout" seconds.
+ */
+static result_t
+spawn_config(stage_t st, size_t n, double degree, size_t reps,
+             unsigned seed, unsigned timeout)
+{
+    result_t   res;
+    int        fds[2], status;
+    pid_t      pid;
+
+    memset(&res, 0, sizeof(res));
+    res.status = RES_FAILED;
+    if (pipe(fds) == -1)
+        return res;
+    fflush(NULL);
+    if ((pid = fork()) == -1) {
+        close(fds[0]);
+        close(fds[1]);
+        return res;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(timeout);
+        run_config(st, n, degree, reps, seed, fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (read(fds[0], &res, sizeof(res)) != (ssize_t)sizeof(res)) {
+        memset(&res, 0, sizeof(res));
+        res.status = RES_FAILED;
+    }
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+        res.status = RES_TIMEOUT;
+    return res;
+}
+
+/* 
+ * Body of the child: time "reps" runs of a stage and write
+ * the result to "fd". The library's diagnostics go to
+ * /dev/null so that they are not mixed with the report.
+ */
+static void
+run_config(stage_t st, size_t n, double degree, size_t reps,
+           unsigned seed, int fd)
+{
+    fixture_t       fx;
+    result_t        res;
+    struct rusage   ru;
+    MetricsBlock    sum;
+    double          times[MAX_REPS], t;
+    size_t          i, c, b;
+
+    if (freopen("/dev/null", "w", stdout) == NULL)
+        return;
+    memset(&res, 0, sizeof(res));
+    res.status = RES_OK;
+    res.power  = power_for_degree(n, degree);
+
+    for (i = 0; i < reps; i++) {
+        if (fixture_setup(&fx, st, n, res.power, seed) == DS_ERROR) {
+            res.status = RES_FAILED;
+            break;
+        }
+        /* simulate() draws backoffs from rand() */
+        srand(seed);
+        c = alloc_count;
+        b = alloc_bytes;
+        Metrics_Reset();
+        t = now_ms();
+        if (run_stage(&fx, st) == DS_ERROR)
+            res.status = RES_FAILED;
+        times[i] = now_ms() - t;
+        Metrics_Snapshot(&sum);
+        memcpy(res.counters, sum.counters, sizeof(res.counters));
+        res.allocs      += (double)(alloc_count - c) / reps;
+        res.alloc_bytes += (double)(alloc_bytes - b) / reps;
+        fixture_clear(&fx);
+        if (res.status != RES_OK)
+            break;
+    }
+
+    if (res.status == RES_OK) {
+        qsort(times, reps, sizeof(double), double_cmp);
+        res.median_ms = reps % 2 ? times[reps / 2] :
+                        (times[reps / 2 - 1] + times[reps / 2]) / 2.0;
+        res.p95_ms    = times[(size_t)ceil(0.95 * reps) - 1];
+    }
+    getrusage(RUSAGE_SELF, &ru);
+    res.peak_rss_kb = ru.ru_maxrss;
+    if (write(fd, &res, sizeof(res)) != (ssize_t)sizeof(res))
+        _exit(-1);
+}
+
+/* 
+ * Time a single run of stage "st" on a prepared fixture.
+ */
+static ds_stat
+run_stage(fixture_t* fx, stage_t st)
+{
+    pt_ALGraph   pg;
+
+    switch (st) {
+    case ST_INIT:
+        if ((fx->pg = ALGraph_Create()) == NULL)
+            return DS_ERROR;
+        return ALGraph_Init(fx->pg, fx->nodes, check_neighbor);
+    case ST_INIT_BULK:
+        if ((fx->pg = ALGraph_Create()) == NULL)
+            return DS_ERROR;
+        return Neighbor_InitGraph(fx->pg, fx->nodes, NULL);
+    case ST_SPT:
+        fx->spt = ALGraph_ShortestPathTree(fx->pg, 0, fx->dsts, fx->n_dsts);
+        return fx->spt ? DS_OK : DS_ERROR;
+    case ST_BFS_TREE:
+        fx->spt = ALGraph_BFSTree(fx->pg, 0, fx->dsts, fx->n_dsts, NULL);
+        return fx->spt ? DS_OK : DS_ERROR;
+    case ST_FEASIBILITY:
+        check_feasibility(fx->pg, 0, fx->dsts, fx->n_dsts);
+        return DS_OK;
+    case ST_SPTIRP:
+        /* an infeasible instance is a valid outcome */
+        if ((pg = SPTiRP(fx->nodes)) != NULL)
+            ALGraph_Free(&pg);
+        return DS_OK;
+    case ST_SIMULATE:
+        return simulate(fx->spt, 0, fx->dsts, fx->n_dsts) < 0.0 ? DS_ERROR : DS_OK;
+    default:
+        return DS_ERROR;
+    }
+}
+
+/* 
+ * Generate the node set of a configuration: a gateway with
+ * ID 0, up to MAX_SNS sensor nodes and candidate deployment
+ * locations for the rest, all sharing transmit power "p".
+ * Then build what stage "st" takes as input.
+ */
+static ds_stat
+fixture_setup(fixture_t* fx, stage_t st, size_t n, double p, unsigned seed)
+{
+    pt_Node      nd;
+    gqrm_hop_t   hop;
+    size_t       i;
+
+    memset(fx, 0, sizeof(fixture_t));
+    fx->n_dsts = n / 10 < MAX_SNS ? n / 10 : MAX_SNS;
+    if (fx->n_dsts == 0)
+        fx->n_dsts = 1;
+    /* twice the hops needed to cross the field diagonally */
+    hop = (gqrm_hop_t)(2.0 * sqrt(2.0) * (UPPER_RIGHT - LOWER_LEFT) /
+                       Neighbor_Range(p)) + 2;
+
+    srand(seed);
+    if (SingleLinkedList_Init(&fx->nodes) == DS_ERROR)
+        return DS_ERROR;
+    for (i = 0; i < n; i++) {
+        if (i == 0)
+            nd = Node_CreateRandomGW(i, p, hop);
+        else if (i <= fx->n_dsts)
+            nd = Node_CreateRandomSN(i, p, hop);
+        else
+            nd = Node_CreateRandomCDL(i, p, hop);
+        if (!nd || SingleLinkedList_InsertTail(fx->nodes, nd) == DS_ERROR) {
+            fixture_clear(fx);
+            return DS_ERROR;
+        }
+        if (i > 0 && i <= fx->n_dsts)
+            fx->dsts[i - 1] = (gqrm_id_t)i;
+    }
+
+    if (st == ST_INIT || st == ST_INIT_BULK || st == ST_SPTIRP)
+        return DS_OK;
+    if ((fx->pg = ALGraph_Create()) == NULL ||
+        Neighbor_InitGraph(fx->pg, fx->nodes, NULL) == DS_ERROR) {
+        fixture_clear(fx);
+        return DS_ERROR;
+    }
+    if (st != ST_SIMULATE)
+        return DS_OK;
+    if ((fx->spt = ALGraph_BFSTree(fx->pg, 0, fx->dsts, fx->n_dsts, NULL)) == NULL) {
+        fixture_clear(fx);
+        return DS_ERROR;
+    }
+    return DS_OK;
+}
+
+static void
+fixture_clear(fixture_t* fx)
+{
+    if (fx->spt)
+        ALGraph_Free(&fx->spt);
+    if (fx->pg)
+        ALGraph_Free(&fx->pg);
+    if (fx->nodes)
+        SingleLinkedList_Destroy(&fx->nodes, node_clear);
+}
+
+static void
+node_clear(sll_data_t* nd)
+{
+    Node_Free((pt_Node*)nd);
+}
+
+/* 
+ * Find the transmit power giving each of "n" nodes spread
+ * over the field "degree" neighbors on average, neglecting
+ * the border. Power is an attenuation: the range shrinks as
+ * it grows.
+ */
+static double
+power_for_degree(size_t n, double degree)
+{
+    double   area = (double)(UPPER_RIGHT - LOWER_LEFT) * (UPPER_RIGHT - LOWER_LEFT);
+    double   range = sqrt(degree * area / (PI * (double)n));
+    double   lo = 0.0, hi = 1000.0, mid, r;
+    int      i;
+
+    for (i = 0; i < 100; i++) {
+        mid = (lo + hi) / 2.0;
+        r   = Neighbor_Range(mid);
+        if (r >= range)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static size_t
+parse_list(const char* s, double* out, size_t max)
+{
+    char*    end;
+    size_t   n = 0;
+
+    while (*s && n < max) {
+        out[n++] = strtod(s, &end);
+        if (end == s)
+            return 0;
+        s = *end == ',' ? end + 1 : end;
+    }
+    return n;
+}
+
+static double
+now_ms(void)
+{
+    struct timespec   ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int
+double_cmp(const void* a, const void* b)
+{
+    double   x = *(const double*)a, y = *(const double*)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
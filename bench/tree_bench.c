@@ -0,0 +1,551 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file tree_bench.c
+ *
+ * Benchmark of the ordered containers: BSTree, AVLTree,
+ * RBTree and the BPTree keyed by the integer value.
+ *
+ * For every size, "n" distinct keys are inserted in a random
+ * order, looked up in another random order (all hits, then
+ * all misses), scanned in order and finally all deleted.
+ * Every phase is timed "reps" times on a fresh tree and the
+ * median reported along with the allocations of the insert
+ * phase and the height reached. Keys come from a fixed seed.
+ *
+ * Results are written as JSON:
+ *
+ *     tree_bench [-n 1000,100000,...] [-r reps] [-S seed] [-o file]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/header.h"
+#include "../src/avl_tree.h"
+#include "../src/rb_tree.h"
+#include "../src/binary_search_tree.h"
+#include "../src/bplus_tree.h"
+
+#define MAX_SIZES      32
+#define MAX_REPS       100
+
+typedef enum {
+    PH_INSERT, PH_HIT, PH_MISS, PH_SCAN, PH_DELETE, PH_COUNT
+} phase_t;
+
+static const char* phase_names[PH_COUNT] = {
+    "insert", "lookup_hit", "lookup_miss", "scan", "delete"
+};
+
+/* @struct
+ * The operations of an ordered container under test.
+ */
+typedef struct {
+    const char*   name;
+    void*         (*create)(void);
+    ds_stat       (*insert)(void*, void*);
+    ds_bool       (*contain)(void*, void*);
+    ds_stat       (*delete)(void*, void*);
+    size_t        (*scan)(void*);
+    size_t        (*height)(void*);
+    void          (*free)(void*);
+} tree_ops;
+
+static void*    avl_create(void);
+static ds_stat  avl_insert(void*, void*);
+static ds_bool  avl_contain(void*, void*);
+static ds_stat  avl_delete(void*, void*);
+static size_t   avl_scan(void*);
+static size_t   avl_height(void*);
+static void     avl_free(void*);
+static void     avl_count(avlt_data_t, size_t);
+static void*    rb_create(void);
+static ds_stat  rb_insert(void*, void*);
+static ds_bool  rb_contain(void*, void*);
+static ds_stat  rb_delete(void*, void*);
+static size_t   rb_scan(void*);
+static size_t   rb_height(void*);
+static void     rb_free(void*);
+static void*    bst_create(void);
+static ds_stat  bst_insert(void*, void*);
+static ds_bool  bst_contain(void*, void*);
+static ds_stat  bst_delete(void*, void*);
+static size_t   bst_scan(void*);
+static size_t   bst_height(void*);
+static void     bst_free(void*);
+static void     bst_count(bst_data_t, size_t);
+static void*    bpt_create(void);
+static ds_stat  bpt_insert(void*, void*);
+static ds_bool  bpt_contain(void*, void*);
+static ds_stat  bpt_delete(void*, void*);
+static size_t   bpt_scan(void*);
+static size_t   bpt_height(void*);
+static void     bpt_free(void*);
+
+static const tree_ops trees[] = {
+    {"AVLTree", avl_create, avl_insert, avl_contain, avl_delete,
+     avl_scan, avl_height, avl_free},
+    {"RBTree", rb_create, rb_insert, rb_contain, rb_delete,
+     rb_scan, rb_height, rb_free},
+    {"BSTree", bst_create, bst_insert, bst_contain, bst_delete,
+     bst_scan, bst_height, bst_free},
+    {"BPTree", bpt_create, bpt_insert, bpt_contain, bpt_delete,
+     bpt_scan, bpt_height, bpt_free}
+};
+#define N_TREES    (sizeof(trees) / sizeof(trees[0]))
+
+static size_t  alloc_count;
+static size_t  scanned, deepest;
+
+extern void* __real_malloc(size_t);
+extern void* __real_calloc(size_t, size_t);
+extern void* __real_realloc(void*, size_t);
+
+void*
+__wrap_malloc(size_t size)
+{
+    alloc_count++;
+    return __real_malloc(size);
+}
+
+void*
+__wrap_calloc(size_t n, size_t size)
+{
+    alloc_count++;
+    return __real_calloc(n, size);
+}
+
+void*
+__wrap_realloc(void* p, size_t size)
+{
+    alloc_count++;
+    return __real_realloc(p, size);
+}
+
+static ds_stat  run_tree(const tree_ops*, int*, size_t*, size_t*, size_t,
+                         double[], size_t*, size_t*);
+static void     shuffle(size_t*, size_t);
+static int      int_cmp(void*, void*);
+static size_t   parse_list(const char*, double*, size_t);
+static double   now_ms(void);
+static int      double_cmp(const void*, const void*);
+
+int main(int argc, char* argv[])
+{
+    double      sizes[MAX_SIZES] = {1000, 10000, 100000, 1000000};
+    double      times[PH_COUNT][MAX_REPS], ms[PH_COUNT];
+    size_t      n_sizes = 4, reps = 5, i, t, r, p, n, allocs, height;
+    size_t*     ins;
+    size_t*     look;
+    int*        keys;
+    unsigned    seed = 20160901;
+    int         opt, first = 1;
+    FILE*       out = stdout;
+
+    while ((opt = getopt(argc, argv, "n:r:S:o:")) != -1) {
+        switch (opt) {
+        case 'n':
+            n_sizes = parse_list(optarg, sizes, MAX_SIZES);
+            break;
+        case 'r':
+            reps = (size_t)atoi(optarg);
+            break;
+        case 'S':
+            seed = (unsigned)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            if ((out = fopen(optarg, "w")) == NULL) {
+                perror(optarg);
+                exit(-1);
+            }
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n sizes] [-r reps] [-S seed] [-o file]\n",
+                    argv[0]);
+            exit(-1);
+        }
+    }
+    if (n_sizes == 0 || reps == 0 || reps > MAX_REPS)
+        exit(-1);
+
+    fprintf(out, "{\n  \"benchmark\": \"tree\",\n");
+    fprintf(out, "  \"seed\": %u,\n  \"reps\": %ld,\n  \"results\": [", seed, reps);
+    for (i = 0; i < n_sizes; i++) {
+        n = (size_t)sizes[i];
+        /* keys 0, 2, 4, ... are inserted, odd ones are misses */
+        if ((keys = malloc((2 * n + 1) * sizeof(int))) == NULL ||
+            (ins = malloc((n + 1) * sizeof(size_t))) == NULL ||
+            (look = malloc((n + 1) * sizeof(size_t))) == NULL)
+            exit(-1);
+        for (p = 0; p < 2 * n; p++)
+            keys[p] = (int)p;
+        srand(seed);
+        for (p = 0; p < n; p++)
+            ins[p] = look[p] = p;
+        shuffle(ins, n);
+        shuffle(look, n);
+
+        for (t = 0; t < N_TREES; t++) {
+            fprintf(stderr, "%s n=%ld\n", trees[t].name, n);
+            for (r = 0; r < reps; r++) {
+                if (run_tree(&trees[t], keys, ins, look, n, ms, &allocs, &height) == DS_ERROR) {
+                    fprintf(stderr, "%s failed at n=%ld\n", trees[t].name, n);
+                    exit(-1);
+                }
+                for (p = 0; p < PH_COUNT; p++)
+                    times[p][r] = ms[p];
+            }
+            for (p = 0; p < PH_COUNT; p++) {
+                qsort(times[p], reps, sizeof(double), double_cmp);
+                ms[p] = reps % 2 ? times[p][reps / 2] :
+                        (times[p][reps / 2 - 1] + times[p][reps / 2]) / 2.0;
+                fprintf(out, "%s\n    {\"tree\": \"%s\", \"nodes\": %ld, \"phase\": \"%s\", "
+                        "\"median_ms\": %.3f, \"ns_per_op\": %.1f", first ? "" : ",",
+                        trees[t].name, n, phase_names[p], ms[p], n ? ms[p] * 1e6 / n : 0.0);
+                if (p == PH_INSERT)
+                    fprintf(out, ", \"allocs\": %ld, \"height\": %ld", allocs, height);
+                fprintf(out, "}");
+                first = 0;
+            }
+        }
+        free(keys);
+        free(ins);
+        free(look);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
+
+/* 
+ * Time every phase once on a fresh tree of the even keys
+ * indexed by "ins", in that order; lookups and deletions go
+ * in the order of "look".
+ */
+static ds_stat
+run_tree(const tree_ops* ops, int* keys, size_t* ins, size_t* look, size_t n,
+         double ms[], size_t* allocs, size_t* height)
+{
+    void*    tree;
+    double   t;
+    size_t   i, found = 0;
+
+    if ((tree = ops->create()) == NULL)
+        return DS_ERROR;
+
+    *allocs = alloc_count;
+    t = now_ms();
+    for (i = 0; i < n; i++)
+        if (ops->insert(tree, &keys[2 * ins[i]]) == DS_ERROR)
+            return DS_ERROR;
+    ms[PH_INSERT] = now_ms() - t;
+    *allocs = alloc_count - *allocs;
+    *height = ops->height(tree);
+
+    t = now_ms();
+    for (i = 0; i < n; i++)
+        found += ops->contain(tree, &keys[2 * look[i]]) == DS_TRUE;
+    ms[PH_HIT] = now_ms() - t;
+    t = now_ms();
+    for (i = 0; i < n; i++)
+        found += ops->contain(tree, &keys[2 * look[i] + 1]) == DS_TRUE;
+    ms[PH_MISS] = now_ms() - t;
+    t = now_ms();
+    if (ops->scan(tree) != n || found != n)
+        return DS_ERROR;
+    ms[PH_SCAN] = now_ms() - t;
+
+    t = now_ms();
+    for (i = 0; i < n; i++)
+        if (ops->delete(tree, &keys[2 * look[i]]) == DS_ERROR)
+            return DS_ERROR;
+    ms[PH_DELETE] = now_ms() - t;
+    ops->free(tree);
+    return DS_OK;
+}
+
+static void*
+avl_create(void)
+{
+    return AVLTree_Create(int_cmp);
+}
+
+static ds_stat
+avl_insert(void* tree, void* key)
+{
+    return AVLTree_Insert(tree, key);
+}
+
+static ds_bool
+avl_contain(void* tree, void* key)
+{
+    return AVLTree_Contain(tree, key);
+}
+
+static ds_stat
+avl_delete(void* tree, void* key)
+{
+    return AVLTree_Delete(tree, key);
+}
+
+static size_t
+avl_scan(void* tree)
+{
+    scanned = 0;
+    AVLTree_InOrderMap(tree, avl_count);
+    return scanned;
+}
+
+static void
+avl_count(avlt_data_t d, size_t depth)
+{
+    scanned++;
+}
+
+static size_t
+avl_height(void* tree)
+{
+    return AVLTree_Height(tree);
+}
+
+static void
+avl_free(void* tree)
+{
+    pt_AVLTree   avl = tree;
+
+    AVLTree_Free(&avl);
+}
+
+static void*
+rb_create(void)
+{
+    return RBTree_Create(int_cmp);
+}
+
+static ds_stat
+rb_insert(void* tree, void* key)
+{
+    return RBTree_Insert(tree, key);
+}
+
+static ds_bool
+rb_contain(void* tree, void* key)
+{
+    return RBTree_Contain(tree, key);
+}
+
+static ds_stat
+rb_delete(void* tree, void* key)
+{
+    return RBTree_Delete(tree, key);
+}
+
+static size_t
+rb_scan(void* tree)
+{
+    rbt_iter   it;
+    size_t     n = 0;
+
+    RBTree_Begin(tree, &it);
+    while (RBTree_Next(&it, NULL) == DS_TRUE)
+        n++;
+    return n;
+}
+
+static size_t
+rb_height(void* tree)
+{
+    return RBTree_Height(tree);
+}
+
+static void
+rb_free(void* tree)
+{
+    pt_RBTree   rb = tree;
+
+    RBTree_Free(&rb);
+}
+
+static void*
+bst_create(void)
+{
+    return BSTree_Create(int_cmp);
+}
+
+static ds_stat
+bst_insert(void* tree, void* key)
+{
+    return BSTree_Insert(tree, key);
+}
+
+static ds_bool
+bst_contain(void* tree, void* key)
+{
+    return BSTree_Contain(tree, key);
+}
+
+static ds_stat
+bst_delete(void* tree, void* key)
+{
+    return BSTree_Delete(tree, key);
+}
+
+static size_t
+bst_scan(void* tree)
+{
+    scanned = deepest = 0;
+    BSTree_InOrderMap(tree, bst_count);
+    return scanned;
+}
+
+static void
+bst_count(bst_data_t d, size_t depth)
+{
+    scanned++;
+    if (depth + 1 > deepest)
+        deepest = depth + 1;
+}
+
+/* @fn
+ * BSTree keeps no height, so take the deepest level an
+ * in-order walk reaches.
+ */
+static size_t
+bst_height(void* tree)
+{
+    bst_scan(tree);
+    return deepest;
+}
+
+static void
+bst_free(void* tree)
+{
+    pt_BSTree   bst = tree;
+
+    BSTree_Free(&bst);
+}
+
+static void*
+bpt_create(void)
+{
+    return BPTree_Create();
+}
+
+static ds_stat
+bpt_insert(void* tree, void* key)
+{
+    return BPTree_Insert(tree, *(int*)key, key);
+}
+
+static ds_bool
+bpt_contain(void* tree, void* key)
+{
+    return BPTree_Contain(tree, *(int*)key);
+}
+
+static ds_stat
+bpt_delete(void* tree, void* key)
+{
+    return BPTree_Delete(tree, *(int*)key, NULL);
+}
+
+static size_t
+bpt_scan(void* tree)
+{
+    bpt_iter   it;
+    size_t     n = 0;
+
+    BPTree_Begin(tree, &it);
+    while (BPTree_Next(&it, NULL, NULL) == DS_TRUE)
+        n++;
+    return n;
+}
+
+static size_t
+bpt_height(void* tree)
+{
+    return BPTree_Height(tree);
+}
+
+static void
+bpt_free(void* tree)
+{
+    pt_BPTree   bpt = tree;
+
+    BPTree_Free(&bpt);
+}
+
+static void
+shuffle(size_t* a, size_t n)
+{
+    size_t   i, j, t;
+
+    for (i = n; i > 1; i--) {
+        j = ((size_t)rand() * RAND_MAX + rand()) % i;
+        t = a[i - 1];
+        a[i - 1] = a[j];
+        a[j] = t;
+    }
+}
+
+static int
+int_cmp(void* a, void* b)
+{
+    return *(int*)a - *(int*)b;
+}
+
+static size_t
+parse_list(const char* s, double* out, size_t max)
+{
+    char*    end;
+    size_t   n = 0;
+
+    while (*s && n < max) {
+        out[n++] = strtod(s, &end);
+        if (end == s)
+            return 0;
+        s = *end == ',' ? end + 1 : end;
+    }
+    return n;
+}
+
+static double
+now_ms(void)
+{
+    struct timespec   ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int
+double_cmp(const void* a, const void* b)
+{
+    double   x = *(const double*)a, y = *(const double*)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
@@ -27,6 +27,8 @@
  * right   - the right child of this node
  * parent  - the parent of this node
  * height  - the height of this node
+ * count   - the number of nodes in the subtree rooted here,
+ *           kept along with the height
  */
 typedef struct _avlt_node {
     avlt_data_t           data;
@@ -34,6 +36,7 @@ typedef struct _avlt_node {
 	struct _avlt_node*    right;
 	struct _avlt_node*    parent;
 	size_t                height;
+	size_t                count;
 } avlt_node, *p_avlt_node;
 
 /** @struct
@@ -41,17 +44,27 @@ typedef struct _avlt_node {
  * root   - the root of this tree
  * cmp    - the function used to compare data stored in nodes
  * size   - indicating the number of nodes in this tree
+ * pool   - the pool nodes of this tree are allocated from
  */
 typedef struct _avl_tree {
     struct _avlt_node*    root;
 	avl_cmp               cmp;
 	size_t                size;
+	pt_NodePool           pool;
 }val_tree, p_avl_tree;
 
-static p_avlt_node create_node(avlt_data_t);
-static ds_stat pre_map_subtree(p_avlt_node, avlt_map_func, size_t);
-static ds_stat in_map_subtree(p_avlt_node, avlt_map_func, size_t);
-static ds_stat post_map_subtree(p_avlt_node, avlt_map_func, size_t);
+/* an upper bound of the height of any AVL tree */
+#define MAX_HEIGHT    128
+
+/** @enum
+ * Orders a tree is walked in.
+ */
+typedef enum {
+    PRE_ORDER, IN_ORDER, POST_ORDER
+} walk_order;
+
+static p_avlt_node create_node(pt_AVLTree, avlt_data_t);
+static ds_stat map_subtree(p_avlt_node, avlt_map_func, walk_order);
 static ds_stat get_max(p_avlt_node, avlt_data_t*);
 static ds_stat get_min(p_avlt_node, avlt_data_t*);
 static ds_stat insert(pt_AVLTree, p_avlt_node, avlt_data_t);
@@ -63,22 +76,29 @@ static ds_stat left_rotate(p_avlt_node*);
 static ds_stat right_left_rotate(p_avlt_node*);
 static ds_stat left_right_rotate(p_avlt_node*);
 static size_t height(p_avlt_node);
+static size_t count(p_avlt_node);
+static size_t rank(pt_AVLTree, avlt_data_t, ds_bool);
+static p_avlt_node lower_bound(pt_AVLTree, avlt_data_t);
+static p_avlt_node successor(p_avlt_node);
+static void range_map(pt_AVLTree, p_avlt_node, avlt_data_t, avlt_data_t,
+                      avlt_map_func, size_t);
 static ds_stat update_height(p_avlt_node);
 static ds_stat balance(p_avlt_node*);
 static ds_stat balance_to_root(pt_AVLTree, p_avlt_node);
-static void free_subtree(p_avlt_node*);
-static p_avlt_node copy_node(p_avlt_node);
-static p_avlt_node copy_subtree(p_avlt_node);
+static p_avlt_node copy_node(pt_NodePool, p_avlt_node);
+static p_avlt_node copy_subtree(pt_NodePool, p_avlt_node);
 static ds_stat in_inter_opt(pt_AVLTree, p_avlt_node, avlt_inter_func);
+static size_t to_array(p_avlt_node, avlt_data_t[], size_t);
+static p_avlt_node build_subtree(pt_NodePool, avlt_data_t[], size_t);
 
 static p_avlt_node
-create_node(avlt_data_t data)
+create_node(pt_AVLTree avl, avlt_data_t data)
 {
     p_avlt_node    nd;
 	if (!data)
 	    return NULL;
 
-	if ((nd = malloc(sizeof(avlt_node))) == NULL)
+	if ((nd = NodePool_Alloc(avl->pool)) == NULL)
 	    return NULL;
 
     nd->data    = data;
@@ -86,6 +106,7 @@ create_node(avlt_data_t data)
 	nd->right   = NULL;
 	nd->parent  = NULL;
 	nd->height  = 1;
+	nd->count   = 1;
 
 	return nd;
 }
@@ -100,6 +121,10 @@ AVLTree_Create(avl_cmp cmp)
 	
 	if ((avl = malloc(sizeof(AVLTree))) == NULL)
 	    return NULL;
+	if ((avl->pool = NodePool_Create(sizeof(avlt_node))) == NULL) {
+	    free(avl);
+		return NULL;
+	}
 	
 	avl->root = NULL;
 	avl->cmp  = cmp;
@@ -113,7 +138,7 @@ AVLTree_PreOrderMap(pt_AVLTree avl, avlt_map_func func)
 {
     if (!avl)
 	    return DS_ERROR;
-	return pre_map_subtree(avl->root, func, 0);
+	return map_subtree(avl->root, func, PRE_ORDER);
 }
 
 ds_stat
@@ -121,7 +146,7 @@ AVLTree_InOrderMap(pt_AVLTree avl, avlt_map_func func)
 {
     if (!avl)
 	    return DS_ERROR;
-	return in_map_subtree(avl->root, func, 0);
+	return map_subtree(avl->root, func, IN_ORDER);
 }
 
 ds_stat
@@ -129,7 +154,7 @@ AVLTree_PostOrderMap(pt_AVLTree avl, avlt_map_func func)
 {
     if (!avl)
 	    return DS_ERROR;
-	return post_map_subtree(avl->root, func, 0);
+	return map_subtree(avl->root, func, POST_ORDER);
 }
 
 /** @fn
@@ -157,41 +182,50 @@ in_inter_opt(pt_AVLTree avl, p_avlt_node sub, avlt_inter_func func)
 	in_inter_opt(avl, sub->left, func);
 	func(avl, sub->data);
 	in_inter_opt(avl, sub->right, func);
-}
-
-static ds_stat
-pre_map_subtree(p_avlt_node sub, avlt_map_func func, size_t depth)
-{
-    if (!sub || !func)
-	    return DS_ERROR;
-	
-	func(sub->data, depth);
-	pre_map_subtree(sub->left, func, depth + 1);
-	pre_map_subtree(sub->right, func, depth + 1);
 	return DS_OK;
 }
 
+/** @fn
+ * Visit subtree "sub" in the given order without recursion.
+ * The ancestors of the current node are kept on a stack
+ * local to this function, whose size is the depth of the
+ * current node; an AVL tree of 2^64 nodes is less than 93
+ * high.
+ */
 static ds_stat
-in_map_subtree(p_avlt_node sub, avlt_map_func func, size_t depth)
+map_subtree(p_avlt_node sub, avlt_map_func func, walk_order order)
 {
-    if (!sub || !func)
-	    return DS_ERROR;
-	
-	in_map_subtree(sub->left, func, depth + 1);
-	func(sub->data, depth);
-	in_map_subtree(sub->right, func, depth + 1);
-	return DS_OK;
-}
+    p_avlt_node   stack[MAX_HEIGHT], last = NULL, top;
+	size_t       n = 0;
 
-static ds_stat
-post_map_subtree(p_avlt_node sub, avlt_map_func func, size_t depth)
-{
-    if (!sub || !func)
+	if (!sub || !func)
 	    return DS_ERROR;
 	
-	post_map_subtree(sub->left, func, depth + 1);
-	post_map_subtree(sub->right, func, depth + 1);
-	func(sub->data, depth);
+	while (sub || n) {
+	    if (sub) {
+		    /* going down the left spine */
+		    if (order == PRE_ORDER)
+			    func(sub->data, n);
+			assert(n < MAX_HEIGHT);
+			stack[n++] = sub;
+			sub = sub->left;
+			continue;
+		}
+		top = stack[n - 1];
+		if (!top->right || last != top->right) {
+		    /* back from the left subtree */
+		    if (order == IN_ORDER)
+			    func(top->data, n - 1);
+			if (top->right) {
+			    sub = top->right;
+				continue;
+			}
+		}
+		if (order == POST_ORDER)
+		    func(top->data, n - 1);
+		last = top;
+		n--;
+	}
 	return DS_OK;
 }
 
@@ -231,6 +265,8 @@ get_max(p_avlt_node sub, avlt_data_t* re)
 	
 	for (; sub->right; sub = sub->right) ;
 	*re = sub->data;
+
+	return DS_OK;
 }
 
 size_t
@@ -350,8 +386,9 @@ delete(pt_AVLTree avl, p_avlt_node* sub, avlt_data_t data)
     		del->left->parent = del->right;
 		*point_to_delete = del->right;
 		del->right->parent = del->parent;
-		update_height(del->parent);
-		balance_to_root(avl, del->parent);
+		/* the successor gained the left subtree */
+		update_height(del->right);
+		balance_to_root(avl, del->right);
 	/** the forth case
 	 *           O
 	 *          / \
@@ -382,7 +419,7 @@ delete(pt_AVLTree avl, p_avlt_node* sub, avlt_data_t data)
 		balance_to_root(avl, min_pa);
 	}
 
-	free(del);
+	NodePool_Release(avl->pool, del);
 	return DS_OK;
 }
 
@@ -402,6 +439,14 @@ height(p_avlt_node sub)
 	return sub->height;
 }
 
+static size_t
+count(p_avlt_node sub)
+{
+    if (!sub)
+	    return 0;
+	return sub->count;
+}
+
 static ds_stat
 update_height(p_avlt_node sub)
 {
@@ -414,6 +459,7 @@ update_height(p_avlt_node sub)
 	    lh = height(sub->left);
     	rh = height(sub->right);
     	sub->height = lh > rh ? lh + 1 : rh + 1;
+		sub->count  = count(sub->left) + count(sub->right) + 1;
 		sub = sub->parent;
 	}
 	return DS_OK;
@@ -425,7 +471,8 @@ AVLTree_Insert(pt_AVLTree avl, avlt_data_t data)
     if (!avl)
 	    return DS_ERROR;
 	if (avl->root == NULL) {
-	    avl->root = create_node(data);
+	    if ((avl->root = create_node(avl, data)) == NULL)
+		    return DS_ERROR;
 		avl->size++;
 		return DS_OK;
 	}
@@ -450,7 +497,7 @@ insert(pt_AVLTree avl, p_avlt_node sub, avlt_data_t data)
 		    if (sub->right) {
 			    sub = sub->right;
 			} else {
-			    if ((nd = create_node(data)) == NULL)
+			    if ((nd = create_node(avl, data)) == NULL)
 				    return DS_ERROR;
 			    sub->right = nd;
 				nd->parent = sub;
@@ -462,7 +509,7 @@ insert(pt_AVLTree avl, p_avlt_node sub, avlt_data_t data)
 		    if (sub->left) {
 			    sub = sub->left;
 			} else {
-			    if ((nd = create_node(data)) == NULL)
+			    if ((nd = create_node(avl, data)) == NULL)
 				    return DS_ERROR;
 			    sub->left = nd;
 				nd->parent = sub;
@@ -673,12 +720,16 @@ AVLTree_Contain(pt_AVLTree avl, avlt_data_t data)
 	return DS_TRUE;
 }
 
+/** @fn
+ * Remove all nodes at once by clearing the node pool; the
+ * tree is not walked.
+ */
 void
 AVLTree_Clear(pt_AVLTree avl)
 {
     if (!avl)
 	    return;
-	free_subtree(&avl->root);
+	NodePool_Clear(avl->pool);
 	avl->root = NULL;
 	avl->size = 0;
 }
@@ -689,22 +740,11 @@ AVLTree_Free(pt_AVLTree* avl)
     if (!avl || !(*avl))
 	    return;
 
-    free_subtree(&(*avl)->root);
-	free((*avl)->root);
+    NodePool_Free(&(*avl)->pool);
+	free(*avl);
 	*avl = NULL;
 }
 
-static void
-free_subtree(p_avlt_node* sub)
-{
-    if (!sub || !(*sub))
-	    return;
-	free_subtree(&(*sub)->left);
-	free_subtree(&(*sub)->right);
-	free(*sub);
-	*sub = NULL;
-}
-
 pt_AVLTree
 AVLTree_Copy(pt_AVLTree avl)
 {
@@ -713,10 +753,15 @@ AVLTree_Copy(pt_AVLTree avl)
 	if (!avl)
 	    return NULL;
 	
-	if ((cpy = malloc(sizeof(AVLTree))) == NULL)
+	if ((cpy = AVLTree_Create(avl->cmp)) == NULL)
 	    return NULL;
+	/* one slab for the whole copy */
+	if (NodePool_Reserve(cpy->pool, avl->size) == DS_ERROR) {
+	    AVLTree_Free(&cpy);
+		return NULL;
+	}
 	
-	cpy->root = copy_subtree(avl->root);
+	cpy->root = copy_subtree(cpy->pool, avl->root);
 	cpy->cmp  = avl->cmp;
 	cpy->size = avl->size;
 
@@ -724,7 +769,7 @@ AVLTree_Copy(pt_AVLTree avl)
 }
 
 static p_avlt_node
-copy_subtree(p_avlt_node from)
+copy_subtree(pt_NodePool pool, p_avlt_node from)
 {
     p_avlt_node  cpy;
 
@@ -732,35 +777,299 @@ copy_subtree(p_avlt_node from)
 	    return NULL;
 
     /* copy the root of this subtree */
-	if ((cpy = copy_node(from)) == NULL)
+	if ((cpy = copy_node(pool, from)) == NULL)
 	    return NULL;
 	/* copy the left subtree of root */
-	cpy->left = copy_subtree(from->left);
+	cpy->left = copy_subtree(pool, from->left);
 	if (cpy->left)
 	    cpy->left->parent = cpy;
 	/* copy the right subtree of root */
-	cpy->right = copy_subtree(from->right);
+	cpy->right = copy_subtree(pool, from->right);
 	if (cpy->right)
 	    cpy->right->parent = cpy;
 	return cpy;
 }
 
 static p_avlt_node
-copy_node(p_avlt_node nd)
+copy_node(pt_NodePool pool, p_avlt_node nd)
 {
     p_avlt_node cpy;
 
 	if (!nd) 
 	    return NULL;
 	
-	if ((cpy = malloc(sizeof(avlt_node))) == NULL)
+	if ((cpy = NodePool_Alloc(pool)) == NULL)
 	    return NULL;
 	
 	cpy->data   = nd->data;
 	cpy->height = nd->height;
+	cpy->count  = nd->count;
 	cpy->left   = NULL;
 	cpy->right  = NULL;
 	cpy->parent = NULL;
 
 	return cpy;
 }
+
+/** @fn
+ * Write the data of this AVL tree in order into "array",
+ * which must hold AVLTree_Size() entries. Returns the
+ * number written.
+ */
+size_t
+AVLTree_ToArray(pt_AVLTree avl, avlt_data_t array[])
+{
+    if (!avl || !array)
+	    return 0;
+	return to_array(avl->root, array, 0);
+}
+
+static size_t
+to_array(p_avlt_node sub, avlt_data_t array[], size_t n)
+{
+    while (sub) {
+	    n = to_array(sub->left, array, n);
+		array[n++] = sub->data;
+		sub = sub->right;
+	}
+	return n;
+}
+
+/** @fn
+ * Replace the content of this AVL tree by the "n" data of
+ * "array", which must be strictly increasing under the
+ * tree's compare function. The tree is built perfectly
+ * balanced in O(n) without any rotation.
+ */
+ds_stat
+AVLTree_BuildFromSorted(pt_AVLTree avl, avlt_data_t array[], size_t n)
+{
+    if (!avl || (!array && n))
+	    return DS_ERROR;
+
+    AVLTree_Clear(avl);
+	if (NodePool_Reserve(avl->pool, n) == DS_ERROR)
+	    return DS_ERROR;
+	if ((avl->root = build_subtree(avl->pool, array, n)) == NULL && n) {
+	    AVLTree_Clear(avl);
+		return DS_ERROR;
+	}
+	avl->size = n;
+	return DS_OK;
+}
+
+/** @fn
+ * Build a balanced subtree from the "n" sorted data of
+ * "array": the middle one at the root, each half below.
+ */
+static p_avlt_node
+build_subtree(pt_NodePool pool, avlt_data_t array[], size_t n)
+{
+    p_avlt_node   nd;
+	size_t        mid = n / 2;
+
+    if (n == 0)
+	    return NULL;
+	if ((nd = NodePool_Alloc(pool)) == NULL)
+	    return NULL;
+	
+	nd->data   = array[mid];
+	nd->parent = NULL;
+	nd->left   = build_subtree(pool, array, mid);
+	nd->right  = build_subtree(pool, array + mid + 1, n - mid - 1);
+	if ((mid && !nd->left) || (n - mid - 1 && !nd->right))
+	    return NULL;
+	if (nd->left)
+	    nd->left->parent = nd;
+	if (nd->right)
+	    nd->right->parent = nd;
+	/* the left half is never the shorter one */
+	nd->height = height(nd->left) + 1;
+	nd->count  = n;
+	return nd;
+}
+
+/** @fn
+ * Return through "re" the data of rank "k", i.e. the k-th
+ * smallest counting from 0, in O(log n).
+ */
+ds_stat
+AVLTree_Select(pt_AVLTree avl, size_t k, avlt_data_t* re)
+{
+    p_avlt_node   sub;
+
+    if (!avl || !re || k >= avl->size)
+	    return DS_ERROR;
+	
+	sub = avl->root;
+	while (k != count(sub->left)) {
+	    if (k < count(sub->left)) {
+		    sub = sub->left;
+		} else {
+		    k  -= count(sub->left) + 1;
+			sub = sub->right;
+		}
+	}
+	*re = sub->data;
+	return DS_OK;
+}
+
+/** @fn
+ * The number of data less than "data", which need not be in
+ * this AVL tree, in O(log n).
+ */
+size_t
+AVLTree_Rank(pt_AVLTree avl, avlt_data_t data)
+{
+    if (!avl || !data)
+	    return 0;
+	return rank(avl, data, DS_FALSE);
+}
+
+/** @fn
+ * The number of data less than "data", or not greater than
+ * "data" if "inclusive".
+ */
+static size_t
+rank(pt_AVLTree avl, avlt_data_t data, ds_bool inclusive)
+{
+    p_avlt_node   sub = avl->root;
+	size_t        n = 0;
+	int           c;
+
+	while (sub) {
+	    c = avl->cmp(data, sub->data);
+		if (c > 0 || (c == 0 && inclusive)) {
+		    n  += count(sub->left) + 1;
+			sub = sub->right;
+		} else {
+		    sub = sub->left;
+		}
+	}
+	return n;
+}
+
+/** @fn
+ * The number of data in ["lo", "hi"] in O(log n).
+ */
+size_t
+AVLTree_RangeCount(pt_AVLTree avl, avlt_data_t lo, avlt_data_t hi)
+{
+    size_t   below, upto;
+
+    if (!avl || !lo || !hi)
+	    return 0;
+	below = rank(avl, lo, DS_FALSE);
+	upto  = rank(avl, hi, DS_TRUE);
+	return upto > below ? upto - below : 0;
+}
+
+/** @fn
+ * Apply "func" in order to the data in ["lo", "hi"],
+ * skipping subtrees outside the range: O(log n + k) for k
+ * data in range.
+ */
+ds_stat
+AVLTree_RangeMap(pt_AVLTree avl, avlt_data_t lo, avlt_data_t hi,
+                 avlt_map_func func)
+{
+    if (!avl || !lo || !hi || !func)
+	    return DS_ERROR;
+	range_map(avl, avl->root, lo, hi, func, 0);
+	return DS_OK;
+}
+
+static void
+range_map(pt_AVLTree avl, p_avlt_node sub, avlt_data_t lo, avlt_data_t hi,
+          avlt_map_func func, size_t depth)
+{
+    int   above_lo, below_hi;
+
+    if (!sub)
+	    return;
+	above_lo = avl->cmp(sub->data, lo) >= 0;
+	below_hi = avl->cmp(sub->data, hi) <= 0;
+	if (above_lo)
+	    range_map(avl, sub->left, lo, hi, func, depth + 1);
+	if (above_lo && below_hi)
+	    func(sub->data, depth);
+	if (below_hi)
+	    range_map(avl, sub->right, lo, hi, func, depth + 1);
+}
+
+static p_avlt_node
+lower_bound(pt_AVLTree avl, avlt_data_t data)
+{
+    p_avlt_node   sub = avl->root, re = NULL;
+
+	while (sub) {
+	    if (avl->cmp(data, sub->data) <= 0) {
+		    re  = sub;
+			sub = sub->left;
+		} else {
+		    sub = sub->right;
+		}
+	}
+	return re;
+}
+
+/** @fn
+ * The next node in order, following parent pointers.
+ */
+static p_avlt_node
+successor(p_avlt_node nd)
+{
+    if (nd->right) {
+		for (nd = nd->right; nd->left; nd = nd->left)
+		    ;
+		return nd;
+	}
+	while (nd->parent && nd->parent->right == nd)
+	    nd = nd->parent;
+	return nd->parent;
+}
+
+/** @fn
+ * Position an iterator before the smallest data.
+ */
+void
+AVLTree_Begin(pt_AVLTree avl, avlt_iter* it)
+{
+    p_avlt_node   nd;
+
+    if (!it)
+	    return;
+	it->tree = avl;
+	if ((nd = avl ? avl->root : NULL) != NULL)
+	    for (; nd->left; nd = nd->left) ;
+	it->next = nd;
+}
+
+/** @fn
+ * Position an iterator before the smallest data not less
+ * than "data".
+ */
+void
+AVLTree_Seek(pt_AVLTree avl, avlt_data_t data, avlt_iter* it)
+{
+    if (!it)
+	    return;
+	it->tree = avl;
+	it->next = avl && data ? lower_bound(avl, data) : NULL;
+}
+
+/** @fn
+ * Return the next data in order through "re". DS_FALSE once
+ * the tree is done. The tree must not be modified while it
+ * is iterated.
+ */
+ds_bool
+AVLTree_Next(avlt_iter* it, avlt_data_t* re)
+{
+    if (!it || !it->next)
+	    return DS_FALSE;
+	if (re)
+	    *re = it->next->data;
+	it->next = successor(it->next);
+	return DS_TRUE;
+}
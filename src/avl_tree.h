@@ -27,6 +27,7 @@
 #include <stdio.h>
 
 #include "header.h"
+#include "node_pool.h"
 
 typedef struct _avl_tree   AVLTree;
 typedef AVLTree*           pt_AVLTree;
@@ -36,6 +37,17 @@ typedef int  (*avl_cmp)(avlt_data_t, avlt_data_t);
 typedef void (*avlt_map_func)(avlt_data_t, size_t);
 typedef void (*avlt_inter_func)(pt_AVLTree, avlt_data_t);
 
+/* @struct
+ * Cursor over an AVL tree in order. Its fields are private
+ * to the tree.
+ * tree - the tree iterated
+ * next - the node AVLTree_Next() returns next, NULL when done
+ */
+typedef struct {
+    pt_AVLTree            tree;
+    struct _avlt_node*    next;
+} avlt_iter;
+
 extern pt_AVLTree    AVLTree_Create(avl_cmp);
 extern ds_stat       AVLTree_PreOrderMap(pt_AVLTree, avlt_map_func);
 extern ds_stat       AVLTree_InOrderMap(pt_AVLTree, avlt_map_func);
@@ -51,4 +63,13 @@ extern void          AVLTree_Free(pt_AVLTree*);
 extern void          AVLTree_Clear(pt_AVLTree);
 extern pt_AVLTree    AVLTree_Copy(pt_AVLTree);
 extern ds_stat       AVLTree_InterOpt(pt_AVLTree, pt_AVLTree, avlt_inter_func);
+extern size_t        AVLTree_ToArray(pt_AVLTree, avlt_data_t []);
+extern ds_stat       AVLTree_BuildFromSorted(pt_AVLTree, avlt_data_t [], size_t);
+extern ds_stat       AVLTree_Select(pt_AVLTree, size_t, avlt_data_t*);
+extern size_t        AVLTree_Rank(pt_AVLTree, avlt_data_t);
+extern size_t        AVLTree_RangeCount(pt_AVLTree, avlt_data_t, avlt_data_t);
+extern ds_stat       AVLTree_RangeMap(pt_AVLTree, avlt_data_t, avlt_data_t, avlt_map_func);
+extern void          AVLTree_Begin(pt_AVLTree, avlt_iter*);
+extern void          AVLTree_Seek(pt_AVLTree, avlt_data_t, avlt_iter*);
+extern ds_bool       AVLTree_Next(avlt_iter*, avlt_data_t*);
 #endif
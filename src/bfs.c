@@ -0,0 +1,576 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#include "bfs.h"
+
+/* switch to bottom-up once the frontier has more than 1 /
+ * BFS_ALPHA of the unexplored edges, and back to top-down
+ * once it holds less than 1 / BFS_BETA of the vertices */
+#define BFS_ALPHA        14
+#define BFS_BETA         24
+/* bitmap words per chunk handed to a worker */
+#define BFS_GRAIN        16
+
+/* @struct
+ * Snapshot of an ALGraph in compressed sparse row form:
+ * n         - the number of vertices
+ * nnz       - the number of edges
+ * ids       - the vertex ID of each index
+ * out_rows, out_cols, out_weights
+ *           - the indices of the out-neighbors of each vertex
+ *             and the weights of the edges leading to them
+ * in_rows, in_cols
+ *           - the indices of the in-neighbors of each vertex,
+ *             in ascending order
+ * order     - indices sorted by ID, for BFSGraph_IndexOf()
+ */
+struct BFS_GRAPH {
+    size_t          n;
+    size_t          nnz;
+    gqrm_id_t*      ids;
+    size_t*         out_rows;
+    size_t*         out_cols;
+    edge_weight_t*  out_weights;
+    size_t*         in_rows;
+    size_t*         in_cols;
+    size_t*         order;
+};
+
+/* @struct
+ * State of a search shared by the workers:
+ * visited, frontier, next
+ *          - bitmaps of the visited vertices, the current
+ *            level and the level being built
+ * nf, mf   - per worker count of the vertices and out-edges
+ *            of the level being built
+ */
+typedef struct {
+    pt_BFSGraph        g;
+    uint64_t*          visited;
+    uint64_t*          frontier;
+    uint64_t*          next;
+    vertex_weight_t*   hops;
+    gqrm_id_t*         parents;
+    vertex_weight_t    level;
+    size_t*            nf;
+    size_t*            mf;
+} bfs_state;
+
+typedef enum {
+    BFS_AUTO, BFS_TOP_DOWN, BFS_BOTTOM_UP
+} bfs_direction;
+
+static int           id_cmp(const void*, const void*);
+static pt_BFSGraph   graph_clear(pt_BFSGraph*, pt_Vertex*);
+static bfs_direction forced_direction(void);
+static void          claim_parent(gqrm_id_t*, gqrm_id_t);
+static void          top_down(size_t, size_t, size_t, void*);
+static void          bottom_up(size_t, size_t, size_t, void*);
+static void          commit_level(size_t, size_t, size_t, void*);
+static pt_ALGraph    tree_clear(pt_ALGraph*, pt_BFSGraph*, vertex_weight_t*, gqrm_id_t*, char*);
+
+/* used by id_cmp(), which qsort() gives no context */
+static __thread const gqrm_id_t*   sort_ids;
+
+/* @fn
+ * Take a snapshot of "pg". Later changes to "pg" are not
+ * reflected.
+ */
+pt_BFSGraph
+BFSGraph_Create(pt_ALGraph pg)
+{
+    pt_BFSGraph   g;
+    pt_Vertex*    vs;
+    pt_Edge       pe;
+    p_vec         edges;
+    gqrm_id_t     id;
+    size_t        i, j, k, deg;
+    size_t*       fill;
+
+    if (!pg)
+        return NULL;
+    if ((g = calloc(1, sizeof(BFSGraph))) == NULL)
+        return NULL;
+    g->n = ALGraph_Size(pg);
+    g->ids      = malloc((g->n ? g->n : 1) * sizeof(gqrm_id_t));
+    g->order    = malloc((g->n ? g->n : 1) * sizeof(size_t));
+    g->out_rows = calloc(g->n + 1, sizeof(size_t));
+    g->in_rows  = calloc(g->n + 1, sizeof(size_t));
+    vs          = malloc((g->n ? g->n : 1) * sizeof(pt_Vertex));
+    if (!g->ids || !g->order || !g->out_rows || !g->in_rows || !vs)
+        return graph_clear(&g, vs);
+
+    for (i = 0; i < g->n; i++) {
+        if (ALGraph_GetVertex(pg, i, &vs[i]) == DS_ERROR)
+            return graph_clear(&g, vs);
+        Vertex_GetID(vs[i], &g->ids[i]);
+        g->order[i] = i;
+        g->out_rows[i + 1] = g->out_rows[i] + Vertex_Degree(vs[i]);
+    }
+    sort_ids = g->ids;
+    qsort(g->order, g->n, sizeof(size_t), id_cmp);
+
+    g->nnz      = g->out_rows[g->n];
+    g->out_cols = malloc((g->nnz ? g->nnz : 1) * sizeof(size_t));
+    g->in_cols  = malloc((g->nnz ? g->nnz : 1) * sizeof(size_t));
+    g->out_weights = malloc((g->nnz ? g->nnz : 1) * sizeof(edge_weight_t));
+    if (!g->out_cols || !g->in_cols || !g->out_weights)
+        return graph_clear(&g, vs);
+
+    for (i = 0; i < g->n; i++) {
+        Vertex_GetEdges(vs[i], &edges);
+        deg = Vertex_Degree(vs[i]);
+        for (j = 0; j < deg; j++) {
+            pe = (pt_Edge)Vector_Data(edges)[j];
+            Edge_GetEndID(pe, &id);
+            if (BFSGraph_IndexOf(g, id, &k) == DS_ERROR)
+                return graph_clear(&g, vs);
+            g->out_cols[g->out_rows[i] + j] = k;
+            Edge_GetWeight(pe, &g->out_weights[g->out_rows[i] + j]);
+            g->in_rows[k + 1]++;
+        }
+    }
+    free(vs);
+
+    /* in-neighbors by counting sort, ascending since "i" is */
+    for (i = 0; i < g->n; i++)
+        g->in_rows[i + 1] += g->in_rows[i];
+    if ((fill = malloc((g->n ? g->n : 1) * sizeof(size_t))) == NULL)
+        return graph_clear(&g, NULL);
+    memcpy(fill, g->in_rows, g->n * sizeof(size_t));
+    for (i = 0; i < g->n; i++)
+        for (j = g->out_rows[i]; j < g->out_rows[i + 1]; j++)
+            g->in_cols[fill[g->out_cols[j]]++] = i;
+    free(fill);
+    return g;
+}
+
+static int
+id_cmp(const void* a, const void* b)
+{
+    gqrm_id_t   ia = sort_ids[*(const size_t*)a];
+    gqrm_id_t   ib = sort_ids[*(const size_t*)b];
+
+    return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static pt_BFSGraph
+graph_clear(pt_BFSGraph* g, pt_Vertex* vs)
+{
+    free(vs);
+    BFSGraph_Free(g);
+    return NULL;
+}
+
+void
+BFSGraph_Free(pt_BFSGraph* g)
+{
+    if (!g || !*g)
+        return;
+    free((*g)->ids);
+    free((*g)->order);
+    free((*g)->out_rows);
+    free((*g)->out_cols);
+    free((*g)->out_weights);
+    free((*g)->in_rows);
+    free((*g)->in_cols);
+    free(*g);
+    *g = NULL;
+}
+
+size_t
+BFSGraph_Size(pt_BFSGraph g)
+{
+    if (!g)
+        return 0;
+    return g->n;
+}
+
+gqrm_id_t
+BFSGraph_ID(pt_BFSGraph g, size_t i)
+{
+    if (!g || i >= g->n)
+        return -1;
+    return g->ids[i];
+}
+
+/* @fn
+ * Point "cols" and "weights" to the out-neighbors of the
+ * "i"th vertex and the weights of the edges leading to them.
+ * Return the out-degree.
+ */
+size_t
+BFSGraph_OutEdges(pt_BFSGraph g, size_t i, const size_t** cols,
+                  const edge_weight_t** weights)
+{
+    if (!g || i >= g->n)
+        return 0;
+    if (cols)
+        *cols = g->out_cols + g->out_rows[i];
+    if (weights)
+        *weights = g->out_weights + g->out_rows[i];
+    return g->out_rows[i + 1] - g->out_rows[i];
+}
+
+/* @fn
+ * Point "cols" to the in-neighbors of the "i"th vertex, in
+ * ascending order. Return the in-degree.
+ */
+size_t
+BFSGraph_InEdges(pt_BFSGraph g, size_t i, const size_t** cols)
+{
+    if (!g || i >= g->n)
+        return 0;
+    if (cols)
+        *cols = g->in_cols + g->in_rows[i];
+    return g->in_rows[i + 1] - g->in_rows[i];
+}
+
+/* @fn
+ * Find the index of the vertex with ID "id".
+ */
+ds_stat
+BFSGraph_IndexOf(pt_BFSGraph g, gqrm_id_t id, size_t* re)
+{
+    size_t   lo, hi, mid;
+
+    if (!g || !re)
+        return DS_ERROR;
+    /* vertices usually are numbered after their index */
+    if (id >= 0 && (size_t)id < g->n && g->ids[id] == id) {
+        *re = (size_t)id;
+        return DS_OK;
+    }
+    for (lo = 0, hi = g->n; lo < hi; ) {
+        mid = lo + (hi - lo) / 2;
+        if (g->ids[g->order[mid]] < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == g->n || g->ids[g->order[lo]] != id)
+        return DS_ERROR;
+    *re = g->order[lo];
+    return DS_OK;
+}
+
+/* @fn
+ * The direction may be forced through the GQRM_BFS_DIRECTION
+ * environment variable ("top-down" or "bottom-up"), which is
+ * meant for testing.
+ */
+static bfs_direction
+forced_direction(void)
+{
+    const char*   env = getenv("GQRM_BFS_DIRECTION");
+
+    if (env && strcmp(env, "top-down") == 0)
+        return BFS_TOP_DOWN;
+    if (env && strcmp(env, "bottom-up") == 0)
+        return BFS_BOTTOM_UP;
+    return BFS_AUTO;
+}
+
+/* @fn
+ * Compute the hop count from vertex "src" (an index) to
+ * every vertex. hops[i] receives VERTEX_WEIGHT_INF and
+ * parents[i] -1 for every vertex not reachable; otherwise
+ * parents[i] is the index of the smallest-indexed vertex one
+ * hop closer to "src" that links to "i". parents[src] is -1.
+ * Levels are processed by the workers of "pool", NULL to run
+ * inline.
+ */
+ds_stat
+BFS_Run(pt_BFSGraph g, size_t src, pt_ThreadPool pool,
+        vertex_weight_t* hops, gqrm_id_t* parents)
+{
+    bfs_state       st;
+    bfs_direction   forced = forced_direction();
+    size_t          words, nworkers, i, nf, mf, mu;
+    uint64_t*       tmp;
+    ds_bool         up = DS_FALSE;
+
+    if (!g || !hops || !parents || src >= g->n)
+        return DS_ERROR;
+
+    METRIC_TIMER_BEGIN(t0);
+    words    = (g->n + 63) / 64;
+    nworkers = ThreadPool_Size(pool);
+    st.g        = g;
+    st.hops     = hops;
+    st.parents  = parents;
+    st.visited  = calloc(words, sizeof(uint64_t));
+    st.frontier = calloc(words, sizeof(uint64_t));
+    st.next     = calloc(words, sizeof(uint64_t));
+    st.nf       = calloc(nworkers, sizeof(size_t));
+    st.mf       = calloc(nworkers, sizeof(size_t));
+    if (!st.visited || !st.frontier || !st.next || !st.nf || !st.mf) {
+        free(st.visited);
+        free(st.frontier);
+        free(st.next);
+        free(st.nf);
+        free(st.mf);
+        return DS_ERROR;
+    }
+
+    for (i = 0; i < g->n; i++) {
+        hops[i]    = VERTEX_WEIGHT_INF;
+        parents[i] = -1;
+    }
+    hops[src] = 0;
+    st.visited[src / 64]  |= (uint64_t)1 << (src % 64);
+    st.frontier[src / 64] |= (uint64_t)1 << (src % 64);
+    nf = 1;
+    mf = g->out_rows[src + 1] - g->out_rows[src];
+    mu = g->nnz - mf;
+
+    for (st.level = 0; nf > 0; st.level++) {
+        if (forced != BFS_AUTO)
+            up = forced == BFS_BOTTOM_UP ? DS_TRUE : DS_FALSE;
+        else if (up == DS_FALSE && mf > mu / BFS_ALPHA)
+            up = DS_TRUE;
+        else if (up == DS_TRUE && nf < g->n / BFS_BETA)
+            up = DS_FALSE;
+
+        memset(st.next, 0, words * sizeof(uint64_t));
+        ThreadPool_ParallelFor(pool, words, BFS_GRAIN,
+                               up == DS_TRUE ? bottom_up : top_down, &st);
+
+        memset(st.nf, 0, nworkers * sizeof(size_t));
+        memset(st.mf, 0, nworkers * sizeof(size_t));
+        ThreadPool_ParallelFor(pool, words, BFS_GRAIN, commit_level, &st);
+        for (i = 0, nf = 0, mf = 0; i < nworkers; i++) {
+            nf += st.nf[i];
+            mf += st.mf[i];
+        }
+        mu -= mf;
+        METRIC_ADD(METRIC_SPT_POPS, nf);
+
+        tmp = st.frontier;
+        st.frontier = st.next;
+        st.next = tmp;
+    }
+
+    free(st.visited);
+    free(st.frontier);
+    free(st.next);
+    free(st.nf);
+    free(st.mf);
+    METRIC_TIMER_END(TIMER_SPT, t0);
+    return DS_OK;
+}
+
+/* @fn
+ * Lower parents[v] to "u" unless it holds a smaller index.
+ */
+static void
+claim_parent(gqrm_id_t* parent, gqrm_id_t u)
+{
+    gqrm_id_t   old = *parent;
+
+    while (old == -1 || u < old) {
+        if (__sync_bool_compare_and_swap(parent, old, u))
+            return;
+        old = *parent;
+    }
+}
+
+/* @fn
+ * Expand the frontier vertices in words [begin, end) along
+ * their out-edges. Several workers may reach one vertex, so
+ * parents and the next bitmap are updated atomically.
+ */
+static void
+top_down(size_t begin, size_t end, size_t worker, void* p)
+{
+    bfs_state*    st = (bfs_state*)p;
+    pt_BFSGraph   g = st->g;
+    size_t        k, u, v, j;
+    uint64_t      bits, bit;
+
+    (void)worker;
+
+    for (k = begin; k < end; k++)
+        for (bits = st->frontier[k]; bits; bits &= bits - 1) {
+            u = k * 64 + (size_t)__builtin_ctzll(bits);
+            for (j = g->out_rows[u]; j < g->out_rows[u + 1]; j++) {
+                v   = g->out_cols[j];
+                bit = (uint64_t)1 << (v % 64);
+                if (st->visited[v / 64] & bit)
+                    continue;
+                claim_parent(&st->parents[v], (gqrm_id_t)u);
+                METRIC_INC(METRIC_SPT_RELAXATIONS);
+                if (!(st->next[v / 64] & bit))
+                    __sync_fetch_and_or(&st->next[v / 64], bit);
+            }
+        }
+}
+
+/* @fn
+ * Let every unvisited vertex in words [begin, end) look for
+ * a parent in the frontier. In-neighbors are sorted, so the
+ * first one found is the smallest, as in top_down(). Each
+ * word is written by one worker only.
+ */
+static void
+bottom_up(size_t begin, size_t end, size_t worker, void* p)
+{
+    bfs_state*    st = (bfs_state*)p;
+    pt_BFSGraph   g = st->g;
+    size_t        k, u, v, j;
+    uint64_t      bits;
+
+    (void)worker;
+
+    for (k = begin; k < end; k++) {
+        bits = ~st->visited[k];
+        if (k == g->n / 64 && g->n % 64)
+            bits &= ((uint64_t)1 << (g->n % 64)) - 1;
+        for (; bits; bits &= bits - 1) {
+            v = k * 64 + (size_t)__builtin_ctzll(bits);
+            for (j = g->in_rows[v]; j < g->in_rows[v + 1]; j++) {
+                u = g->in_cols[j];
+                if (st->frontier[u / 64] & ((uint64_t)1 << (u % 64))) {
+                    st->parents[v] = (gqrm_id_t)u;
+                    METRIC_INC(METRIC_SPT_RELAXATIONS);
+                    st->next[k] |= bits & -bits;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* @fn
+ * Mark the vertices of the next level in words [begin, end)
+ * as visited and count them with their out-edges.
+ */
+static void
+commit_level(size_t begin, size_t end, size_t worker, void* p)
+{
+    bfs_state*    st = (bfs_state*)p;
+    pt_BFSGraph   g = st->g;
+    size_t        k, v;
+    uint64_t      bits;
+
+    for (k = begin; k < end; k++) {
+        st->visited[k] |= st->next[k];
+        for (bits = st->next[k]; bits; bits &= bits - 1) {
+            v = k * 64 + (size_t)__builtin_ctzll(bits);
+            st->hops[v] = st->level + 1;
+            st->nf[worker]++;
+            st->mf[worker] += g->out_rows[v + 1] - g->out_rows[v];
+        }
+    }
+}
+
+/* @fn
+ * Drop-in replacement of ALGraph_ShortestPathTree() for unit
+ * weights: return a tree with a shallow copy of every vertex
+ * of "pg", weighted by its hop count to "src", where only the
+ * paths from "src" to the destinations are kept. Vertices
+ * not on these paths keep their hop count but have no parent.
+ */
+pt_ALGraph
+ALGraph_BFSTree(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n,
+                pt_ThreadPool pool)
+{
+    pt_ALGraph         spt = NULL;
+    pt_BFSGraph        g = NULL;
+    pt_Vertex          pv, pv_new, pv_parent, pv_orig;
+    vertex_weight_t*   hops = NULL;
+    gqrm_id_t*         parents = NULL;
+    char*              keep = NULL;
+    edge_weight_t      w;
+    size_t             size, s, i, v;
+
+    if (!pg || ALGraph_Size(pg) == 0 || (n && !dsts))
+        return NULL;
+    if ((g = BFSGraph_Create(pg)) == NULL)
+        return NULL;
+    size    = BFSGraph_Size(g);
+    hops    = malloc(size * sizeof(vertex_weight_t));
+    parents = malloc(size * sizeof(gqrm_id_t));
+    keep    = calloc(size, sizeof(char));
+    if (!hops || !parents || !keep)
+        return tree_clear(&spt, &g, hops, parents, keep);
+    if (BFSGraph_IndexOf(g, src, &s) == DS_ERROR)
+        return tree_clear(&spt, &g, hops, parents, keep);
+    if (BFS_Run(g, s, pool, hops, parents) == DS_ERROR)
+        return tree_clear(&spt, &g, hops, parents, keep);
+
+    /* keep the paths to the destinations */
+    keep[s] = 1;
+    for (i = 0; i < n; i++) {
+        if (BFSGraph_IndexOf(g, dsts[i], &v) == DS_ERROR)
+            return tree_clear(&spt, &g, hops, parents, keep);
+        for (; v != s && !keep[v] && parents[v] != -1; v = (size_t)parents[v])
+            keep[v] = 1;
+    }
+
+    if ((spt = ALGraph_Create()) == NULL)
+        return tree_clear(&spt, &g, hops, parents, keep);
+    for (i = 0; i < size; i++) {
+        if (ALGraph_GetVertex(pg, i, &pv) == DS_ERROR)
+            return tree_clear(&spt, &g, hops, parents, keep);
+        if ((pv_new = Vertex_ShallowCopy(pv)) == NULL)
+            return tree_clear(&spt, &g, hops, parents, keep);
+        Vertex_SetWeight(pv_new, hops[i]);
+        Vertex_SetParent(pv_new, keep[i] && parents[i] != -1 ?
+                                 BFSGraph_ID(g, parents[i]) : -1);
+        if (ALGraph_PushVertex(spt, pv_new) == DS_ERROR) {
+            Vertex_Free(&pv_new);
+            return tree_clear(&spt, &g, hops, parents, keep);
+        }
+    }
+
+    /* add an edge from each kept vertex's parent to it */
+    for (i = 0; i < size; i++) {
+        if (!keep[i] || parents[i] == -1)
+            continue;
+        if (ALGraph_GetVertex(pg, parents[i], &pv_orig) == DS_ERROR ||
+            ALGraph_GetVertex(spt, parents[i], &pv_parent) == DS_ERROR ||
+            ALGraph_GetVertex(spt, i, &pv) == DS_ERROR)
+            return tree_clear(&spt, &g, hops, parents, keep);
+        if (Vertex_GetEdgeWeight(pv_orig, BFSGraph_ID(g, i), &w) == DS_ERROR)
+            return tree_clear(&spt, &g, hops, parents, keep);
+        if (Vertex_PushNeighbor(pv_parent, pv, w) == DS_ERROR)
+            return tree_clear(&spt, &g, hops, parents, keep);
+    }
+
+    tree_clear(NULL, &g, hops, parents, keep);
+    return spt;
+}
+
+static pt_ALGraph
+tree_clear(pt_ALGraph* spt, pt_BFSGraph* g, vertex_weight_t* hops,
+           gqrm_id_t* parents, char* keep)
+{
+    if (spt)
+        ALGraph_Free(spt);
+    BFSGraph_Free(g);
+    free(hops);
+    free(parents);
+    free(keep);
+    return NULL;
+}
@@ -0,0 +1,63 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file bfs.h
+ *
+ * Breadth-first search for hop-count shortest paths.
+ *
+ * Every shortest path tree in this project is computed on
+ * hop counts, i.e. with unit weights, which is exactly BFS.
+ * A BFSGraph is a snapshot of an ALGraph in compressed sparse
+ * row form, holding both out- and in-neighbors so that every
+ * level can be expanded either top-down (from the frontier)
+ * or bottom-up (from the unvisited vertices), whichever
+ * touches fewer edges. Frontiers are bitmaps and each level
+ * may be processed by a thread pool.
+ *
+ * Among all frontier vertices linking to a vertex, the one
+ * with the smallest index always becomes its parent, so the
+ * result depends neither on the direction nor on the number
+ * of threads.
+ */
+
+#ifndef GQRM_BFS_H
+#define GQRM_BFS_H
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "header.h"
+#include "metrics.h"
+#include "graph.h"
+#include "thread_pool.h"
+
+typedef struct BFS_GRAPH    BFSGraph;
+typedef BFSGraph*           pt_BFSGraph;
+
+extern pt_BFSGraph  BFSGraph_Create(pt_ALGraph);
+extern void         BFSGraph_Free(pt_BFSGraph*);
+extern size_t       BFSGraph_Size(pt_BFSGraph);
+extern gqrm_id_t    BFSGraph_ID(pt_BFSGraph, size_t);
+extern ds_stat      BFSGraph_IndexOf(pt_BFSGraph, gqrm_id_t, size_t*);
+extern size_t       BFSGraph_OutEdges(pt_BFSGraph, size_t, const size_t**, const edge_weight_t**);
+extern size_t       BFSGraph_InEdges(pt_BFSGraph, size_t, const size_t**);
+extern ds_stat      BFS_Run(pt_BFSGraph, size_t, pt_ThreadPool, vertex_weight_t*, gqrm_id_t*);
+extern pt_ALGraph   ALGraph_BFSTree(pt_ALGraph, gqrm_id_t, gqrm_id_t [], size_t, pt_ThreadPool);
+#endif
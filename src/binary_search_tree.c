@@ -44,15 +44,22 @@ typedef struct _binary_search_tree {
 	size_t       size;
 } bstree, *p_bstree;
 
-static ds_stat pre_map_subtree(p_bst_node, bst_map_func, size_t);
-static ds_stat in_map_subtree(p_bst_node, bst_map_func, size_t);
-static ds_stat post_map_subtree(p_bst_node, bst_map_func, size_t);
+/** @enum
+ * Orders a tree is walked in.
+ */
+typedef enum {
+    PRE_ORDER, IN_ORDER
+} walk_order;
+
+static ds_stat map_subtree(p_bst_node, bst_map_func, walk_order);
+static ds_stat post_map_subtree(p_bst_node, bst_map_func);
 static ds_stat get_max(p_bst_node, bst_data_t*);
 static ds_stat get_min(p_bst_node, bst_data_t*);
 static p_bst_node create_node(bst_data_t);
 static ds_stat find_parent(p_bst_node, bst_data_t, bst_cmp, p_bst_node*);
 static ds_stat insert(p_bst_node, bst_data_t, bst_cmp);
 static ds_stat get_min_parent(p_bst_node, p_bst_node*);
+static p_bst_node build_subtree(bst_data_t[], size_t);
 
 p_bstree
 BSTree_Create(bst_cmp cmp)
@@ -77,7 +84,7 @@ BSTree_PreOrderMap(p_bstree bst, bst_map_func func)
     if (!bst)
 	    return DS_ERROR;
 
-    return pre_map_subtree(bst->root, func, 0);
+    return map_subtree(bst->root, func, PRE_ORDER);
 }
 
 ds_stat
@@ -86,7 +93,7 @@ BSTree_InOrderMap(p_bstree bst, bst_map_func func)
     if (!bst)
 	    return DS_ERROR;
 	
-	return in_map_subtree(bst->root, func, 0);
+	return map_subtree(bst->root, func, IN_ORDER);
 }
 
 ds_stat
@@ -95,44 +102,108 @@ BSTree_PostOrderMap(p_bstree bst, bst_map_func func)
     if (!bst)
 	    return DS_ERROR;
 	
-	return post_map_subtree(bst->root, func, 0);
+	return post_map_subtree(bst->root, func);
 }
 
+/* @fn
+ * Visit subtree "sub" in pre-order or in-order by Morris
+ * traversal: the right pointer of the in-order predecessor
+ * of a node is temporarily threaded back to that node, so
+ * neither recursion nor a stack is needed however deep an
+ * unbalanced tree is. Following a thread upwards first adds
+ * one to "depth" like any right move; the true depth is
+ * restored from the length of the path to the predecessor.
+ * "func" must not access the tree.
+ */
 static ds_stat
-pre_map_subtree(p_bst_node sub, bst_map_func func, size_t depth)
+map_subtree(p_bst_node sub, bst_map_func func, walk_order order)
 {
-    if (!sub || !func)
-	    return DS_ERROR;
-	func(sub->data, depth);
-	pre_map_subtree(sub->left, func, depth + 1);
-	pre_map_subtree(sub->right, func, depth + 1);
+    p_bst_node   pred;
+	size_t       depth = 0, k;
 
-	return DS_OK;
-}
-
-static ds_stat
-in_map_subtree(p_bst_node sub, bst_map_func func, size_t depth)
-{
-    if (!sub || !func)
+	if (!sub || !func)
 	    return DS_ERROR;
 	
-	in_map_subtree(sub->left, func, depth + 1);
-	func(sub->data, depth);
-	in_map_subtree(sub->right, func, depth + 1);
-
+	while (sub) {
+	    if (!sub->left) {
+		    func(sub->data, depth);
+			sub = sub->right;
+			depth++;
+			continue;
+		}
+		for (pred = sub->left, k = 0; pred->right && pred->right != sub; k++)
+		    pred = pred->right;
+		if (!pred->right) {
+		    /* first time here: thread the predecessor */
+		    if (order == PRE_ORDER)
+			    func(sub->data, depth);
+			pred->right = sub;
+			sub = sub->left;
+			depth++;
+		} else {
+		    /* back through the thread from the predecessor */
+		    depth -= k + 2;
+		    pred->right = NULL;
+			if (order == IN_ORDER)
+			    func(sub->data, depth);
+			sub = sub->right;
+			depth++;
+		}
+	}
 	return DS_OK;
 }
 
+/* @fn
+ * Visit subtree "sub" in post-order by Morris traversal. A
+ * dummy node takes "sub" as left child; whenever a thread is
+ * removed, the right spine from the left child of the node
+ * to its predecessor is visited bottom up by reversing it in
+ * place twice. Depths are reported with the root of "sub"
+ * at depth 0.
+ */
 static ds_stat
-post_map_subtree(p_bst_node sub, bst_map_func func, size_t depth)
+post_map_subtree(p_bst_node sub, bst_map_func func)
 {
-    if (!sub || !func)
+    bst_node     dummy;
+	p_bst_node   pred, nd, prev, next;
+	size_t       depth = 0, k, i;
+
+	if (!sub || !func)
 	    return DS_ERROR;
 	
-	post_map_subtree(sub->left, func, depth + 1);
-	post_map_subtree(sub->right, func, depth + 1);
-	func(sub->data, depth);
-
+	dummy.data  = NULL;
+	dummy.left  = sub;
+	dummy.right = NULL;
+	sub = &dummy;
+	while (sub) {
+	    if (!sub->left) {
+			sub = sub->right;
+			depth++;
+			continue;
+		}
+		for (pred = sub->left, k = 0; pred->right && pred->right != sub; k++)
+		    pred = pred->right;
+		if (!pred->right) {
+			pred->right = sub;
+			sub = sub->left;
+			depth++;
+			continue;
+		}
+		depth -= k + 2;
+		pred->right = NULL;
+		/* reverse the spine, visit it from "pred" up, restore it */
+		for (prev = NULL, nd = sub->left; nd; prev = nd, nd = next) {
+		    next = nd->right;
+			nd->right = prev;
+		}
+		for (i = 0, nd = pred, prev = NULL; nd; i++, prev = nd, nd = next) {
+		    func(nd->data, depth + k - i);
+		    next = nd->right;
+			nd->right = prev;
+		}
+		sub = sub->right;
+		depth++;
+	}
 	return DS_OK;
 }
 
@@ -152,6 +223,23 @@ BSTree_GetMin(p_bstree bst, bst_data_t* re)
 	return get_min(bst->root, re);
 }
 
+/* @fn
+ * Whether "data" is stored in the tree.
+ */
+ds_bool
+BSTree_Contain(p_bstree bst, bst_data_t data)
+{
+    p_bst_node   nd;
+	int          c;
+
+	if (!bst)
+	    return DS_FALSE;
+	for (nd = bst->root; nd; nd = c < 0 ? nd->left : nd->right)
+	    if ((c = bst->cmp(data, nd->data)) == 0)
+		    return DS_TRUE;
+	return DS_FALSE;
+}
+
 static ds_stat
 get_min(p_bst_node sub, bst_data_t* re)
 {
@@ -198,13 +286,10 @@ find_parent(p_bst_node sub, bst_data_t data, bst_cmp cmp, p_bst_node* re)
     while (sub) {
 	    if (cmp(data, sub->data) > 0) {
 		    if (sub->right) {
-			    printf("check right\n");
 		        if (cmp(sub->right->data, data) == 0) {
-				    printf("find\n");
 			        *re = sub;
 			    	return DS_OK;
 			    } else {
-				    printf("go to right\n");
 				    sub = sub->right;
 				}
 			} else {
@@ -212,13 +297,10 @@ find_parent(p_bst_node sub, bst_data_t data, bst_cmp cmp, p_bst_node* re)
 			}
 		} else if (cmp(data, sub->data) < 0) {
 		    if (sub->left) {
-			    printf("check left\n");
 			    if (cmp(sub->left->data, data) == 0) {
-				    printf("find\n");
 				    *re = sub;
 					return DS_OK;
 				} else {
-				    printf("go to left\n");
 				    sub = sub->left;
 				}
 			} else {
@@ -422,3 +504,79 @@ BSTree_Size(p_bstree bst)
 	    return 0;
 	return bst->size;
 }
+
+/* @fn
+ * Free every node without recursion: a left child is
+ * rotated up until the root has none, then the root goes.
+ */
+void
+BSTree_Clear(p_bstree bst)
+{
+    p_bst_node   nd, left;
+
+	if (!bst)
+	    return;
+	while ((nd = bst->root) != NULL) {
+	    if ((left = nd->left) != NULL) {
+		    nd->left    = left->right;
+			left->right = nd;
+			bst->root   = left;
+		} else {
+		    bst->root = nd->right;
+			free(nd);
+		}
+	}
+	bst->size = 0;
+}
+
+void
+BSTree_Free(p_bstree* bst)
+{
+    if (!bst || !(*bst))
+	    return;
+	BSTree_Clear(*bst);
+	free(*bst);
+	*bst = NULL;
+}
+
+/* @fn
+ * Replace the content of this tree by the "n" data of
+ * "array", which must be strictly increasing under the
+ * tree's compare function. The tree is built balanced in
+ * O(n), whereas inserting sorted data one by one degenerates
+ * into a list.
+ */
+ds_stat
+BSTree_BuildFromSorted(p_bstree bst, bst_data_t array[], size_t n)
+{
+    if (!bst || (!array && n))
+	    return DS_ERROR;
+
+    BSTree_Clear(bst);
+	if ((bst->root = build_subtree(array, n)) == NULL && n)
+	    return DS_ERROR;
+	bst->size = n;
+	return DS_OK;
+}
+
+static p_bst_node
+build_subtree(bst_data_t array[], size_t n)
+{
+    p_bst_node   nd;
+	bstree       part;
+	size_t       mid = n / 2;
+
+    if (n == 0)
+	    return NULL;
+	if ((nd = create_node(array[mid])) == NULL)
+	    return NULL;
+	nd->left  = build_subtree(array, mid);
+	nd->right = build_subtree(array + mid + 1, n - mid - 1);
+	if ((mid && !nd->left) || (n - mid - 1 && !nd->right)) {
+	    /* free what was built of this subtree */
+	    part.root = nd;
+		BSTree_Clear(&part);
+	    return NULL;
+	}
+	return nd;
+}
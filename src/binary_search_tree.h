@@ -43,9 +43,13 @@ extern ds_stat      BSTree_InOrderMap(p_bstree, bst_map_func);
 extern ds_stat      BSTree_PostOrderMap(p_bstree, bst_map_func);
 extern ds_stat      BSTree_GetMax(p_bstree, bst_data_t*);
 extern ds_stat      BSTree_GetMin(p_bstree, bst_data_t*);
+extern ds_bool      BSTree_Contain(p_bstree, bst_data_t);
 extern ds_stat      BSTree_Insert(p_bstree, bst_data_t);
 extern size_t       BSTree_Size(p_bstree);
 extern ds_stat      BSTree_Delete(p_bstree, bst_data_t);
+extern void         BSTree_Clear(p_bstree);
+extern void         BSTree_Free(p_bstree*);
+extern ds_stat      BSTree_BuildFromSorted(p_bstree, bst_data_t [], size_t);
 
 #undef p_bstree
 
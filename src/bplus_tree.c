@@ -0,0 +1,662 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bplus_tree.h"
+
+/* the fewest ids in a node other than the root */
+#define BPT_MIN           (BPT_KEYS / 2)
+/* more levels than any tree of 2^64 ids has */
+#define BPT_MAX_HEIGHT    64
+
+/* @struct
+ * Part common to inner nodes and leaves.
+ * keys - the ids, increasing; first so that they start a
+ *        cache line
+ * n    - the number of ids used
+ * leaf - whether this node is a leaf
+ */
+typedef struct BPT_NODE {
+    gqrm_id_t   keys[BPT_KEYS];
+    size_t      n;
+    ds_bool     leaf;
+} bpt_node;
+
+/* @struct
+ * An inner node: the ids of child[i] are not less than
+ * keys[i - 1] and less than keys[i].
+ */
+typedef struct {
+    bpt_node    hdr;
+    bpt_node*   child[BPT_KEYS + 1];
+} bpt_inner;
+
+/* @struct
+ * A leaf: data[i] is mapped from keys[i].
+ * next - the leaf with the next larger ids
+ */
+typedef struct BPT_LEAF {
+    bpt_node           hdr;
+    bpt_data_t         data[BPT_KEYS];
+    struct BPT_LEAF*   next;
+} bpt_leaf;
+
+/* @struct
+ * root   - the root, a leaf while the tree is small
+ * size   - the number of ids
+ * height - the number of levels, 0 when empty
+ * inners - the pool inner nodes come from
+ * leaves - the pool leaves come from
+ */
+struct BPLUS_TREE {
+    bpt_node*     root;
+    size_t        size;
+    size_t        height;
+    pt_NodePool   inners;
+    pt_NodePool   leaves;
+};
+
+#define INNER(nd)    ((bpt_inner*)(nd))
+#define LEAF(nd)     ((bpt_leaf*)(nd))
+
+static size_t     lower(bpt_node*, gqrm_id_t);
+static size_t     upper(bpt_node*, gqrm_id_t);
+static bpt_leaf*  find_leaf(pt_BPTree, gqrm_id_t);
+static bpt_node*  create_node(pt_BPTree, ds_bool);
+static ds_stat    reserve(pt_BPTree, bpt_node*[], size_t, bpt_node*);
+static bpt_node*  leaf_insert(pt_BPTree, bpt_leaf*, size_t, gqrm_id_t,
+                              bpt_data_t, gqrm_id_t*);
+static bpt_node*  inner_insert(pt_BPTree, bpt_inner*, size_t, gqrm_id_t,
+                               bpt_node*, gqrm_id_t*);
+static void       rebalance(pt_BPTree, bpt_inner*, size_t);
+static void       borrow_left(bpt_inner*, size_t);
+static void       borrow_right(bpt_inner*, size_t);
+static void       merge(pt_BPTree, bpt_inner*, size_t);
+
+pt_BPTree
+BPTree_Create(void)
+{
+    pt_BPTree   tree;
+
+    if ((tree = malloc(sizeof(BPTree))) == NULL)
+        return NULL;
+    tree->inners = NodePool_CreateAligned(sizeof(bpt_inner), BPT_CACHE_LINE);
+    tree->leaves = NodePool_CreateAligned(sizeof(bpt_leaf), BPT_CACHE_LINE);
+    if (!tree->inners || !tree->leaves) {
+        BPTree_Free(&tree);
+        return NULL;
+    }
+    tree->root   = NULL;
+    tree->size   = 0;
+    tree->height = 0;
+    return tree;
+}
+
+/* @fn
+ * Map "id" to "data". DS_ERROR if "id" is already mapped.
+ * A full leaf is split in two, which may split its
+ * ancestors in turn; the nodes needed are reserved first so
+ * that a failed allocation leaves the tree untouched.
+ */
+ds_stat
+BPTree_Insert(pt_BPTree tree, gqrm_id_t id, bpt_data_t data)
+{
+    bpt_node*   path[BPT_MAX_HEIGHT];
+    size_t      slot[BPT_MAX_HEIGHT];
+    bpt_node*   nd;
+    bpt_node*   right;
+    gqrm_id_t   sep;
+    size_t      h = 0, i;
+
+    if (!tree)
+        return DS_ERROR;
+    if (!tree->root) {
+        /* the first leaf is only attached once filled */
+        if ((nd = create_node(tree, DS_TRUE)) == NULL)
+            return DS_ERROR;
+        nd->keys[0]        = id;
+        LEAF(nd)->data[0]  = data;
+        nd->n              = 1;
+        tree->root   = nd;
+        tree->height = 1;
+        tree->size   = 1;
+        return DS_OK;
+    }
+
+    for (nd = tree->root; !nd->leaf; nd = INNER(nd)->child[i]) {
+        i = upper(nd, id);
+        path[h]   = nd;
+        slot[h++] = i;
+    }
+    i = lower(nd, id);
+    if (i < nd->n && nd->keys[i] == id)
+        return DS_ERROR;
+    if (reserve(tree, path, h, nd) == DS_ERROR)
+        return DS_ERROR;
+
+    right = leaf_insert(tree, LEAF(nd), i, id, data, &sep);
+    while (right && h > 0) {
+        h--;
+        right = inner_insert(tree, INNER(path[h]), slot[h], sep, right, &sep);
+    }
+    if (right) {
+        /* the root was split */
+        nd = create_node(tree, DS_FALSE);
+        nd->keys[0]         = sep;
+        nd->n               = 1;
+        INNER(nd)->child[0] = tree->root;
+        INNER(nd)->child[1] = right;
+        tree->root = nd;
+        tree->height++;
+    }
+    tree->size++;
+    return DS_OK;
+}
+
+ds_stat
+BPTree_Find(pt_BPTree tree, gqrm_id_t id, bpt_data_t* re)
+{
+    bpt_leaf*   leaf;
+    size_t      i;
+
+    if (!tree || !re || (leaf = find_leaf(tree, id)) == NULL)
+        return DS_ERROR;
+    i = lower(&leaf->hdr, id);
+    if (i == leaf->hdr.n || leaf->hdr.keys[i] != id)
+        return DS_ERROR;
+    *re = leaf->data[i];
+    return DS_OK;
+}
+
+ds_bool
+BPTree_Contain(pt_BPTree tree, gqrm_id_t id)
+{
+    bpt_data_t   data;
+
+    return BPTree_Find(tree, id, &data) == DS_OK ? DS_TRUE : DS_FALSE;
+}
+
+/* @fn
+ * Remove "id", returning its data through "re" unless it is
+ * NULL. A leaf left with fewer than BPT_MIN ids borrows one
+ * from a sibling or is merged with it, which may leave its
+ * parent short in turn.
+ */
+ds_stat
+BPTree_Delete(pt_BPTree tree, gqrm_id_t id, bpt_data_t* re)
+{
+    bpt_node*   path[BPT_MAX_HEIGHT];
+    size_t      slot[BPT_MAX_HEIGHT];
+    bpt_node*   nd;
+    size_t      h = 0, i;
+
+    if (!tree || !tree->root)
+        return DS_ERROR;
+
+    for (nd = tree->root; !nd->leaf; nd = INNER(nd)->child[i]) {
+        i = upper(nd, id);
+        path[h]   = nd;
+        slot[h++] = i;
+    }
+    i = lower(nd, id);
+    if (i == nd->n || nd->keys[i] != id)
+        return DS_ERROR;
+
+    if (re)
+        *re = LEAF(nd)->data[i];
+    memmove(&nd->keys[i], &nd->keys[i + 1], (nd->n - i - 1) * sizeof(gqrm_id_t));
+    memmove(&LEAF(nd)->data[i], &LEAF(nd)->data[i + 1],
+            (nd->n - i - 1) * sizeof(bpt_data_t));
+    nd->n--;
+    tree->size--;
+
+    while (h > 0 && nd->n < BPT_MIN) {
+        h--;
+        rebalance(tree, INNER(path[h]), slot[h]);
+        nd = path[h];
+    }
+
+    nd = tree->root;
+    if (!nd->leaf && nd->n == 0) {
+        tree->root = INNER(nd)->child[0];
+        NodePool_Release(tree->inners, nd);
+        tree->height--;
+    } else if (nd->leaf && nd->n == 0) {
+        tree->root = NULL;
+        NodePool_Release(tree->leaves, nd);
+        tree->height = 0;
+    }
+    return DS_OK;
+}
+
+size_t
+BPTree_Size(pt_BPTree tree)
+{
+    return tree ? tree->size : 0;
+}
+
+size_t
+BPTree_Height(pt_BPTree tree)
+{
+    return tree ? tree->height : 0;
+}
+
+/* @fn
+ * Apply "func" in id order to the ids in ["lo", "hi"] and
+ * their data.
+ */
+ds_stat
+BPTree_RangeMap(pt_BPTree tree, gqrm_id_t lo, gqrm_id_t hi, bpt_map_func func)
+{
+    bpt_iter     it;
+    gqrm_id_t    id;
+    bpt_data_t   data;
+
+    if (!tree || !func)
+        return DS_ERROR;
+    BPTree_Seek(tree, lo, &it);
+    while (BPTree_Next(&it, &id, &data) == DS_TRUE && id <= hi)
+        func(id, data);
+    return DS_OK;
+}
+
+/* @fn
+ * The number of ids in ["lo", "hi"]; whole leaves in range
+ * are counted without visiting their entries.
+ */
+size_t
+BPTree_RangeCount(pt_BPTree tree, gqrm_id_t lo, gqrm_id_t hi)
+{
+    bpt_iter   it;
+    size_t     n = 0, end;
+
+    if (!tree || lo > hi)
+        return 0;
+    BPTree_Seek(tree, lo, &it);
+    for (; it.leaf; it.leaf = it.leaf->next, it.index = 0) {
+        end = upper(&it.leaf->hdr, hi);
+        if (end <= it.index)
+            break;
+        n += end - it.index;
+        if (end < it.leaf->hdr.n)
+            break;
+    }
+    return n;
+}
+
+/* @fn
+ * Position an iterator before the smallest id.
+ */
+void
+BPTree_Begin(pt_BPTree tree, bpt_iter* it)
+{
+    bpt_node*   nd;
+
+    if (!it)
+        return;
+    it->leaf  = NULL;
+    it->index = 0;
+    if (!tree || !tree->root)
+        return;
+    for (nd = tree->root; !nd->leaf; nd = INNER(nd)->child[0]) ;
+    it->leaf = LEAF(nd);
+}
+
+/* @fn
+ * Position an iterator before the smallest id not less than
+ * "id".
+ */
+void
+BPTree_Seek(pt_BPTree tree, gqrm_id_t id, bpt_iter* it)
+{
+    if (!it)
+        return;
+    it->index = 0;
+    if (!tree || (it->leaf = find_leaf(tree, id)) == NULL)
+        return;
+    it->index = lower(&it->leaf->hdr, id);
+    if (it->index == it->leaf->hdr.n) {
+        it->leaf  = it->leaf->next;
+        it->index = 0;
+    }
+}
+
+/* @fn
+ * Return the next id and its data, either of which may be
+ * NULL. DS_FALSE once the tree is done.
+ */
+ds_bool
+BPTree_Next(bpt_iter* it, gqrm_id_t* id, bpt_data_t* data)
+{
+    if (!it || !it->leaf)
+        return DS_FALSE;
+    if (id)
+        *id = it->leaf->hdr.keys[it->index];
+    if (data)
+        *data = it->leaf->data[it->index];
+    if (++it->index == it->leaf->hdr.n) {
+        it->leaf  = it->leaf->next;
+        it->index = 0;
+    }
+    return DS_TRUE;
+}
+
+/* @fn
+ * Remove all ids at once by clearing the node pools.
+ */
+void
+BPTree_Clear(pt_BPTree tree)
+{
+    if (!tree)
+        return;
+    NodePool_Clear(tree->inners);
+    NodePool_Clear(tree->leaves);
+    tree->root   = NULL;
+    tree->size   = 0;
+    tree->height = 0;
+}
+
+void
+BPTree_Free(pt_BPTree* tree)
+{
+    if (!tree || !*tree)
+        return;
+    NodePool_Free(&(*tree)->inners);
+    NodePool_Free(&(*tree)->leaves);
+    free(*tree);
+    *tree = NULL;
+}
+
+/* @fn
+ * The first position whose id is not less than "id".
+ */
+static size_t
+lower(bpt_node* nd, gqrm_id_t id)
+{
+    size_t   lo = 0, hi = nd->n, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (nd->keys[mid] < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* @fn
+ * The first position whose id is greater than "id", which
+ * in an inner node is the child to descend into.
+ */
+static size_t
+upper(bpt_node* nd, gqrm_id_t id)
+{
+    size_t   lo = 0, hi = nd->n, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (nd->keys[mid] <= id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static bpt_leaf*
+find_leaf(pt_BPTree tree, gqrm_id_t id)
+{
+    bpt_node*   nd = tree->root;
+
+    if (!nd)
+        return NULL;
+    while (!nd->leaf)
+        nd = INNER(nd)->child[upper(nd, id)];
+    return LEAF(nd);
+}
+
+static bpt_node*
+create_node(pt_BPTree tree, ds_bool leaf)
+{
+    bpt_node*   nd;
+
+    if ((nd = NodePool_Alloc(leaf ? tree->leaves : tree->inners)) == NULL)
+        return NULL;
+    nd->n    = 0;
+    nd->leaf = leaf;
+    if (leaf)
+        LEAF(nd)->next = NULL;
+    return nd;
+}
+
+/* @fn
+ * Make sure the nodes an insertion into "leaf" below the
+ * "h" nodes of "path" splits can be allocated: the leaf if
+ * it is full, every full ancestor right above it, and a new
+ * root if they reach the root.
+ */
+static ds_stat
+reserve(pt_BPTree tree, bpt_node* path[], size_t h, bpt_node* leaf)
+{
+    size_t   inners = 0;
+
+    if (leaf->n < BPT_KEYS)
+        return DS_OK;
+    for (; h > 0 && path[h - 1]->n == BPT_KEYS; h--)
+        inners++;
+    if (h == 0)
+        inners++;
+    if (NodePool_Reserve(tree->leaves, 1) == DS_ERROR ||
+        NodePool_Reserve(tree->inners, inners) == DS_ERROR)
+        return DS_ERROR;
+    return DS_OK;
+}
+
+/* @fn
+ * Insert "id" and "data" at position "i" of "leaf". If the
+ * leaf is full it is split, and the new right half returned
+ * with its smallest id through "sep"; NULL otherwise.
+ */
+static bpt_node*
+leaf_insert(pt_BPTree tree, bpt_leaf* leaf, size_t i, gqrm_id_t id,
+            bpt_data_t data, gqrm_id_t* sep)
+{
+    gqrm_id_t    keys[BPT_KEYS + 1];
+    bpt_data_t   datas[BPT_KEYS + 1];
+    bpt_leaf*    right;
+    size_t       n = leaf->hdr.n, half;
+
+    if (n < BPT_KEYS) {
+        memmove(&leaf->hdr.keys[i + 1], &leaf->hdr.keys[i], (n - i) * sizeof(gqrm_id_t));
+        memmove(&leaf->data[i + 1], &leaf->data[i], (n - i) * sizeof(bpt_data_t));
+        leaf->hdr.keys[i] = id;
+        leaf->data[i]     = data;
+        leaf->hdr.n++;
+        return NULL;
+    }
+
+    memcpy(keys, leaf->hdr.keys, i * sizeof(gqrm_id_t));
+    memcpy(datas, leaf->data, i * sizeof(bpt_data_t));
+    keys[i]  = id;
+    datas[i] = data;
+    memcpy(&keys[i + 1], &leaf->hdr.keys[i], (n - i) * sizeof(gqrm_id_t));
+    memcpy(&datas[i + 1], &leaf->data[i], (n - i) * sizeof(bpt_data_t));
+
+    /* reserve() made sure the node is there */
+    right = LEAF(create_node(tree, DS_TRUE));
+    assert(right != NULL);
+    half  = (BPT_KEYS + 1) / 2;
+    memcpy(leaf->hdr.keys, keys, half * sizeof(gqrm_id_t));
+    memcpy(leaf->data, datas, half * sizeof(bpt_data_t));
+    leaf->hdr.n = half;
+    memcpy(right->hdr.keys, &keys[half], (BPT_KEYS + 1 - half) * sizeof(gqrm_id_t));
+    memcpy(right->data, &datas[half], (BPT_KEYS + 1 - half) * sizeof(bpt_data_t));
+    right->hdr.n = BPT_KEYS + 1 - half;
+    right->next  = leaf->next;
+    leaf->next   = right;
+    *sep = right->hdr.keys[0];
+    return &right->hdr;
+}
+
+/* @fn
+ * Insert separator "id" at position "i" of "nd" with
+ * "child" on its right. If "nd" is full it is split: the
+ * middle id moves up through "sep" and the new right half
+ * is returned; NULL otherwise.
+ */
+static bpt_node*
+inner_insert(pt_BPTree tree, bpt_inner* nd, size_t i, gqrm_id_t id,
+             bpt_node* child, gqrm_id_t* sep)
+{
+    gqrm_id_t    keys[BPT_KEYS + 1];
+    bpt_node*    children[BPT_KEYS + 2];
+    bpt_inner*   right;
+    size_t       n = nd->hdr.n, half;
+
+    if (n < BPT_KEYS) {
+        memmove(&nd->hdr.keys[i + 1], &nd->hdr.keys[i], (n - i) * sizeof(gqrm_id_t));
+        memmove(&nd->child[i + 2], &nd->child[i + 1], (n - i) * sizeof(bpt_node*));
+        nd->hdr.keys[i]  = id;
+        nd->child[i + 1] = child;
+        nd->hdr.n++;
+        return NULL;
+    }
+
+    memcpy(keys, nd->hdr.keys, i * sizeof(gqrm_id_t));
+    keys[i] = id;
+    memcpy(&keys[i + 1], &nd->hdr.keys[i], (n - i) * sizeof(gqrm_id_t));
+    memcpy(children, nd->child, (i + 1) * sizeof(bpt_node*));
+    children[i + 1] = child;
+    memcpy(&children[i + 2], &nd->child[i + 1], (n - i) * sizeof(bpt_node*));
+
+    /* reserve() made sure the node is there */
+    right = INNER(create_node(tree, DS_FALSE));
+    assert(right != NULL);
+    half  = (BPT_KEYS + 1) / 2;
+    memcpy(nd->hdr.keys, keys, half * sizeof(gqrm_id_t));
+    memcpy(nd->child, children, (half + 1) * sizeof(bpt_node*));
+    nd->hdr.n = half;
+    *sep = keys[half];
+    memcpy(right->hdr.keys, &keys[half + 1], (BPT_KEYS - half) * sizeof(gqrm_id_t));
+    memcpy(right->child, &children[half + 1], (BPT_KEYS + 1 - half) * sizeof(bpt_node*));
+    right->hdr.n = BPT_KEYS - half;
+    return &right->hdr;
+}
+
+/* @fn
+ * Bring child "i" of "p", which is one id short, back to
+ * BPT_MIN ids: borrow from a sibling that can spare one,
+ * otherwise merge with a sibling.
+ */
+static void
+rebalance(pt_BPTree tree, bpt_inner* p, size_t i)
+{
+    if (i > 0 && p->child[i - 1]->n > BPT_MIN)
+        borrow_left(p, i);
+    else if (i < p->hdr.n && p->child[i + 1]->n > BPT_MIN)
+        borrow_right(p, i);
+    else if (i > 0)
+        merge(tree, p, i - 1);
+    else
+        merge(tree, p, i);
+}
+
+/* @fn
+ * Move the last entry of child "i - 1" of "p" to the front
+ * of child "i".
+ */
+static void
+borrow_left(bpt_inner* p, size_t i)
+{
+    bpt_node*   left = p->child[i - 1];
+    bpt_node*   nd   = p->child[i];
+
+    memmove(&nd->keys[1], &nd->keys[0], nd->n * sizeof(gqrm_id_t));
+    if (nd->leaf) {
+        memmove(&LEAF(nd)->data[1], &LEAF(nd)->data[0], nd->n * sizeof(bpt_data_t));
+        nd->keys[0]       = left->keys[left->n - 1];
+        LEAF(nd)->data[0] = LEAF(left)->data[left->n - 1];
+        p->hdr.keys[i - 1] = nd->keys[0];
+    } else {
+        /* rotate through the separator */
+        memmove(&INNER(nd)->child[1], &INNER(nd)->child[0], (nd->n + 1) * sizeof(bpt_node*));
+        nd->keys[0]         = p->hdr.keys[i - 1];
+        INNER(nd)->child[0] = INNER(left)->child[left->n];
+        p->hdr.keys[i - 1]  = left->keys[left->n - 1];
+    }
+    left->n--;
+    nd->n++;
+}
+
+/* @fn
+ * Move the first entry of child "i + 1" of "p" to the end
+ * of child "i".
+ */
+static void
+borrow_right(bpt_inner* p, size_t i)
+{
+    bpt_node*   nd    = p->child[i];
+    bpt_node*   right = p->child[i + 1];
+
+    if (nd->leaf) {
+        nd->keys[nd->n]       = right->keys[0];
+        LEAF(nd)->data[nd->n] = LEAF(right)->data[0];
+        memmove(&LEAF(right)->data[0], &LEAF(right)->data[1],
+                (right->n - 1) * sizeof(bpt_data_t));
+        memmove(&right->keys[0], &right->keys[1], (right->n - 1) * sizeof(gqrm_id_t));
+        p->hdr.keys[i] = right->keys[0];
+    } else {
+        nd->keys[nd->n]              = p->hdr.keys[i];
+        INNER(nd)->child[nd->n + 1]  = INNER(right)->child[0];
+        p->hdr.keys[i]               = right->keys[0];
+        memmove(&right->keys[0], &right->keys[1], (right->n - 1) * sizeof(gqrm_id_t));
+        memmove(&INNER(right)->child[0], &INNER(right)->child[1], right->n * sizeof(bpt_node*));
+    }
+    right->n--;
+    nd->n++;
+}
+
+/* @fn
+ * Merge child "i + 1" of "p" into child "i" and drop it
+ * along with the separator between them.
+ */
+static void
+merge(pt_BPTree tree, bpt_inner* p, size_t i)
+{
+    bpt_node*   left  = p->child[i];
+    bpt_node*   right = p->child[i + 1];
+
+    if (left->leaf) {
+        memcpy(&left->keys[left->n], right->keys, right->n * sizeof(gqrm_id_t));
+        memcpy(&LEAF(left)->data[left->n], LEAF(right)->data, right->n * sizeof(bpt_data_t));
+        left->n += right->n;
+        LEAF(left)->next = LEAF(right)->next;
+        NodePool_Release(tree->leaves, right);
+    } else {
+        left->keys[left->n] = p->hdr.keys[i];
+        memcpy(&left->keys[left->n + 1], right->keys, right->n * sizeof(gqrm_id_t));
+        memcpy(&INNER(left)->child[left->n + 1], INNER(right)->child,
+               (right->n + 1) * sizeof(bpt_node*));
+        left->n += right->n + 1;
+        NodePool_Release(tree->inners, right);
+    }
+    memmove(&p->hdr.keys[i], &p->hdr.keys[i + 1], (p->hdr.n - i - 1) * sizeof(gqrm_id_t));
+    memmove(&p->child[i + 1], &p->child[i + 2], (p->hdr.n - i - 1) * sizeof(bpt_node*));
+    p->hdr.n--;
+}
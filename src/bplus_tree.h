@@ -0,0 +1,90 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* @file bplus_tree.h
+ *
+ * B+ tree ordered map from gqrm_id_t to user data.
+ *
+ * Unlike the other trees of this library, which hold one
+ * data per node, a node holds up to BPT_KEYS ids in an array
+ * spanning whole cache lines, so a lookup touches a few
+ * lines per level and a tree of a million ids is 5 levels
+ * deep. Nodes come from cache-line aligned node pools. All
+ * data are in the leaves, which are linked in id order so
+ * range scans and iterators walk leaf arrays:
+ *
+ *     bpt_iter     it;
+ *     gqrm_id_t    id;
+ *     bpt_data_t   data;
+ *
+ *     BPTree_Seek(tree, lo, &it);
+ *     while (BPTree_Next(&it, &id, &data) == DS_TRUE && id <= hi)
+ *         use(id, data);
+ *
+ * The tree must not be modified while it is iterated.
+ */
+
+#ifndef GQRM_BPLUS_TREE_H
+#define GQRM_BPLUS_TREE_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "header.h"
+#include "node_pool.h"
+
+/* the size of a cache line, and how many a node's ids span */
+#define BPT_CACHE_LINE    64
+#define BPT_KEY_LINES     4
+/* the most ids in a node */
+#define BPT_KEYS          (BPT_KEY_LINES * BPT_CACHE_LINE / sizeof(gqrm_id_t))
+
+typedef struct BPLUS_TREE    BPTree;
+typedef BPTree*              pt_BPTree;
+typedef void*                bpt_data_t;
+typedef void (*bpt_map_func)(gqrm_id_t, bpt_data_t);
+
+/* @struct
+ * Cursor over a B+ tree in id order. Its fields are private
+ * to the tree.
+ * leaf  - the leaf of the entry returned next, NULL when done
+ * index - the position of that entry in the leaf
+ */
+typedef struct {
+    struct BPT_LEAF*   leaf;
+    size_t             index;
+} bpt_iter;
+
+extern pt_BPTree   BPTree_Create(void);
+extern ds_stat     BPTree_Insert(pt_BPTree, gqrm_id_t, bpt_data_t);
+extern ds_stat     BPTree_Find(pt_BPTree, gqrm_id_t, bpt_data_t*);
+extern ds_bool     BPTree_Contain(pt_BPTree, gqrm_id_t);
+extern ds_stat     BPTree_Delete(pt_BPTree, gqrm_id_t, bpt_data_t*);
+extern size_t      BPTree_Size(pt_BPTree);
+extern size_t      BPTree_Height(pt_BPTree);
+extern ds_stat     BPTree_RangeMap(pt_BPTree, gqrm_id_t, gqrm_id_t, bpt_map_func);
+extern size_t      BPTree_RangeCount(pt_BPTree, gqrm_id_t, gqrm_id_t);
+extern void        BPTree_Begin(pt_BPTree, bpt_iter*);
+extern void        BPTree_Seek(pt_BPTree, gqrm_id_t, bpt_iter*);
+extern ds_bool     BPTree_Next(bpt_iter*, gqrm_id_t*, bpt_data_t*);
+extern void        BPTree_Clear(pt_BPTree);
+extern void        BPTree_Free(pt_BPTree*);
+#endif
@@ -30,7 +30,7 @@ typedef enum {
     x_field, y_field, z_field
 } coor_field;
 
-static ds_stat get_coordinate(pt_Coordinate, const coor_field, coordinate_t*);
+static ds_stat get_coordinate(const Coordinate*, const coor_field, coordinate_t*);
 static ds_stat set_coordinate(pt_Coordinate, const coor_field, const coordinate_t);
 static ds_bool check_equality(pt_Coordinate, pt_Coordinate, coor_field);
 
@@ -91,8 +91,47 @@ Coordinate_Create3D(const coordinate_t x, const coordinate_t y,
 void
 Coordinate_Free(pt_Coordinate* co)
 {
-    if (!*co)
-        return 
+    if (!co || !*co)
+        return;
+    free(*co);
+    *co = NULL;
+}
+
+/* @fn
+ * Create "n" contiguous coordinates initialized to the origin.
+ * The returned pointer is the first element; the others are
+ * reached through Coordinate_ArrayAt(). Elements of such an
+ * array MUST NOT be released through Coordinate_Free(), free
+ * the whole array with Coordinate_FreeArray() instead.
+ */
+pt_Coordinate
+Coordinate_CreateArray(size_t n)
+{
+    pt_Coordinate    co;
+
+    if (n == 0)
+        return NULL;
+    if ((co = calloc(n, sizeof(Coordinate))) == NULL)
+        return NULL;
+    return co;
+}
+
+/* @fn
+ * Return the "i"th coordinate of an array created by
+ * Coordinate_CreateArray(). No bound check is performed.
+ */
+pt_Coordinate
+Coordinate_ArrayAt(pt_Coordinate base, size_t i)
+{
+    assert(base);
+    return base + i;
+}
+
+void
+Coordinate_FreeArray(pt_Coordinate* co)
+{
+    if (!co || !*co)
+        return;
     free(*co);
     *co = NULL;
 }
@@ -102,7 +141,7 @@ Coordinate_Free(pt_Coordinate* co)
  * parameter "x".
  */
 ds_stat
-Coordinate_GetX(pt_Coordinate co, coordinate_t* x)
+Coordinate_GetX(const Coordinate* co, coordinate_t* x)
 {
     return get_coordinate(co, x_field, x);
 }
@@ -112,7 +151,7 @@ Coordinate_GetX(pt_Coordinate co, coordinate_t* x)
  * parameter "y".
  */
 ds_stat
-Coordinate_GetY(pt_Coordinate co, coordinate_t* y)
+Coordinate_GetY(const Coordinate* co, coordinate_t* y)
 {
     return get_coordinate(co, y_field, y);
 }
@@ -122,7 +161,7 @@ Coordinate_GetY(pt_Coordinate co, coordinate_t* y)
  * parameter "z".
  */
 ds_stat
-Coordinate_GetZ(pt_Coordinate co, coordinate_t* z)
+Coordinate_GetZ(const Coordinate* co, coordinate_t* z)
 {
     return get_coordinate(co, z_field, z);
 }
@@ -131,7 +170,7 @@ Coordinate_GetZ(pt_Coordinate co, coordinate_t* z)
  * Get x-, y-, or z-coordinate according to parameters.
  */
 static ds_stat
-get_coordinate(pt_Coordinate co, const coor_field f, coordinate_t* re)
+get_coordinate(const Coordinate* co, const coor_field f, coordinate_t* re)
 {
     if (!co || !re)
         return DS_ERROR;
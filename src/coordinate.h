@@ -36,10 +36,13 @@ extern pt_Coordinate Coordinate_Create2D(const coordinate_t, const coordinate_t)
 extern pt_Coordinate Coordinate_Create3D(const coordinate_t, const coordinate_t, const coordinate_t);
 extern pt_Coordinate Coordinate_CreateRandom2D(const int, const int);
 extern void Coordinate_Free(pt_Coordinate*);
+extern pt_Coordinate Coordinate_CreateArray(size_t);
+extern pt_Coordinate Coordinate_ArrayAt(pt_Coordinate, size_t);
+extern void Coordinate_FreeArray(pt_Coordinate*);
 extern ds_stat Coordinate_Assign(pt_Coordinate, pt_Coordinate);
-extern ds_stat Coordinate_GetX(pt_Coordinate, coordinate_t*);
-extern ds_stat Coordinate_GetY(pt_Coordinate, coordinate_t*);
-extern ds_stat Coordinate_GetZ(pt_Coordinate, coordinate_t*);
+extern ds_stat Coordinate_GetX(const Coordinate*, coordinate_t*);
+extern ds_stat Coordinate_GetY(const Coordinate*, coordinate_t*);
+extern ds_stat Coordinate_GetZ(const Coordinate*, coordinate_t*);
 extern ds_stat Coordinate_SetX(pt_Coordinate, const coordinate_t);
 extern ds_stat Coordinate_SetY(pt_Coordinate, const coordinate_t);
 extern ds_stat Coordinate_SetZ(pt_Coordinate, const coordinate_t);
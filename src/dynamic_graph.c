@@ -0,0 +1,517 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#include "dynamic_graph.h"
+
+/* @struct
+ * A node in the grid: the cell (cx, cy) it falls in and the
+ * id of its vertex.
+ */
+typedef struct {
+    long        cx;
+    long        cy;
+    gqrm_id_t   id;
+} grid_entry;
+
+/* @struct
+ * What the grid knows about vertex "i" of its graph: the
+ * range of its node, negative when it reaches nobody, and
+ * whether the node is in the grid, i.e. not removed.
+ */
+typedef struct {
+    double      range;
+    ds_bool     indexed;
+} grid_slot;
+
+GQRM_VECTOR(CellVec, grid_entry)
+GQRM_VECTOR(SlotVec, grid_slot)
+
+/* @struct
+ * cell      - the width of a cell, 0 until a node has a range
+ * reach     - the largest range of a node ever indexed, the
+ *             farthest an edge into a node can come from
+ * buckets   - the cells hashed by coordinate, "n_buckets" of
+ *             them, a power of 2
+ * size      - the number of nodes in the grid
+ * slots     - one per vertex of the graph
+ * near      - scratch for the ids found around a node
+ */
+struct SPATIAL_GRID {
+    double      cell;
+    double      reach;
+    CellVec*    buckets;
+    size_t      n_buckets;
+    size_t      size;
+    SlotVec     slots;
+    IDVec       near;
+};
+
+#define GRID_MIN_BUCKETS    64
+
+static pt_SpatialGrid error_clear(pt_SpatialGrid*);
+static ds_stat  insert_clear(pt_ALGraph, pt_SpatialGrid);
+static ds_stat  node_of(pt_ALGraph, gqrm_id_t, pt_Vertex*, pt_Node*);
+static void     cell_of(pt_SpatialGrid, pt_Node, long*, long*);
+static size_t   cell_hash(pt_SpatialGrid, long, long);
+static ds_stat  grid_rehash(pt_SpatialGrid, size_t);
+static ds_stat  rehash_clear(pt_SpatialGrid, CellVec*, size_t);
+static ds_stat  grid_add(pt_SpatialGrid, gqrm_id_t, pt_Node);
+static void     grid_remove(pt_SpatialGrid, gqrm_id_t, pt_Node);
+static ds_stat  grid_near(pt_SpatialGrid, pt_Node, double);
+static ds_stat  link_node(pt_ALGraph, pt_SpatialGrid, gqrm_id_t);
+static void     unlink_node(pt_ALGraph, pt_SpatialGrid, gqrm_id_t);
+
+/* @fn
+ * Index the nodes of "pg", whose vertex "i" must have id "i"
+ * and a pt_Node as data. Returns NULL otherwise or when out
+ * of memory.
+ */
+pt_SpatialGrid
+SpatialGrid_Create(pt_ALGraph pg)
+{
+    pt_SpatialGrid   g;
+    pt_Vertex        pv;
+    pt_Node          nd;
+    gqrm_power_t     power;
+    grid_slot        slot;
+    size_t           i, n;
+
+    if (!pg)
+        return NULL;
+    if ((g = malloc(sizeof(SpatialGrid))) == NULL)
+        return NULL;
+    g->cell      = 0.0;
+    g->reach     = -1.0;
+    g->buckets   = NULL;
+    g->n_buckets = 0;
+    g->size      = 0;
+    SlotVec_Init(&g->slots);
+    IDVec_Init(&g->near);
+
+    n = ALGraph_Size(pg);
+    if (SlotVec_Reserve(&g->slots, n) == DS_ERROR ||
+        grid_rehash(g, GRID_MIN_BUCKETS) == DS_ERROR)
+        return error_clear(&g);
+    /* ranges first, so that the cell size is known */
+    for (i = 0; i < n; i++) {
+        if (node_of(pg, (gqrm_id_t)i, &pv, &nd) == DS_ERROR ||
+            Node_GetPower(nd, &power) == DS_ERROR)
+            return error_clear(&g);
+        slot.range   = Neighbor_Range(power);
+        slot.indexed = DS_FALSE;
+        SlotVec_PushBack(&g->slots, slot);
+        if (slot.range > g->reach)
+            g->reach = slot.range;
+    }
+    if (g->reach > 0.0)
+        g->cell = g->reach;
+    for (i = 0; i < n; i++) {
+        node_of(pg, (gqrm_id_t)i, &pv, &nd);
+        if (grid_add(g, (gqrm_id_t)i, nd) == DS_ERROR)
+            return error_clear(&g);
+    }
+    return g;
+}
+
+void
+SpatialGrid_Free(pt_SpatialGrid* g)
+{
+    size_t   i;
+
+    if (!g || !*g)
+        return;
+    for (i = 0; i < (*g)->n_buckets; i++)
+        CellVec_Destroy(&(*g)->buckets[i]);
+    free((*g)->buckets);
+    SlotVec_Destroy(&(*g)->slots);
+    IDVec_Destroy(&(*g)->near);
+    free(*g);
+    *g = NULL;
+}
+
+/* @fn
+ * The number of nodes in the grid, removed ones excluded.
+ */
+size_t
+SpatialGrid_Size(pt_SpatialGrid g)
+{
+    return g ? g->size : 0;
+}
+
+double
+SpatialGrid_CellSize(pt_SpatialGrid g)
+{
+    return g ? g->cell : 0.0;
+}
+
+/* @fn
+ * Whether vertex "id" holds a node that was not removed.
+ */
+ds_bool
+SpatialGrid_Contain(pt_SpatialGrid g, gqrm_id_t id)
+{
+    if (!g || id < 0 || (size_t)id >= g->slots.size)
+        return DS_FALSE;
+    return g->slots.data[id].indexed;
+}
+
+/* @fn
+ * Add node "nd" to "pg" as a new vertex, the last one, and
+ * link it to and from the nodes in range around it. Only
+ * the nodes of the cells within reach are tested, and as
+ * the new vertex has the largest id, the edges into it are
+ * appended to their sources.
+ *
+ * @param id Where to store the id of the new vertex, or NULL.
+ */
+ds_stat
+ALGraph_InsertNode(pt_ALGraph pg, pt_SpatialGrid g, pt_Node nd, gqrm_id_t* id)
+{
+    pt_Vertex      pv;
+    gqrm_power_t   power;
+    gqrm_id_t      n;
+    grid_slot      slot;
+
+    if (!pg || !g || !nd || Node_GetPower(nd, &power) == DS_ERROR)
+        return DS_ERROR;
+    n = (gqrm_id_t)ALGraph_Size(pg);
+    /* the grid is out of step with the graph */
+    if ((size_t)n != g->slots.size)
+        return DS_ERROR;
+
+    slot.range   = Neighbor_Range(power);
+    slot.indexed = DS_FALSE;
+    if (SlotVec_PushBack(&g->slots, slot) == DS_ERROR)
+        return DS_ERROR;
+    if ((pv = Vertex_CreateMediate(n, nd, VERTEX_WEIGHT_INF)) == NULL)
+        return insert_clear(NULL, g);
+    if (ALGraph_PushVertex(pg, pv) == DS_ERROR) {
+        Vertex_Free(&pv);
+        return insert_clear(NULL, g);
+    }
+    /* the first node with a range sets the cell size */
+    if (g->cell <= 0.0 && g->size == 0 && slot.range > 0.0)
+        g->cell = slot.range;
+    if (slot.range > g->reach)
+        g->reach = slot.range;
+    if (grid_add(g, n, nd) == DS_ERROR)
+        return insert_clear(pg, g);
+    if (link_node(pg, g, n) == DS_ERROR) {
+        unlink_node(pg, g, n);
+        grid_remove(g, n, nd);
+        return insert_clear(pg, g);
+    }
+    if (id)
+        *id = n;
+    return DS_OK;
+}
+
+/* @fn
+ * Take the node of vertex "id" out of the network: drop its
+ * edges and the edges into it, and take it off the grid. The
+ * vertex stays, isolated, so that the other vertices keep
+ * their ids and positions; the node is left to the caller.
+ */
+ds_stat
+ALGraph_RemoveNode(pt_ALGraph pg, pt_SpatialGrid g, gqrm_id_t id)
+{
+    pt_Vertex   pv;
+    pt_Node     nd;
+
+    if (!pg || !g || SpatialGrid_Contain(g, id) == DS_FALSE ||
+        node_of(pg, id, &pv, &nd) == DS_ERROR)
+        return DS_ERROR;
+    unlink_node(pg, g, id);
+    grid_remove(g, id, nd);
+    return DS_OK;
+}
+
+/* @fn
+ * Select or unselect the node of vertex "id" and recompute
+ * its edges both ways. An unselected node has no edges, see
+ * Node_IsNeighbor().
+ */
+ds_stat
+ALGraph_SetNodeSelected(pt_ALGraph pg, pt_SpatialGrid g, gqrm_id_t id, ds_bool selected)
+{
+    pt_Vertex   pv;
+    pt_Node     nd;
+
+    if (!pg || !g || SpatialGrid_Contain(g, id) == DS_FALSE ||
+        node_of(pg, id, &pv, &nd) == DS_ERROR)
+        return DS_ERROR;
+    if ((selected == DS_TRUE ? Node_SetSelected(nd) : Node_SetUnselected(nd)) == DS_ERROR)
+        return DS_ERROR;
+    unlink_node(pg, g, id);
+    if (link_node(pg, g, id) == DS_ERROR) {
+        unlink_node(pg, g, id);
+        return DS_ERROR;
+    }
+    return DS_OK;
+}
+
+static pt_SpatialGrid
+error_clear(pt_SpatialGrid* g)
+{
+    SpatialGrid_Free(g);
+    return NULL;
+}
+
+/*
+ * Undo a failed ALGraph_InsertNode(): drop the vertex pushed
+ * to "pg", if given, and the slot pushed to "g".
+ */
+static ds_stat
+insert_clear(pt_ALGraph pg, pt_SpatialGrid g)
+{
+    pt_Vertex   pv;
+
+    if (pg && ALGraph_PopVertex(pg, &pv) == DS_OK)
+        Vertex_Free(&pv);
+    SlotVec_PopBack(&g->slots, NULL);
+    return DS_ERROR;
+}
+
+/*
+ * The vertex "id" of "pg" and the node it holds.
+ */
+static ds_stat
+node_of(pt_ALGraph pg, gqrm_id_t id, pt_Vertex* pv, pt_Node* nd)
+{
+    gqrm_id_t      vid;
+    graph_data_t   data;
+
+    if (id < 0 || ALGraph_GetVertex(pg, (size_t)id, pv) == DS_ERROR ||
+        Vertex_GetID(*pv, &vid) == DS_ERROR || vid != id ||
+        Vertex_GetData(*pv, &data) == DS_ERROR || !data)
+        return DS_ERROR;
+    *nd = (pt_Node)data;
+    return DS_OK;
+}
+
+/*
+ * The cell of "nd". Before any node has a range every node
+ * goes to cell (0, 0).
+ */
+static void
+cell_of(pt_SpatialGrid g, pt_Node nd, long* cx, long* cy)
+{
+    const Coordinate*  pc;
+    coordinate_t       x, y;
+
+    *cx = *cy = 0;
+    if (g->cell <= 0.0 || Node_GetCoordinate(nd, &pc) == DS_ERROR ||
+        Coordinate_GetX(pc, &x) == DS_ERROR || Coordinate_GetY(pc, &y) == DS_ERROR)
+        return;
+    *cx = (long)floor(x / g->cell);
+    *cy = (long)floor(y / g->cell);
+}
+
+static size_t
+cell_hash(pt_SpatialGrid g, long cx, long cy)
+{
+    uint64_t   h = (uint64_t)cx * 0x9E3779B97F4A7C15ULL ^
+                   (uint64_t)cy * 0xC2B2AE3D27D4EB4FULL;
+
+    return (size_t)(h ^ h >> 31) & (g->n_buckets - 1);
+}
+
+/*
+ * Spread the entries over "n" buckets, a power of 2.
+ */
+static ds_stat
+grid_rehash(pt_SpatialGrid g, size_t n)
+{
+    CellVec*   old = g->buckets;
+    size_t     n_old = g->n_buckets, i, j;
+    grid_entry e;
+
+    if ((g->buckets = malloc(n * sizeof(CellVec))) == NULL) {
+        g->buckets = old;
+        return DS_ERROR;
+    }
+    g->n_buckets = n;
+    for (i = 0; i < n; i++)
+        CellVec_Init(&g->buckets[i]);
+    for (i = 0; i < n_old; i++) {
+        for (j = 0; j < old[i].size; j++) {
+            e = old[i].data[j];
+            if (CellVec_PushBack(&g->buckets[cell_hash(g, e.cx, e.cy)], e) == DS_ERROR)
+                return rehash_clear(g, old, n_old);
+        }
+    }
+    for (i = 0; i < n_old; i++)
+        CellVec_Destroy(&old[i]);
+    free(old);
+    return DS_OK;
+}
+
+/*
+ * Drop the buckets being filled and go back to "old".
+ */
+static ds_stat
+rehash_clear(pt_SpatialGrid g, CellVec* old, size_t n_old)
+{
+    size_t   i;
+
+    for (i = 0; i < g->n_buckets; i++)
+        CellVec_Destroy(&g->buckets[i]);
+    free(g->buckets);
+    g->buckets   = old;
+    g->n_buckets = n_old;
+    return DS_ERROR;
+}
+
+static ds_stat
+grid_add(pt_SpatialGrid g, gqrm_id_t id, pt_Node nd)
+{
+    grid_entry   e;
+
+    /* keep about one node per bucket */
+    if (g->size >= g->n_buckets && grid_rehash(g, 2 * g->n_buckets) == DS_ERROR)
+        return DS_ERROR;
+    cell_of(g, nd, &e.cx, &e.cy);
+    e.id = id;
+    if (CellVec_PushBack(&g->buckets[cell_hash(g, e.cx, e.cy)], e) == DS_ERROR)
+        return DS_ERROR;
+    g->slots.data[id].indexed = DS_TRUE;
+    g->size++;
+    return DS_OK;
+}
+
+static void
+grid_remove(pt_SpatialGrid g, gqrm_id_t id, pt_Node nd)
+{
+    CellVec*   b;
+    long       cx, cy;
+    size_t     i;
+
+    cell_of(g, nd, &cx, &cy);
+    b = &g->buckets[cell_hash(g, cx, cy)];
+    for (i = 0; i < b->size; i++)
+        if (b->data[i].id == id) {
+            CellVec_SwapRemove(b, i);
+            g->slots.data[id].indexed = DS_FALSE;
+            g->size--;
+            return;
+        }
+}
+
+/*
+ * Gather in g->near the ids of the nodes whose cell is
+ * within "r" of the cell of "nd", "nd" included, in no
+ * particular order. When the cells to visit outnumber the
+ * buckets, every bucket is gathered instead.
+ */
+static ds_stat
+grid_near(pt_SpatialGrid g, pt_Node nd, double r)
+{
+    CellVec*   b;
+    long       cx, cy, x, y, k;
+    double     side;
+    size_t     i, j;
+
+    IDVec_Clear(&g->near);
+    if (r < 0.0 || g->size == 0)
+        return DS_OK;
+    side = g->cell > 0.0 ? 2.0 * ceil(r / g->cell) + 1.0 : 1.0;
+    if (side * side >= (double)g->n_buckets) {
+        for (i = 0; i < g->n_buckets; i++)
+            for (j = 0; j < g->buckets[i].size; j++)
+                if (IDVec_PushBack(&g->near, g->buckets[i].data[j].id) == DS_ERROR)
+                    return DS_ERROR;
+        return DS_OK;
+    }
+    k = (long)(side - 1.0) / 2;
+    cell_of(g, nd, &cx, &cy);
+    for (x = cx - k; x <= cx + k; x++)
+        for (y = cy - k; y <= cy + k; y++) {
+            b = &g->buckets[cell_hash(g, x, y)];
+            for (j = 0; j < b->size; j++)
+                if (b->data[j].cx == x && b->data[j].cy == y &&
+                    IDVec_PushBack(&g->near, b->data[j].id) == DS_ERROR)
+                    return DS_ERROR;
+        }
+    return DS_OK;
+}
+
+/*
+ * Add the edges from and to vertex "id", which has none.
+ * Edges out of it go as far as its own range, edges into it
+ * come from as far as the reach of the grid.
+ */
+static ds_stat
+link_node(pt_ALGraph pg, pt_SpatialGrid g, gqrm_id_t id)
+{
+    pt_Vertex   pv, pu;
+    pt_Node     nv, nu;
+    double      w;
+    size_t      i;
+    gqrm_id_t   u;
+
+    node_of(pg, id, &pv, &nv);
+    if (grid_near(g, nv, g->reach) == DS_ERROR)
+        return DS_ERROR;
+    /* gathered by cell, pushed in place by Vertex_PushEdge() */
+    for (i = 0; i < g->near.size; i++) {
+        if ((u = g->near.data[i]) == id)
+            continue;
+        node_of(pg, u, &pu, &nu);
+        METRIC_ADD(METRIC_PAIR_TESTS, 2);
+        if (Node_IsNeighbor(nv, nu, &w) == DS_TRUE &&
+            Vertex_PushNeighbor(pv, pu, w) == DS_ERROR)
+            return DS_ERROR;
+        if (Node_IsNeighbor(nu, nv, &w) == DS_TRUE &&
+            Vertex_PushNeighbor(pu, pv, w) == DS_ERROR)
+            return DS_ERROR;
+    }
+    return DS_OK;
+}
+
+/*
+ * Drop the edges from and to vertex "id". An edge into it
+ * comes from no farther than the reach of the grid.
+ */
+static void
+unlink_node(pt_ALGraph pg, pt_SpatialGrid g, gqrm_id_t id)
+{
+    pt_Vertex   pv, pu;
+    pt_Node     nv, nu;
+    size_t      i;
+    gqrm_id_t   u;
+
+    node_of(pg, id, &pv, &nv);
+    Vertex_ClearEdge(pv);
+    if (grid_near(g, nv, g->reach) == DS_ERROR) {
+        /* out of memory, fall back on every vertex */
+        for (u = 0; (size_t)u < g->slots.size; u++)
+            if (node_of(pg, u, &pu, &nu) == DS_OK && Vertex_IsNeighbor(pu, pv) == DS_TRUE)
+                Vertex_DeleteEdge(pu, id);
+        return;
+    }
+    for (i = 0; i < g->near.size; i++) {
+        node_of(pg, g->near.data[i], &pu, &nu);
+        if (Vertex_IsNeighbor(pu, pv) == DS_TRUE)
+            Vertex_DeleteEdge(pu, id);
+    }
+}
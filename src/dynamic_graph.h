@@ -0,0 +1,66 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file dynamic_graph.h
+ *
+ * Local maintenance of a neighbor graph under topology
+ * changes.
+ *
+ * The graph of a set of nodes, as built by ALGraph_Init()
+ * with check_neighbor() or by Neighbor_InitGraph(), has to be
+ * rebuilt in O(n^2) pair tests whenever a node is added,
+ * fails, or is selected or unselected. A SpatialGrid buckets
+ * the nodes of such a graph by the cell of a uniform grid
+ * their coordinate falls in, with cells as wide as the
+ * largest transmission range (see Neighbor_Range()), so the
+ * only nodes a change can link to or unlink from are found in
+ * the few cells around it. The functions below update the
+ * edges of those nodes only, and leave the graph equal to a
+ * full rebuild.
+ *
+ * A graph and its grid are kept in step: the graph must only
+ * change through these functions once its grid is created.
+ */
+
+#ifndef GQRM_DYNAMIC_GRAPH_H
+#define GQRM_DYNAMIC_GRAPH_H
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "header.h"
+#include "metrics.h"
+#include "node.h"
+#include "graph.h"
+#include "neighbor.h"
+#include "typed_containers.h"
+
+typedef struct SPATIAL_GRID    SpatialGrid;
+typedef SpatialGrid*           pt_SpatialGrid;
+
+extern pt_SpatialGrid  SpatialGrid_Create(pt_ALGraph);
+extern void            SpatialGrid_Free(pt_SpatialGrid*);
+extern size_t          SpatialGrid_Size(pt_SpatialGrid);
+extern double          SpatialGrid_CellSize(pt_SpatialGrid);
+extern ds_bool         SpatialGrid_Contain(pt_SpatialGrid, gqrm_id_t);
+extern ds_stat         ALGraph_InsertNode(pt_ALGraph, pt_SpatialGrid, pt_Node, gqrm_id_t*);
+extern ds_stat         ALGraph_RemoveNode(pt_ALGraph, pt_SpatialGrid, gqrm_id_t);
+extern ds_stat         ALGraph_SetNodeSelected(pt_ALGraph, pt_SpatialGrid, gqrm_id_t, ds_bool);
+#endif
@@ -0,0 +1,557 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dynamic_spt.h"
+
+/* @struct
+ * An edge, by the indices of its ends.
+ */
+typedef struct {
+    size_t   from;
+    size_t   to;
+} edge_key;
+
+#define EDGE_LESS(a, b)    ((a).from < (b).from || \
+                            ((a).from == (b).from && (a).to < (b).to))
+GQRM_SORTED_SET(EdgeSet, edge_key, EDGE_LESS)
+
+/* @struct
+ * A vertex, by index, and the hop count it was seeded with.
+ */
+typedef struct {
+    vertex_weight_t   hop;
+    size_t            vertex;
+} hop_entry;
+
+#define HOP_LESS(a, b)    ((a).hop < (b).hop || \
+                           ((a).hop == (b).hop && (a).vertex < (b).vertex))
+GQRM_HEAP(HopHeap, hop_entry, HOP_LESS)
+
+/* @struct
+ * Everything is indexed by BFSGraph index.
+ * g          - the snapshot of the graph
+ * src        - the index of the source
+ * hops       - the hop count of every vertex from "src",
+ *              VERTEX_WEIGHT_INF if not reached
+ * parents    - the index of the parent in the tree, -1 for
+ *              "src" and the vertices not reached
+ * bounds     - the hop bound of every destination, -1 for
+ *              the other vertices
+ * violations - the number of destinations out of bound
+ * removed    - whether a vertex is taken out
+ * dead       - the edges taken out
+ * affected   - the subtree being repaired
+ * done       - the vertices settled by an update
+ * touched    - the vertices whose hop count an update set,
+ *              in "touched_list", with their hop count before
+ *              the update in "old"
+ * fifo, subtree, seeds
+ *            - the scratch of an update, all reserved to the
+ *              number of vertices, so that no update but
+ *              DynamicSPT_RemoveEdge() allocates
+ * changed    - the IDs of the destinations whose hop count
+ *              the last update changed
+ */
+struct DYNAMIC_SPT {
+    pt_BFSGraph        g;
+    size_t             n;
+    size_t             src;
+    vertex_weight_t*   hops;
+    gqrm_id_t*         parents;
+    gqrm_hop_t*        bounds;
+    size_t             violations;
+    char*              removed;
+    EdgeSet            dead;
+    char*              affected;
+    char*              done;
+    char*              touched;
+    vertex_weight_t*   old;
+    IDVec              touched_list;
+    size_t*            fifo;
+    size_t*            subtree;
+    HopHeap            seeds;
+    IDVec              changed;
+};
+
+static pt_DynamicSPT error_clear(pt_DynamicSPT*);
+static ds_bool  out_of_bound(pt_DynamicSPT, size_t);
+static void     set_hop(pt_DynamicSPT, size_t, vertex_weight_t, gqrm_id_t);
+static ds_bool  edge_alive(pt_DynamicSPT, size_t, size_t);
+static ds_bool  has_edge(pt_DynamicSPT, size_t, size_t);
+static void     seed_vertex(pt_DynamicSPT, size_t);
+static void     cut_subtree(pt_DynamicSPT, size_t);
+static void     propagate(pt_DynamicSPT, ds_bool);
+static void     end_update(pt_DynamicSPT);
+
+/* @fn
+ * Compute the hop counts from "src" over a snapshot of "pg".
+ * The "n" destinations "dsts" must be within hop counts
+ * "bounds" for DynamicSPT_Feasible() to hold; without
+ * "bounds" they only have to be reached. Later changes of
+ * "pg" are not seen.
+ */
+pt_DynamicSPT
+DynamicSPT_Create(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[],
+                  gqrm_hop_t bounds[], size_t n)
+{
+    pt_DynamicSPT   t;
+    size_t          i, d, size;
+
+    if (!pg || (n && !dsts))
+        return NULL;
+    if ((t = calloc(1, sizeof(DynamicSPT))) == NULL)
+        return NULL;
+    EdgeSet_Init(&t->dead);
+    IDVec_Init(&t->touched_list);
+    HopHeap_Init(&t->seeds);
+    IDVec_Init(&t->changed);
+    if ((t->g = BFSGraph_Create(pg)) == NULL ||
+        BFSGraph_IndexOf(t->g, src, &t->src) == DS_ERROR)
+        return error_clear(&t);
+
+    t->n = size = BFSGraph_Size(t->g);
+    t->hops     = malloc(size * sizeof(vertex_weight_t));
+    t->parents  = malloc(size * sizeof(gqrm_id_t));
+    t->bounds   = malloc(size * sizeof(gqrm_hop_t));
+    t->removed  = calloc(size, sizeof(char));
+    t->affected = calloc(size, sizeof(char));
+    t->done     = calloc(size, sizeof(char));
+    t->touched  = calloc(size, sizeof(char));
+    t->old      = malloc(size * sizeof(vertex_weight_t));
+    t->fifo     = malloc(size * sizeof(size_t));
+    t->subtree  = malloc(size * sizeof(size_t));
+    if (!t->hops || !t->parents || !t->bounds || !t->removed ||
+        !t->affected || !t->done || !t->touched || !t->old ||
+        !t->fifo || !t->subtree ||
+        IDVec_Reserve(&t->touched_list, size) == DS_ERROR ||
+        HopHeap_Reserve(&t->seeds, size) == DS_ERROR ||
+        IDVec_Reserve(&t->changed, size) == DS_ERROR)
+        return error_clear(&t);
+
+    if (BFS_Run(t->g, t->src, NULL, t->hops, t->parents) == DS_ERROR)
+        return error_clear(&t);
+    for (i = 0; i < size; i++)
+        t->bounds[i] = -1;
+    for (i = 0; i < n; i++) {
+        if (BFSGraph_IndexOf(t->g, dsts[i], &d) == DS_ERROR)
+            return error_clear(&t);
+        t->bounds[d] = bounds ? bounds[i] : VERTEX_WEIGHT_INF - 1;
+    }
+    for (i = 0; i < size; i++)
+        if (out_of_bound(t, i) == DS_TRUE)
+            t->violations++;
+    return t;
+}
+
+void
+DynamicSPT_Free(pt_DynamicSPT* t)
+{
+    error_clear(t);
+}
+
+/* @fn
+ * Take vertex "id" out, with all its edges. Only the subtree
+ * below it is searched again.
+ */
+ds_stat
+DynamicSPT_RemoveVertex(pt_DynamicSPT t, gqrm_id_t id)
+{
+    size_t   x;
+
+    if (!t)
+        return DS_ERROR;
+    IDVec_Clear(&t->changed);
+    if (BFSGraph_IndexOf(t->g, id, &x) == DS_ERROR || t->removed[x])
+        return DS_ERROR;
+    t->removed[x] = 1;
+    if (t->hops[x] != VERTEX_WEIGHT_INF)
+        cut_subtree(t, x);
+    end_update(t);
+    return DS_OK;
+}
+
+/* @fn
+ * Put vertex "id" back. Only the vertices it brings closer
+ * to the source are visited.
+ */
+ds_stat
+DynamicSPT_InsertVertex(pt_DynamicSPT t, gqrm_id_t id)
+{
+    size_t   x;
+
+    if (!t)
+        return DS_ERROR;
+    IDVec_Clear(&t->changed);
+    if (BFSGraph_IndexOf(t->g, id, &x) == DS_ERROR || !t->removed[x])
+        return DS_ERROR;
+    t->removed[x] = 0;
+    seed_vertex(t, x);
+    propagate(t, DS_FALSE);
+    end_update(t);
+    return DS_OK;
+}
+
+/* @fn
+ * Take the edge from "from" to "to" out. Nothing is searched
+ * again unless it is an edge of the tree. DS_ERROR if the
+ * graph has no such edge, or it is already out.
+ */
+ds_stat
+DynamicSPT_RemoveEdge(pt_DynamicSPT t, gqrm_id_t from, gqrm_id_t to)
+{
+    edge_key   e;
+
+    if (!t)
+        return DS_ERROR;
+    IDVec_Clear(&t->changed);
+    if (BFSGraph_IndexOf(t->g, from, &e.from) == DS_ERROR ||
+        BFSGraph_IndexOf(t->g, to, &e.to) == DS_ERROR ||
+        has_edge(t, e.from, e.to) == DS_FALSE ||
+        EdgeSet_Insert(&t->dead, e) == DS_ERROR)
+        return DS_ERROR;
+    if (t->parents[e.to] == (gqrm_id_t)e.from)
+        cut_subtree(t, e.to);
+    end_update(t);
+    return DS_OK;
+}
+
+/* @fn
+ * Put the edge from "from" to "to" back.
+ */
+ds_stat
+DynamicSPT_InsertEdge(pt_DynamicSPT t, gqrm_id_t from, gqrm_id_t to)
+{
+    edge_key    e;
+    hop_entry   s;
+
+    if (!t)
+        return DS_ERROR;
+    IDVec_Clear(&t->changed);
+    if (BFSGraph_IndexOf(t->g, from, &e.from) == DS_ERROR ||
+        BFSGraph_IndexOf(t->g, to, &e.to) == DS_ERROR ||
+        EdgeSet_Delete(&t->dead, e) == DS_ERROR)
+        return DS_ERROR;
+    if (!t->removed[e.from] && !t->removed[e.to] &&
+        t->hops[e.from] != VERTEX_WEIGHT_INF &&
+        t->hops[e.from] + 1 < t->hops[e.to]) {
+        set_hop(t, e.to, t->hops[e.from] + 1, (gqrm_id_t)e.from);
+        s.hop    = t->hops[e.to];
+        s.vertex = e.to;
+        HopHeap_Push(&t->seeds, s);
+        propagate(t, DS_FALSE);
+    }
+    end_update(t);
+    return DS_OK;
+}
+
+ds_bool
+DynamicSPT_IsRemoved(pt_DynamicSPT t, gqrm_id_t id)
+{
+    size_t   i;
+
+    if (!t || BFSGraph_IndexOf(t->g, id, &i) == DS_ERROR)
+        return DS_FALSE;
+    return t->removed[i] ? DS_TRUE : DS_FALSE;
+}
+
+/* @fn
+ * The hop count of vertex "id", VERTEX_WEIGHT_INF if it is
+ * not reached.
+ */
+ds_stat
+DynamicSPT_GetHop(pt_DynamicSPT t, gqrm_id_t id, vertex_weight_t* re)
+{
+    size_t   i;
+
+    if (!t || !re || BFSGraph_IndexOf(t->g, id, &i) == DS_ERROR)
+        return DS_ERROR;
+    *re = t->hops[i];
+    return DS_OK;
+}
+
+/* @fn
+ * The ID of the parent of vertex "id" in the tree, -1 for
+ * the source and the vertices not reached.
+ */
+ds_stat
+DynamicSPT_GetParent(pt_DynamicSPT t, gqrm_id_t id, gqrm_id_t* re)
+{
+    size_t   i;
+
+    if (!t || !re || BFSGraph_IndexOf(t->g, id, &i) == DS_ERROR)
+        return DS_ERROR;
+    *re = t->parents[i] < 0 ? -1 : BFSGraph_ID(t->g, (size_t)t->parents[i]);
+    return DS_OK;
+}
+
+/* @fn
+ * Whether every destination is reached within its bound.
+ */
+ds_bool
+DynamicSPT_Feasible(pt_DynamicSPT t)
+{
+    return t && t->violations == 0 ? DS_TRUE : DS_FALSE;
+}
+
+/* @fn
+ * Point "ids" to the IDs of the destinations whose hop count
+ * the last update changed, and return how many there are.
+ * An update that fails changes nothing.
+ */
+size_t
+DynamicSPT_Changed(pt_DynamicSPT t, const gqrm_id_t** ids)
+{
+    if (!t)
+        return 0;
+    if (ids)
+        *ids = t->changed.data;
+    return t->changed.size;
+}
+
+static pt_DynamicSPT
+error_clear(pt_DynamicSPT* t)
+{
+    if (!t || !*t)
+        return NULL;
+    BFSGraph_Free(&(*t)->g);
+    free((*t)->hops);
+    free((*t)->parents);
+    free((*t)->bounds);
+    free((*t)->removed);
+    free((*t)->affected);
+    free((*t)->done);
+    free((*t)->touched);
+    free((*t)->old);
+    free((*t)->fifo);
+    free((*t)->subtree);
+    EdgeSet_Destroy(&(*t)->dead);
+    IDVec_Destroy(&(*t)->touched_list);
+    HopHeap_Destroy(&(*t)->seeds);
+    IDVec_Destroy(&(*t)->changed);
+    free(*t);
+    *t = NULL;
+    return NULL;
+}
+
+static ds_bool
+out_of_bound(pt_DynamicSPT t, size_t v)
+{
+    if (t->bounds[v] < 0)
+        return DS_FALSE;
+    return t->hops[v] == VERTEX_WEIGHT_INF || t->hops[v] > t->bounds[v]
+           ? DS_TRUE : DS_FALSE;
+}
+
+/*
+ * Give vertex "v" hop count "h" and parent "p", remembering
+ * its hop count before the update and keeping the number of
+ * violations.
+ */
+static void
+set_hop(pt_DynamicSPT t, size_t v, vertex_weight_t h, gqrm_id_t p)
+{
+    if (!t->touched[v]) {
+        t->touched[v] = 1;
+        t->old[v]     = t->hops[v];
+        IDVec_PushBack(&t->touched_list, (gqrm_id_t)v);
+    }
+    if (out_of_bound(t, v) == DS_TRUE)
+        t->violations--;
+    t->hops[v]    = h;
+    t->parents[v] = p;
+    if (out_of_bound(t, v) == DS_TRUE)
+        t->violations++;
+}
+
+static ds_bool
+edge_alive(pt_DynamicSPT t, size_t u, size_t v)
+{
+    edge_key   e;
+
+    if (EdgeSet_Empty(&t->dead) == DS_TRUE)
+        return DS_TRUE;
+    e.from = u;
+    e.to   = v;
+    return EdgeSet_Contain(&t->dead, e) == DS_TRUE ? DS_FALSE : DS_TRUE;
+}
+
+static ds_bool
+has_edge(pt_DynamicSPT t, size_t u, size_t v)
+{
+    const size_t*   cols;
+    size_t          deg, j;
+
+    deg = BFSGraph_OutEdges(t->g, u, &cols, NULL);
+    for (j = 0; j < deg; j++)
+        if (cols[j] == v)
+            return DS_TRUE;
+    return DS_FALSE;
+}
+
+/*
+ * Give vertex "v", which is not reached, the best hop count
+ * its in-neighbors offer, and seed the search with it. The
+ * smallest in-neighbor among the closest becomes the parent.
+ */
+static void
+seed_vertex(pt_DynamicSPT t, size_t v)
+{
+    const size_t*     cols;
+    size_t            deg, j, u;
+    vertex_weight_t   best = VERTEX_WEIGHT_INF;
+    gqrm_id_t         parent = -1;
+    hop_entry         s;
+
+    if (v == t->src) {
+        best = 0;
+    } else {
+        deg = BFSGraph_InEdges(t->g, v, &cols);
+        for (j = 0; j < deg; j++) {
+            u = cols[j];
+            if (!t->removed[u] && t->hops[u] != VERTEX_WEIGHT_INF &&
+                t->hops[u] + 1 < best && edge_alive(t, u, v) == DS_TRUE) {
+                best   = t->hops[u] + 1;
+                parent = (gqrm_id_t)u;
+            }
+        }
+    }
+    if (best == VERTEX_WEIGHT_INF)
+        return;
+    set_hop(t, v, best, parent);
+    s.hop    = best;
+    s.vertex = v;
+    HopHeap_Push(&t->seeds, s);
+}
+
+/*
+ * Repair the tree after vertex "top" was removed or lost
+ * the edge from its parent.
+ *
+ * The subtree below "top" is walked level by level: a vertex
+ * with an in-neighbor one hop closer that is not affected
+ * just changes parent, and its own subtree is left alone;
+ * the others, and "top" if removed, are affected, and their
+ * children are walked in turn. The affected vertices are
+ * then searched again from the best hop counts their
+ * in-neighbors outside the subtree offer.
+ */
+static void
+cut_subtree(pt_DynamicSPT t, size_t top)
+{
+    const size_t*   cols;
+    size_t          head = 0, tail = 0, n_sub = 0, deg, i, j, u, v;
+    ds_bool         kept;
+
+    t->fifo[tail++] = top;
+    while (head < tail) {
+        v    = t->fifo[head++];
+        kept = DS_FALSE;
+        deg  = t->removed[v] ? 0 : BFSGraph_InEdges(t->g, v, &cols);
+        for (j = 0; j < deg && kept == DS_FALSE; j++) {
+            u = cols[j];
+            if (!t->removed[u] && !t->affected[u] &&
+                t->hops[u] != VERTEX_WEIGHT_INF && t->hops[u] + 1 == t->hops[v] &&
+                edge_alive(t, u, v) == DS_TRUE) {
+                t->parents[v] = (gqrm_id_t)u;
+                kept = DS_TRUE;
+            }
+        }
+        if (kept == DS_TRUE)
+            continue;
+        METRIC_INC(METRIC_SPT_POPS);
+        t->affected[v]      = 1;
+        t->subtree[n_sub++] = v;
+        deg = BFSGraph_OutEdges(t->g, v, &cols, NULL);
+        for (j = 0; j < deg; j++)
+            if (t->parents[cols[j]] == (gqrm_id_t)v && !t->affected[cols[j]])
+                t->fifo[tail++] = cols[j];
+    }
+
+    for (i = 0; i < n_sub; i++)
+        set_hop(t, t->subtree[i], VERTEX_WEIGHT_INF, -1);
+    for (i = 0; i < n_sub; i++)
+        if (!t->removed[t->subtree[i]])
+            seed_vertex(t, t->subtree[i]);
+    propagate(t, DS_TRUE);
+    for (i = 0; i < n_sub; i++)
+        t->affected[t->subtree[i]] = 0;
+}
+
+/*
+ * Settle the seeded vertices and those they bring closer by
+ * increasing hop count, merging the seeds, taken from their
+ * heap, with the vertices reached, which come in order
+ * through a FIFO. With "within" only affected vertices are
+ * reached. Every vertex is settled once, at its final hop
+ * count, so the FIFO never holds more than all vertices.
+ */
+static void
+propagate(pt_DynamicSPT t, ds_bool within)
+{
+    const size_t*   cols;
+    size_t          head = 0, tail = 0, deg, j, u, w;
+    hop_entry       s;
+
+    for (;;) {
+        if (head < tail && (HopHeap_Empty(&t->seeds) == DS_TRUE ||
+                            t->hops[t->fifo[head]] <= t->seeds.data[0].hop)) {
+            u = t->fifo[head++];
+        } else if (HopHeap_Pop(&t->seeds, &s) == DS_OK) {
+            /* superseded by a shorter path */
+            if (t->hops[s.vertex] != s.hop)
+                continue;
+            u = s.vertex;
+        } else {
+            break;
+        }
+        if (t->done[u])
+            continue;
+        t->done[u] = 1;
+        deg = BFSGraph_OutEdges(t->g, u, &cols, NULL);
+        for (j = 0; j < deg; j++) {
+            w = cols[j];
+            if (t->removed[w] || (within == DS_TRUE && !t->affected[w]) ||
+                t->hops[u] + 1 >= t->hops[w] || edge_alive(t, u, w) == DS_FALSE)
+                continue;
+            METRIC_INC(METRIC_SPT_RELAXATIONS);
+            set_hop(t, w, t->hops[u] + 1, (gqrm_id_t)u);
+            t->fifo[tail++] = w;
+        }
+    }
+}
+
+/*
+ * Collect the destinations whose hop count the update
+ * changed, and forget what it touched.
+ */
+static void
+end_update(pt_DynamicSPT t)
+{
+    size_t   i, v;
+
+    for (i = 0; i < t->touched_list.size; i++) {
+        v = (size_t)t->touched_list.data[i];
+        t->touched[v] = 0;
+        t->done[v]    = 0;
+        if (t->bounds[v] >= 0 && t->hops[v] != t->old[v])
+            IDVec_PushBack(&t->changed, BFSGraph_ID(t->g, v));
+    }
+    IDVec_Clear(&t->touched_list);
+}
@@ -0,0 +1,69 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file dynamic_spt.h
+ *
+ * Hop-count shortest paths kept up to date while vertices
+ * and edges are taken out of a graph and put back.
+ *
+ * A DynamicSPT is built once from a snapshot of an ALGraph
+ * (a BFSGraph) and a source. Removing a vertex or an edge
+ * only revisits the subtree hanging below it, in the manner
+ * of Ramalingam and Reps for unit weights: the vertices of
+ * the subtree that still have an in-neighbor one hop closer
+ * outside of it keep their hop count, and only the others
+ * are searched again. Putting a vertex or an edge back only
+ * revisits the vertices it brings closer. Hop counts are
+ * always those a BFS over the graph left would give.
+ *
+ * Destinations may be given with hop bounds, and after every
+ * update the destinations whose hop count changed are
+ * reported, so a what-if question, e.g. "can this relay be
+ * unselected?", is a removal, a look at DynamicSPT_Feasible()
+ * and, if needed, an insertion to undo it.
+ */
+
+#ifndef GQRM_DYNAMIC_SPT_H
+#define GQRM_DYNAMIC_SPT_H
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "header.h"
+#include "metrics.h"
+#include "graph.h"
+#include "bfs.h"
+#include "typed_containers.h"
+
+typedef struct DYNAMIC_SPT    DynamicSPT;
+typedef DynamicSPT*           pt_DynamicSPT;
+
+extern pt_DynamicSPT  DynamicSPT_Create(pt_ALGraph, gqrm_id_t, gqrm_id_t [], gqrm_hop_t [], size_t);
+extern void           DynamicSPT_Free(pt_DynamicSPT*);
+extern ds_stat        DynamicSPT_RemoveVertex(pt_DynamicSPT, gqrm_id_t);
+extern ds_stat        DynamicSPT_InsertVertex(pt_DynamicSPT, gqrm_id_t);
+extern ds_stat        DynamicSPT_RemoveEdge(pt_DynamicSPT, gqrm_id_t, gqrm_id_t);
+extern ds_stat        DynamicSPT_InsertEdge(pt_DynamicSPT, gqrm_id_t, gqrm_id_t);
+extern ds_bool        DynamicSPT_IsRemoved(pt_DynamicSPT, gqrm_id_t);
+extern ds_stat        DynamicSPT_GetHop(pt_DynamicSPT, gqrm_id_t, vertex_weight_t*);
+extern ds_stat        DynamicSPT_GetParent(pt_DynamicSPT, gqrm_id_t, gqrm_id_t*);
+extern ds_bool        DynamicSPT_Feasible(pt_DynamicSPT);
+extern size_t         DynamicSPT_Changed(pt_DynamicSPT, const gqrm_id_t**);
+#endif
@@ -48,7 +48,7 @@ typedef enum {
  * status - 
  * parent - while building a tree, this field point to 
  *          the parent of this vertex
- * edges  - edges adjacent to this vertex
+ * adj    - edges adjacent to this vertex, NULL if none
  */
 struct VERTEX {
     gqrm_id_t         id;
@@ -57,17 +57,36 @@ struct VERTEX {
     vertex_weight_t     weight;
     vertex_status     status;
     gqrm_id_t         parent;
-    p_sll             edges;
+    struct ADJACENCY* adj;
 };
 
+/* @struct
+ * The edges of a vertex, shared copy-on-write by the vertex
+ * and its copies: a copy only takes a reference, and the
+ * first change through any of them copies the edges first.
+ * The count is not atomic, so a vertex and its copies must
+ * not be changed from several threads at once.
+ * edges - edges sorted by the id of their other end, which
+ *         Vertex_IsNeighbor(), Vertex_GetEdgeWeight() and
+ *         Vertex_DeleteEdge() binary search
+ * refs  - the number of vertices sharing them
+ */
+typedef struct ADJACENCY {
+    p_vec             edges;
+    size_t            refs;
+} adjacency;
+
 /* @struct
  * Structure defining an edge in graph.
  * end     - an end of this edge (the other is the vertex
  *           where this edge is stored)
+ * end_id  - the id of "end", kept so that lookups and
+ *           copies of a graph never touch "end"
  * weight  - edge weight
  */
 struct EDGE {
     pt_Vertex         end;
+    gqrm_id_t         end_id;
     edge_weight_t     weight;
 };
 
@@ -76,14 +95,55 @@ struct EDGE {
  * adjacency list.
  */
 struct ALGRAPH {
-    p_sll    vertices;
+    p_vec    vertices;
 };
 
+/* @struct
+ * Adjacency computed for a block of consecutive rows while
+ * building a graph in parallel. Every block is filled by a
+ * single worker, so no locking is needed, and blocks are
+ * concatenated in row order afterwards.
+ * counts  - the number of neighbors of each row in the block
+ * cols    - the neighbors of all rows, row after row
+ * weights - the edge weight of each neighbor
+ * nnz     - the number of edges in the block
+ */
+typedef struct {
+    size_t*           counts;
+    size_t*           cols;
+    edge_weight_t*    weights;
+    size_t            nnz;
+    size_t            cap;
+} adjacency_block;
+
+/* @struct
+ * Shared input of the parallel builder. Each worker only
+ * writes its own blocks and its own entry of "failed", set
+ * if memory ran out.
+ */
+typedef struct {
+    graph_data_t*     data;
+    size_t            size;
+    is_neighbor       func;
+    adjacency_block*  blocks;
+    char*             failed;
+} parallel_init_arg;
+
+/* rows per adjacency block of the parallel builder */
+#define INIT_BLOCK_ROWS    64
+
 static pt_Vertex create_vertex(gqrm_id_t, vertex_type, graph_data_t, vertex_weight_t, vertex_status, gqrm_id_t);
-static int       edge_cmp(sll_data_t, sll_data_t);
-static void      edge_clear_op(sll_data_t*);
-static void      destroy_edges(pt_Vertex);
+static size_t    edge_lower(pt_Vertex, gqrm_id_t);
+static void      edge_clear_op(vec_data_t*);
+static p_vec     edges_of(pt_Vertex);
+static ds_stat   own_edges(pt_Vertex);
+static void      release_edges(pt_Vertex);
+static ds_stat   push_vertices(pt_ALGraph, p_sll);
 static ds_stat   error_clear(pt_ALGraph);
+static void      init_blocks(size_t, size_t, size_t, void*);
+static ds_stat   block_push(adjacency_block*, size_t, edge_weight_t);
+static ds_stat   parallel_error(parallel_init_arg*, size_t);
+static void      free_blocks(parallel_init_arg*, size_t);
 
 pt_Edge
 Edge_Create(pt_Vertex v, const edge_weight_t w)
@@ -96,6 +156,7 @@ Edge_Create(pt_Vertex v, const edge_weight_t w)
     if ((pe = malloc(sizeof(Edge))) == NULL)
         return NULL;
     pe->end    = v;
+    pe->end_id = v->id;
     pe->weight = w;
     return pe;
 }
@@ -113,6 +174,7 @@ Edge_Assign(pt_Edge rhs, pt_Edge lhs)
     assert(lhs);
 
     rhs->end    = lhs->end;
+    rhs->end_id = lhs->end_id;
     rhs->weight = lhs->weight;
     return DS_OK;
 }
@@ -137,7 +199,7 @@ Edge_Same(pt_Edge rhs, pt_Edge lhs)
     if (!rhs || !lhs)
         return DS_FALSE;
 
-    if (rhs->end->id == lhs->end->id)
+    if (rhs->end_id == lhs->end_id)
         return DS_TRUE;
     return DS_FALSE;
 }
@@ -203,6 +265,12 @@ Edge_Free(pt_Edge* pe)
     *pe = NULL;
 }
 
+/* @fn
+ * The vertex "pe" was created with. Edges are shared by
+ * copies of a graph, so that vertex belongs to the graph the
+ * edge was first pushed in and may be gone; use
+ * Edge_GetEndID() with ALGraph_GetVertexByID() instead.
+ */
 ds_stat
 Edge_GetEnd(pt_Edge pe, pt_Vertex* re)
 {
@@ -217,7 +285,7 @@ Edge_GetEndID(pt_Edge pe, gqrm_id_t* re)
 {
     if (!pe || !re)
 	    return DS_ERROR;
-	*re = pe->end->id;
+	*re = pe->end_id;
 	return DS_OK;
 }
 
@@ -230,12 +298,18 @@ Edge_GetWeight(pt_Edge pe, edge_weight_t* re)
     return DS_OK;
 }
 
+/* @fn
+ * Set the end of "pe". An edge stored in a vertex must keep
+ * its end id, or the edges of the vertex are no longer
+ * sorted, and is shared by the copies of the vertex.
+ */
 ds_stat
 Edge_SetEnd(pt_Edge pe, pt_Vertex v)
 {
     if (!pe || !v)
         return DS_ERROR;
-    pe->end = v;
+    pe->end    = v;
+    pe->end_id = v->id;
     return DS_OK;
 }
 
@@ -264,11 +338,7 @@ create_vertex(gqrm_id_t i, vertex_type t,
     pv->weight  = w;
     pv->status  = s;
     pv->parent  = p;
-	pv->edges   = NULL;
-    if (SingleLinkedList_Init(&pv->edges) == DS_ERROR) {
-        free(pv);
-        return NULL;
-    }
+	pv->adj     = NULL;
     return pv;
 }
 
@@ -293,6 +363,10 @@ Vertex_CreateMediate(gqrm_id_t i, graph_data_t d,
     return create_vertex(i, MDT, d, w, U, -1);
 }
 
+/* @fn
+ * Copy "pv" with its edges, which are shared until either
+ * vertex changes them, see Vertex_Assign().
+ */
 pt_Vertex
 Vertex_DeepCopy(pt_Vertex pv)
 {
@@ -326,16 +400,21 @@ Vertex_ShallowCopy(pt_Vertex pv)
 	return cpy;
 }
 
+/* @fn
+ * Make "rhs" a copy of "lhs". The edges are shared until
+ * either vertex changes them, see struct ADJACENCY.
+ */
 ds_stat
 Vertex_Assign(pt_Vertex rhs, pt_Vertex lhs)
 {
-    p_sll cpy;
-
     if (!rhs || !lhs)
         return DS_ERROR;
+    if (rhs == lhs)
+        return DS_OK;
  
-    if ((cpy = SingleLinkedList_Copy(lhs->edges)) == NULL)
-        return DS_ERROR;
+    if (lhs->adj)
+        lhs->adj->refs++;
+    release_edges(rhs);
 
     rhs->id     = lhs->id;
     rhs->type   = lhs->type;
@@ -343,7 +422,7 @@ Vertex_Assign(pt_Vertex rhs, pt_Vertex lhs)
     rhs->weight = lhs->weight;
     rhs->status = lhs->status;
     rhs->parent = lhs->parent;
-	rhs->edges  = cpy;
+	rhs->adj    = lhs->adj;
 
     return DS_OK;
 }
@@ -458,37 +537,39 @@ Vertex_GetParent(pt_Vertex pv, gqrm_id_t* re)
     return DS_OK;
 }
 
+/* @fn
+ * The edges of "pv", sorted by the id of their other end,
+ * NULL if it has none, which the vector functions take as
+ * empty. They may be shared with copies of "pv", so are
+ * read only.
+ */
 ds_stat
-Vertex_GetEdges(pt_Vertex pv, p_sll* re)
+Vertex_GetEdges(pt_Vertex pv, p_vec* re)
 {
     if (!pv || !re)
         return DS_ERROR;
 
-    *re = pv->edges;
+    *re = edges_of(pv);
     return DS_OK;
 }
 
 ds_stat
 Vertex_DeleteEdge(pt_Vertex pv, gqrm_id_t id)
 {
-    size_t  size, i;
-	pt_Edge pe;
+    size_t     i;
+	pt_Edge    pe;
 
     if (!pv)
 	    return DS_ERROR;
-    size = Vertex_Degree(pv);
-	for (i = 0; i < size; i++) {
-	    if (SingleLinkedList_GetData(pv->edges, i, (sll_data_t*)&pe) == DS_ERROR)
-		    return DS_ERROR;
-		if (pe->end->id == id)
-		    if (SingleLinkedList_Delete(pv->edges, i, NULL) == DS_ERROR) {
-			    return DS_ERROR;
-			} else {
-			    Edge_Free(&pe);
-				return DS_OK;
-			}
-	}
-	return DS_ERROR;
+	i = edge_lower(pv, id);
+	if (i == Vertex_Degree(pv) || ((pt_Edge)Vector_Data(edges_of(pv))[i])->end_id != id)
+	    return DS_ERROR;
+	/* keep the rest in order */
+	if (own_edges(pv) == DS_ERROR ||
+	    Vector_Delete(pv->adj->edges, i, (vec_data_t*)&pe) == DS_ERROR)
+	    return DS_ERROR;
+	Edge_Free(&pe);
+	return DS_OK;
 }
 
 ds_stat
@@ -568,22 +649,20 @@ Vertex_IsSelected(pt_Vertex pv)
 ds_stat
 Vertex_GetEdgeWeight(pt_Vertex pv, gqrm_id_t neighbor, edge_weight_t* w)
 {
-    pt_Edge  pe;
-    size_t   size, i;
+    pt_Edge   pe;
+    size_t    i;
 
 	if (!pv || !w)
 	    return DS_ERROR;
 	
-	size = SingleLinkedList_Size(pv->edges);
-	for (i = 0; i < size; i++) {
-	    if (SingleLinkedList_GetData(pv->edges, i, (sll_data_t*)&pe) == DS_ERROR)
-		    return DS_ERROR;
-		if (neighbor == pe->end->id) {
-		    *w = pe->weight;
-			return DS_OK;
-		}
-	}
-	return DS_ERROR;
+	i = edge_lower(pv, neighbor);
+	if (i == Vertex_Degree(pv))
+	    return DS_ERROR;
+	pe = (pt_Edge)Vector_Data(edges_of(pv))[i];
+	if (pe->end_id != neighbor)
+	    return DS_ERROR;
+	*w = pe->weight;
+	return DS_OK;
 }
 
 ds_stat
@@ -594,29 +673,47 @@ Vertex_PushNeighbor(pt_Vertex pv, pt_Vertex n, edge_weight_t w)
     if (!pe)
         return DS_ERROR;
     
-    return Vertex_PushEdge(pv, pe);
+    if (Vertex_PushEdge(pv, pe) == DS_ERROR) {
+        Edge_Free(&pe);
+        return DS_ERROR;
+    }
+    return DS_OK;
 }
 
+/* @fn
+ * Insert "pe" at its place in the edges of "pv", DS_ERROR if
+ * "pv" already has an edge to the same end. Edges pushed by
+ * increasing end id, as graphs are built, are appended.
+ */
 ds_stat
 Vertex_PushEdge(pt_Vertex pv, pt_Edge pe)
 {
+    size_t   i;
+
     if (!pv || !pe)
         return DS_ERROR;
 
-    if (!SingleLinkedList_Contain(pv->edges, pe, edge_cmp)) {
-        SingleLinkedList_InsertHead(pv->edges, pe);
-        return DS_OK;
-    }
-    return DS_ERROR;
+    i = edge_lower(pv, pe->end_id);
+    if (i < Vertex_Degree(pv) &&
+        ((pt_Edge)Vector_Data(edges_of(pv))[i])->end_id == pe->end_id)
+        return DS_ERROR;
+    if (own_edges(pv) == DS_ERROR)
+        return DS_ERROR;
+    if (i == Vertex_Degree(pv))
+        return Vector_PushBack(pv->adj->edges, pe);
+    return Vector_Insert(pv->adj->edges, i, pe);
 }
 
+/* @fn
+ * Delete the edge to the neighbor with the largest id.
+ */
 ds_stat
 Vertex_PopEdge(pt_Vertex pv)
 {
     pt_Edge pe;
-    if (!pv)
+    if (!pv || Vertex_Degree(pv) == 0 || own_edges(pv) == DS_ERROR)
         return DS_ERROR;
-    if (SingleLinkedList_DeleteHead(pv->edges, (sll_data_t*)&pe) == DS_OK) {
+    if (Vector_PopBack(pv->adj->edges, (vec_data_t*)&pe) == DS_OK) {
         Edge_Free(&pe);
         return DS_OK;
     }
@@ -626,21 +723,16 @@ Vertex_PopEdge(pt_Vertex pv)
 void
 Vertex_ClearEdge(pt_Vertex pv)
 {
-    SingleLinkedList_Clear(pv->edges, edge_clear_op);
-}
-
-static void
-destroy_edges(pt_Vertex pv)
-{
-    SingleLinkedList_Destroy(&pv->edges, edge_clear_op);
+    if (pv)
+        release_edges(pv);
 }
 
 void
 Vertex_Free(pt_Vertex* pv)
 {
-    if (!pv)
+    if (!pv || !*pv)
         return;
-    destroy_edges(*pv);
+    release_edges(*pv);
     free(*pv);
     *pv = NULL;
 }
@@ -650,38 +742,111 @@ Vertex_Degree(pt_Vertex pv)
 {
     if (!pv)
         return 0;
-    return SingleLinkedList_Size(pv->edges);
+    return Vector_Size(edges_of(pv));
 }
 
 ds_bool
 Vertex_IsNeighbor(pt_Vertex pv, pt_Vertex n)
 {
-    pt_Edge pe;
+    size_t    i;
+
     if (!pv || !n)
         return DS_FALSE;
 
-    if ((pe = Edge_Create(n, 0.0)) == NULL)
-        return DS_FALSE;
-    if (SingleLinkedList_Contain(pv->edges, pe, edge_cmp)) {
-        Edge_Free(&pe);
+    i = edge_lower(pv, n->id);
+    if (i < Vertex_Degree(pv) &&
+        ((pt_Edge)Vector_Data(edges_of(pv))[i])->end_id == n->id)
         return DS_TRUE;
-    } else {
-        Edge_Free(&pe);
-        return DS_FALSE;
+    return DS_FALSE;
+}
+
+/* @fn
+ * The position of the first edge of "pv" whose end has an
+ * id not less than "id".
+ */
+static size_t
+edge_lower(pt_Vertex pv, gqrm_id_t id)
+{
+    pt_Edge*  edges = (pt_Edge*)Vector_Data(edges_of(pv));
+    size_t    lo = 0, hi = Vertex_Degree(pv), mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (edges[mid]->end_id < id)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-        
+    return lo;
 }
 
-static int
-edge_cmp(sll_data_t rhs, sll_data_t lhs)
+static p_vec
+edges_of(pt_Vertex pv)
 {
-    if (Edge_Same((pt_Edge)rhs, (pt_Edge)lhs) == DS_TRUE)
-        return 0;
-    return 1;
+    return pv->adj ? pv->adj->edges : NULL;
+}
+
+/* @fn
+ * Make the edges of "pv" its own before changing them:
+ * create them if it has none, copy them if they are shared
+ * with a copy of the vertex.
+ */
+static ds_stat
+own_edges(pt_Vertex pv)
+{
+    adjacency*  adj;
+    pt_Edge*    edges;
+    pt_Edge     pe;
+    size_t      size, i;
+
+    if (pv->adj && pv->adj->refs == 1)
+        return DS_OK;
+    if ((adj = malloc(sizeof(adjacency))) == NULL)
+        return DS_ERROR;
+    adj->edges = NULL;
+    adj->refs  = 1;
+    size = Vertex_Degree(pv);
+    if (Vector_Init(&adj->edges) == DS_ERROR ||
+        Vector_Reserve(adj->edges, size) == DS_ERROR) {
+        Vector_Destroy(&adj->edges, NULL);
+        free(adj);
+        return DS_ERROR;
+    }
+    edges = (pt_Edge*)Vector_Data(edges_of(pv));
+    for (i = 0; i < size; i++) {
+        if ((pe = malloc(sizeof(Edge))) == NULL) {
+            Vector_Destroy(&adj->edges, edge_clear_op);
+            free(adj);
+            return DS_ERROR;
+        }
+        /* "end" may be gone, so copy rather than Edge_Create() */
+        *pe = *edges[i];
+        /* cannot fail, the vector is reserved */
+        Vector_PushBack(adj->edges, pe);
+    }
+    release_edges(pv);
+    pv->adj = adj;
+    return DS_OK;
+}
+
+/* @fn
+ * Drop the reference of "pv" to its edges, freeing them
+ * with the last one.
+ */
+static void
+release_edges(pt_Vertex pv)
+{
+    if (!pv->adj)
+        return;
+    if (--pv->adj->refs == 0) {
+        Vector_Destroy(&pv->adj->edges, edge_clear_op);
+        free(pv->adj);
+    }
+    pv->adj = NULL;
 }
 
 static void
-edge_clear_op(sll_data_t* e)
+edge_clear_op(vec_data_t* e)
 {
     pt_Edge* pe;
     if (!e)
@@ -701,7 +866,7 @@ ALGraph_Create(void)
 	}
 	pg->vertices = NULL;
 
-    if (SingleLinkedList_Init(&pg->vertices) == DS_ERROR) {
+    if (Vector_Init(&pg->vertices) == DS_ERROR) {
         free(pg);
         return NULL;
     }
@@ -722,34 +887,248 @@ ds_stat
 ALGraph_Init(pt_ALGraph pg, p_sll init_list, is_neighbor func)
 {
     size_t           i, j, size;
-    graph_data_t     data;
-    pt_Vertex        pv, pi, pj;
+    pt_Vertex*       vs;
     edge_weight_t    w;
 
     if (!pg || !init_list)
         return DS_ERROR;
 
+    METRIC_TIMER_BEGIN(t0);
     size = SingleLinkedList_Size(init_list);
-    for (i = 0; i < size; i++) {
-        if (SingleLinkedList_GetData(init_list, i, &data) == DS_ERROR)
-            return error_clear(pg);
-        if ((pv = Vertex_CreateMediate(i, data, VERTEX_WEIGHT_INF)) == NULL)
-            return error_clear(pg);
-        if (SingleLinkedList_InsertTail(pg->vertices, pv) == DS_ERROR)
-            return error_clear(pg);
-    }
+    if (push_vertices(pg, init_list) == DS_ERROR)
+        return error_clear(pg);
 
+    vs = (pt_Vertex*)Vector_Data(pg->vertices);
     for (i = 0; i < size; i++)
         for (j = 0; j < size; j++)
             if (i != j) {
-                if (SingleLinkedList_GetData(pg->vertices, i, (sll_data_t*)&pi) == DS_ERROR)
-                    return error_clear(pg);
-                if (SingleLinkedList_GetData(pg->vertices, j, (sll_data_t*)&pj) == DS_ERROR)
-                    return error_clear(pg);
-                if ((w = func(pi->data, pj->data)) > 0.0)
-                    if (Vertex_PushNeighbor(pi, pj, w) == DS_ERROR)
+                METRIC_INC(METRIC_PAIR_TESTS);
+                if ((w = func(vs[i]->data, vs[j]->data)) > 0.0)
+                    if (Vertex_PushNeighbor(vs[i], vs[j], w) == DS_ERROR)
                         return error_clear(pg);
             }
+    METRIC_INC(METRIC_GRAPH_BUILDS);
+    METRIC_TIMER_END(TIMER_GRAPH_BUILD, t0);
+    return DS_OK;
+}
+
+/* @fn 
+ * Parallel counterpart of ALGraph_Init(). Rows are split in
+ * blocks which the workers of "pool" fill independently; the
+ * blocks are then concatenated in row order and the graph is
+ * assembled by the calling thread, so the result is the same
+ * as ALGraph_Init() whatever the number of threads.
+ *
+ * @param pg An empty graph to be initialized.
+ * @param init_list The list storing all data.
+ * @param func A callback function to determine whether
+ *        two vertices are neighbors in this graph. It is
+ *        called concurrently and MUST be thread-safe.
+ * @param pool The workers to use, NULL to run inline.
+ */
+ds_stat
+ALGraph_ParallelInit(pt_ALGraph pg, p_sll init_list, is_neighbor func,
+                     pt_ThreadPool pool)
+{
+    parallel_init_arg   arg;
+    sll_iter            it;
+    size_t              nblocks, nworkers, b, i, k, nnz;
+    size_t*             row;
+    size_t*             col;
+    edge_weight_t*      w;
+    ds_stat             re;
+
+    if (!pg || !init_list || !func)
+        return DS_ERROR;
+
+    arg.size = SingleLinkedList_Size(init_list);
+    arg.func = func;
+    if (arg.size == 0)
+        return DS_OK;
+    METRIC_TIMER_BEGIN(t0);
+    nblocks  = (arg.size + INIT_BLOCK_ROWS - 1) / INIT_BLOCK_ROWS;
+    nworkers = ThreadPool_Size(pool);
+    arg.data   = malloc(arg.size * sizeof(graph_data_t));
+    arg.blocks = calloc(nblocks, sizeof(adjacency_block));
+    arg.failed = calloc(nworkers, sizeof(char));
+    if (!arg.data || !arg.blocks || !arg.failed)
+        return parallel_error(&arg, 0);
+    SingleLinkedList_Begin(init_list, &it);
+    for (i = 0; SingleLinkedList_Next(&it, &arg.data[i]) == DS_TRUE; i++) ;
+
+    ThreadPool_ParallelFor(pool, nblocks, 1, init_blocks, &arg);
+
+    for (i = 0; i < nworkers; i++)
+        if (arg.failed[i])
+            return parallel_error(&arg, nblocks);
+    for (b = 0, nnz = 0; b < nblocks; b++)
+        nnz += arg.blocks[b].nnz;
+
+    /* concatenate the blocks into one adjacency */
+    row = malloc((arg.size + 1) * sizeof(size_t));
+    col = malloc((nnz ? nnz : 1) * sizeof(size_t));
+    w   = malloc((nnz ? nnz : 1) * sizeof(edge_weight_t));
+    if (!row || !col || !w) {
+        free(row);
+        free(col);
+        free(w);
+        return parallel_error(&arg, nblocks);
+    }
+    row[0] = 0;
+    for (b = 0, i = 0, nnz = 0; b < nblocks; b++) {
+        for (k = 0; k < arg.blocks[b].nnz; k++) {
+            col[nnz + k] = arg.blocks[b].cols[k];
+            w[nnz + k]   = arg.blocks[b].weights[k];
+        }
+        nnz += arg.blocks[b].nnz;
+        for (k = 0; i < arg.size && k < INIT_BLOCK_ROWS; k++, i++)
+            row[i + 1] = row[i] + arg.blocks[b].counts[k];
+    }
+    free_blocks(&arg, nblocks);
+
+    re = ALGraph_InitAdjacency(pg, init_list, row, col, w);
+    free(row);
+    free(col);
+    free(w);
+    METRIC_INC(METRIC_GRAPH_BUILDS);
+    METRIC_TIMER_END(TIMER_GRAPH_BUILD, t0);
+    return re;
+}
+
+/* @fn
+ * Worker of ALGraph_ParallelInit(): fill blocks [begin, end).
+ */
+static void
+init_blocks(size_t begin, size_t end, size_t worker, void* p)
+{
+    parallel_init_arg*  arg = (parallel_init_arg*)p;
+    adjacency_block*    blk;
+    size_t              b, i, j, last;
+    edge_weight_t       w;
+
+    for (b = begin; b < end && !arg->failed[worker]; b++) {
+        blk  = &arg->blocks[b];
+        last = (b + 1) * INIT_BLOCK_ROWS;
+        if (last > arg->size)
+            last = arg->size;
+        if ((blk->counts = calloc(INIT_BLOCK_ROWS, sizeof(size_t))) == NULL) {
+            arg->failed[worker] = 1;
+            break;
+        }
+        METRIC_ADD(METRIC_PAIR_TESTS, (last - b * INIT_BLOCK_ROWS) * (arg->size - 1));
+        for (i = b * INIT_BLOCK_ROWS; i < last && !arg->failed[worker]; i++)
+            for (j = 0; j < arg->size; j++)
+                if (i != j && (w = arg->func(arg->data[i], arg->data[j])) > 0.0) {
+                    if (block_push(blk, j, w) == DS_ERROR) {
+                        arg->failed[worker] = 1;
+                        break;
+                    }
+                    blk->counts[i - b * INIT_BLOCK_ROWS]++;
+                }
+    }
+}
+
+static ds_stat
+block_push(adjacency_block* blk, size_t col, edge_weight_t w)
+{
+    size_t            cap;
+    size_t*           cols;
+    edge_weight_t*    weights;
+
+    if (blk->nnz == blk->cap) {
+        cap = blk->cap ? blk->cap * 2 : 256;
+        if ((cols = realloc(blk->cols, cap * sizeof(size_t))) == NULL)
+            return DS_ERROR;
+        blk->cols = cols;
+        if ((weights = realloc(blk->weights, cap * sizeof(edge_weight_t))) == NULL)
+            return DS_ERROR;
+        blk->weights = weights;
+        blk->cap     = cap;
+    }
+    blk->cols[blk->nnz]    = col;
+    blk->weights[blk->nnz] = w;
+    blk->nnz++;
+    return DS_OK;
+}
+
+static ds_stat
+parallel_error(parallel_init_arg* arg, size_t nblocks)
+{
+    free_blocks(arg, nblocks);
+    return DS_ERROR;
+}
+
+/* @fn
+ * Release the scratch of ALGraph_ParallelInit().
+ */
+static void
+free_blocks(parallel_init_arg* arg, size_t nblocks)
+{
+    size_t   b;
+
+    if (arg->blocks)
+        for (b = 0; b < nblocks; b++) {
+            free(arg->blocks[b].counts);
+            free(arg->blocks[b].cols);
+            free(arg->blocks[b].weights);
+        }
+    free(arg->blocks);
+    free(arg->failed);
+    free(arg->data);
+}
+
+/* @fn
+ * Initialize an empty graph from precomputed adjacency in
+ * compressed sparse row form instead of testing every pair
+ * through a callback. The neighbors of the "i"th vertex are
+ * col[row[i]] ... col[row[i + 1] - 1], in ascending order,
+ * with edge weights w[row[i]] ... w[row[i + 1] - 1]. The
+ * resulting graph is identical to the one ALGraph_Init()
+ * builds when the callback agrees with the adjacency.
+ *
+ * @param pg An empty graph to be initialized.
+ * @param init_list The list storing all data.
+ * @param row Row offsets, size(init_list) + 1 entries.
+ * @param col Column (vertex index) of each edge.
+ * @param w Weight of each edge.
+ */
+ds_stat
+ALGraph_InitAdjacency(pt_ALGraph pg, p_sll init_list, const size_t* row,
+                      const size_t* col, const edge_weight_t* w)
+{
+    size_t           i, k, size;
+    pt_Vertex*       vs;
+    pt_Edge          pe;
+
+    if (!pg || !init_list || !row)
+        return DS_ERROR;
+
+    size = SingleLinkedList_Size(init_list);
+    if (size == 0)
+        return DS_OK;
+    if (row[size] && (!col || !w))
+        return DS_ERROR;
+    if (push_vertices(pg, init_list) == DS_ERROR)
+        return error_clear(pg);
+
+    vs = (pt_Vertex*)Vector_Data(pg->vertices);
+    for (i = 0; i < size; i++) {
+        if (row[i + 1] == row[i])
+            continue;
+        if (own_edges(vs[i]) == DS_ERROR ||
+            Vector_Reserve(vs[i]->adj->edges, row[i + 1] - row[i]) == DS_ERROR)
+            return error_clear(pg);
+        for (k = row[i]; k < row[i + 1]; k++) {
+            assert(col[k] < size && col[k] != i);
+            /* ids follow the index, so the row is already sorted */
+            assert(k == row[i] || col[k] > col[k - 1]);
+            /* rows carry no duplicates, so skip the containment check */
+            if ((pe = Edge_Create(vs[col[k]], w[k])) == NULL)
+                return error_clear(pg);
+            /* cannot fail, the row is reserved */
+            Vector_PushBack(vs[i]->adj->edges, pe);
+        }
+    }
     return DS_OK;
 }
 
@@ -758,43 +1137,36 @@ ALGraph_Size(pt_ALGraph pg)
 {
     if (!pg || !pg->vertices)
 	    return 0;
-    return SingleLinkedList_Size(pg->vertices);
+    return Vector_Size(pg->vertices);
 }
 
 ds_bool
 ALGraph_ContainVertexID(pt_ALGraph pg, gqrm_id_t id)
 {
-    size_t     i, size;
 	pt_Vertex  iter;
-	if (!pg || !pg->vertices)
-	    return DS_FALSE;
-	size = ALGraph_Size(pg);
-	for (i = 0; i < size; i++) {
-	    if (ALGraph_GetVertex(pg, i, &iter) == DS_ERROR)
-		    return DS_FALSE;
-		if (iter->id == id)
-		    return DS_TRUE;
-	}
+
+	if (ALGraph_GetVertexByID(pg, id, &iter) == DS_OK)
+	    return DS_TRUE;
 	return DS_FALSE;
 }
 
 ds_bool
 ALGraph_ContainVertex(pt_ALGraph pg, pt_Vertex pv)
 {
-    size_t      i, size;
-	pt_Vertex   iter;
-    if (!pg || !pg->vertices || !pv)
+    if (!pv)
 	    return DS_FALSE;
-	size = ALGraph_Size(pg);
-	for (i = 0;i < size; i++) {
-	    if (ALGraph_GetVertex(pg, i, &iter) == DS_ERROR)
-		    return DS_FALSE;
-		if (Vertex_Same(iter, pv) == DS_TRUE)
-		    return DS_TRUE;
-	}
-	return DS_FALSE;
+	return ALGraph_ContainVertexID(pg, pv->id);
 }
 
+/* @fn
+ * Snapshot "pg": every vertex is copied, with its weight,
+ * parent and status, but the edges are shared with "pg" and
+ * copied vertex by vertex only when either graph changes
+ * them. A copy thus costs O(V) rather than O(V + E), and
+ * trying alternatives from one base graph only pays for the
+ * edges each alternative touches. Either graph may be freed
+ * first.
+ */
 pt_ALGraph
 ALGraph_Copy(pt_ALGraph pg)
 {
@@ -808,24 +1180,20 @@ ALGraph_Copy(pt_ALGraph pg)
     if ((cpy = ALGraph_Create()) == NULL)
 	    return NULL;
 
-    size = SingleLinkedList_Size(pg->vertices);
+    size = Vector_Size(pg->vertices);
+	if (Vector_Reserve(cpy->vertices, size) == DS_ERROR) {
+	    ALGraph_Free(&cpy);
+		return NULL;
+	}
 	for (i = 0; i <size; i++) {
-	    if (SingleLinkedList_GetData(pg->vertices, i, (sll_data_t*)&tmp) == DS_ERROR) {
-		    ALGraph_Free(&cpy);
-			return NULL;
-		}
+	    tmp = (pt_Vertex)Vector_Data(pg->vertices)[i];
 	    if ((pv = Vertex_CreateMediate(0, NULL, 0)) == NULL) {
 		    ALGraph_Free(&cpy);
 			return NULL;
 		}
-		if (Vertex_Assign(pv, tmp) == DS_ERROR) {
-		    ALGraph_Free(&cpy);
-			return NULL;
-		}
-		if (SingleLinkedList_InsertTail(cpy->vertices, pv) == DS_ERROR) {
-		    ALGraph_Free(&cpy);
-			return NULL;
-		}
+		/* cannot fail: both exist, and the vector is reserved */
+		Vertex_Assign(pv, tmp);
+		Vector_PushBack(cpy->vertices, pv);
 	}
 	return cpy;
 }
@@ -835,29 +1203,33 @@ ALGraph_GetVertex(pt_ALGraph pg, size_t index, pt_Vertex* re)
 {
     if (!pg || !pg->vertices || !re)
 	    return DS_ERROR;
-	return SingleLinkedList_GetData(pg->vertices, index, (sll_data_t*)re);
+	return Vector_GetData(pg->vertices, index, (vec_data_t*)re);
 }
 
+/* @fn
+ * Find a vertex by id. Graphs built by ALGraph_Init() give
+ * the "i"th vertex id "i", which is tried first in O(1);
+ * other graphs, e.g. trees, are scanned.
+ */
 ds_stat
 ALGraph_GetVertexByID(pt_ALGraph pg, gqrm_id_t id, pt_Vertex* re)
 {
-    pt_Vertex    pv;
+    pt_Vertex*   vs;
 	size_t       size, i;
-	gqrm_id_t    cmp;
 
     if (!pg || !pg->vertices || !re)
 	    return DS_ERROR;
 	size = ALGraph_Size(pg);
-	for (i = 0; i < size; i++) {
-	    if (ALGraph_GetVertex(pg, i, &pv) == DS_ERROR)
-		    return DS_ERROR;
-		if (Vertex_GetID(pv, &cmp) == DS_ERROR)
-		    return DS_ERROR;
-		if (id == cmp) {
-		    *re = pv;
+	vs   = (pt_Vertex*)Vector_Data(pg->vertices);
+	if (id >= 0 && (size_t)id < size && vs[id]->id == id) {
+	    *re = vs[id];
+		return DS_OK;
+	}
+	for (i = 0; i < size; i++)
+		if (vs[i]->id == id) {
+		    *re = vs[i];
 			return DS_OK;
 		}
-	}
 	return DS_ERROR;
 }
 
@@ -865,13 +1237,10 @@ ds_stat
 ALGraph_PushVertex(pt_ALGraph pg, pt_Vertex pv)
 {
     if (!pg || !pv) {
-	    if (!pg)
-            printf("func: %s, line: %d\n", __func__, __LINE__);
-		else
-            printf("func: %s, line: %d\n", __func__, __LINE__);
+        TRACE_ERROR(TRACE_GRAPH, pg ? "no vertex to push" : "no graph to push to");
 	    return DS_ERROR;
 	}
-	return SingleLinkedList_InsertTail(pg->vertices, pv);
+	return Vector_PushBack(pg->vertices, pv);
 }
 
 ds_stat
@@ -879,7 +1248,7 @@ ALGraph_PopVertex(pt_ALGraph pg, pt_Vertex* re)
 {
     if (!pg)
 	    return DS_ERROR;
-	return SingleLinkedList_DeleteTail(pg->vertices, (sll_data_t*)re);
+	return Vector_PopBack(pg->vertices, (vec_data_t*)re);
 }
 
 void
@@ -888,22 +1257,46 @@ ALGraph_Free(pt_ALGraph* pg)
     if (!*pg)
 	    return;
 	if ((*pg)->vertices)
-	    SingleLinkedList_Destroy(&(*pg)->vertices, vertex_clear_op);
+	    Vector_Destroy(&(*pg)->vertices, vertex_clear_op);
 	free(*pg);
 	*pg = NULL;
 }
 
+/* @fn
+ * Append a vertex per element of "init_list" to "pg", the
+ * "i"th one getting id "i".
+ */
+static ds_stat
+push_vertices(pt_ALGraph pg, p_sll init_list)
+{
+    sll_iter         it;
+    graph_data_t     data;
+    pt_Vertex        pv;
+    gqrm_id_t        id = (gqrm_id_t)ALGraph_Size(pg);
+
+    if (Vector_Reserve(pg->vertices, id + SingleLinkedList_Size(init_list)) == DS_ERROR)
+        return DS_ERROR;
+    SingleLinkedList_Begin(init_list, &it);
+    while (SingleLinkedList_Next(&it, &data) == DS_TRUE) {
+        if ((pv = Vertex_CreateMediate(id++, data, VERTEX_WEIGHT_INF)) == NULL)
+            return DS_ERROR;
+        /* cannot fail, the vertices are reserved */
+        Vector_PushBack(pg->vertices, pv);
+    }
+    return DS_OK;
+}
+
 static ds_stat
 error_clear(pt_ALGraph pg)
 {
     if (!pg)
         return DS_ERROR;
-    SingleLinkedList_Clear(pg->vertices, vertex_clear_op);
+    Vector_Clear(pg->vertices, vertex_clear_op);
     return DS_ERROR;
 }
 
 void
-vertex_clear_op(sll_data_t* v)
+vertex_clear_op(vec_data_t* v)
 {
     pt_Vertex* pv;
     if (!v)
@@ -922,17 +1315,16 @@ ALGraph_Print(pt_ALGraph pg, FILE* fp)
     if (!pg || !fp)
         return DS_ERROR;
 
-    v_size = SingleLinkedList_Size(pg->vertices);
+    v_size = Vector_Size(pg->vertices);
     for (i = 0; i < v_size; i++) {
-        if (SingleLinkedList_GetData(pg->vertices, i, (sll_data_t*)&pv) == DS_ERROR)
-            return DS_ERROR;
+        pv = (pt_Vertex)Vector_Data(pg->vertices)[i];
         fprintf(fp, "id: %4ld, weight: %3d, parent: %4ld, edges: ", pv->id, pv->weight, pv->parent);
-        e_size = SingleLinkedList_Size(pv->edges);
+        e_size = Vertex_Degree(pv);
         for (j = 0; j < e_size; j++) {
-            if (SingleLinkedList_GetData(pv->edges, j, (sll_data_t*)&pe) == DS_ERROR)
-                return DS_ERROR;
-            fprintf(fp, "->(id: %4ld, weight: %2.4lf) ", pe->end->id, pe->weight);
+            pe = (pt_Edge)Vector_Data(edges_of(pv))[j];
+            fprintf(fp, "->(id: %4ld, weight: %2.4lf) ", pe->end_id, pe->weight);
         }
         fprintf(fp, "\n");
     }
+    return DS_OK;
 }
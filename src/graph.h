@@ -26,7 +26,11 @@
 #include <assert.h>
 
 #include "header.h"
+#include "metrics.h"
+#include "trace.h"
 #include "single_linked_list.h"
+#include "vector.h"
+#include "thread_pool.h"
 
 #define VERTEX_WEIGHT_INF    999
 
@@ -75,7 +79,7 @@ extern ds_stat   Vertex_GetData(pt_Vertex, graph_data_t*);
 extern ds_stat   Vertex_GetID(pt_Vertex, gqrm_id_t*);
 extern ds_stat   Vertex_GetWeight(pt_Vertex, vertex_weight_t*);
 extern ds_stat   Vertex_GetParent(pt_Vertex, gqrm_id_t*);
-extern ds_stat   Vertex_GetEdges(pt_Vertex, p_sll*);
+extern ds_stat   Vertex_GetEdges(pt_Vertex, p_vec*);
 extern ds_stat   Vertex_SetData(pt_Vertex, graph_data_t);
 extern ds_stat   Vertex_SetWeight(pt_Vertex, vertex_weight_t);
 extern ds_stat   Vertex_SetParent(pt_Vertex, gqrm_id_t);
@@ -92,11 +96,13 @@ extern size_t    Vertex_Degree(pt_Vertex);
 extern ds_stat   Vertex_PopEdge(pt_Vertex);
 extern void      Vertex_ClearEdge(pt_Vertex);
 extern void      Vertex_Free(pt_Vertex*);
-extern void      vertex_clear_op(sll_data_t* v);
+extern void      vertex_clear_op(vec_data_t* v);
 
 
 extern pt_ALGraph    ALGraph_Create(void);
 extern ds_stat       ALGraph_Init(pt_ALGraph, p_sll, is_neighbor);
+extern ds_stat       ALGraph_ParallelInit(pt_ALGraph, p_sll, is_neighbor, pt_ThreadPool);
+extern ds_stat       ALGraph_InitAdjacency(pt_ALGraph, p_sll, const size_t*, const size_t*, const edge_weight_t*);
 extern ds_stat       ALGraph_Print(pt_ALGraph, FILE*);
 extern size_t        ALGraph_Size(pt_ALGraph);
 extern void          ALGraph_Free(pt_ALGraph*);
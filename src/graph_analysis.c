@@ -0,0 +1,272 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graph_analysis.h"
+
+static size_t  neighbor_count(pt_BFSGraph, size_t);
+static size_t  neighbor_at(pt_BFSGraph, size_t, size_t);
+static size_t  intersect(const gqrm_id_t*, const size_t*, size_t, size_t);
+static void    free_all(void*, void*, void*, void*);
+
+/* @fn
+ * Set cut[i] to 1 if removing the "i"th vertex leaves more
+ * connected components, links taken both ways, and to 0
+ * otherwise. Removed vertices are never cut vertices.
+ *
+ * @param removed The mask of removed vertices, or NULL.
+ */
+ds_stat
+GraphAnalysis_ArticulationPoints(pt_BFSGraph g, const char* removed, char* cut)
+{
+    size_t*    disc;
+    size_t*    low;
+    size_t*    pos;
+    size_t*    stack;
+    gqrm_id_t* parent;
+    size_t     n, r, v, w, p, top, time = 0, root_children;
+
+    if (!g || !cut)
+        return DS_ERROR;
+    n = BFSGraph_Size(g);
+    disc   = calloc(n ? n : 1, sizeof(size_t));
+    low    = malloc((n ? n : 1) * sizeof(size_t));
+    pos    = calloc(n ? n : 1, sizeof(size_t));
+    stack  = malloc((n ? n : 1) * sizeof(size_t));
+    parent = malloc((n ? n : 1) * sizeof(gqrm_id_t));
+    if (!disc || !low || !pos || !stack || !parent) {
+        free(parent);
+        free_all(disc, low, pos, stack);
+        return DS_ERROR;
+    }
+    for (v = 0; v < n; v++)
+        cut[v] = 0;
+
+    for (r = 0; r < n; r++) {
+        if ((removed && removed[r]) || disc[r])
+            continue;
+        disc[r] = low[r] = ++time;
+        parent[r] = -1;
+        stack[0]  = r;
+        top = 1;
+        root_children = 0;
+        while (top) {
+            v = stack[top - 1];
+            if (pos[v] < neighbor_count(g, v)) {
+                w = neighbor_at(g, v, pos[v]++);
+                if (removed && removed[w])
+                    continue;
+                if (!disc[w]) {
+                    disc[w] = low[w] = ++time;
+                    parent[w] = (gqrm_id_t)v;
+                    stack[top++] = w;
+                    if (v == r)
+                        root_children++;
+                } else if ((gqrm_id_t)w != parent[v] && disc[w] < low[v]) {
+                    low[v] = disc[w];
+                }
+                continue;
+            }
+            /* "v" is done, hand its low point to its parent */
+            top--;
+            if (parent[v] < 0)
+                continue;
+            p = (size_t)parent[v];
+            if (low[v] < low[p])
+                low[p] = low[v];
+            if (p != r && low[v] >= disc[p])
+                cut[p] = 1;
+        }
+        if (root_children >= 2)
+            cut[r] = 1;
+    }
+    free(parent);
+    free_all(disc, low, pos, stack);
+    return DS_OK;
+}
+
+/* @fn
+ * Set idom[i] to the immediate dominator of the "i"th
+ * vertex from vertex "src", i.e. the closest vertex all
+ * paths from "src" to it go through, or -1 for "src" and the
+ * vertices not reached.
+ *
+ * The vertices are numbered in postorder of a depth-first
+ * search from "src", then every vertex takes, in reverse
+ * postorder, the common dominator of its in-neighbors
+ * already given one, found by walking both up the current
+ * tree, until nothing changes.
+ *
+ * @param removed The mask of removed vertices, or NULL.
+ */
+ds_stat
+GraphAnalysis_Dominators(pt_BFSGraph g, size_t src, const char* removed, gqrm_id_t* idom)
+{
+    size_t*         po;
+    size_t*         order;
+    size_t*         pos;
+    size_t*         stack;
+    const size_t*   cols;
+    size_t          n, v, u, k, j, deg, top, n_order = 0;
+    gqrm_id_t       best;
+    ds_bool         changed;
+
+    if (!g || !idom || src >= BFSGraph_Size(g) || (removed && removed[src]))
+        return DS_ERROR;
+    n = BFSGraph_Size(g);
+    po    = malloc(n * sizeof(size_t));
+    order = malloc(n * sizeof(size_t));
+    pos   = calloc(n, sizeof(size_t));
+    stack = malloc(n * sizeof(size_t));
+    if (!po || !order || !pos || !stack) {
+        free_all(po, order, pos, stack);
+        return DS_ERROR;
+    }
+    for (v = 0; v < n; v++)
+        idom[v] = -1;
+
+    /* postorder; idom[] doubles as the visited mark */
+    idom[src] = (gqrm_id_t)src;
+    stack[0]  = src;
+    top = 1;
+    while (top) {
+        v   = stack[top - 1];
+        deg = BFSGraph_OutEdges(g, v, &cols, NULL);
+        if (pos[v] < deg) {
+            u = cols[pos[v]++];
+            if ((removed && removed[u]) || idom[u] != -1)
+                continue;
+            idom[u] = (gqrm_id_t)u;
+            stack[top++] = u;
+            continue;
+        }
+        top--;
+        po[v] = n_order;
+        order[n_order++] = v;
+    }
+    for (k = 0; k < n_order; k++)
+        if (order[k] != src)
+            idom[order[k]] = -1;
+
+    do {
+        changed = DS_FALSE;
+        /* reverse postorder, "src" last in "order" */
+        for (k = n_order - 1; k-- > 0; ) {
+            v    = order[k];
+            best = -1;
+            deg  = BFSGraph_InEdges(g, v, &cols);
+            for (j = 0; j < deg; j++) {
+                u = cols[j];
+                if ((removed && removed[u]) || idom[u] == -1)
+                    continue;
+                best = best == -1 ? (gqrm_id_t)u : (gqrm_id_t)intersect(idom, po, u, (size_t)best);
+            }
+            if (best != idom[v]) {
+                idom[v] = best;
+                changed = DS_TRUE;
+            }
+        }
+    } while (changed == DS_TRUE);
+    idom[src] = -1;
+    free_all(po, order, pos, stack);
+    return DS_OK;
+}
+
+/* @fn
+ * Set re[i] to 1 if the "i"th vertex is on every path from
+ * "src" to one of the "n" destinations "dsts", other than
+ * "src" and that destination, and to 0 otherwise. The
+ * destinations not reached mark nothing.
+ *
+ * @param removed The mask of removed vertices, or NULL.
+ */
+ds_stat
+GraphAnalysis_Separators(pt_BFSGraph g, size_t src, const size_t* dsts, size_t n,
+                         const char* removed, char* re)
+{
+    gqrm_id_t*   idom;
+    gqrm_id_t    x;
+    size_t       size, i;
+
+    if (!g || !re || (n && !dsts))
+        return DS_ERROR;
+    size = BFSGraph_Size(g);
+    if ((idom = malloc((size ? size : 1) * sizeof(gqrm_id_t))) == NULL)
+        return DS_ERROR;
+    if (GraphAnalysis_Dominators(g, src, removed, idom) == DS_ERROR) {
+        free(idom);
+        return DS_ERROR;
+    }
+    for (i = 0; i < size; i++)
+        re[i] = 0;
+    /* up the dominator tree, down to what is already marked */
+    for (i = 0; i < n; i++)
+        for (x = idom[dsts[i]]; x >= 0 && (size_t)x != src && !re[x]; x = idom[x])
+            re[x] = 1;
+    free(idom);
+    return DS_OK;
+}
+
+/*
+ * The neighbors of "v" with links taken both ways: its
+ * out-neighbors, then its in-neighbors.
+ */
+static size_t
+neighbor_count(pt_BFSGraph g, size_t v)
+{
+    return BFSGraph_OutEdges(g, v, NULL, NULL) + BFSGraph_InEdges(g, v, NULL);
+}
+
+static size_t
+neighbor_at(pt_BFSGraph g, size_t v, size_t k)
+{
+    const size_t*   cols;
+    size_t          deg = BFSGraph_OutEdges(g, v, &cols, NULL);
+
+    if (k < deg)
+        return cols[k];
+    BFSGraph_InEdges(g, v, &cols);
+    return cols[k - deg];
+}
+
+/*
+ * The closest common ancestor of "a" and "b" in the tree of
+ * "idom", walking up from the one with the lower postorder
+ * number.
+ */
+static size_t
+intersect(const gqrm_id_t* idom, const size_t* po, size_t a, size_t b)
+{
+    while (a != b) {
+        while (po[a] < po[b])
+            a = (size_t)idom[a];
+        while (po[b] < po[a])
+            b = (size_t)idom[b];
+    }
+    return a;
+}
+
+static void
+free_all(void* p1, void* p2, void* p3, void* p4)
+{
+    free(p1);
+    free(p2);
+    free(p3);
+    free(p4);
+}
@@ -0,0 +1,55 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file graph_analysis.h
+ *
+ * Structural analysis of a BFSGraph: which vertices every
+ * path between others has to go through.
+ *
+ * GraphAnalysis_ArticulationPoints() finds the cut vertices
+ * of the graph with links taken both ways, by Tarjan's
+ * depth-first search, in O(V + E). GraphAnalysis_Dominators()
+ * gives the immediate dominator of every vertex reached from
+ * a source over the directed links, by the iterative method
+ * of Cooper, Harvey and Kennedy, which takes a few passes in
+ * reverse postorder on graphs like ours. A vertex that
+ * dominates a destination cannot be removed without cutting
+ * the destination off, whatever else is removed later:
+ * GraphAnalysis_Separators() marks them all.
+ *
+ * Every function takes an optional mask of removed vertices,
+ * seen as absent from the graph. Vertices are BFSGraph
+ * indices.
+ */
+
+#ifndef GQRM_GRAPH_ANALYSIS_H
+#define GQRM_GRAPH_ANALYSIS_H
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "header.h"
+#include "graph.h"
+#include "bfs.h"
+
+extern ds_stat GraphAnalysis_ArticulationPoints(pt_BFSGraph, const char*, char*);
+extern ds_stat GraphAnalysis_Dominators(pt_BFSGraph, size_t, const char*, gqrm_id_t*);
+extern ds_stat GraphAnalysis_Separators(pt_BFSGraph, size_t, const size_t*, size_t, const char*, char*);
+#endif
@@ -0,0 +1,295 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "metrics.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define METRICS_RDTSC
+#endif
+
+__thread pt_MetricsBlock   metrics_local = NULL;
+
+/*
+ * The blocks of the live threads, newest first, the counts
+ * of the threads gone, and the blocks they left for reuse;
+ * all guarded by "lock". The key frees a block at thread
+ * exit.
+ */
+static pthread_mutex_t     lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t      once = PTHREAD_ONCE_INIT;
+static pthread_key_t       key;
+static pt_MetricsBlock     blocks = NULL;
+static pt_MetricsBlock     spare = NULL;
+static MetricsBlock        retired;
+static size_t              allocated = 0;
+
+static const char*  counter_names[METRIC_COUNT] = {
+    "prr_calls", "pair_tests", "graph_builds", "spt_pops",
+    "spt_relaxations", "feasibility_checks", "prune_attempts",
+    "prune_removals", "prune_skips", "sptirp_rebuilds", "sim_events",
+    "sim_collisions"
+};
+
+static const char*  timer_names[TIMER_COUNT] = {
+    "graph_build", "spt", "feasibility", "sptirp", "simulate"
+};
+
+static double  cycles_per_ms(void);
+static void    make_key(void);
+static void    retire(void*);
+static void    add_block(pt_MetricsBlock, pt_MetricsBlock);
+
+/* @fn
+ * Give the calling thread a block, reusing one left by a
+ * thread gone if any. This happens once per thread, so the
+ * lock is not on the counting path.
+ */
+pt_MetricsBlock
+Metrics_Local(void)
+{
+    pt_MetricsBlock   b;
+
+    if (metrics_local)
+        return metrics_local;
+    pthread_once(&once, make_key);
+    pthread_mutex_lock(&lock);
+    if ((b = spare) != NULL)
+        spare = b->next;
+    else if ((b = calloc(1, sizeof(MetricsBlock))) != NULL)
+        allocated++;
+    if (b) {
+        b->next = blocks;
+        blocks  = b;
+    }
+    pthread_mutex_unlock(&lock);
+    if (!b) {
+        /* count into a throwaway block rather than crash */
+        static __thread MetricsBlock   fallback;
+        return &fallback;
+    }
+    pthread_setspecific(key, b);
+    metrics_local = b;
+    return b;
+}
+
+/* @fn
+ * The number of blocks allocated so far, which is at most
+ * the number of threads ever counting at the same time.
+ */
+size_t
+Metrics_Blocks(void)
+{
+    size_t   n;
+
+    pthread_mutex_lock(&lock);
+    n = allocated;
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+/* @fn
+ * Read the time stamp counter, or nanoseconds where there
+ * is none.
+ */
+uint64_t
+Metrics_Cycles(void)
+{
+#ifdef METRICS_RDTSC
+    return __rdtsc();
+#else
+    struct timespec   ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* @fn
+ * Sum the blocks of all threads into "re". Counts made by
+ * other threads while summing may or may not be included.
+ */
+void
+Metrics_Snapshot(pt_MetricsBlock re)
+{
+    pt_MetricsBlock   b;
+
+    if (!re)
+        return;
+    memset(re, 0, sizeof(MetricsBlock));
+    pthread_mutex_lock(&lock);
+    add_block(re, &retired);
+    for (b = blocks; b; b = b->next)
+        add_block(re, b);
+    pthread_mutex_unlock(&lock);
+    re->next = NULL;
+}
+
+/* @fn
+ * Zero all blocks, e.g. between two runs. Must not run
+ * concurrently with instrumented code.
+ */
+void
+Metrics_Reset(void)
+{
+    pt_MetricsBlock   b;
+
+    pthread_mutex_lock(&lock);
+    memset(&retired, 0, sizeof(retired));
+    for (b = blocks; b; b = b->next) {
+        memset(b->counters, 0, sizeof(b->counters));
+        memset(b->cycles, 0, sizeof(b->cycles));
+        memset(b->calls, 0, sizeof(b->calls));
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+/* @fn
+ * Print the sum over all threads as a table.
+ */
+void
+Metrics_Report(FILE* fp)
+{
+    MetricsBlock   sum;
+    double         cpm = cycles_per_ms();
+    size_t         i;
+
+    if (!fp)
+        return;
+    Metrics_Snapshot(&sum);
+    fprintf(fp, "%-20s %16s\n", "counter", "value");
+    for (i = 0; i < METRIC_COUNT; i++)
+        fprintf(fp, "%-20s %16llu\n", counter_names[i],
+                (unsigned long long)sum.counters[i]);
+    fprintf(fp, "%-20s %10s %16s %12s\n", "timer", "calls", "cycles", "ms");
+    for (i = 0; i < TIMER_COUNT; i++)
+        fprintf(fp, "%-20s %10llu %16llu %12.3f\n", timer_names[i],
+                (unsigned long long)sum.calls[i],
+                (unsigned long long)sum.cycles[i], sum.cycles[i] / cpm);
+}
+
+/* @fn
+ * Print the sum over all threads as a JSON object.
+ */
+void
+Metrics_ReportJSON(FILE* fp)
+{
+    MetricsBlock   sum;
+    double         cpm = cycles_per_ms();
+    size_t         i;
+
+    if (!fp)
+        return;
+    Metrics_Snapshot(&sum);
+    fprintf(fp, "{\"counters\": {");
+    for (i = 0; i < METRIC_COUNT; i++)
+        fprintf(fp, "%s\"%s\": %llu", i ? ", " : "", counter_names[i],
+                (unsigned long long)sum.counters[i]);
+    fprintf(fp, "}, \"timers\": {");
+    for (i = 0; i < TIMER_COUNT; i++)
+        fprintf(fp, "%s\"%s\": {\"calls\": %llu, \"cycles\": %llu, \"ms\": %.3f}",
+                i ? ", " : "", timer_names[i], (unsigned long long)sum.calls[i],
+                (unsigned long long)sum.cycles[i], sum.cycles[i] / cpm);
+    fprintf(fp, "}}\n");
+}
+
+const char*
+Metrics_CounterName(metric_counter c)
+{
+    return c < METRIC_COUNT ? counter_names[c] : NULL;
+}
+
+const char*
+Metrics_TimerName(metric_timer t)
+{
+    return t < TIMER_COUNT ? timer_names[t] : NULL;
+}
+
+/* @fn
+ * Estimate the rate of Metrics_Cycles() against the
+ * monotonic clock over a few milliseconds, once.
+ */
+static double
+cycles_per_ms(void)
+{
+    static double     rate = 0.0;
+    struct timespec   a, b;
+    uint64_t          c0, c1;
+    double            ms;
+
+    if (rate > 0.0)
+        return rate;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    c0 = Metrics_Cycles();
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        ms = (b.tv_sec - a.tv_sec) * 1e3 + (b.tv_nsec - a.tv_nsec) / 1e6;
+    } while (ms < 5.0);
+    c1 = Metrics_Cycles();
+    rate = (c1 - c0) / ms;
+    return rate;
+}
+
+static void
+make_key(void)
+{
+    pthread_key_create(&key, retire);
+}
+
+/* @fn
+ * Fold the counts of a thread exiting into "retired" and
+ * keep its block for the next thread.
+ */
+static void
+retire(void* p)
+{
+    pt_MetricsBlock    b = (pt_MetricsBlock)p;
+    pt_MetricsBlock*   pp;
+
+    pthread_mutex_lock(&lock);
+    add_block(&retired, b);
+    for (pp = &blocks; *pp && *pp != b; pp = &(*pp)->next)
+        ;
+    if (*pp)
+        *pp = b->next;
+    memset(b, 0, sizeof(MetricsBlock));
+    b->next = spare;
+    spare   = b;
+    pthread_mutex_unlock(&lock);
+}
+
+static void
+add_block(pt_MetricsBlock sum, pt_MetricsBlock b)
+{
+    size_t   i;
+
+    for (i = 0; i < METRIC_COUNT; i++)
+        sum->counters[i] += b->counters[i];
+    for (i = 0; i < TIMER_COUNT; i++) {
+        sum->cycles[i] += b->cycles[i];
+        sum->calls[i]  += b->calls[i];
+    }
+}
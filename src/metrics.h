@@ -0,0 +1,122 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file metrics.h
+ *
+ * Counters and cycle timers for the placement algorithms.
+ *
+ * Every thread counts into a block of its own, so updating
+ * a metric is a plain increment of thread-local memory.
+ * Blocks are chained on first use and summed on demand by
+ * Metrics_Snapshot() or Metrics_Report(), typically after a
+ * run. The counts of a thread that exits are kept, and its
+ * block goes to the next thread that starts counting.
+ * Building with -DGQRM_METRICS=0 compiles all metrics out.
+ *
+ *     METRIC_TIMER_BEGIN(t0);
+ *     ...
+ *     METRIC_INC(METRIC_SPT_POPS);
+ *     ...
+ *     METRIC_TIMER_END(TIMER_SPT, t0);
+ */
+
+#ifndef GQRM_METRICS_H
+#define GQRM_METRICS_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#ifndef GQRM_METRICS
+#define GQRM_METRICS    1
+#endif
+
+typedef enum {
+    METRIC_PRR_CALLS,
+    METRIC_PAIR_TESTS,
+    METRIC_GRAPH_BUILDS,
+    METRIC_SPT_POPS,
+    METRIC_SPT_RELAXATIONS,
+    METRIC_FEASIBILITY_CHECKS,
+    METRIC_PRUNE_ATTEMPTS,
+    METRIC_PRUNE_REMOVALS,
+    METRIC_PRUNE_SKIPS,
+    METRIC_SPTIRP_REBUILDS,
+    METRIC_SIM_EVENTS,
+    METRIC_SIM_COLLISIONS,
+    METRIC_COUNT
+} metric_counter;
+
+typedef enum {
+    TIMER_GRAPH_BUILD,
+    TIMER_SPT,
+    TIMER_FEASIBILITY,
+    TIMER_SPTIRP,
+    TIMER_SIMULATE,
+    TIMER_COUNT
+} metric_timer;
+
+/* @struct
+ * Metrics of a thread, or the sum over all threads.
+ * counters - the value of each counter
+ * cycles   - the cycles spent in each timed section
+ * calls    - the number of times each section was timed
+ */
+typedef struct METRICS_BLOCK {
+    uint64_t                 counters[METRIC_COUNT];
+    uint64_t                 cycles[TIMER_COUNT];
+    uint64_t                 calls[TIMER_COUNT];
+    struct METRICS_BLOCK*    next;
+} MetricsBlock;
+
+typedef MetricsBlock*   pt_MetricsBlock;
+
+/* the block of the calling thread, NULL before first use */
+extern __thread pt_MetricsBlock   metrics_local;
+
+extern pt_MetricsBlock Metrics_Local(void);
+extern size_t          Metrics_Blocks(void);
+extern uint64_t        Metrics_Cycles(void);
+extern void            Metrics_Snapshot(pt_MetricsBlock);
+extern void            Metrics_Reset(void);
+extern void            Metrics_Report(FILE*);
+extern void            Metrics_ReportJSON(FILE*);
+extern const char*     Metrics_CounterName(metric_counter);
+extern const char*     Metrics_TimerName(metric_timer);
+
+#if GQRM_METRICS
+#define METRICS_BLOCK()               (metrics_local ? metrics_local : Metrics_Local())
+#define METRIC_ADD(c, n)              (METRICS_BLOCK()->counters[(c)] += (n))
+#define METRIC_INC(c)                 METRIC_ADD(c, 1)
+#define METRIC_TIMER_BEGIN(t0)        uint64_t t0 = Metrics_Cycles()
+#define METRIC_TIMER_END(t, t0) \
+    do { \
+        pt_MetricsBlock   metrics_b = METRICS_BLOCK(); \
+        metrics_b->cycles[(t)] += Metrics_Cycles() - (t0); \
+        metrics_b->calls[(t)]++; \
+    } while (0)
+#else
+#define METRIC_ADD(c, n)              ((void)0)
+#define METRIC_INC(c)                 ((void)0)
+#define METRIC_TIMER_BEGIN(t0)        ((void)0)
+#define METRIC_TIMER_END(t, t0)       ((void)0)
+#endif
+
+#endif
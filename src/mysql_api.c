@@ -152,10 +152,10 @@ Mysql_WriteGraph(pt_ALGraph pg, pt_Mysql pm, const char* table)
 	char           cmd[1000], buf[100];
 	gqrm_id_t      id;
 	gqrm_power_t   power;
-	pt_Coordinate  pcoor;
+	const Coordinate*  pcoor;
 	coordinate_t   coor;
 	pt_Edge        pe;
-	p_sll          edges;
+	p_vec          edges;
 
     size = ALGraph_Size(pg);
 	for (i = 0; i < size; i++) {
@@ -197,8 +197,8 @@ Mysql_WriteGraph(pt_ALGraph pg, pt_Mysql pm, const char* table)
 		strcat(cmd, buf);
 		if (Vertex_GetEdges(pv, &edges) == DS_ERROR)
 		    return DS_ERROR;
-		for (j = 0; j < SingleLinkedList_Size(edges); j++) {
-		    if (SingleLinkedList_GetData(edges, j, (sll_data_t*)&pe) == DS_ERROR)
+		for (j = 0; j < Vector_Size(edges); j++) {
+		    if (Vector_GetData(edges, j, (vec_data_t*)&pe) == DS_ERROR)
 			    return DS_ERROR;
 			if (Edge_GetEndID(pe, &id) == DS_ERROR)
 			    return DS_ERROR;
@@ -0,0 +1,618 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "neighbor.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NEIGHBOR_X86
+#include <immintrin.h>
+#endif
+
+/* upper bound of the range search, far beyond any field size */
+#define RANGE_LIMIT      1.0e9
+/* relative slack added to a range so that rounding in the
+ * vectorized distance never drops a true neighbor */
+#define RANGE_SLACK      1.0e-9
+
+/* @struct
+ * Adjacency of all nodes of a table in compressed sparse row
+ * form: the neighbors of row "i" are cols[rows[i]] ...
+ * cols[rows[i + 1] - 1], in ascending order, and weights
+ * holds the PRR of each of these links.
+ */
+struct NEIGHBOR_CSR {
+    size_t     n;
+    size_t     nnz;
+    size_t*    rows;
+    size_t*    cols;
+    double*    weights;
+};
+
+/* rows per block of the parallel CSR builder */
+#define CSR_BLOCK_ROWS   32
+
+/* @struct
+ * State shared by the workers of Neighbor_BuildCSR(). Each
+ * block of rows gets its own partial adjacency in "parts",
+ * each worker its own scratch in "masks" and "ws" and its
+ * own entry of "failed", set if memory ran out.
+ */
+typedef struct {
+    pt_NodeTable      tbl;
+    pt_NeighborCSR*   parts;
+    uint64_t**        masks;
+    double**          ws;
+    char*             failed;
+} build_arg;
+
+/* @typedef
+ * A prefilter sets bit (j - begin) of "mask" for every node
+ * j in [begin, end) whose squared distance to (xi, yi, zi)
+ * is no greater than "thr2". "mask" must be zeroed.
+ */
+typedef void (*prefilter_func)(const coordinate_t*, const coordinate_t*,
+                               const coordinate_t*, size_t, size_t,
+                               coordinate_t, coordinate_t, coordinate_t,
+                               double, uint64_t*);
+
+static void prefilter_scalar(const coordinate_t*, const coordinate_t*,
+                             const coordinate_t*, size_t, size_t,
+                             coordinate_t, coordinate_t, coordinate_t,
+                             double, uint64_t*);
+static void tail_scalar(const coordinate_t*, const coordinate_t*,
+                        const coordinate_t*, size_t, size_t, size_t,
+                        coordinate_t, coordinate_t, coordinate_t,
+                        double, uint64_t*);
+#ifdef NEIGHBOR_X86
+static void prefilter_sse2(const coordinate_t*, const coordinate_t*,
+                           const coordinate_t*, size_t, size_t,
+                           coordinate_t, coordinate_t, coordinate_t,
+                           double, uint64_t*);
+static void prefilter_avx2(const coordinate_t*, const coordinate_t*,
+                           const coordinate_t*, size_t, size_t,
+                           coordinate_t, coordinate_t, coordinate_t,
+                           double, uint64_t*);
+#endif
+static prefilter_func select_kernel(void);
+static double threshold(gqrm_power_t);
+static size_t scan_row(pt_NodeTable, size_t, size_t, size_t, double, uint64_t*, double*);
+static ds_stat csr_reserve(pt_NeighborCSR, size_t, size_t*);
+static ds_stat build_rows(pt_NodeTable, pt_NeighborCSR, size_t, size_t, uint64_t*, double*);
+static void build_blocks(size_t, size_t, size_t, void*);
+static pt_NeighborCSR build_clear(build_arg*, size_t, size_t, pt_NeighborCSR);
+
+static prefilter_func   kernel = NULL;
+static const char*      kernel_name = "none";
+
+/* @fn
+ * Pick the widest prefilter the CPU supports. The choice can
+ * be forced through the GQRM_NEIGHBOR_KERNEL environment
+ * variable ("scalar", "sse2" or "avx2"), which is meant for
+ * testing the fallbacks.
+ */
+static prefilter_func
+select_kernel(void)
+{
+    const char*   force;
+
+    if (kernel)
+        return kernel;
+
+    force = getenv("GQRM_NEIGHBOR_KERNEL");
+#ifdef NEIGHBOR_X86
+    __builtin_cpu_init();
+    if ((!force || strcmp(force, "avx2") == 0) &&
+        __builtin_cpu_supports("avx2")) {
+        kernel_name = "avx2";
+        return kernel = prefilter_avx2;
+    }
+    if ((!force || strcmp(force, "scalar") != 0) &&
+        __builtin_cpu_supports("sse2")) {
+        kernel_name = "sse2";
+        return kernel = prefilter_sse2;
+    }
+#endif
+    kernel_name = "scalar";
+    return kernel = prefilter_scalar;
+}
+
+/* @fn
+ * Return the name of the prefilter in use.
+ */
+const char*
+Neighbor_KernelName(void)
+{
+    select_kernel();
+    return kernel_name;
+}
+
+/* @fn
+ * Compute the largest distance at which a node transmitting
+ * at power "p" still reaches PRR_CONSTRAINT, or a negative
+ * value when it cannot even at distance 0. prr() decreases
+ * with distance (and becomes NaN once the SNR turns
+ * negative), so the range is located by bisection.
+ */
+double
+Neighbor_Range(gqrm_power_t p)
+{
+    double   lo = 0.0, hi = 1.0, mid, re;
+    int      i;
+
+    re = prr(p, 0.0);
+    if (isnan(re) || re < PRR_CONSTRAINT)
+        return -1.0;
+
+    /* grow "hi" until it is out of range */
+    for (;;) {
+        re = prr(p, hi);
+        if (isnan(re) || re < PRR_CONSTRAINT)
+            break;
+        lo = hi;
+        if ((hi *= 2.0) > RANGE_LIMIT)
+            return RANGE_LIMIT;
+    }
+
+    for (i = 0; i < 200 && hi - lo > lo * DBL_EPSILON; i++) {
+        mid = lo + (hi - lo) / 2.0;
+        re  = prr(p, mid);
+        if (isnan(re) || re < PRR_CONSTRAINT)
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return hi;
+}
+
+/* @fn
+ * Squared prefilter threshold for transmit power "p",
+ * negative when no node can be reached.
+ */
+static double
+threshold(gqrm_power_t p)
+{
+    double   r = Neighbor_Range(p);
+
+    if (r < 0.0)
+        return -1.0;
+    r *= 1.0 + RANGE_SLACK;
+    return r * r;
+}
+
+static void
+prefilter_scalar(const coordinate_t* x, const coordinate_t* y,
+                 const coordinate_t* z, size_t begin, size_t end,
+                 coordinate_t xi, coordinate_t yi, coordinate_t zi,
+                 double thr2, uint64_t* mask)
+{
+    tail_scalar(x, y, z, begin, begin, end, xi, yi, zi, thr2, mask);
+}
+
+/* @fn
+ * Scalar test of nodes [from, end), with bits numbered from
+ * "begin". Also finishes the blocks left over by the
+ * vectorized prefilters.
+ */
+static void
+tail_scalar(const coordinate_t* x, const coordinate_t* y,
+            const coordinate_t* z, size_t begin, size_t from, size_t end,
+            coordinate_t xi, coordinate_t yi, coordinate_t zi,
+            double thr2, uint64_t* mask)
+{
+    size_t         j, k;
+    coordinate_t   dx, dy, dz;
+
+    for (j = from; j < end; j++) {
+        dx = x[j] - xi;
+        dy = y[j] - yi;
+        dz = z[j] - zi;
+        if (dx * dx + dy * dy + dz * dz <= thr2) {
+            k = j - begin;
+            mask[k >> 6] |= (uint64_t)1 << (k & 63);
+        }
+    }
+}
+
+#ifdef NEIGHBOR_X86
+static void
+prefilter_sse2(const coordinate_t* x, const coordinate_t* y,
+               const coordinate_t* z, size_t begin, size_t end,
+               coordinate_t xi, coordinate_t yi, coordinate_t zi,
+               double thr2, uint64_t* mask)
+{
+    size_t    j, k;
+    __m128d   vx = _mm_set1_pd(xi), vy = _mm_set1_pd(yi);
+    __m128d   vz = _mm_set1_pd(zi), vt = _mm_set1_pd(thr2);
+    __m128d   dx, dy, dz, d2;
+    unsigned  bits;
+
+    for (j = begin; j + 2 <= end; j += 2) {
+        dx = _mm_sub_pd(_mm_loadu_pd(x + j), vx);
+        dy = _mm_sub_pd(_mm_loadu_pd(y + j), vy);
+        dz = _mm_sub_pd(_mm_loadu_pd(z + j), vz);
+        d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)),
+                        _mm_mul_pd(dz, dz));
+        if ((bits = (unsigned)_mm_movemask_pd(_mm_cmple_pd(d2, vt))) != 0) {
+            /* blocks start at even offsets, so they never straddle words */
+            k = j - begin;
+            mask[k >> 6] |= (uint64_t)bits << (k & 63);
+        }
+    }
+    tail_scalar(x, y, z, begin, j, end, xi, yi, zi, thr2, mask);
+}
+
+__attribute__((target("avx2")))
+static void
+prefilter_avx2(const coordinate_t* x, const coordinate_t* y,
+               const coordinate_t* z, size_t begin, size_t end,
+               coordinate_t xi, coordinate_t yi, coordinate_t zi,
+               double thr2, uint64_t* mask)
+{
+    size_t    j, k;
+    __m256d   vx = _mm256_set1_pd(xi), vy = _mm256_set1_pd(yi);
+    __m256d   vz = _mm256_set1_pd(zi), vt = _mm256_set1_pd(thr2);
+    __m256d   dx, dy, dz, d2;
+    unsigned  bits;
+
+    for (j = begin; j + 4 <= end; j += 4) {
+        dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), vx);
+        dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), vy);
+        dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), vz);
+        d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx),
+                                         _mm256_mul_pd(dy, dy)),
+                           _mm256_mul_pd(dz, dz));
+        bits = (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(d2, vt, _CMP_LE_OQ));
+        if (bits) {
+            /* blocks start at offsets divisible by 4 within a word */
+            k = j - begin;
+            mask[k >> 6] |= (uint64_t)bits << (k & 63);
+        }
+    }
+    tail_scalar(x, y, z, begin, j, end, xi, yi, zi, thr2, mask);
+}
+#endif
+
+/* @fn
+ * Test the "i"th row against rows [begin, end) and set bit
+ * (j - begin) of "mask" for every neighbor j, following the
+ * semantics of Node_IsNeighbor() with row "i" transmitting.
+ * When "w" is not NULL, w[j - begin] receives the PRR of each
+ * neighbor. Return the number of neighbors found. The caller
+ * has picked the prefilter through select_kernel().
+ */
+static size_t
+scan_row(pt_NodeTable tbl, size_t i, size_t begin, size_t end,
+         double thr2, uint64_t* mask, double* w)
+{
+    const coordinate_t*  x = NodeTable_Xs(tbl);
+    const coordinate_t*  y = NodeTable_Ys(tbl);
+    const coordinate_t*  z = NodeTable_Zs(tbl);
+    gqrm_power_t         p = NodeTable_Powers(tbl)[i];
+    size_t               words = (end - begin + 63) / 64, cnt = 0, k, j;
+    uint64_t             bits;
+    coordinate_t         dx, dy, dz;
+    double               re;
+
+    memset(mask, 0, words * sizeof(uint64_t));
+    if (thr2 < 0.0 || NodeTable_IsSelected(tbl, i) == DS_FALSE)
+        return 0;
+
+    kernel(x, y, z, begin, end, x[i], y[i], z[i], thr2, mask);
+
+    for (k = 0; k < words; k++)
+        for (bits = mask[k]; bits; bits &= bits - 1) {
+            j = begin + k * 64 + (size_t)__builtin_ctzll(bits);
+            if (j != i && NodeTable_IsSelected(tbl, j) == DS_TRUE) {
+                METRIC_INC(METRIC_PAIR_TESTS);
+                /* exactly the distance Coordinate_Distance() computes */
+                dx = x[i] - x[j];
+                dy = y[i] - y[j];
+                dz = z[i] - z[j];
+                re = prr(p, sqrt(dx * dx + dy * dy + dz * dz));
+                if (!isnan(re) && re >= PRR_CONSTRAINT) {
+                    if (w)
+                        w[j - begin] = re;
+                    cnt++;
+                    continue;
+                }
+            }
+            mask[k] &= ~(bits & -bits);
+        }
+    return cnt;
+}
+
+/* @fn
+ * Compute the neighbor bitmask of the "i"th row over rows
+ * [begin, end). "mask" must hold (end - begin + 63) / 64
+ * words. Return the number of neighbors.
+ */
+size_t
+Neighbor_RowMask(pt_NodeTable tbl, size_t i, size_t begin, size_t end,
+                 uint64_t* mask)
+{
+    if (!tbl || !mask || i >= NodeTable_Size(tbl) ||
+        begin >= end || end > NodeTable_Size(tbl))
+        return 0;
+    select_kernel();
+    return scan_row(tbl, i, begin, end,
+                    threshold(NodeTable_Powers(tbl)[i]), mask, NULL);
+}
+
+/* @fn
+ * Make room for "more" edges in "csr", "cap" being the
+ * current capacity of its column and weight arrays.
+ */
+static ds_stat
+csr_reserve(pt_NeighborCSR csr, size_t more, size_t* cap)
+{
+    size_t    ncap;
+    size_t*   cols;
+    double*   weights;
+
+    if (csr->nnz + more <= *cap)
+        return DS_OK;
+    for (ncap = *cap ? *cap : 64; ncap < csr->nnz + more; ncap *= 2) ;
+
+    if ((cols = realloc(csr->cols, ncap * sizeof(size_t))) == NULL)
+        return DS_ERROR;
+    csr->cols = cols;
+    if ((weights = realloc(csr->weights, ncap * sizeof(double))) == NULL)
+        return DS_ERROR;
+    csr->weights = weights;
+    *cap = ncap;
+    return DS_OK;
+}
+
+/* @fn
+ * Append the adjacency of rows [begin, end) of "tbl" to
+ * "csr", whose "rows" must hold end - begin + 1 entries.
+ * "mask" and "w" are scratch sized for the whole table.
+ */
+static ds_stat
+build_rows(pt_NodeTable tbl, pt_NeighborCSR csr, size_t begin, size_t end,
+           uint64_t* mask, double* w)
+{
+    size_t           n = NodeTable_Size(tbl), i, k, j, cnt, cap = 0;
+    uint64_t         bits;
+    double           thr2 = -1.0;
+    gqrm_power_t     last = -1.0;
+
+    csr->rows[0] = 0;
+    for (i = begin; i < end; i++) {
+        /* nodes usually share a power level */
+        if (NodeTable_Powers(tbl)[i] != last) {
+            last = NodeTable_Powers(tbl)[i];
+            thr2 = threshold(last);
+        }
+        cnt = scan_row(tbl, i, 0, n, thr2, mask, w);
+        if (csr_reserve(csr, cnt, &cap) == DS_ERROR)
+            return DS_ERROR;
+        for (k = 0; k < (n + 63) / 64; k++)
+            for (bits = mask[k]; bits; bits &= bits - 1) {
+                j = k * 64 + (size_t)__builtin_ctzll(bits);
+                csr->cols[csr->nnz]    = j;
+                csr->weights[csr->nnz] = w[j];
+                csr->nnz++;
+            }
+        csr->rows[i - begin + 1] = csr->nnz;
+    }
+    return DS_OK;
+}
+
+/* @fn
+ * Worker of Neighbor_BuildCSR(): fill the partial adjacency
+ * of blocks [begin, end) using the scratch of "worker".
+ */
+static void
+build_blocks(size_t begin, size_t end, size_t worker, void* p)
+{
+    build_arg*       arg = (build_arg*)p;
+    size_t           n = NodeTable_Size(arg->tbl), b, last;
+    pt_NeighborCSR   part;
+
+    if (!arg->masks[worker])
+        arg->masks[worker] = malloc((n + 63) / 64 * sizeof(uint64_t));
+    if (!arg->ws[worker])
+        arg->ws[worker] = malloc(n * sizeof(double));
+
+    for (b = begin; b < end; b++) {
+        last = (b + 1) * CSR_BLOCK_ROWS < n ? (b + 1) * CSR_BLOCK_ROWS : n;
+        if (!arg->masks[worker] || !arg->ws[worker] ||
+            (part = calloc(1, sizeof(NeighborCSR))) == NULL) {
+            arg->failed[worker] = 1;
+            continue;
+        }
+        arg->parts[b] = part;
+        part->n    = last - b * CSR_BLOCK_ROWS;
+        part->rows = malloc((part->n + 1) * sizeof(size_t));
+        if (!part->rows || build_rows(arg->tbl, part, b * CSR_BLOCK_ROWS, last,
+                                      arg->masks[worker], arg->ws[worker]) == DS_ERROR)
+            arg->failed[worker] = 1;
+    }
+}
+
+/* @fn
+ * Release the scratch of Neighbor_BuildCSR() and return
+ * "csr".
+ */
+static pt_NeighborCSR
+build_clear(build_arg* arg, size_t nblocks, size_t nworkers, pt_NeighborCSR csr)
+{
+    size_t   i;
+
+    if (arg->parts)
+        for (i = 0; i < nblocks; i++)
+            NeighborCSR_Free(&arg->parts[i]);
+    if (arg->masks)
+        for (i = 0; i < nworkers; i++)
+            free(arg->masks[i]);
+    if (arg->ws)
+        for (i = 0; i < nworkers; i++)
+            free(arg->ws[i]);
+    free(arg->parts);
+    free(arg->masks);
+    free(arg->ws);
+    free(arg->failed);
+    return csr;
+}
+
+/* @fn
+ * Build the adjacency of every row of "tbl". Rows are split
+ * in blocks filled by the workers of "pool" (NULL to run
+ * inline) and concatenated in row order, so the result does
+ * not depend on the number of threads.
+ */
+pt_NeighborCSR
+Neighbor_BuildCSR(pt_NodeTable tbl, pt_ThreadPool pool)
+{
+    pt_NeighborCSR   csr, part;
+    build_arg        arg;
+    size_t           n, nblocks, nworkers, b, i, k, nnz;
+
+    if (!tbl || (n = NodeTable_Size(tbl)) == 0)
+        return NULL;
+    nblocks  = (n + CSR_BLOCK_ROWS - 1) / CSR_BLOCK_ROWS;
+    nworkers = ThreadPool_Size(pool);
+    arg.tbl    = tbl;
+    arg.parts  = calloc(nblocks, sizeof(pt_NeighborCSR));
+    arg.masks  = calloc(nworkers, sizeof(uint64_t*));
+    arg.ws     = calloc(nworkers, sizeof(double*));
+    arg.failed = calloc(nworkers, sizeof(char));
+    if (!arg.parts || !arg.masks || !arg.ws || !arg.failed)
+        return build_clear(&arg, 0, 0, NULL);
+
+    /* picked here, the workers only read it */
+    select_kernel();
+    ThreadPool_ParallelFor(pool, nblocks, 1, build_blocks, &arg);
+    for (i = 0; i < nworkers; i++)
+        if (arg.failed[i])
+            return build_clear(&arg, nblocks, nworkers, NULL);
+
+    /* a single block already is the whole adjacency */
+    if (nblocks == 1) {
+        csr = arg.parts[0];
+        arg.parts[0] = NULL;
+        return build_clear(&arg, nblocks, nworkers, csr);
+    }
+
+    for (b = 0, nnz = 0; b < nblocks; b++)
+        nnz += arg.parts[b]->nnz;
+    if ((csr = calloc(1, sizeof(NeighborCSR))) == NULL)
+        return build_clear(&arg, nblocks, nworkers, NULL);
+    csr->n       = n;
+    csr->rows    = malloc((n + 1) * sizeof(size_t));
+    csr->cols    = malloc((nnz ? nnz : 1) * sizeof(size_t));
+    csr->weights = malloc((nnz ? nnz : 1) * sizeof(double));
+    if (!csr->rows || !csr->cols || !csr->weights) {
+        NeighborCSR_Free(&csr);
+        return build_clear(&arg, nblocks, nworkers, NULL);
+    }
+
+    csr->rows[0] = 0;
+    for (b = 0, i = 0; b < nblocks; b++) {
+        part = arg.parts[b];
+        if (part->nnz) {
+            memcpy(csr->cols + csr->nnz, part->cols, part->nnz * sizeof(size_t));
+            memcpy(csr->weights + csr->nnz, part->weights, part->nnz * sizeof(double));
+        }
+        for (k = 0; k < part->n; k++, i++)
+            csr->rows[i + 1] = csr->nnz + part->rows[k + 1];
+        csr->nnz += part->nnz;
+    }
+    return build_clear(&arg, nblocks, nworkers, csr);
+}
+
+/* @fn
+ * Initialize an empty graph from a list of nodes, giving the
+ * same graph as ALGraph_Init(pg, nodes, check_neighbor) but
+ * without testing all pairs through prr(). The adjacency is
+ * computed by the workers of "pool", NULL to run inline.
+ */
+ds_stat
+Neighbor_InitGraph(pt_ALGraph pg, p_sll nodes, pt_ThreadPool pool)
+{
+    pt_NodeTable     tbl;
+    pt_NeighborCSR   csr;
+    ds_stat          re;
+
+    if (!pg || !nodes)
+        return DS_ERROR;
+    if (SingleLinkedList_Size(nodes) == 0)
+        return DS_OK;
+    METRIC_TIMER_BEGIN(t0);
+    if ((tbl = NodeTable_CreateFromList(nodes)) == NULL)
+        return DS_ERROR;
+    if ((csr = Neighbor_BuildCSR(tbl, pool)) == NULL) {
+        NodeTable_Free(&tbl);
+        return DS_ERROR;
+    }
+    re = ALGraph_InitAdjacency(pg, nodes, csr->rows, csr->cols, csr->weights);
+    NeighborCSR_Free(&csr);
+    NodeTable_Free(&tbl);
+    METRIC_INC(METRIC_GRAPH_BUILDS);
+    METRIC_TIMER_END(TIMER_GRAPH_BUILD, t0);
+    return re;
+}
+
+void
+NeighborCSR_Free(pt_NeighborCSR* csr)
+{
+    if (!csr || !*csr)
+        return;
+    free((*csr)->rows);
+    free((*csr)->cols);
+    free((*csr)->weights);
+    free(*csr);
+    *csr = NULL;
+}
+
+size_t
+NeighborCSR_Size(pt_NeighborCSR csr)
+{
+    return csr ? csr->n : 0;
+}
+
+size_t
+NeighborCSR_Edges(pt_NeighborCSR csr)
+{
+    return csr ? csr->nnz : 0;
+}
+
+const size_t*
+NeighborCSR_Rows(pt_NeighborCSR csr)
+{
+    return csr ? csr->rows : NULL;
+}
+
+const size_t*
+NeighborCSR_Cols(pt_NeighborCSR csr)
+{
+    return csr ? csr->cols : NULL;
+}
+
+const double*
+NeighborCSR_Weights(pt_NeighborCSR csr)
+{
+    return csr ? csr->weights : NULL;
+}
@@ -0,0 +1,61 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file neighbor.h
+ *
+ * Bulk neighbor discovery over a NodeTable.
+ *
+ * Instead of evaluating prr() for every pair of nodes, the
+ * distance beyond which a transmit power can no longer meet
+ * PRR_CONSTRAINT is computed once, and a vectorized kernel
+ * compares squared distances from one node to a block of
+ * nodes against it. Only the surviving candidates go through
+ * prr(), so the result is identical to Node_IsNeighbor().
+ */
+
+#ifndef GQRM_NEIGHBOR_H
+#define GQRM_NEIGHBOR_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "header.h"
+#include "metrics.h"
+#include "prr.h"
+#include "node.h"
+#include "graph.h"
+#include "thread_pool.h"
+
+typedef struct NEIGHBOR_CSR    NeighborCSR;
+typedef NeighborCSR*           pt_NeighborCSR;
+
+extern double          Neighbor_Range(gqrm_power_t);
+extern const char*     Neighbor_KernelName(void);
+extern size_t          Neighbor_RowMask(pt_NodeTable, size_t, size_t, size_t, uint64_t*);
+extern pt_NeighborCSR  Neighbor_BuildCSR(pt_NodeTable, pt_ThreadPool);
+extern ds_stat         Neighbor_InitGraph(pt_ALGraph, p_sll, pt_ThreadPool);
+extern void            NeighborCSR_Free(pt_NeighborCSR*);
+extern size_t          NeighborCSR_Size(pt_NeighborCSR);
+extern size_t          NeighborCSR_Edges(pt_NeighborCSR);
+extern const size_t*   NeighborCSR_Rows(pt_NeighborCSR);
+extern const size_t*   NeighborCSR_Cols(pt_NeighborCSR);
+extern const double*   NeighborCSR_Weights(pt_NeighborCSR);
+#endif
@@ -47,6 +47,9 @@ enum STATUS {
  * hop       - the hop constraint imposed on this wireless node
  * type      - the node type, i.e., SN, CDL, or GW.
  * status    - identifying whether a CDL is selected to place relay
+ * table     - the node table owning this node if it is a view
+ *             into a NodeTable, NULL for a standalone node
+ * slot      - the row of this node in "table"
  */
 struct NODE {
     pt_Coordinate      pcoor;
@@ -55,15 +58,45 @@ struct NODE {
     gqrm_hop_t              hop;
     node_t             type;
     cdl_status         status;
+    pt_NodeTable       table;
+    size_t             slot;
 };
 
 struct NODES {
-    p_sll    nodes;
+    p_vec    nodes;
+};
+
+/* @struct
+ * Structure storing wireless nodes column by column, so that
+ * distance and PRR computations over many nodes read each
+ * attribute from one contiguous array:
+ * size      - the number of nodes stored
+ * capacity  - the maximum number of nodes, fixed at creation
+ *             so that views handed out never move
+ * ids, types, status, power, hop, x, y, z
+ *           - one array per attribute, indexed by row
+ * views     - one Node per row, mirroring the row so that the
+ *             pt_Node API keeps working on table rows
+ * coors     - contiguous coordinates backing the views
+ */
+struct NODE_TABLE {
+    size_t             size;
+    size_t             capacity;
+    gqrm_id_t*         ids;
+    node_t*            types;
+    cdl_status*        status;
+    gqrm_power_t*      power;
+    gqrm_hop_t*        hop;
+    coordinate_t*      x;
+    coordinate_t*      y;
+    coordinate_t*      z;
+    Node*              views;
+    pt_Coordinate      coors;
 };
 
 static pt_Node create_node(pt_Coordinate, gqrm_id_t, gqrm_power_t, gqrm_hop_t, node_t, cdl_status);
 static ds_stat print(pt_Node, FILE*, int);
-static void node_clear_op(sll_data_t*);
+static void node_clear_op(vec_data_t*);
 
 /* @fn
  * Create a sensor node.
@@ -135,6 +168,8 @@ create_node(pt_Coordinate c, gqrm_id_t i, gqrm_power_t p,
     pn->hop      = h;
     pn->type     = t;
     pn->status   = s;
+    pn->table    = NULL;
+    pn->slot     = 0;
 
     return pn;
 }
@@ -142,7 +177,9 @@ create_node(pt_Coordinate c, gqrm_id_t i, gqrm_power_t p,
 /* @fn
  * Free a node. It's worth noting that the coordinate of 
  * this node will BE FREED in this procedure automatically,
- * and this coordinate CANNOT BE USED anymore.
+ * and this coordinate CANNOT BE USED anymore. A view into a
+ * NodeTable is owned by the table, so only the pointer is
+ * reset for it.
  */
 void
 Node_Free(pt_Node* nd)
@@ -150,6 +187,10 @@ Node_Free(pt_Node* nd)
     if (!nd)
         return;
 
+    if (*nd && (*nd)->table) {
+        *nd = NULL;
+        return;
+    }
     Coordinate_Free(&(*nd)->pcoor);
     free(*nd);
     *nd = NULL;
@@ -172,6 +213,8 @@ Node_SetStatus(pt_Node nd, cdl_status s)
         return DS_ERROR;
 
     nd->status = s;
+    if (nd->table)
+        nd->table->status[nd->slot] = s;
     return DS_OK;
 }
 
@@ -180,13 +223,27 @@ Node_SetStatus(pt_Node nd, cdl_status s)
  * worth noting that the original coordinate of 
  * this node will BE AUTOMATICALLY FREED in this
  * procedure, so DO NOT USE that coordinate anymore.
+ * For a view into a NodeTable, the position is copied
+ * into the table and "co" itself is freed.
  */
 ds_stat
 Node_SetCoordinate(pt_Node nd, pt_Coordinate co)
 {
+    coordinate_t  x, y, z;
+
     if (!nd)
         return DS_ERROR;
 
+    if (nd->table) {
+        if (
+            Coordinate_GetX(co, &x) == DS_ERROR ||
+            Coordinate_GetY(co, &y) == DS_ERROR ||
+            Coordinate_GetZ(co, &z) == DS_ERROR
+           )
+            return DS_ERROR;
+        Coordinate_Free(&co);
+        return NodeTable_SetPosition(nd->table, nd->slot, x, y, z);
+    }
     Coordinate_Free(&nd->pcoor);
     nd->pcoor = co;
     return DS_OK;
@@ -208,6 +265,8 @@ Node_SetSelected(pt_Node nd)
     if (!nd)
 	    return DS_ERROR;
 	nd->status = SLCT;
+	if (nd->table)
+	    nd->table->status[nd->slot] = SLCT;
 	return DS_OK;
 }
 
@@ -217,6 +276,8 @@ Node_SetUnselected(pt_Node nd)
     if (!nd)
 	    return DS_ERROR;
 	nd->status = UNSLCT;
+	if (nd->table)
+	    nd->table->status[nd->slot] = UNSLCT;
 	return DS_OK;
 }
 
@@ -227,6 +288,8 @@ Node_SetHop(pt_Node nd, gqrm_hop_t h)
         return DS_ERROR;
 
     nd->hop = h;
+    if (nd->table)
+        nd->table->hop[nd->slot] = h;
     return DS_OK;
 }
 
@@ -247,14 +310,19 @@ Node_SetPower(pt_Node nd, gqrm_power_t p)
         return DS_ERROR;
 
     nd->power = p;
+    if (nd->table)
+        nd->table->power[nd->slot] = p;
     return DS_OK;
 }
 
 /* @fn
  * Return the coordinate of this node through parameter "re".
+ * The coordinate still belongs to the node and is read-only;
+ * move a node through Node_SetCoordinate(), which also keeps
+ * the row of a NodeTable view in step.
  */
 ds_stat
-Node_GetCoordinate(pt_Node nd, pt_Coordinate* re)
+Node_GetCoordinate(pt_Node nd, const Coordinate** re)
 {
     if (!nd || !re)
         return DS_ERROR;
@@ -414,7 +482,8 @@ Nodes_Create(void)
     if (!nds)
         return NULL;
 
-    if (SingleLinkedList_Init(&nds->nodes) == DS_ERROR) {
+    nds->nodes = NULL;
+    if (Vector_Init(&nds->nodes) == DS_ERROR) {
         free(nds);
         return NULL;
     }
@@ -427,7 +496,7 @@ Nodes_PushNode(pt_Nodes nds, pt_Node n)
     if (!nds)
         return DS_ERROR;
 
-    return SingleLinkedList_InsertHead(nds->nodes, n);
+    return Vector_PushBack(nds->nodes, n);
 }
 
 ds_stat
@@ -438,7 +507,8 @@ Nodes_PopNode(pt_Nodes nds)
     if (!nds)
         return DS_ERROR;
 
-    SingleLinkedList_DeleteHead(nds->nodes, (sll_data_t*)&nd);
+    if (Vector_PopBack(nds->nodes, (vec_data_t*)&nd) == DS_ERROR)
+        return DS_ERROR;
     Node_Free(&nd);
     return DS_OK;
 }
@@ -449,13 +519,13 @@ Nodes_Clear(pt_Nodes nds)
     if (!nds)
         return;
 
-    SingleLinkedList_Clear(nds->nodes, node_clear_op);
+    Vector_Clear(nds->nodes, node_clear_op);
 }
 
 void
 Nodes_Free(pt_Nodes* nds)
 {
-    SingleLinkedList_Destroy(&(*nds)->nodes, node_clear_op);
+    Vector_Destroy(&(*nds)->nodes, node_clear_op);
     free(*nds);
     *nds = NULL;
 }
@@ -463,24 +533,355 @@ Nodes_Free(pt_Nodes* nds)
 size_t
 Nodes_Size(pt_Nodes nds)
 {
-    return SingleLinkedList_Size(nds->nodes);
+    return Vector_Size(nds->nodes);
 }
 
 ds_bool
 Nodes_Empty(pt_Nodes nds)
 {
-    return SingleLinkedList_Empty(nds->nodes);
+    return Vector_Empty(nds->nodes);
 }
 
+/* @fn
+ * Get the "index"th node, the last one pushed being the 0th
+ * as when the nodes were kept on a list pushed at its head.
+ * They are stored in push order, so that pushing and
+ * popping are O(1).
+ */
 ds_stat
 Nodes_GetNode(pt_Nodes nds, size_t index, pt_Node* re)
 {
-    return SingleLinkedList_GetData(nds->nodes, index, (sll_data_t*)re);
+    if (!nds || index >= Vector_Size(nds->nodes))
+        return DS_ERROR;
+    return Vector_GetData(nds->nodes, Vector_Size(nds->nodes) - 1 - index, (vec_data_t*)re);
 }
 
 static void
-node_clear_op(sll_data_t* nd)
+node_clear_op(vec_data_t* nd)
+{
+    Node_Free((pt_Node*)nd);
+}
+
+/* @fn
+ * Create an empty node table able to hold "capacity" nodes.
+ * The capacity never changes afterwards, which keeps the
+ * views returned by NodeTable_GetNode() valid for the whole
+ * lifetime of the table.
+ */
+pt_NodeTable
+NodeTable_Create(size_t capacity)
+{
+    pt_NodeTable   tbl;
+
+    if (capacity == 0)
+        return NULL;
+    if ((tbl = calloc(1, sizeof(NodeTable))) == NULL)
+        return NULL;
+
+    tbl->capacity = capacity;
+    tbl->ids      = malloc(capacity * sizeof(gqrm_id_t));
+    tbl->types    = malloc(capacity * sizeof(node_t));
+    tbl->status   = malloc(capacity * sizeof(cdl_status));
+    tbl->power    = malloc(capacity * sizeof(gqrm_power_t));
+    tbl->hop      = malloc(capacity * sizeof(gqrm_hop_t));
+    tbl->x        = malloc(capacity * sizeof(coordinate_t));
+    tbl->y        = malloc(capacity * sizeof(coordinate_t));
+    tbl->z        = malloc(capacity * sizeof(coordinate_t));
+    tbl->views    = malloc(capacity * sizeof(Node));
+    tbl->coors    = Coordinate_CreateArray(capacity);
+
+    if (
+        !tbl->ids || !tbl->types || !tbl->status || !tbl->power ||
+        !tbl->hop || !tbl->x || !tbl->y || !tbl->z || !tbl->views ||
+        !tbl->coors
+       ) {
+        NodeTable_Free(&tbl);
+        return NULL;
+    }
+    return tbl;
+}
+
+/* @fn
+ * Create a node table holding a copy of every node in
+ * "list", in list order. The nodes in "list" are left
+ * untouched and remain owned by the caller.
+ */
+pt_NodeTable
+NodeTable_CreateFromList(p_sll list)
+{
+    pt_NodeTable   tbl;
+    pt_Node        pn;
+    size_t         size;
+    sll_iter       it;
+
+    if ((size = SingleLinkedList_Size(list)) == 0)
+        return NULL;
+    if ((tbl = NodeTable_Create(size)) == NULL)
+        return NULL;
+
+    SingleLinkedList_Begin(list, &it);
+    while (SingleLinkedList_Next(&it, (sll_data_t*)&pn) == DS_TRUE)
+        if (NodeTable_PushNode(tbl, pn) == DS_ERROR) {
+            NodeTable_Free(&tbl);
+            return NULL;
+        }
+    return tbl;
+}
+
+void
+NodeTable_Free(pt_NodeTable* tbl)
+{
+    if (!tbl || !*tbl)
+        return;
+
+    free((*tbl)->ids);
+    free((*tbl)->types);
+    free((*tbl)->status);
+    free((*tbl)->power);
+    free((*tbl)->hop);
+    free((*tbl)->x);
+    free((*tbl)->y);
+    free((*tbl)->z);
+    free((*tbl)->views);
+    Coordinate_FreeArray(&(*tbl)->coors);
+    free(*tbl);
+    *tbl = NULL;
+}
+
+/* @fn
+ * Append a copy of node "pn" to the table. "pn" is not
+ * retained, so the caller still owns it.
+ */
+ds_stat
+NodeTable_PushNode(pt_NodeTable tbl, pt_Node pn)
+{
+    size_t         i;
+    pt_Node        view;
+    coordinate_t   x = 0.0, y = 0.0, z = 0.0;
+
+    if (!tbl || !pn || tbl->size >= tbl->capacity)
+        return DS_ERROR;
+
+    if (pn->pcoor) {
+        Coordinate_GetX(pn->pcoor, &x);
+        Coordinate_GetY(pn->pcoor, &y);
+        Coordinate_GetZ(pn->pcoor, &z);
+    }
+
+    i = tbl->size++;
+    tbl->ids[i]    = pn->id;
+    tbl->types[i]  = pn->type;
+    tbl->status[i] = pn->status;
+    tbl->power[i]  = pn->power;
+    tbl->hop[i]    = pn->hop;
+
+    view         = &tbl->views[i];
+    view->pcoor  = Coordinate_ArrayAt(tbl->coors, i);
+    view->id     = pn->id;
+    view->power  = pn->power;
+    view->hop    = pn->hop;
+    view->type   = pn->type;
+    view->status = pn->status;
+    view->table  = tbl;
+    view->slot   = i;
+
+    return NodeTable_SetPosition(tbl, i, x, y, z);
+}
+
+size_t
+NodeTable_Size(pt_NodeTable tbl)
+{
+    if (!tbl)
+        return 0;
+    return tbl->size;
+}
+
+size_t
+NodeTable_Capacity(pt_NodeTable tbl)
+{
+    if (!tbl)
+        return 0;
+    return tbl->capacity;
+}
+
+/* @fn
+ * Return, through "re", a view of the "index"th row. The
+ * view works with every Node_* function and its setters
+ * write through to the table. It is owned by the table and
+ * MUST NOT outlive it.
+ */
+ds_stat
+NodeTable_GetNode(pt_NodeTable tbl, size_t index, pt_Node* re)
+{
+    if (!tbl || !re || index >= tbl->size)
+        return DS_ERROR;
+
+    *re = &tbl->views[index];
+    return DS_OK;
+}
+
+/* @fn
+ * Build a linked list of the views of all rows in table
+ * order, e.g. to feed ALGraph_Init(). The list must be
+ * destroyed WITHOUT a clear operation, since the views
+ * belong to the table.
+ */
+ds_stat
+NodeTable_ToList(pt_NodeTable tbl, p_sll* re)
+{
+    size_t   i;
+
+    if (!tbl || !re || *re)
+        return DS_ERROR;
+    if (SingleLinkedList_Init(re) == DS_ERROR)
+        return DS_ERROR;
+
+    for (i = 0; i < tbl->size; i++)
+        if (SingleLinkedList_InsertTail(*re, &tbl->views[i]) == DS_ERROR) {
+            SingleLinkedList_Destroy(re, NULL);
+            return DS_ERROR;
+        }
+    return DS_OK;
+}
+
+ds_stat
+NodeTable_SetStatus(pt_NodeTable tbl, size_t index, cdl_status s)
+{
+    if (!tbl || index >= tbl->size)
+        return DS_ERROR;
+
+    tbl->status[index]        = s;
+    tbl->views[index].status  = s;
+    return DS_OK;
+}
+
+ds_stat
+NodeTable_SetPower(pt_NodeTable tbl, size_t index, gqrm_power_t p)
+{
+    if (!tbl || index >= tbl->size)
+        return DS_ERROR;
+
+    tbl->power[index]        = p;
+    tbl->views[index].power  = p;
+    return DS_OK;
+}
+
+ds_stat
+NodeTable_SetHop(pt_NodeTable tbl, size_t index, gqrm_hop_t h)
 {
-    pt_Node* n = (pt_Node*)*nd;
-    Node_Free(n);
+    if (!tbl || index >= tbl->size)
+        return DS_ERROR;
+
+    tbl->hop[index]        = h;
+    tbl->views[index].hop  = h;
+    return DS_OK;
+}
+
+ds_stat
+NodeTable_SetPosition(pt_NodeTable tbl, size_t index, coordinate_t x,
+                      coordinate_t y, coordinate_t z)
+{
+    pt_Coordinate   co;
+
+    if (!tbl || index >= tbl->size)
+        return DS_ERROR;
+
+    tbl->x[index] = x;
+    tbl->y[index] = y;
+    tbl->z[index] = z;
+
+    co = tbl->views[index].pcoor;
+    Coordinate_SetX(co, x);
+    Coordinate_SetY(co, y);
+    Coordinate_SetZ(co, z);
+    return DS_OK;
+}
+
+ds_bool
+NodeTable_IsSelected(pt_NodeTable tbl, size_t index)
+{
+    if (!tbl || index >= tbl->size)
+        return DS_FALSE;
+    return tbl->status[index] == SLCT ? DS_TRUE : DS_FALSE;
+}
+
+/* @fn
+ * The following functions expose the column arrays for
+ * kernels streaming over many nodes. They are read-only,
+ * use the NodeTable_Set* functions to modify a row.
+ */
+const gqrm_id_t*
+NodeTable_IDs(pt_NodeTable tbl)
+{
+    return tbl ? tbl->ids : NULL;
+}
+
+const gqrm_power_t*
+NodeTable_Powers(pt_NodeTable tbl)
+{
+    return tbl ? tbl->power : NULL;
+}
+
+const gqrm_hop_t*
+NodeTable_Hops(pt_NodeTable tbl)
+{
+    return tbl ? tbl->hop : NULL;
+}
+
+const coordinate_t*
+NodeTable_Xs(pt_NodeTable tbl)
+{
+    return tbl ? tbl->x : NULL;
+}
+
+const coordinate_t*
+NodeTable_Ys(pt_NodeTable tbl)
+{
+    return tbl ? tbl->y : NULL;
+}
+
+const coordinate_t*
+NodeTable_Zs(pt_NodeTable tbl)
+{
+    return tbl ? tbl->z : NULL;
+}
+
+/* @fn
+ * Compute the Euclidean distance between the "i"th and the
+ * "j"th rows. Both indices MUST be valid.
+ */
+coordinate_t
+NodeTable_Distance(pt_NodeTable tbl, size_t i, size_t j)
+{
+    coordinate_t  dx, dy, dz;
+
+    assert(tbl);
+    assert(i < tbl->size && j < tbl->size);
+
+    dx = tbl->x[i] - tbl->x[j];
+    dy = tbl->y[i] - tbl->y[j];
+    dz = tbl->z[i] - tbl->z[j];
+
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/* @fn
+ * Row based counterpart of Node_IsNeighbor(), with the
+ * "i"th row as the transmitter.
+ */
+ds_bool
+NodeTable_IsNeighbor(pt_NodeTable tbl, size_t i, size_t j, double* re)
+{
+    if (!tbl || !re || i >= tbl->size || j >= tbl->size)
+        return DS_FALSE;
+    assert(tbl->power[i] >= 0.0);
+    assert(tbl->power[j] >= 0.0);
+
+    if (tbl->status[i] == UNSLCT || tbl->status[j] == UNSLCT)
+        return DS_FALSE;
+
+    *re = prr(tbl->power[i], NodeTable_Distance(tbl, i, j));
+    if (isnan(*re) || *re < PRR_CONSTRAINT)
+        return DS_FALSE;
+    return DS_TRUE;
 }
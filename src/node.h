@@ -29,6 +29,7 @@
 #include "coordinate.h"
 #include "prr.h"
 #include "single_linked_list.h"
+#include "vector.h"
 
 typedef enum NODE_T     node_t; 
 typedef enum STATUS     cdl_status;
@@ -36,6 +37,8 @@ typedef struct NODE     Node;
 typedef Node*           pt_Node;
 typedef struct NODES    Nodes;
 typedef Nodes*          pt_Nodes;
+typedef struct NODE_TABLE   NodeTable;
+typedef NodeTable*          pt_NodeTable;
 
 extern pt_Node      Node_CreateSN(pt_Coordinate, gqrm_id_t, gqrm_power_t, gqrm_hop_t);
 extern pt_Node      Node_CreateRandomSN(gqrm_id_t, gqrm_power_t, gqrm_hop_t);
@@ -44,7 +47,7 @@ extern pt_Node      Node_CreateRandomCDL(gqrm_id_t, gqrm_power_t, gqrm_hop_t);
 extern pt_Node      Node_CreateGW(pt_Coordinate, gqrm_id_t, gqrm_power_t, gqrm_hop_t);
 extern pt_Node      Node_CreateRandomGW(gqrm_id_t, gqrm_power_t, gqrm_hop_t);
 extern void         Node_Free(pt_Node*);
-extern ds_stat      Node_GetCoordinate(pt_Node, pt_Coordinate*);
+extern ds_stat      Node_GetCoordinate(pt_Node, const Coordinate**);
 extern ds_stat      Node_SetCoordinate(pt_Node, pt_Coordinate);
 extern ds_stat      Node_GetID(pt_Node, gqrm_id_t*);
 extern ds_stat      Node_GetPower(pt_Node, gqrm_power_t*);
@@ -74,4 +77,27 @@ extern void         Nodes_Free(pt_Nodes*);
 extern size_t       Nodes_Size(pt_Nodes);
 extern ds_bool      Nodes_Empty(pt_Nodes);
 extern ds_stat      Nodes_GetNode(pt_Nodes, size_t, pt_Node*);
+
+
+extern pt_NodeTable NodeTable_Create(size_t);
+extern pt_NodeTable NodeTable_CreateFromList(p_sll);
+extern void         NodeTable_Free(pt_NodeTable*);
+extern ds_stat      NodeTable_PushNode(pt_NodeTable, pt_Node);
+extern size_t       NodeTable_Size(pt_NodeTable);
+extern size_t       NodeTable_Capacity(pt_NodeTable);
+extern ds_stat      NodeTable_GetNode(pt_NodeTable, size_t, pt_Node*);
+extern ds_stat      NodeTable_ToList(pt_NodeTable, p_sll*);
+extern ds_stat      NodeTable_SetStatus(pt_NodeTable, size_t, cdl_status);
+extern ds_stat      NodeTable_SetPower(pt_NodeTable, size_t, gqrm_power_t);
+extern ds_stat      NodeTable_SetHop(pt_NodeTable, size_t, gqrm_hop_t);
+extern ds_stat      NodeTable_SetPosition(pt_NodeTable, size_t, coordinate_t, coordinate_t, coordinate_t);
+extern ds_bool      NodeTable_IsSelected(pt_NodeTable, size_t);
+extern const gqrm_id_t*    NodeTable_IDs(pt_NodeTable);
+extern const gqrm_power_t* NodeTable_Powers(pt_NodeTable);
+extern const gqrm_hop_t*   NodeTable_Hops(pt_NodeTable);
+extern const coordinate_t* NodeTable_Xs(pt_NodeTable);
+extern const coordinate_t* NodeTable_Ys(pt_NodeTable);
+extern const coordinate_t* NodeTable_Zs(pt_NodeTable);
+extern coordinate_t NodeTable_Distance(pt_NodeTable, size_t, size_t);
+extern ds_bool      NodeTable_IsNeighbor(pt_NodeTable, size_t, size_t, double*);
 #endif
@@ -0,0 +1,257 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "node_pool.h"
+
+/* nodes in the first slab of a pool, and the most in any */
+#define POOL_MIN_SLAB    32
+#define POOL_MAX_SLAB    65536
+
+/* @struct
+ * A block of memory nodes are carved from.
+ * next  - the slab allocated before this one
+ * count - the number of nodes this slab holds
+ * nodes - the nodes, aligned for pointers, doubles and
+ *         long integers
+ */
+typedef struct SLAB {
+    struct SLAB*   next;
+    size_t         count;
+    union {
+        void*        p;
+        double       d;
+        long long    l;
+    }              nodes[1];
+} slab;
+
+/* @struct
+ * Structure of a pool.
+ * node_size - the size of a node, rounded up for alignment
+ * align     - the alignment of nodes
+ * slabs     - the slabs, newest first
+ * carved    - the number of nodes handed out from the
+ *             newest slab so far
+ * free_list - released nodes, linked through their first word
+ * used      - the number of nodes currently handed out
+ */
+struct NODE_POOL {
+    size_t     node_size;
+    size_t     align;
+    slab*      slabs;
+    size_t     carved;
+    void*      free_list;
+    size_t     used;
+};
+
+static size_t  next_slab(pt_NodePool);
+static char*   slab_base(pt_NodePool, slab*);
+static ds_stat add_slab(pt_NodePool, size_t);
+
+/* @fn
+ * Create an empty pool of nodes of "size" bytes.
+ */
+pt_NodePool
+NodePool_Create(size_t size)
+{
+    return NodePool_CreateAligned(size, sizeof(((slab*)0)->nodes[0]));
+}
+
+/* @fn
+ * Create an empty pool of nodes of "size" bytes starting at
+ * multiples of "align", a power of two, e.g. the size of a
+ * cache line.
+ */
+pt_NodePool
+NodePool_CreateAligned(size_t size, size_t align)
+{
+    pt_NodePool   pool;
+
+    if (size == 0 || align == 0 || (align & (align - 1)))
+        return NULL;
+    if (align < sizeof(((slab*)0)->nodes[0]))
+        align = sizeof(((slab*)0)->nodes[0]);
+    if ((pool = malloc(sizeof(NodePool))) == NULL)
+        return NULL;
+    pool->node_size = (size + align - 1) / align * align;
+    pool->align     = align;
+    pool->slabs     = NULL;
+    pool->carved    = 0;
+    pool->free_list = NULL;
+    pool->used      = 0;
+    return pool;
+}
+
+/* @fn
+ * Hand out a node, reusing a released one if any. Its
+ * content is undefined.
+ */
+void*
+NodePool_Alloc(pt_NodePool pool)
+{
+    void*   nd;
+
+    if (!pool)
+        return NULL;
+    if (pool->free_list) {
+        nd = pool->free_list;
+        pool->free_list = *(void**)nd;
+    } else {
+        if (!pool->slabs || pool->carved == pool->slabs->count)
+            if (add_slab(pool, next_slab(pool)) == DS_ERROR)
+                return NULL;
+        nd = slab_base(pool, pool->slabs) + pool->carved++ * pool->node_size;
+    }
+    pool->used++;
+    return nd;
+}
+
+/* @fn
+ * Give a node back to the pool it came from.
+ */
+void
+NodePool_Release(pt_NodePool pool, void* nd)
+{
+    if (!pool || !nd)
+        return;
+    *(void**)nd = pool->free_list;
+    pool->free_list = nd;
+    pool->used--;
+}
+
+/* @fn
+ * Make sure the next "n" allocations need at most one more
+ * slab, e.g. before copying a tree of "n" nodes.
+ */
+ds_stat
+NodePool_Reserve(pt_NodePool pool, size_t n)
+{
+    size_t   left;
+
+    if (!pool)
+        return DS_ERROR;
+    left = pool->slabs ? pool->slabs->count - pool->carved : 0;
+    if (left >= n)
+        return DS_OK;
+    return add_slab(pool, n > next_slab(pool) ? n : next_slab(pool));
+}
+
+size_t
+NodePool_Used(pt_NodePool pool)
+{
+    return pool ? pool->used : 0;
+}
+
+/* @fn
+ * Release every node at once. The largest slab is kept so
+ * that refilling the pool to its former size allocates
+ * little.
+ */
+void
+NodePool_Clear(pt_NodePool pool)
+{
+    slab*   s;
+    slab*   keep;
+
+    if (!pool || !pool->slabs)
+        return;
+    for (keep = s = pool->slabs; s; s = s->next)
+        if (s->count > keep->count)
+            keep = s;
+    while ((s = pool->slabs) != NULL) {
+        pool->slabs = s->next;
+        if (s != keep)
+            free(s);
+    }
+    keep->next      = NULL;
+    pool->slabs     = keep;
+    pool->carved    = 0;
+    pool->free_list = NULL;
+    pool->used      = 0;
+}
+
+void
+NodePool_Free(pt_NodePool* pool)
+{
+    slab*   s;
+
+    if (!pool || !*pool)
+        return;
+    while ((s = (*pool)->slabs) != NULL) {
+        (*pool)->slabs = s->next;
+        free(s);
+    }
+    free(*pool);
+    *pool = NULL;
+}
+
+/* @fn
+ * Start carving from a new slab of at least "count" nodes.
+ * Nodes left in the previous slab are put on the free list
+ * so that none is lost.
+ */
+static ds_stat
+add_slab(pt_NodePool pool, size_t count)
+{
+    slab*   s;
+    char*   nd;
+
+    /* room to move the first node up to the alignment */
+    if ((s = malloc(offsetof(slab, nodes) + count * pool->node_size +
+                    pool->align - sizeof(s->nodes[0]))) == NULL)
+        return DS_ERROR;
+    if (pool->slabs)
+        for (; pool->carved < pool->slabs->count; pool->carved++) {
+            nd = slab_base(pool, pool->slabs) + pool->carved * pool->node_size;
+            *(void**)nd = pool->free_list;
+            pool->free_list = nd;
+        }
+    s->count    = count;
+    s->next     = pool->slabs;
+    pool->slabs = s;
+    pool->carved = 0;
+    return DS_OK;
+}
+
+/* @fn
+ * Size of the next slab: twice the newest one, within
+ * [POOL_MIN_SLAB, POOL_MAX_SLAB].
+ */
+static size_t
+next_slab(pt_NodePool pool)
+{
+    size_t   count;
+
+    if (!pool->slabs)
+        return POOL_MIN_SLAB;
+    count = pool->slabs->count * 2;
+    if (count < POOL_MIN_SLAB)
+        return POOL_MIN_SLAB;
+    return count > POOL_MAX_SLAB ? POOL_MAX_SLAB : count;
+}
+
+/* @fn
+ * Address of the first node of slab "s".
+ */
+static char*
+slab_base(pt_NodePool pool, slab* s)
+{
+    uintptr_t   p = (uintptr_t)s->nodes;
+
+    return (char*)s->nodes + ((pool->align - p % pool->align) % pool->align);
+}
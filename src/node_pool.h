@@ -0,0 +1,52 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* @file node_pool.h
+ *
+ * Slab allocator for fixed-size tree nodes.
+ *
+ * A pool hands out nodes of one size carved from slabs that
+ * double in size as the pool grows. Released nodes go to a
+ * free list and are reused first. All nodes of a pool are
+ * released at once by NodePool_Clear(), which keeps the
+ * largest slab for reuse, or NodePool_Free(); neither walks
+ * the nodes. A pool is not thread-safe, every tree owns one.
+ */
+
+#ifndef GQRM_NODE_POOL_H
+#define GQRM_NODE_POOL_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "header.h"
+
+typedef struct NODE_POOL    NodePool;
+typedef NodePool*           pt_NodePool;
+
+extern pt_NodePool   NodePool_Create(size_t);
+extern pt_NodePool   NodePool_CreateAligned(size_t, size_t);
+extern void*         NodePool_Alloc(pt_NodePool);
+extern void          NodePool_Release(pt_NodePool, void*);
+extern ds_stat       NodePool_Reserve(pt_NodePool, size_t);
+extern size_t        NodePool_Used(pt_NodePool);
+extern void          NodePool_Clear(pt_NodePool);
+extern void          NodePool_Free(pt_NodePool*);
+#endif
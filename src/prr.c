@@ -89,5 +89,6 @@ ber(const double pt, const double d) {
 double 
 prr(const double pt, const double d) {
     double p = - pt;
+    METRIC_INC(METRIC_PRR_CALLS);
     return pow(1.0 - ber(p, d), 8 * BITS);
 }
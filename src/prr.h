@@ -23,6 +23,8 @@
 
 #include <math.h>
 
+#include "metrics.h"
+
 extern double PRR_CONSTRAINT;
 
 extern double prr(const double, const double);
@@ -51,23 +51,43 @@ typedef struct _rbt_node {
  * cmp    - function used to compare data stored in nodes
  *          of this red-black tree
  * size   - the number of nodes in this tree
+ * pool   - the pool nodes of this tree are allocated from
  */
 struct _rb_tree{
     p_rbt_node           root;
 	rbt_cmp              cmp;
 	size_t               size;
+	pt_NodePool          pool;
 };
 
+/* an upper bound of the height of any red-black tree */
+#define MAX_HEIGHT    128
+
+/** @enum
+ * Orders a tree is walked in.
+ */
+typedef enum {
+    PRE_ORDER, IN_ORDER, POST_ORDER
+} walk_order;
+
 static rbt_color color(p_rbt_node);
-static p_rbt_node create_node(rbt_data_t, rbt_color);
-static ds_stat pre_map_subtree(p_rbt_node, rbt_map_func, size_t);
-static ds_stat in_map_subtree(p_rbt_node, rbt_map_func, size_t);
-static ds_stat post_map_subtree(p_rbt_node, rbt_map_func, size_t);
+static p_rbt_node create_node(pt_RBTree, rbt_data_t, rbt_color);
+static ds_stat map_subtree(p_rbt_node, rbt_map_func, walk_order);
 static ds_stat insert(pt_RBTree, p_rbt_node, rbt_data_t);
 static ds_stat insert_fixup(pt_RBTree, p_rbt_node);
 static ds_stat left_rotate(p_rbt_node*);
 static ds_stat right_rotate(p_rbt_node*);
 static ds_stat get_uncle(p_rbt_node, p_rbt_node*);
+static p_rbt_node* link_of(pt_RBTree, p_rbt_node);
+static p_rbt_node find_node(pt_RBTree, rbt_data_t);
+static p_rbt_node bound_node(pt_RBTree, rbt_data_t, ds_bool);
+static p_rbt_node min_node(p_rbt_node);
+static p_rbt_node max_node(p_rbt_node);
+static p_rbt_node successor(p_rbt_node);
+static ds_stat delete_fixup(pt_RBTree, p_rbt_node, p_rbt_node);
+static size_t height(p_rbt_node);
+static p_rbt_node copy_subtree(pt_NodePool, p_rbt_node);
+static p_rbt_node build_subtree(pt_NodePool, rbt_data_t[], size_t, size_t, size_t);
 
 static rbt_color
 color(p_rbt_node nd)
@@ -78,14 +98,14 @@ color(p_rbt_node nd)
 }
 
 static p_rbt_node
-create_node(rbt_data_t data, rbt_color color)
+create_node(pt_RBTree rb, rbt_data_t data, rbt_color color)
 {
     p_rbt_node    nd;
 
     if (!data)
 	    return NULL;
 	
-	if ((nd = malloc(sizeof(rbt_node))) == NULL)
+	if ((nd = NodePool_Alloc(rb->pool)) == NULL)
 	    return NULL;
 	
 	nd->data    = data;
@@ -94,6 +114,8 @@ create_node(rbt_data_t data, rbt_color color)
 	nd->parent  = NULL;
 	nd->height  = 1;
 	nd->color   = color;
+
+	return nd;
 }
 
 pt_RBTree
@@ -106,6 +128,10 @@ RBTree_Create(rbt_cmp cmp)
 	
 	if ((rbt = malloc(sizeof(RBTree))) == NULL)
 	    return NULL;
+	if ((rbt->pool = NodePool_Create(sizeof(rbt_node))) == NULL) {
+	    free(rbt);
+		return NULL;
+	}
 	
 	rbt->root  = NULL;
 	rbt->cmp   = cmp;
@@ -114,6 +140,31 @@ RBTree_Create(rbt_cmp cmp)
 	return rbt;
 }
 
+/** @fn
+ * Remove all nodes at once by clearing the node pool; the
+ * tree is not walked.
+ */
+void
+RBTree_Clear(pt_RBTree rb)
+{
+    if (!rb)
+	    return;
+	NodePool_Clear(rb->pool);
+	rb->root = NULL;
+	rb->size = 0;
+}
+
+void
+RBTree_Free(pt_RBTree* rb)
+{
+    if (!rb || !(*rb))
+	    return;
+
+    NodePool_Free(&(*rb)->pool);
+	free(*rb);
+	*rb = NULL;
+}
+
 size_t
 RBTree_Size(pt_RBTree rb)
 {
@@ -127,7 +178,7 @@ RBTree_PreOrderMap(pt_RBTree rbt, rbt_map_func func)
 {
     if (!rbt)
 	    return DS_ERROR;
-	return pre_map_subtree(rbt->root, func, 0);
+	return map_subtree(rbt->root, func, PRE_ORDER);
 }
 
 ds_stat
@@ -135,7 +186,7 @@ RBTree_InOrderMap(pt_RBTree rbt, rbt_map_func func)
 {
     if (!rbt)
 	    return DS_ERROR;
-	return in_map_subtree(rbt->root, func, 0);
+	return map_subtree(rbt->root, func, IN_ORDER);
 }
 
 ds_stat
@@ -143,46 +194,50 @@ RBTree_PostOrderMap(pt_RBTree rbt, rbt_map_func func)
 {
     if (!rbt)
 	    return DS_ERROR;
-	return post_map_subtree(rbt->root, func, 0);
+	return map_subtree(rbt->root, func, POST_ORDER);
 }
 
+/** @fn
+ * Visit subtree "sub" in the given order without recursion.
+ * The ancestors of the current node are kept on a stack
+ * local to this function, whose size is the depth of the
+ * current node; a red-black tree of 2^64 nodes is at most
+ * 128 high.
+ */
 static ds_stat
-pre_map_subtree(p_rbt_node sub, rbt_map_func func, size_t depth)
+map_subtree(p_rbt_node sub, rbt_map_func func, walk_order order)
 {
-    if (!sub || !func)
-	    return DS_ERROR;
-	
-	func(sub->data, depth);
-	pre_map_subtree(sub->left, func, depth + 1);
-	pre_map_subtree(sub->right, func, depth + 1);
-	return DS_OK;
-}
+    p_rbt_node   stack[MAX_HEIGHT], last = NULL, top;
+	size_t       n = 0;
 
-static ds_stat
-in_map_subtree(p_rbt_node sub, rbt_map_func func, size_t depth)
-{
-    if (!sub || !func)
+	if (!sub || !func)
 	    return DS_ERROR;
 	
-	in_map_subtree(sub->left, func, depth + 1);
-	if (sub->color == RED)
-	    printf("r");
-	else
-	    printf("b");
-	func(sub->data, depth);
-	in_map_subtree(sub->right, func, depth + 1);
-	return DS_OK;
-}
-
-static ds_stat
-post_map_subtree(p_rbt_node sub, rbt_map_func func, size_t depth)
-{
-    if (!sub || !func)
-	    return DS_ERROR;
-	
-	post_map_subtree(sub->left, func, depth + 1);
-	post_map_subtree(sub->right, func, depth + 1);
-	func(sub->data, depth);
+	while (sub || n) {
+	    if (sub) {
+		    /* going down the left spine */
+		    if (order == PRE_ORDER)
+			    func(sub->data, n);
+			assert(n < MAX_HEIGHT);
+			stack[n++] = sub;
+			sub = sub->left;
+			continue;
+		}
+		top = stack[n - 1];
+		if (!top->right || last != top->right) {
+		    /* back from the left subtree */
+		    if (order == IN_ORDER)
+			    func(top->data, n - 1);
+			if (top->right) {
+			    sub = top->right;
+				continue;
+			}
+		}
+		if (order == POST_ORDER)
+		    func(top->data, n - 1);
+		last = top;
+		n--;
+	}
 	return DS_OK;
 }
 
@@ -195,7 +250,8 @@ RBTree_Insert(pt_RBTree rb, rbt_data_t data)
     if (!rb)
 	    return DS_ERROR;
 	if (rb->root == NULL) {
-	    rb->root = create_node(data, BLACK);
+	    if ((rb->root = create_node(rb, data, BLACK)) == NULL)
+		    return DS_ERROR;
 		rb->size++;
 		return DS_OK;
 	}
@@ -220,7 +276,7 @@ insert(pt_RBTree rb, p_rbt_node sub, rbt_data_t data)
 		    if (sub->right) {
 			    sub = sub->right;
 			} else {
-			    if ((nd = create_node(data, RED)) == NULL)
+			    if ((nd = create_node(rb, data, RED)) == NULL)
 				    return DS_ERROR;
 			    sub->right = nd;
 				nd->parent = sub;
@@ -231,7 +287,7 @@ insert(pt_RBTree rb, p_rbt_node sub, rbt_data_t data)
 		    if (sub->left) {
 			    sub = sub->left;
 			} else {
-			    if ((nd = create_node(data, RED)) == NULL)
+			    if ((nd = create_node(rb, data, RED)) == NULL)
 				    return DS_ERROR;
 			    sub->left = nd;
 				nd->parent = sub;
@@ -277,10 +333,9 @@ insert_fixup(pt_RBTree rb, p_rbt_node sub)
 
 		    /* left cases */
 		    if (sub->parent->parent->left == sub->parent) {
-			    printf("left ");
 			    /* left right case */
 			    if (sub->parent->right == sub) {
-				    printf("right\n");
+				    TRACE_DEBUG(TRACE_TREE, "left right case");
 				    sub = sub->parent;
 				    if (left_rotate(&sub->parent->left) == DS_ERROR)
 					    return DS_ERROR;
@@ -292,12 +347,11 @@ insert_fixup(pt_RBTree rb, p_rbt_node sub)
 				sub->parent->right->color = RED;
 			/* right cases */
 			} else if (sub->parent->parent->right == sub->parent) {
-			    printf("right ");
 			    /* right left case */
 			    if (sub->parent->left == sub) {
-				    printf("left\n");
+				    TRACE_DEBUG(TRACE_TREE, "right left case");
 				    sub = sub->parent;
-					if (right_rotate(&sub->parent->left) == DS_ERROR)
+					if (right_rotate(&sub->parent->right) == DS_ERROR)
 					    return DS_ERROR;
 				}
 				/* right right case */
@@ -390,3 +444,421 @@ get_uncle(p_rbt_node sub, p_rbt_node* uncle)
 	    *uncle = sub->parent->parent->left;
 	return DS_OK;
 }
+
+/** @fn
+ * The link pointing to node "nd": the root pointer or a
+ * child pointer of its parent.
+ */
+static p_rbt_node*
+link_of(pt_RBTree rb, p_rbt_node nd)
+{
+    if (!nd->parent)
+	    return &rb->root;
+	if (nd->parent->left == nd)
+	    return &nd->parent->left;
+	return &nd->parent->right;
+}
+
+static p_rbt_node
+find_node(pt_RBTree rb, rbt_data_t data)
+{
+    p_rbt_node   sub = rb->root;
+	int          c;
+
+	while (sub) {
+	    if ((c = rb->cmp(data, sub->data)) == 0)
+		    return sub;
+		sub = c < 0 ? sub->left : sub->right;
+	}
+	return NULL;
+}
+
+/** @fn
+ * The first node not less than "data", or greater than
+ * "data" if "strict".
+ */
+static p_rbt_node
+bound_node(pt_RBTree rb, rbt_data_t data, ds_bool strict)
+{
+    p_rbt_node   sub = rb->root, re = NULL;
+	int          c;
+
+	while (sub) {
+	    c = rb->cmp(data, sub->data);
+		if (c < 0 || (c == 0 && !strict)) {
+		    re = sub;
+			sub = sub->left;
+		} else {
+		    sub = sub->right;
+		}
+	}
+	return re;
+}
+
+static p_rbt_node
+min_node(p_rbt_node sub)
+{
+    if (sub)
+	    while (sub->left)
+		    sub = sub->left;
+	return sub;
+}
+
+static p_rbt_node
+max_node(p_rbt_node sub)
+{
+    if (sub)
+	    while (sub->right)
+		    sub = sub->right;
+	return sub;
+}
+
+/** @fn
+ * The next node in order, following parent pointers.
+ */
+static p_rbt_node
+successor(p_rbt_node nd)
+{
+    if (nd->right)
+	    return min_node(nd->right);
+	while (nd->parent && nd->parent->right == nd)
+	    nd = nd->parent;
+	return nd->parent;
+}
+
+/** @fn
+ * Find the data equal to "data" and return it through "re".
+ */
+ds_stat
+RBTree_Find(pt_RBTree rb, rbt_data_t data, rbt_data_t* re)
+{
+    p_rbt_node   nd;
+
+    if (!rb || !data || !re)
+	    return DS_ERROR;
+	if ((nd = find_node(rb, data)) == NULL)
+	    return DS_ERROR;
+	*re = nd->data;
+	return DS_OK;
+}
+
+ds_bool
+RBTree_Contain(pt_RBTree rb, rbt_data_t data)
+{
+    if (!rb || !data)
+	    return DS_FALSE;
+	return find_node(rb, data) ? DS_TRUE : DS_FALSE;
+}
+
+/** @fn
+ * Return through "re" the smallest data not less than
+ * "data".
+ */
+ds_stat
+RBTree_LowerBound(pt_RBTree rb, rbt_data_t data, rbt_data_t* re)
+{
+    p_rbt_node   nd;
+
+    if (!rb || !data || !re)
+	    return DS_ERROR;
+	if ((nd = bound_node(rb, data, DS_FALSE)) == NULL)
+	    return DS_ERROR;
+	*re = nd->data;
+	return DS_OK;
+}
+
+/** @fn
+ * Return through "re" the smallest data greater than
+ * "data".
+ */
+ds_stat
+RBTree_UpperBound(pt_RBTree rb, rbt_data_t data, rbt_data_t* re)
+{
+    p_rbt_node   nd;
+
+    if (!rb || !data || !re)
+	    return DS_ERROR;
+	if ((nd = bound_node(rb, data, DS_TRUE)) == NULL)
+	    return DS_ERROR;
+	*re = nd->data;
+	return DS_OK;
+}
+
+ds_stat
+RBTree_GetMin(pt_RBTree rb, rbt_data_t* re)
+{
+    if (!rb || !rb->root || !re)
+	    return DS_ERROR;
+	*re = min_node(rb->root)->data;
+	return DS_OK;
+}
+
+ds_stat
+RBTree_GetMax(pt_RBTree rb, rbt_data_t* re)
+{
+    if (!rb || !rb->root || !re)
+	    return DS_ERROR;
+	*re = max_node(rb->root)->data;
+	return DS_OK;
+}
+
+/** @fn
+ * Delete the data equal to "data". A node with two
+ * children takes the data of its successor, which is
+ * unlinked instead.
+ */
+ds_stat
+RBTree_Delete(pt_RBTree rb, rbt_data_t data)
+{
+    p_rbt_node   del, x, x_parent;
+
+    if (!rb || !data)
+	    return DS_ERROR;
+	if ((del = find_node(rb, data)) == NULL)
+	    return DS_ERROR;
+	
+	if (del->left && del->right) {
+	    x = min_node(del->right);
+		del->data = x->data;
+		del = x;
+	}
+	/* "del" has at most one child, which takes its place */
+	x = del->left ? del->left : del->right;
+	x_parent = del->parent;
+	if (x)
+	    x->parent = x_parent;
+	*link_of(rb, del) = x;
+	if (del->color == BLACK)
+	    delete_fixup(rb, x, x_parent);
+
+	NodePool_Release(rb->pool, del);
+	rb->size--;
+	return DS_OK;
+}
+
+/** @fn
+ * Restore the black height after a black node was removed
+ * above "sub", which may be NULL, hence its parent is
+ * passed along.
+ */
+static ds_stat
+delete_fixup(pt_RBTree rb, p_rbt_node sub, p_rbt_node parent)
+{
+    p_rbt_node   sib;
+
+	while (sub != rb->root && color(sub) == BLACK) {
+	    if (parent->left == sub) {
+		    sib = parent->right;
+			if (color(sib) == RED) {
+			    sib->color = BLACK;
+				parent->color = RED;
+				left_rotate(link_of(rb, parent));
+				sib = parent->right;
+			}
+			if (color(sib->left) == BLACK && color(sib->right) == BLACK) {
+			    sib->color = RED;
+				sub = parent;
+				parent = sub->parent;
+			} else {
+			    if (color(sib->right) == BLACK) {
+				    sib->left->color = BLACK;
+					sib->color = RED;
+					right_rotate(link_of(rb, sib));
+					sib = parent->right;
+				}
+				sib->color = parent->color;
+				parent->color = BLACK;
+				sib->right->color = BLACK;
+				left_rotate(link_of(rb, parent));
+				sub = rb->root;
+			}
+		} else {
+		    sib = parent->left;
+			if (color(sib) == RED) {
+			    sib->color = BLACK;
+				parent->color = RED;
+				right_rotate(link_of(rb, parent));
+				sib = parent->left;
+			}
+			if (color(sib->left) == BLACK && color(sib->right) == BLACK) {
+			    sib->color = RED;
+				sub = parent;
+				parent = sub->parent;
+			} else {
+			    if (color(sib->left) == BLACK) {
+				    sib->right->color = BLACK;
+					sib->color = RED;
+					left_rotate(link_of(rb, sib));
+					sib = parent->left;
+				}
+				sib->color = parent->color;
+				parent->color = BLACK;
+				sib->left->color = BLACK;
+				right_rotate(link_of(rb, parent));
+				sub = rb->root;
+			}
+		}
+	}
+	if (sub)
+	    sub->color = BLACK;
+	return DS_OK;
+}
+
+size_t
+RBTree_Height(pt_RBTree rb)
+{
+    if (!rb)
+	    return 0;
+	return height(rb->root);
+}
+
+static size_t
+height(p_rbt_node sub)
+{
+    size_t   lh, rh;
+
+    if (!sub)
+	    return 0;
+	lh = height(sub->left);
+	rh = height(sub->right);
+	return lh > rh ? lh + 1 : rh + 1;
+}
+
+pt_RBTree
+RBTree_Copy(pt_RBTree rb)
+{
+    pt_RBTree   cpy;
+
+	if (!rb)
+	    return NULL;
+	if ((cpy = RBTree_Create(rb->cmp)) == NULL)
+	    return NULL;
+	/* one slab for the whole copy */
+	if (NodePool_Reserve(cpy->pool, rb->size) == DS_ERROR ||
+	    ((cpy->root = copy_subtree(cpy->pool, rb->root)) == NULL && rb->root)) {
+	    RBTree_Free(&cpy);
+		return NULL;
+	}
+	cpy->size = rb->size;
+	return cpy;
+}
+
+static p_rbt_node
+copy_subtree(pt_NodePool pool, p_rbt_node from)
+{
+    p_rbt_node   cpy;
+
+	if (!from)
+	    return NULL;
+	if ((cpy = NodePool_Alloc(pool)) == NULL)
+	    return NULL;
+	*cpy = *from;
+	cpy->parent = NULL;
+	if ((cpy->left = copy_subtree(pool, from->left)) != NULL)
+	    cpy->left->parent = cpy;
+	if ((cpy->right = copy_subtree(pool, from->right)) != NULL)
+	    cpy->right->parent = cpy;
+	if ((from->left && !cpy->left) || (from->right && !cpy->right))
+	    return NULL;
+	return cpy;
+}
+
+/** @fn
+ * Position an iterator before the smallest data.
+ */
+void
+RBTree_Begin(pt_RBTree rb, rbt_iter* it)
+{
+    if (!it)
+	    return;
+	it->tree = rb;
+	it->next = rb ? min_node(rb->root) : NULL;
+}
+
+/** @fn
+ * Position an iterator before the smallest data not less
+ * than "data".
+ */
+void
+RBTree_Seek(pt_RBTree rb, rbt_data_t data, rbt_iter* it)
+{
+    if (!it)
+	    return;
+	it->tree = rb;
+	it->next = rb && data ? bound_node(rb, data, DS_FALSE) : NULL;
+}
+
+/** @fn
+ * Return the next data in order through "re". DS_FALSE once
+ * the tree is done. The tree must not be modified while it
+ * is iterated.
+ */
+ds_bool
+RBTree_Next(rbt_iter* it, rbt_data_t* re)
+{
+    if (!it || !it->next)
+	    return DS_FALSE;
+	if (re)
+	    *re = it->next->data;
+	it->next = successor(it->next);
+	return DS_TRUE;
+}
+
+/** @fn
+ * Replace the content of this red-black tree by the "n"
+ * data of "array", which must be strictly increasing under
+ * the tree's compare function, in O(n). The tree is built
+ * with the middle data at the root of every subtree, so all
+ * levels but the deepest one are full; the nodes of that
+ * level are red and all others black.
+ */
+ds_stat
+RBTree_BuildFromSorted(pt_RBTree rb, rbt_data_t array[], size_t n)
+{
+    size_t   full;
+
+    if (!rb || (!array && n))
+	    return DS_ERROR;
+
+    RBTree_Clear(rb);
+	if (NodePool_Reserve(rb->pool, n) == DS_ERROR)
+	    return DS_ERROR;
+	/* levels 0 .. full - 1 are full */
+	for (full = 0; ((size_t)2 << full) <= n + 1; full++)
+	    ;
+	if ((rb->root = build_subtree(rb->pool, array, n, 0, full)) == NULL && n) {
+	    RBTree_Clear(rb);
+		return DS_ERROR;
+	}
+	if (rb->root)
+	    rb->root->color = BLACK;
+	rb->size = n;
+	return DS_OK;
+}
+
+static p_rbt_node
+build_subtree(pt_NodePool pool, rbt_data_t array[], size_t n, size_t depth,
+              size_t red_depth)
+{
+    p_rbt_node   nd;
+	size_t       mid = n / 2;
+
+    if (n == 0)
+	    return NULL;
+	if ((nd = NodePool_Alloc(pool)) == NULL)
+	    return NULL;
+	
+	nd->data   = array[mid];
+	nd->parent = NULL;
+	nd->height = 1;
+	nd->color  = depth == red_depth ? RED : BLACK;
+	nd->left   = build_subtree(pool, array, mid, depth + 1, red_depth);
+	nd->right  = build_subtree(pool, array + mid + 1, n - mid - 1, depth + 1, red_depth);
+	if ((mid && !nd->left) || (n - mid - 1 && !nd->right))
+	    return NULL;
+	if (nd->left)
+	    nd->left->parent = nd;
+	if (nd->right)
+	    nd->right->parent = nd;
+	return nd;
+}
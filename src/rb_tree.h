@@ -27,6 +27,8 @@
 #include <stdio.h>
 
 #include "header.h"
+#include "node_pool.h"
+#include "trace.h"
 
 typedef struct _rb_tree      RBTree;
 typedef RBTree*              pt_RBTree;
@@ -34,11 +36,37 @@ typedef void*                rbt_data_t;
 typedef int (*rbt_cmp)(rbt_data_t, rbt_data_t);
 typedef void (*rbt_map_func)(rbt_data_t, size_t);
 
+/* @struct
+ * Cursor over a red-black tree in order. Its fields are
+ * private to the tree.
+ * tree - the tree iterated
+ * next - the node RBTree_Next() returns next, NULL when done
+ */
+typedef struct {
+    pt_RBTree            tree;
+    struct _rbt_node*    next;
+} rbt_iter;
+
 extern pt_RBTree RBTree_Create(rbt_cmp);
 extern ds_stat   RBTree_PreOrderMap(pt_RBTree, rbt_map_func);
 extern ds_stat   RBTree_InOrderMap(pt_RBTree, rbt_map_func);
 extern ds_stat   RBTree_PostOrderMap(pt_RBTree, rbt_map_func);
 extern ds_stat   RBTree_Insert(pt_RBTree, rbt_data_t);
 extern size_t    RBTree_Size(pt_RBTree);
+extern void      RBTree_Clear(pt_RBTree);
+extern void      RBTree_Free(pt_RBTree*);
+extern ds_stat   RBTree_Delete(pt_RBTree, rbt_data_t);
+extern ds_stat   RBTree_Find(pt_RBTree, rbt_data_t, rbt_data_t*);
+extern ds_bool   RBTree_Contain(pt_RBTree, rbt_data_t);
+extern ds_stat   RBTree_LowerBound(pt_RBTree, rbt_data_t, rbt_data_t*);
+extern ds_stat   RBTree_UpperBound(pt_RBTree, rbt_data_t, rbt_data_t*);
+extern ds_stat   RBTree_GetMin(pt_RBTree, rbt_data_t*);
+extern ds_stat   RBTree_GetMax(pt_RBTree, rbt_data_t*);
+extern size_t    RBTree_Height(pt_RBTree);
+extern pt_RBTree RBTree_Copy(pt_RBTree);
+extern void      RBTree_Begin(pt_RBTree, rbt_iter*);
+extern void      RBTree_Seek(pt_RBTree, rbt_data_t, rbt_iter*);
+extern ds_bool   RBTree_Next(rbt_iter*, rbt_data_t*);
+extern ds_stat   RBTree_BuildFromSorted(pt_RBTree, rbt_data_t [], size_t);
 
 #endif
@@ -20,8 +20,8 @@
 
 #include "rnp_misc.h"
 
-static ds_bool error_clear(pt_ALGraph*);
-static ds_bool is_dst(gqrm_id_t[], size_t, gqrm_id_t);
+static ds_bool feasibility(pt_ALGraph, gqrm_id_t, gqrm_id_t[], size_t);
+static ds_bool error_clear(pt_BFSGraph*, vertex_weight_t*, gqrm_id_t*);
 
 /* @fn 
  * Check whether the given graph has a feasible 
@@ -32,65 +32,69 @@ static ds_bool is_dst(gqrm_id_t[], size_t, gqrm_id_t);
  * each destination vertex fulfill hop constraints;
  * 2) no destination vertex is isolated from the 
  * source vertex.
+ * Hop counts are computed by BFS_Run(), unreachable
+ * vertices getting VERTEX_WEIGHT_INF.
  */
 ds_bool
 check_feasibility(pt_ALGraph pg, gqrm_id_t src, 
                   gqrm_id_t dsts[], size_t n)
 {
-    pt_ALGraph         spt = NULL; 
-	pt_ALGraph         cpy = NULL;
-	size_t             size, i;
+    ds_bool   ok;
+
+    METRIC_INC(METRIC_FEASIBILITY_CHECKS);
+    METRIC_TIMER_BEGIN(t0);
+    ok = feasibility(pg, src, dsts, n);
+    METRIC_TIMER_END(TIMER_FEASIBILITY, t0);
+    return ok;
+}
+
+static ds_bool
+feasibility(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
+{
+    pt_BFSGraph        g = NULL;
+	size_t             size, i, s, d;
 	pt_Vertex          pv = NULL;
-	vertex_weight_t    hop;
+	vertex_weight_t*   hops = NULL;
+	gqrm_id_t*         parents = NULL;
 	pt_Node            pn = NULL;
-	gqrm_id_t          id, parent;
 	gqrm_hop_t         hop_constraint;
 
-	if (!pg)
+	if (!pg || ALGraph_Size(pg) <= 0)
 	    return DS_FALSE;
-	if ((spt = ALGraph_ShortestPathTree(pg, src, dsts, n)) == NULL)
+	if ((g = BFSGraph_Create(pg)) == NULL)
 	    return DS_FALSE;
-
-	size = ALGraph_Size(pg);
-	for (i = 0; i < size; i++) {
-	    if (ALGraph_GetVertex(spt, i, &pv) == DS_ERROR)
-		    return error_clear(&spt);
-		if (Vertex_GetID(pv, &id) == DS_ERROR)
-		    return error_clear(&spt);
-		/* we should only check the destination vertex */
-		if (is_dst(dsts, n, id) == DS_TRUE) {
-		    /* get its least hop count to the source vertex */
-		    if (Vertex_GetWeight(pv, &hop) == DS_ERROR)
-		        return error_clear(&spt);
-    		if (Vertex_GetData(pv, (graph_data_t)&pn) == DS_ERROR)
-	    	    return error_clear(&spt);
-			/* get the hop constraint imposed on this vertex */
-		    if (Node_GetHop(pn, &hop_constraint) == DS_ERROR)
-		        return error_clear(&spt);
-			/* check whether hop constraint is met */
-		    if (hop > hop_constraint) {
-		        return error_clear(&spt);
-			}
-			/* 
-			 * check whether this destination is isolated from 
-			 * the srouce vertex.
-			 */
-			while (id != -1) {
-		        if (Vertex_GetParent(pv, &parent) == DS_ERROR)
-		            return error_clear(&spt);
-				if (parent == src) {
-				    break;
-				} else if (parent == -1) {
-				    return error_clear(&spt);
-				} else {
-				    id = parent;
-					if (ALGraph_GetVertexByID(spt, id, &pv) == DS_ERROR)
-		                return error_clear(&spt);
-				}
-			}
-		}
+	size    = BFSGraph_Size(g);
+	hops    = malloc(size * sizeof(vertex_weight_t));
+	parents = malloc(size * sizeof(gqrm_id_t));
+	if (!hops || !parents)
+	    return error_clear(&g, hops, parents);
+	if (BFSGraph_IndexOf(g, src, &s) == DS_ERROR)
+	    return error_clear(&g, hops, parents);
+	if (BFS_Run(g, s, NULL, hops, parents) == DS_ERROR)
+	    return error_clear(&g, hops, parents);
+
+	/* we should only check the destination vertex */
+	for (i = 0; i < n; i++) {
+	    if (BFSGraph_IndexOf(g, dsts[i], &d) == DS_ERROR)
+		    return error_clear(&g, hops, parents);
+		/* 
+		 * check whether this destination is isolated from 
+		 * the srouce vertex.
+		 */
+		if (hops[d] == VERTEX_WEIGHT_INF)
+		    return error_clear(&g, hops, parents);
+		if (ALGraph_GetVertex(pg, d, &pv) == DS_ERROR)
+		    return error_clear(&g, hops, parents);
+    	if (Vertex_GetData(pv, (graph_data_t*)&pn) == DS_ERROR)
+	        return error_clear(&g, hops, parents);
+		/* get the hop constraint imposed on this vertex */
+	    if (Node_GetHop(pn, &hop_constraint) == DS_ERROR)
+	        return error_clear(&g, hops, parents);
+		/* check whether hop constraint is met */
+	    if (hops[d] > hop_constraint)
+	        return error_clear(&g, hops, parents);
 	}
-	ALGraph_Free(&spt);
+	error_clear(&g, hops, parents);
 	return DS_TRUE;
 }
 
@@ -107,20 +111,11 @@ check_neighbor(graph_data_t d1, graph_data_t d2)
 }
 
 static ds_bool
-is_dst(gqrm_id_t dsts[], size_t n, gqrm_id_t id)
-{
-    size_t  i;
-
-	for (i = 0; i < n; i++)
-	    if (dsts[i] == id)
-		    return DS_TRUE;
-	return DS_FALSE;
-}
-
-static ds_bool
-error_clear(pt_ALGraph* pg) 
+error_clear(pt_BFSGraph* g, vertex_weight_t* hops, gqrm_id_t* parents) 
 {
-    ALGraph_Free(pg);
+    BFSGraph_Free(g);
+	free(hops);
+	free(parents);
 	return DS_FALSE;
 }
 
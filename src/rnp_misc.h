@@ -26,9 +26,11 @@
 #include <stdio.h>
 
 #include "header.h"
+#include "metrics.h"
 #include "node.h"
 #include "graph.h"
 #include "shortest_path_tree.h"
+#include "bfs.h"
 
 extern ds_bool         check_feasibility(pt_ALGraph, gqrm_id_t, gqrm_id_t [], size_t);
 extern edge_weight_t   check_neighbor(graph_data_t, graph_data_t);
@@ -20,6 +20,13 @@
 
 #include "set.h"
 
+/** @enum
+ * Operations done by merging two sets in order.
+ */
+typedef enum {
+    SET_UNION, SET_MINUS, SET_INTER, SET_XOR
+} set_op;
+
 struct _set {
     pt_AVLTree     avl;
 	set_cmp        cmp;
@@ -28,7 +35,10 @@ struct _set {
 
 static void add(pt_AVLTree, avlt_data_t);
 static void minus(pt_AVLTree, avlt_data_t);
-static pt_Set copy(pt_Set);
+static ds_bool by_element(pt_Set, pt_Set);
+static ds_stat merge(pt_Set, pt_Set, set_op, set_data_t**, size_t*);
+static pt_Set operate(pt_Set, pt_Set, set_op);
+static ds_stat in_operate(pt_Set, pt_Set, set_op);
 
 pt_Set
 Set_Create(set_cmp cmp, gqrm_id_t id)
@@ -47,20 +57,41 @@ Set_Create(set_cmp cmp, gqrm_id_t id)
 	return ps;
 }
 
+/** @fn
+ * Insert "n" data into a set. Strictly increasing data
+ * given to an empty set are built into it in O(n); any
+ * other input is inserted one by one.
+ */
 ds_stat
 Set_Init(pt_Set st, set_data_t array[], size_t n)
 {
     size_t   i;
 
-	if (!array)
+	if (!st || !array)
 	    return DS_ERROR;
 	
+	if (AVLTree_Size(st->avl) == 0) {
+	    for (i = 1; i < n && st->cmp(array[i - 1], array[i]) < 0; i++)
+		    ;
+		if (i >= n)
+		    return AVLTree_BuildFromSorted(st->avl, array, n);
+	}
 	for (i = 0; i < n ; i++)
 	    if (AVLTree_Insert(st->avl, array[i]) == DS_ERROR)
 		    return DS_ERROR;
 	return DS_OK;
 }
 
+void
+Set_Free(pt_Set* st)
+{
+    if (!st || !(*st))
+	    return;
+	AVLTree_Free(&(*st)->avl);
+	free(*st);
+	*st = NULL;
+}
+
 ds_stat
 Set_Insert(pt_Set st, set_data_t data)
 {
@@ -85,38 +116,47 @@ Set_Size(pt_Set st)
 	return AVLTree_Size(st->avl);
 }
 
+ds_bool
+Set_Contain(pt_Set st, set_data_t data)
+{
+    if (!st || !st->avl)
+	    return DS_FALSE;
+	return AVLTree_Contain(st->avl, data);
+}
+
 pt_Set
 Set_Minus(pt_Set to, pt_Set from)
 {
-    pt_Set res;
-
     if (!to || !from)
 	    return to;
-	
-	if ((res = copy(to)) == NULL)
-	    return NULL;
-	
-	AVLTree_InterOpt(res->avl, from->avl, minus);
-
-	return res;
+	return operate(to, from, SET_MINUS);
 }
 
 pt_Set
 Set_Union(pt_Set st1, pt_Set st2)
 {
-    pt_Set res;
-
 	if (!st1 || !st2)
 	    return NULL;
-	
-	if ((res = copy(st1)) == NULL)
-	    return NULL;
+	return operate(st1, st2, SET_UNION);
+}
 
-    printf("copy over\n");
-	AVLTree_InterOpt(res->avl, st2->avl, add);
-	printf("insert over\n");
+pt_Set
+Set_Intersect(pt_Set st1, pt_Set st2)
+{
+	if (!st1 || !st2)
+	    return NULL;
+	return operate(st1, st2, SET_INTER);
+}
 
-	return res;
+/** @fn
+ * Data in exactly one of the two sets.
+ */
+pt_Set
+Set_SymDiff(pt_Set st1, pt_Set st2)
+{
+	if (!st1 || !st2)
+	    return NULL;
+	return operate(st1, st2, SET_XOR);
 }
 
 ds_stat
@@ -124,8 +164,11 @@ Set_InSetMinus(pt_Set to, pt_Set from)
 {
     if (!to || !from)
 	    return DS_ERROR;
-	AVLTree_InterOpt(to->avl, from->avl, minus);
-	return DS_OK;
+	if (AVLTree_Size(from->avl) == 0)
+	    return DS_OK;
+	if (by_element(to, from))
+	    return AVLTree_InterOpt(to->avl, from->avl, minus);
+	return in_operate(to, from, SET_MINUS);
 }
 
 ds_stat
@@ -133,8 +176,27 @@ Set_InSetUnion(pt_Set lhs, pt_Set rhs)
 {
     if (!lhs || !rhs)
 	    return DS_ERROR;
-	AVLTree_InterOpt(lhs->avl, rhs->avl, add);
-	return DS_OK;
+	if (AVLTree_Size(rhs->avl) == 0)
+	    return DS_OK;
+	if (by_element(lhs, rhs))
+	    return AVLTree_InterOpt(lhs->avl, rhs->avl, add);
+	return in_operate(lhs, rhs, SET_UNION);
+}
+
+ds_stat
+Set_InSetIntersect(pt_Set lhs, pt_Set rhs)
+{
+    if (!lhs || !rhs)
+	    return DS_ERROR;
+	return in_operate(lhs, rhs, SET_INTER);
+}
+
+ds_stat
+Set_InSetSymDiff(pt_Set lhs, pt_Set rhs)
+{
+    if (!lhs || !rhs)
+	    return DS_ERROR;
+	return in_operate(lhs, rhs, SET_XOR);
 }
 
 ds_stat
@@ -145,21 +207,113 @@ Set_Map(pt_Set st, set_map func)
 	return AVLTree_InOrderMap(st->avl, func);
 }
 
+/** @fn
+ * Whether updating "to" one data of "from" at a time, in
+ * O(m log n), beats merging both sets, in O(n + m).
+ */
+static ds_bool
+by_element(pt_Set to, pt_Set from)
+{
+    size_t   n = AVLTree_Size(to->avl), m = AVLTree_Size(from->avl);
+	size_t   lg;
+
+	for (lg = 1; lg < 64 && ((size_t)1 << lg) < n + m; lg++)
+	    ;
+	return m * lg < n + m ? DS_TRUE : DS_FALSE;
+}
+
+/** @fn
+ * Merge the data of "lhs" and "rhs" in order into a newly
+ * allocated array "res" of "n" data, keeping those the
+ * operation "op" selects. The array is strictly increasing.
+ */
+static ds_stat
+merge(pt_Set lhs, pt_Set rhs, set_op op, set_data_t** res, size_t* n)
+{
+    set_data_t*   a;
+	set_data_t*   b;
+	size_t        na, nb, i = 0, j = 0, k = 0;
+	int           c;
+
+	na = AVLTree_Size(lhs->avl);
+	nb = AVLTree_Size(rhs->avl);
+	if ((a = malloc((na + nb + 1) * sizeof(set_data_t))) == NULL)
+	    return DS_ERROR;
+	if ((*res = malloc((na + nb + 1) * sizeof(set_data_t))) == NULL) {
+	    free(a);
+		return DS_ERROR;
+	}
+	b = a + na;
+	AVLTree_ToArray(lhs->avl, a);
+	AVLTree_ToArray(rhs->avl, b);
+
+	while (i < na || j < nb) {
+	    if (i == na)
+		    c = 1;
+		else if (j == nb)
+		    c = -1;
+		else
+		    c = lhs->cmp(a[i], b[j]);
+
+		if (c < 0) {
+		    if (op != SET_INTER)
+			    (*res)[k++] = a[i];
+			i++;
+		} else if (c > 0) {
+		    if (op == SET_UNION || op == SET_XOR)
+			    (*res)[k++] = b[j];
+			j++;
+		} else {
+		    if (op == SET_UNION || op == SET_INTER)
+			    (*res)[k++] = a[i];
+			i++;
+			j++;
+		}
+	}
+	free(a);
+	*n = k;
+	return DS_OK;
+}
+
+/** @fn
+ * Apply "op" to "lhs" and "rhs" into a new set with the id
+ * of "lhs".
+ */
 static pt_Set
-copy(pt_Set st)
+operate(pt_Set lhs, pt_Set rhs, set_op op)
 {
-    pt_Set cpy;
+    pt_Set        res;
+	set_data_t*   array;
+	size_t        n;
 
-	if (!st)
+	if ((res = Set_Create(lhs->cmp, lhs->id)) == NULL)
 	    return NULL;
-	
-	if ((cpy = Set_Create(st->cmp, st->id)) == NULL)
-	    return NULL;
-	if ((cpy->avl = AVLTree_Copy(st->avl)) == NULL) {
-	    free(cpy);
+	if (merge(lhs, rhs, op, &array, &n) == DS_ERROR) {
+	    Set_Free(&res);
 		return NULL;
 	}
-	return cpy;
+	if (AVLTree_BuildFromSorted(res->avl, array, n) == DS_ERROR)
+	    Set_Free(&res);
+	free(array);
+	return res;
+}
+
+/** @fn
+ * Apply "op" to "lhs" and "rhs", storing the result in
+ * "lhs".
+ */
+static ds_stat
+in_operate(pt_Set lhs, pt_Set rhs, set_op op)
+{
+    set_data_t*   array;
+	size_t        n;
+	ds_stat       stat;
+
+	if (merge(lhs, rhs, op, &array, &n) == DS_ERROR)
+	    return DS_ERROR;
+	stat = AVLTree_BuildFromSorted(lhs->avl, array, n);
+	free(array);
+	return stat;
 }
 
 static void
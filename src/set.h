@@ -38,12 +38,18 @@ typedef void (*set_map)(set_data_t, size_t);
 
 extern pt_Set      Set_Create(set_cmp, gqrm_id_t);
 extern ds_stat     Set_Init(pt_Set, set_data_t [], size_t);
+extern void        Set_Free(pt_Set*);
 extern ds_stat     Set_Insert(pt_Set, set_data_t);
 extern ds_stat     Set_Delete(pt_Set, set_data_t);
 extern size_t      Set_Size(pt_Set);
+extern ds_bool     Set_Contain(pt_Set, set_data_t);
 extern pt_Set      Set_Minus(pt_Set, pt_Set);
 extern ds_stat     Set_InSetMinus(pt_Set, pt_Set);
 extern pt_Set      Set_Union(pt_Set, pt_Set);
 extern ds_stat     Set_InSetUnion(pt_Set, pt_Set);
+extern pt_Set      Set_Intersect(pt_Set, pt_Set);
+extern ds_stat     Set_InSetIntersect(pt_Set, pt_Set);
+extern pt_Set      Set_SymDiff(pt_Set, pt_Set);
+extern ds_stat     Set_InSetSymDiff(pt_Set, pt_Set);
 extern ds_stat     Set_Map(pt_Set, set_map);
 #endif
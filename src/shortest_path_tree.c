@@ -18,14 +18,97 @@
  * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
+
 #include "shortest_path_tree.h"
+#include "typed_containers.h"
+
+/* @struct
+ * A label of the reliability search: a path from the source
+ * to "vertex" of "hop" edges whose cost is the sum of
+ * -log(PRR) over these edges, "pred" being the label it
+ * extends (-1 for the source).
+ */
+typedef struct {
+    size_t       vertex;
+    gqrm_hop_t   hop;
+    double       cost;
+    ssize_t      pred;
+} path_label;
+
+/* @struct
+ * An entry of the label heap, carrying the keys of label
+ * "label" so that sifting never looks the label up.
+ */
+typedef struct {
+    double       cost;
+    gqrm_hop_t   hop;
+    size_t       label;
+} label_entry;
+
+/* by cost, then by hop count */
+#define LABEL_LESS(a, b)    ((a).cost < (b).cost || \
+                             ((a).cost == (b).cost && (a).hop < (b).hop))
+GQRM_HEAP(LabelHeap, label_entry, LABEL_LESS)
+
+/* @struct
+ * Labels and a min-heap of their entries.
+ */
+typedef struct {
+    path_label*  labels;
+    size_t       n_labels;
+    size_t       cap_labels;
+    LabelHeap    heap;
+} label_queue;
+
+/* @struct
+ * An entry of the gray set: a vertex, by index, and the
+ * weight it was given when pushed.
+ */
+typedef struct {
+    vertex_weight_t   weight;
+    size_t            vertex;
+} gray_entry;
+
+#define GRAY_LESS(a, b)    ((a).weight < (b).weight || \
+                            ((a).weight == (b).weight && (a).vertex < (b).vertex))
+GQRM_HEAP(GrayHeap, gray_entry, GRAY_LESS)
+
+/* @enum
+ * Where a vertex is in ALGraph_ShortestPaths().
+ */
+typedef enum {
+    WHITE, GRAY, BLACK
+} vertex_color;
+
+/* @struct
+ * Caller-owned state of ALGraph_ShortestPaths(), indexed by
+ * vertex position, so that the graph searched is only read.
+ * The arrays grow on demand and are reused from run to run.
+ * color  - the vertex_color of every vertex
+ * weight - hop count from the source
+ * parent - index of the parent, -1 if none
+ * gray   - the gray set
+ * cap    - the number of vertices the arrays hold
+ */
+struct SPT_WORKSPACE {
+    char*              color;
+    vertex_weight_t*   weight;
+    gqrm_id_t*         parent;
+    GrayHeap           gray;
+    size_t             cap;
+};
 
 static ds_bool input_feasibility(pt_ALGraph, gqrm_id_t, gqrm_id_t [], size_t);
-static pt_ALGraph error_clear(pt_ALGraph*, p_sll*, p_sll*, p_sll*);
-static int vertex_cmp(sll_data_t, sll_data_t);
+static pt_ALGraph error_clear(pt_ALGraph*, pt_SPTWorkspace*, IDSet*);
+static ds_stat reserve_workspace(pt_SPTWorkspace, size_t);
+static ds_stat vertex_index(pt_ALGraph, gqrm_id_t, size_t*);
 static ds_bool is_dst_or_src(gqrm_id_t, gqrm_id_t [], size_t, gqrm_id_t);
-static ds_bool is_dst(gqrm_id_t [], size_t, gqrm_id_t);
-static ds_bool has_non_dst_leaves(pt_ALGraph, gqrm_id_t[], size_t);
+static ds_bool has_non_dst_leaves(pt_ALGraph, const IDSet*);
+static ds_stat label_push(label_queue*, size_t, gqrm_hop_t, double, ssize_t);
+static size_t  label_pop(label_queue*);
+static void    graft_path(label_queue*, size_t, size_t, gqrm_id_t*, gqrm_hop_t*, size_t);
+static pt_ALGraph reliable_clear(pt_ALGraph*, pt_BFSGraph*, label_queue*, gqrm_hop_t*, gqrm_hop_t*, gqrm_id_t*, ssize_t*);
 
 /* @fn
  * Create a shortest path tree based on 
@@ -98,226 +181,493 @@ static ds_bool has_non_dst_leaves(pt_ALGraph, gqrm_id_t[], size_t);
  *  |                 \|/
  *  |                  |
  *  --------------------
+ *
+ * The search itself is ALGraph_ShortestPaths(), which leaves
+ * "pg" untouched; the tree is then assembled from its result.
  */
 pt_ALGraph
 ALGraph_ShortestPathTree(pt_ALGraph pg, gqrm_id_t src,
                          gqrm_id_t dsts[], size_t n)
 {
     pt_ALGraph       spt = NULL;
+	pt_SPTWorkspace  ws;
 	gqrm_id_t        id, parent;
-	size_t           size, i, index;
+	size_t           size, i;
 	edge_weight_t    edge_weight;
-	vertex_weight_t  vertex_weight1, vertex_weight2;
-	pt_Vertex        pv = NULL, pv_tmp = NULL, pv_new = NULL, min = NULL, pv_parent = NULL;
-	pt_Edge          pe = NULL;
-	p_sll            gray = NULL;
-	p_sll            white = NULL;
-	p_sll            black = NULL;
+	pt_Vertex        pv = NULL, pv_tmp = NULL, pv_new = NULL, pv_parent = NULL;
+	IDSet            dst_set;
 
-    printf("func: %s, line: %d\n", __func__, __LINE__);
+    TRACE_DEBUG(TRACE_SPT, "src %ld, %ld destinations", src, n);
 
-    /*
-	 * gray  = \varnothing;
-	 * white = \varnothing;
-	 * black = \varnothing;
-	 */
 	if (input_feasibility(pg, src, dsts, n) == DS_FALSE)
 	    return NULL;
-    printf("func: %s, line: %d\n", __func__, __LINE__);
-	if (SingleLinkedList_Init(&gray) == DS_ERROR)
+	METRIC_TIMER_BEGIN(t0);
+	IDSet_Init(&dst_set);
+	if ((ws = SPTWorkspace_Create()) == NULL)
 	    return NULL;
-    printf("func: %s, line: %d\n", __func__, __LINE__);
-	if (SingleLinkedList_Init(&white) == DS_ERROR) {
-	    SingleLinkedList_Destroy(&gray, NULL);
-	    return NULL;
-	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
-	if (SingleLinkedList_Init(&black) == DS_ERROR) {
-	    SingleLinkedList_Destroy(&gray, NULL);
-	    SingleLinkedList_Destroy(&white, NULL);
-	    return NULL;
-	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
+	if (IDSet_Build(&dst_set, dsts, n) == DS_ERROR ||
+	    ALGraph_ShortestPaths(pg, src, ws) == DS_ERROR)
+	    return error_clear(&spt, &ws, &dst_set);
 
-    /* create a graph without any edge */
+    /*
+	 * copy the vertices without any edge, with the weights and
+	 * parents found for the vertices reached
+	 */
 	spt = ALGraph_Create();
 	size = ALGraph_Size(pg);
 	for (i = 0; i < size; i++) {
 	    if (ALGraph_GetVertex(pg, i, &pv) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
+		    return error_clear(&spt, &ws, &dst_set);
 		if ((pv_new = Vertex_ShallowCopy(pv)) == NULL)
-		    return error_clear(&spt, &gray, &white, &black);
-		if (ALGraph_PushVertex(spt, pv_new) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
+		    return error_clear(&spt, &ws, &dst_set);
+		if (ws->color[i] == BLACK) {
+		    parent = -1;
+		    if (ws->parent[i] >= 0 &&
+			    (ALGraph_GetVertex(pg, ws->parent[i], &pv_tmp) == DS_ERROR ||
+				 Vertex_GetID(pv_tmp, &parent) == DS_ERROR)) {
+			    Vertex_Free(&pv_new);
+		        return error_clear(&spt, &ws, &dst_set);
+			}
+			Vertex_SetWeight(pv_new, ws->weight[i]);
+			Vertex_SetParent(pv_new, parent);
+		}
+		if (ALGraph_PushVertex(spt, pv_new) == DS_ERROR) {
+		    Vertex_Free(&pv_new);
+		    return error_clear(&spt, &ws, &dst_set);
+		}
 	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
 
     /*
-	 * copy src; src->weight = 0;
-	 * add src to gray;
-	 */
-    if (ALGraph_GetVertex(spt, src, &pv) == DS_ERROR)
-	    return error_clear(&spt, &gray, &white, &black);
-	Vertex_SetWeight(pv, 0);
-	if (SingleLinkedList_InsertHead(gray, pv) == DS_ERROR)
-	    return error_clear(&spt, &gray, &white, &black);
-	/*
-	 * white = all vertices except for src.
+	 * add an edge (to v) between every reached v and its parent
 	 */
 	for (i = 0; i < size; i++) {
-	    if (ALGraph_GetVertex(spt, i, &pv_tmp) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		/* if src != pv, add pv to white */
-		if (Vertex_Same(pv, pv_tmp) != DS_TRUE)
-			if (SingleLinkedList_InsertHead(white, pv_tmp) == DS_ERROR)
-			    return error_clear(&spt, &gray, &white, &black);
+	    if (ws->color[i] != BLACK || ws->parent[i] < 0)
+		    continue;
+		if (ALGraph_GetVertex(spt, ws->parent[i], &pv_parent) == DS_ERROR ||
+		    ALGraph_GetVertex(pg, ws->parent[i], &pv_tmp) == DS_ERROR ||
+		    ALGraph_GetVertex(spt, i, &pv) == DS_ERROR ||
+		    Vertex_GetID(pv, &id) == DS_ERROR)
+		    return error_clear(&spt, &ws, &dst_set);
+		if (Vertex_GetEdgeWeight(pv_tmp, id, &edge_weight) == DS_ERROR)
+		    return error_clear(&spt, &ws, &dst_set);
+		if (Vertex_PushNeighbor(pv_parent, pv, edge_weight) == DS_ERROR)
+		    return error_clear(&spt, &ws, &dst_set);
 	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
-
-    /* loop until gray is empty */
-	while (SingleLinkedList_Empty(gray) != DS_TRUE) {
-	    /* get index of the vertex with minimum weight */
-	    if (SingleLinkedList_Min(gray, vertex_cmp, &index) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		/* get the minimal weighted vertex */
-		if (SingleLinkedList_GetData(gray, index, (sll_data_t*)&min) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-
-		/* add min to black */
-		if (SingleLinkedList_InsertHead(black, min) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		/* delete min from gray */
-		if (SingleLinkedList_Delete(gray, index, NULL) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-
-        /*
-		 * add edges between min and its parent
-		 */
-		if (Vertex_GetParent(min, &parent) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		if (parent >= 0) {
-		    /* get the parent vertex of min */
-		    if (ALGraph_GetVertexByID(spt, parent, &pv_parent) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-		    if (ALGraph_GetVertexByID(pg, parent, &pv_tmp) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			if (Vertex_GetID(min, &id) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			if (Vertex_GetEdgeWeight(pv_tmp, id, &edge_weight) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			/* add an edge (to min's parent) between min and its parent */
-			if (Vertex_PushNeighbor(pv_parent, min, edge_weight) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			/* add an edge (to min) between min and its parent */
-//			if (Vertex_PushNeighbor(min, pv_parent, edge_weight) == DS_ERROR)
-//		        return error_clear(&spt, &gray, &white, &black);
-		}
 
-        /*
-		 * A = all neighbors of min in gray;
-		 * foreach v in A:
-		 *     if (v->weight > min->weight + 1):
-		 *         v->weight = min->weight + 1;
-		 *         v->parent = min;
-		 */
-		/* get min's id */
-		if (Vertex_GetID(min, &id) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		/* get the min in pg so as to find all min's neighbors */
-	    if (ALGraph_GetVertexByID(pg, id, &pv_tmp) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		/* get min's weight */
-		if (Vertex_GetWeight(min, &vertex_weight1) == DS_ERROR)
-		    return error_clear(&spt, &gray, &white, &black);
-		size = SingleLinkedList_Size(gray);
-		/* for each vertex in gray */
-		for (i = 0; i < size; i++) {
-		    /* get the ith vertex in gray */
-		    if (SingleLinkedList_GetData(gray, i, (sll_data_t*)&pv) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			/* check whether "pv" is a neighbor of min */
-			if (Vertex_IsNeighbor(pv_tmp, pv) == DS_TRUE) {
-			/* if so */
-			    /* get the weight of "pv" */
-			    if (Vertex_GetWeight(pv, &vertex_weight2) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
-				/* if pv->weight > min->weight + 1*/
-				if (vertex_weight2 > vertex_weight1 + 1) {
-				    /* pv->weight = min->weight + 1*/
-				    Vertex_SetWeight(pv, vertex_weight1 + 1);
-					/* pv->parent = min */
-					Vertex_SetParent(pv, id);
-				}
-			}
-		}
-
-        printf("func: %s, line: %d\n", __func__, __LINE__);
-        /*
-		 * B = all neighbors of min in white;
-		 * delete B from white;
-		 * add B to gray;
-		 * foreach v in B:
-		 *     v->weight = min->weight + 1;
-		 *     v->parent = min;
-		 */
-		for (i = 0; i < SingleLinkedList_Size(white);) {
-		    /* get the ith vertex in white */
-		    if (SingleLinkedList_GetData(white, i, (sll_data_t*)&pv) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
-			/* check whether "pv" is a neighbor of min */
-			if (Vertex_IsNeighbor(pv_tmp, pv) == DS_TRUE) {
-			/* if so */
-			    /* pv->weight = min->weight + 1 */
-			    Vertex_SetWeight(pv, vertex_weight1 + 1);
-				/* pv->parent = min */
-				Vertex_SetParent(pv, id);
-				/* delete pv from white */
-				if (SingleLinkedList_Delete(white, i, NULL) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
-				/* add pv to gray */
-				if (SingleLinkedList_InsertHead(gray, pv) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
-			} else {
-			    i++;
-			}
-		}
-	}
-        printf("func: %s, line: %d\n", __func__, __LINE__);
-    size = ALGraph_Size(spt);
-	while (has_non_dst_leaves(spt, dsts, n) == DS_TRUE) {
+    TRACE_DEBUG(TRACE_SPT, "pruning non-destination leaves");
+	while (has_non_dst_leaves(spt, &dst_set) == DS_TRUE) {
 	    for (i = 0; i < size; i++) {
 		    if (ALGraph_GetVertex(spt, i, &pv) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
+		        return error_clear(&spt, &ws, &dst_set);
 			if (Vertex_GetID(pv, &id) == DS_ERROR)
-		        return error_clear(&spt, &gray, &white, &black);
+		        return error_clear(&spt, &ws, &dst_set);
 			if (
 			    Vertex_Degree(pv) <= 0 && 
-				is_dst(dsts, n, id) == DS_FALSE
+				IDSet_Contain(&dst_set, id) == DS_FALSE
 			   ) {
 			    if (Vertex_GetParent(pv, &parent) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
+		            return error_clear(&spt, &ws, &dst_set);
 				if (parent == -1)
 				    continue;
 				if (ALGraph_GetVertexByID(spt, parent, &pv_parent) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
+		            return error_clear(&spt, &ws, &dst_set);
 				if (Vertex_DeleteEdge(pv_parent, id) == DS_ERROR)
-		            return error_clear(&spt, &gray, &white, &black);
+		            return error_clear(&spt, &ws, &dst_set);
 				Vertex_SetParent(pv, -1);
 			}
 		}
 	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
 
-	SingleLinkedList_Destroy(&gray, NULL);
-	SingleLinkedList_Destroy(&white, NULL);
-	SingleLinkedList_Destroy(&black, NULL);
-   printf("func: %s, line: %d\n", __func__, __LINE__);
+	error_clear(NULL, &ws, &dst_set);
 
+	METRIC_TIMER_END(TIMER_SPT, t0);
 	return spt;
 }
 
+/* @fn
+ * Hop counts from "src" to every vertex of "pg" by Dijkstra's
+ * method, into workspace "ws": the weight and parent of the
+ * "i"th vertex are SPTWorkspace_Weights(ws)[i] and
+ * SPTWorkspace_Parents(ws)[i], the latter an index, -1 for
+ * "src" and the vertices not reached, which weigh
+ * VERTEX_WEIGHT_INF.
+ *
+ * Colors, weights and parents live in "ws" and gray is a
+ * GrayHeap of (weight, vertex) entries, so finding the next
+ * vertex costs O(log n), only its edges are visited, and
+ * "pg" is only read: searches with different workspaces may
+ * run over one graph at the same time.
+ */
+ds_stat
+ALGraph_ShortestPaths(pt_ALGraph pg, gqrm_id_t src, pt_SPTWorkspace ws)
+{
+    gqrm_id_t        end;
+	size_t           size, i, j, deg, s, v;
+	pt_Vertex        pv;
+	pt_Edge*         edges;
+	p_vec            adj;
+	gray_entry       e, next;
+
+	if (!pg || !ws || vertex_index(pg, src, &s) == DS_ERROR)
+	    return DS_ERROR;
+	size = ALGraph_Size(pg);
+	if (reserve_workspace(ws, size) == DS_ERROR)
+	    return DS_ERROR;
+	/* every vertex starts white */
+	for (i = 0; i < size; i++) {
+	    ws->color[i]  = WHITE;
+		ws->weight[i] = VERTEX_WEIGHT_INF;
+		ws->parent[i] = -1;
+	}
+	GrayHeap_Clear(&ws->gray);
+
+	ws->weight[s] = 0;
+	e.weight = 0;
+	e.vertex = s;
+	if (GrayHeap_Push(&ws->gray, e) == DS_ERROR)
+	    return DS_ERROR;
+	ws->color[s] = GRAY;
+
+    /*
+	 * loop until gray is empty, taking the vertex with minimum
+	 * weight; a vertex whose weight was lowered was pushed
+	 * again, and its older entries are skipped once it is black
+	 */
+	while (GrayHeap_Pop(&ws->gray, &e) == DS_OK) {
+	    if (ws->color[e.vertex] == BLACK)
+		    continue;
+		ws->color[e.vertex] = BLACK;
+		METRIC_INC(METRIC_SPT_POPS);
+
+        /*
+		 * foreach neighbor v of min:
+		 *     if v is white, or gray and v->weight > min->weight + 1:
+		 *         v->weight = min->weight + 1;
+		 *         v->parent = min;
+		 *         add v to gray;
+		 */
+		if (ALGraph_GetVertex(pg, e.vertex, &pv) == DS_ERROR ||
+		    Vertex_GetEdges(pv, &adj) == DS_ERROR)
+		    return DS_ERROR;
+		deg   = Vector_Size(adj);
+		edges = (pt_Edge*)Vector_Data(adj);
+		for (j = 0; j < deg; j++) {
+		    if (Edge_GetEndID(edges[j], &end) == DS_ERROR ||
+			    vertex_index(pg, end, &v) == DS_ERROR)
+		        return DS_ERROR;
+			if (ws->color[v] == BLACK ||
+			    (ws->color[v] == GRAY && ws->weight[v] <= e.weight + 1))
+			    continue;
+			METRIC_INC(METRIC_SPT_RELAXATIONS);
+			ws->weight[v] = e.weight + 1;
+			ws->parent[v] = (gqrm_id_t)e.vertex;
+			ws->color[v]  = GRAY;
+			next.weight = e.weight + 1;
+			next.vertex = v;
+			if (GrayHeap_Push(&ws->gray, next) == DS_ERROR)
+			    return DS_ERROR;
+		}
+	}
+	return DS_OK;
+}
+
+pt_SPTWorkspace
+SPTWorkspace_Create(void)
+{
+    pt_SPTWorkspace   ws;
+
+    if ((ws = malloc(sizeof(SPTWorkspace))) == NULL)
+	    return NULL;
+	ws->color  = NULL;
+	ws->weight = NULL;
+	ws->parent = NULL;
+	ws->cap    = 0;
+	GrayHeap_Init(&ws->gray);
+	return ws;
+}
+
+void
+SPTWorkspace_Free(pt_SPTWorkspace* ws)
+{
+    if (!ws || !*ws)
+	    return;
+	free((*ws)->color);
+	free((*ws)->weight);
+	free((*ws)->parent);
+	GrayHeap_Destroy(&(*ws)->gray);
+	free(*ws);
+	*ws = NULL;
+}
+
+const vertex_weight_t*
+SPTWorkspace_Weights(pt_SPTWorkspace ws)
+{
+    return ws ? ws->weight : NULL;
+}
+
+const gqrm_id_t*
+SPTWorkspace_Parents(pt_SPTWorkspace ws)
+{
+    return ws ? ws->parent : NULL;
+}
+
+/* @fn
+ * Grow the arrays of "ws" to "n" vertices; they are never
+ * shrunk, so a workspace reused for graphs of one size
+ * allocates only once.
+ */
+static ds_stat
+reserve_workspace(pt_SPTWorkspace ws, size_t n)
+{
+    char*              color;
+	vertex_weight_t*   weight;
+	gqrm_id_t*         parent;
+
+	if (n <= ws->cap)
+	    return DS_OK;
+	if ((color = realloc(ws->color, n * sizeof(char))) == NULL)
+	    return DS_ERROR;
+	ws->color = color;
+	if ((weight = realloc(ws->weight, n * sizeof(vertex_weight_t))) == NULL)
+	    return DS_ERROR;
+	ws->weight = weight;
+	if ((parent = realloc(ws->parent, n * sizeof(gqrm_id_t))) == NULL)
+	    return DS_ERROR;
+	ws->parent = parent;
+	ws->cap    = n;
+	return DS_OK;
+}
+
+/* @fn
+ * Create a shortest path tree maximizing the end-to-end
+ * delivery probability, i.e. minimizing the sum of -log(PRR)
+ * along each path, where the path to dsts[i] has at most
+ * bounds[i] hops.
+ *
+ * This is a resource constrained shortest path problem,
+ * solved by label setting: labels (hop, cost) are settled by
+ * increasing cost, and a label is dropped when the vertex
+ * already has a settled label with no more hops, which
+ * dominates it. Every vertex thus keeps at most one settled
+ * label per hop count.
+ *
+ * The best path of every destination is then grafted onto
+ * the tree. A path vertex already in the tree at no more hops
+ * than on the path keeps its place and the rest of the path
+ * hangs below it; otherwise it moves onto the path, which
+ * only lowers hop counts, so no bound is ever violated.
+ *
+ * Vertices of the tree are weighted by their hop count, the
+ * others by VERTEX_WEIGHT_INF. Return NULL if a destination
+ * cannot be reached within its bound.
+ */
+pt_ALGraph
+ALGraph_ReliableShortestPathTree(pt_ALGraph pg, gqrm_id_t src,
+                                 gqrm_id_t dsts[], gqrm_hop_t bounds[],
+                                 size_t n)
+{
+    pt_ALGraph          spt = NULL;
+    pt_BFSGraph         g = NULL;
+    label_queue         q = {NULL, 0, 0, {NULL, 0, 0}};
+    pt_Vertex           pv, pv_new, pv_parent;
+    const size_t*       cols;
+    const edge_weight_t* ws;
+    gqrm_hop_t*         settled = NULL;
+    gqrm_hop_t*         hops = NULL;
+    gqrm_id_t*          parents = NULL;
+    ssize_t*            best = NULL;
+    gqrm_hop_t          max_bound = 0;
+    edge_weight_t       w;
+    path_label          l;
+    size_t              size, s, i, j, k, deg, cur;
+
+    if (input_feasibility(pg, src, dsts, n) == DS_FALSE || (n && !bounds))
+        return NULL;
+    METRIC_TIMER_BEGIN(t0);
+    if ((g = BFSGraph_Create(pg)) == NULL)
+        return NULL;
+    size     = BFSGraph_Size(g);
+    settled  = malloc(size * sizeof(gqrm_hop_t));
+    hops     = malloc(size * sizeof(gqrm_hop_t));
+    parents  = malloc(size * sizeof(gqrm_id_t));
+    best     = malloc((n ? n : 1) * sizeof(ssize_t));
+    if (!settled || !hops || !parents || !best)
+        return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+    BFSGraph_IndexOf(g, src, &s);
+    for (i = 0; i < n; i++) {
+        best[i] = -1;
+        if (bounds[i] > max_bound)
+            max_bound = bounds[i];
+    }
+    for (i = 0; i < size; i++) {
+        settled[i] = max_bound + 1;
+        hops[i]    = -1;
+        parents[i] = -1;
+    }
+
+    /* label setting, by increasing cost */
+    if (label_push(&q, s, 0, 0.0, -1) == DS_ERROR)
+        return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+    while (LabelHeap_Empty(&q.heap) == DS_FALSE) {
+        cur = label_pop(&q);
+        l   = q.labels[cur];
+        METRIC_INC(METRIC_SPT_POPS);
+        /* dominated by a settled label with no more hops */
+        if (l.hop >= settled[l.vertex])
+            continue;
+        settled[l.vertex] = l.hop;
+
+        /* the first settled label within a bound is the best */
+        for (i = 0; i < n; i++)
+            if (best[i] == -1 && BFSGraph_ID(g, l.vertex) == dsts[i] &&
+                l.hop <= bounds[i])
+                best[i] = (ssize_t)cur;
+
+        if (l.hop + 1 > max_bound)
+            continue;
+        deg = BFSGraph_OutEdges(g, l.vertex, &cols, &ws);
+        for (j = 0; j < deg; j++) {
+            if (l.hop + 1 >= settled[cols[j]] || ws[j] <= 0.0)
+                continue;
+            METRIC_INC(METRIC_SPT_RELAXATIONS);
+            if (label_push(&q, cols[j], l.hop + 1, l.cost - log(ws[j]),
+                           (ssize_t)cur) == DS_ERROR)
+                return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+        }
+    }
+
+    /* graft the path of every destination onto the tree */
+    hops[s] = 0;
+    for (i = 0; i < n; i++) {
+        if (best[i] == -1)
+            return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+        graft_path(&q, (size_t)best[i], s, parents, hops, size);
+    }
+
+    if ((spt = ALGraph_Create()) == NULL)
+        return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+    for (i = 0; i < size; i++) {
+        if (ALGraph_GetVertex(pg, i, &pv) == DS_ERROR)
+            return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+        if ((pv_new = Vertex_ShallowCopy(pv)) == NULL)
+            return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+        Vertex_SetWeight(pv_new, hops[i] >= 0 ? hops[i] : VERTEX_WEIGHT_INF);
+        Vertex_SetParent(pv_new, parents[i] >= 0 ? BFSGraph_ID(g, parents[i]) : -1);
+        if (ALGraph_PushVertex(spt, pv_new) == DS_ERROR) {
+            Vertex_Free(&pv_new);
+            return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+        }
+    }
+    for (i = 0; i < size; i++) {
+        if (parents[i] < 0)
+            continue;
+        deg = BFSGraph_OutEdges(g, parents[i], &cols, &ws);
+        for (k = 0, w = -1.0; k < deg; k++)
+            if (cols[k] == i)
+                w = ws[k];
+        if (ALGraph_GetVertex(spt, parents[i], &pv_parent) == DS_ERROR ||
+            ALGraph_GetVertex(spt, i, &pv) == DS_ERROR ||
+            Vertex_PushNeighbor(pv_parent, pv, w) == DS_ERROR)
+            return reliable_clear(&spt, &g, &q, settled, hops, parents, best);
+    }
+
+    reliable_clear(NULL, &g, &q, settled, hops, parents, best);
+    METRIC_TIMER_END(TIMER_SPT, t0);
+    return spt;
+}
+
+/* @fn
+ * Graft the path of label "at" onto the tree given by
+ * "parents" and "hops" (-1 for vertices not in the tree),
+ * rooted at "src".
+ */
+static void
+graft_path(label_queue* q, size_t at, size_t src, gqrm_id_t* parents,
+           gqrm_hop_t* hops, size_t size)
+{
+    path_label*   l;
+    size_t        i, v, k;
+    gqrm_hop_t    h;
+
+    /* walk back up to a vertex the tree reaches soon enough */
+    for (l = &q->labels[at]; l->pred != -1; l = &q->labels[l->pred]) {
+        if (hops[l->vertex] >= 0 && hops[l->vertex] <= l->hop)
+            break;
+        parents[l->vertex] = (gqrm_id_t)q->labels[l->pred].vertex;
+    }
+
+    /* recompute the hop counts of the tree */
+    for (i = 0; i < size; i++)
+        if (i != src)
+            hops[i] = -1;
+    for (i = 0; i < size; i++) {
+        if (parents[i] < 0 || hops[i] >= 0)
+            continue;
+        /* count the steps up to a vertex with a known hop count */
+        for (v = i, k = 0; hops[v] < 0; v = (size_t)parents[v], k++) ;
+        /* and number the vertices on the way down */
+        for (h = hops[v] + (gqrm_hop_t)k, v = i; hops[v] < 0; v = (size_t)parents[v])
+            hops[v] = h--;
+    }
+}
+
+static ds_stat
+label_push(label_queue* q, size_t vertex, gqrm_hop_t hop, double cost,
+           ssize_t pred)
+{
+    path_label*   labels;
+    label_entry   e;
+    size_t        cap;
+
+    if (q->n_labels == q->cap_labels) {
+        cap = q->cap_labels ? q->cap_labels * 2 : 256;
+        if ((labels = realloc(q->labels, cap * sizeof(path_label))) == NULL)
+            return DS_ERROR;
+        q->labels     = labels;
+        q->cap_labels = cap;
+    }
+    q->labels[q->n_labels].vertex = vertex;
+    q->labels[q->n_labels].hop    = hop;
+    q->labels[q->n_labels].cost   = cost;
+    q->labels[q->n_labels].pred   = pred;
+
+    e.cost  = cost;
+    e.hop   = hop;
+    e.label = q->n_labels;
+    if (LabelHeap_Push(&q->heap, e) == DS_ERROR)
+        return DS_ERROR;
+    q->n_labels++;
+    return DS_OK;
+}
+
+static size_t
+label_pop(label_queue* q)
+{
+    label_entry   e;
+
+    LabelHeap_Pop(&q->heap, &e);
+    return e.label;
+}
+
+static pt_ALGraph
+reliable_clear(pt_ALGraph* spt, pt_BFSGraph* g, label_queue* q,
+               gqrm_hop_t* settled, gqrm_hop_t* hops, gqrm_id_t* parents,
+               ssize_t* best)
+{
+    if (spt)
+        ALGraph_Free(spt);
+    BFSGraph_Free(g);
+    free(q->labels);
+    LabelHeap_Destroy(&q->heap);
+    free(settled);
+    free(hops);
+    free(parents);
+    free(best);
+    return NULL;
+}
+
 static ds_bool
-has_non_dst_leaves(pt_ALGraph pg, gqrm_id_t dsts[], size_t n)
+has_non_dst_leaves(pt_ALGraph pg, const IDSet* dsts)
 {
     pt_Vertex   pv;
 	gqrm_id_t   id, parent;
@@ -335,7 +685,7 @@ has_non_dst_leaves(pt_ALGraph pg, gqrm_id_t dsts[], size_t n)
 		    assert(0);
 		if (
 		    Vertex_Degree(pv) <= 0 && 
-			is_dst(dsts, n, id) == DS_FALSE &&
+			IDSet_Contain(dsts, id) == DS_FALSE &&
 			parent != -1
 		   ) {
 		    return DS_TRUE;
@@ -344,16 +694,6 @@ has_non_dst_leaves(pt_ALGraph pg, gqrm_id_t dsts[], size_t n)
 	return DS_FALSE;
 }
 
-static ds_bool
-is_dst(gqrm_id_t dsts[], size_t n, gqrm_id_t d)
-{
-    size_t i;
-	for (i = 0; i < n; i++)
-	    if (dsts[i] == d)
-		    return DS_TRUE;
-	return DS_FALSE;
-}
-
 static ds_bool
 is_dst_or_src(gqrm_id_t src, gqrm_id_t dsts[], size_t n, gqrm_id_t d)
 {
@@ -366,27 +706,41 @@ is_dst_or_src(gqrm_id_t src, gqrm_id_t dsts[], size_t n, gqrm_id_t d)
 	return DS_FALSE;
 }
 
-static int 
-vertex_cmp(sll_data_t v1, sll_data_t v2)
+static pt_ALGraph
+error_clear(pt_ALGraph* pg, pt_SPTWorkspace* ws, IDSet* dsts)
 {
-	vertex_weight_t   w1, w2;
-
-    assert(v1);
-	assert(v2);
-	
-	Vertex_GetWeight((pt_Vertex)v1, &w1);
-	Vertex_GetWeight((pt_Vertex)v2, &w2);
-	return w1 - w2;
+    if (pg)
+        ALGraph_Free(pg);
+    SPTWorkspace_Free(ws);
+    IDSet_Destroy(dsts);
+	return NULL;
 }
 
-static pt_ALGraph
-error_clear(pt_ALGraph* pg, p_sll* g, p_sll* w, p_sll* b)
+/* @fn
+ * The index of the vertex of "pg" with ID "id": the ID
+ * itself when vertices are numbered by index, as graphs
+ * built from a node list are, otherwise found by a scan.
+ */
+static ds_stat
+vertex_index(pt_ALGraph pg, gqrm_id_t id, size_t* re)
 {
-    ALGraph_Free(pg);
-    SingleLinkedList_Destroy(g, NULL);
-    SingleLinkedList_Destroy(w, NULL);
-    SingleLinkedList_Destroy(b, NULL);
-	return NULL;
+    pt_Vertex   pv;
+    gqrm_id_t   vid;
+    size_t      size, i;
+
+    size = ALGraph_Size(pg);
+    if (id >= 0 && (size_t)id < size && ALGraph_GetVertex(pg, id, &pv) == DS_OK &&
+        Vertex_GetID(pv, &vid) == DS_OK && vid == id) {
+        *re = (size_t)id;
+        return DS_OK;
+    }
+    for (i = 0; i < size; i++)
+        if (ALGraph_GetVertex(pg, i, &pv) == DS_OK &&
+            Vertex_GetID(pv, &vid) == DS_OK && vid == id) {
+            *re = i;
+            return DS_OK;
+        }
+    return DS_ERROR;
 }
 
 static ds_bool
@@ -395,18 +749,17 @@ input_feasibility(pt_ALGraph pg, gqrm_id_t src,
 {
     size_t    i;
 
-    printf("func: %s, line: %d\n", __func__, __LINE__);
 	if (!pg || ALGraph_Size(pg) <= 0)
 	    return DS_FALSE;
-    printf("func: %s, line: %d\n", __func__, __LINE__);
-	if (ALGraph_ContainVertexID(pg, src) == DS_FALSE)
+	if (ALGraph_ContainVertexID(pg, src) == DS_FALSE) {
+	    TRACE_ERROR(TRACE_SPT, "source %ld not in graph", src);
 	    return DS_FALSE;
-    printf("func: %s, line: %d\n", __func__, __LINE__);
+	}
 	for (i = 0; i < n; i++) {
-	    printf("dsts: %ld\n", dsts[i]);
-	    if (ALGraph_ContainVertexID(pg, dsts[i]) == DS_FALSE)
+	    if (ALGraph_ContainVertexID(pg, dsts[i]) == DS_FALSE) {
+		    TRACE_ERROR(TRACE_SPT, "destination %ld not in graph", dsts[i]);
 		    return DS_FALSE;
+		}
 	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
 	return DS_TRUE;
 }
@@ -26,8 +26,21 @@
 #include <stdio.h>
 
 #include "header.h"
+#include "metrics.h"
+#include "trace.h"
 #include "graph.h"
 #include "single_linked_list.h"
+#include "vector.h"
+#include "bfs.h"
+
+typedef struct SPT_WORKSPACE    SPTWorkspace;
+typedef SPTWorkspace*           pt_SPTWorkspace;
 
 pt_ALGraph ALGraph_ShortestPathTree(pt_ALGraph, gqrm_id_t, gqrm_id_t [], size_t);
+ds_stat    ALGraph_ShortestPaths(pt_ALGraph, gqrm_id_t, pt_SPTWorkspace);
+pt_SPTWorkspace        SPTWorkspace_Create(void);
+void                   SPTWorkspace_Free(pt_SPTWorkspace*);
+const vertex_weight_t* SPTWorkspace_Weights(pt_SPTWorkspace);
+const gqrm_id_t*       SPTWorkspace_Parents(pt_SPTWorkspace);
+pt_ALGraph ALGraph_ReliableShortestPathTree(pt_ALGraph, gqrm_id_t, gqrm_id_t [], gqrm_hop_t [], size_t);
 #endif
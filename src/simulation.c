@@ -48,6 +48,7 @@ create_event(packet* pkt, int trigger)
 	    return NULL;
 	pe->pkt = pkt;
 	pe->trigger_time = trigger;
+	METRIC_INC(METRIC_SIM_EVENTS);
 	return pe;
 }
 
@@ -80,7 +81,6 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 	gqrm_id_t    parent;
 	double       statistic = 0.0;
 
-    printf("func: %s, line: %d\n", __func__, __LINE__);
     /* generate n packets */
 	for (i = 0; i < n; i++) {
 	    pv = NULL;
@@ -95,7 +95,7 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 		pkts[i].end     = 0;
 		pkts[i].id      = i;
 	}
-    printf("func: %s, line: %d\n", __func__, __LINE__);
+	METRIC_TIMER_BEGIN(t0);
 	/* make n waiting event */
     for (i = 0; i < n; i++) {
 	    wait[i] = create_event(&pkts[i], 0);
@@ -103,9 +103,8 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 	}
 	wait_size = n; run_size = 0;
 
-    printf("func: %s, line: %d\n", __func__, __LINE__);
 	while (wait_size || run_size) { 
-        printf("func: %s, line: %d\n", __func__, __LINE__);
+        TRACE_DEBUG(TRACE_SIM, "tick %ld: %ld waiting, %ld running", clk, wait_size, run_size);
 	    /* check each waiting event */
 	    for (i = 0; i < wait_size; ) {
 		    /* if an event meets its trigger time */
@@ -121,13 +120,13 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 			    } else {
 				   /* backoff */
 				   col++;
+				   METRIC_INC(METRIC_SIM_COLLISIONS);
 		    	    backoff(wait[i++]);
 	    		}
     		} else {
 			    i++;
 			}
 		}
-        printf("func: %s, line: %d\n", __func__, __LINE__);
         /* check each running event */
 		for (i = 0; i < run_size;) {
 		    /* if a running event has expired */
@@ -146,7 +145,7 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 					Vertex_GetParent(pv, &parent);
 					run[i]->pkt->current = run[i]->pkt->next;
 					run[i]->pkt->next    = parent;
-					wait[wait_size++] == create_event(run[i]->pkt, clk + 1);
+					wait[wait_size++] = create_event(run[i]->pkt, clk + 1);
 				}
 				run[i]->pkt->end = clk;
 				/* delete this expired event */
@@ -162,6 +161,7 @@ simulate(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n)
 	}
 	for (i = 0; i < n; i++)
 	    statistic += pkts[i].end;
-	printf("collision %ld\n", col);
+	TRACE_INFO(TRACE_SIM, "collision %ld", col);
+	METRIC_TIMER_END(TIMER_SIMULATE, t0);
 	return statistic / n;
 }
@@ -27,6 +27,8 @@
 #include <time.h>
 
 #include "header.h"
+#include "metrics.h"
+#include "trace.h"
 #include "node.h"
 #include "graph.h"
 
@@ -33,7 +33,12 @@ typedef struct SingleLinkedListNode*  psll_node;
 static psll_node CreateNode(sll_data_t);
 static psll_node FindPrev(p_sll, size_t);
 static psll_node FindNode(p_sll, size_t);
-static void swap(sll_data_t*, sll_data_t*);
+static void merge_sort(p_sll, sll_comp_func, int);
+static psll_node split(psll_node, size_t);
+static psll_node merge(psll_node, psll_node, sll_comp_func, int, psll_node*);
+static int  head_before(p_sll[], size_t, size_t, sll_comp_func);
+static void heap_push(size_t*, size_t*, size_t, p_sll[], sll_comp_func);
+static void heap_sift(size_t*, size_t, size_t, p_sll[], sll_comp_func);
 
 /* @struct 
  *
@@ -53,6 +58,8 @@ struct SingleLinkedListNode {
 struct SingleLinkedList {
     /* the first node with valid data */
     psll_node    head;
+    /* the last node, so that appending is O(1) */
+    psll_node    tail;
     /* the number of nodes in this list */
     size_t      length;
 };
@@ -78,6 +85,7 @@ SingleLinkedList_Init(p_sll* list)
 
     assert(list);
     (*list)->head   = NULL;
+    (*list)->tail   = NULL;
     (*list)->length = 0;
 
     return DS_OK;
@@ -136,6 +144,8 @@ FindNode(p_sll list, size_t index)
         return NULL;
     if (index < 0 || index >= list->length )
         return NULL;
+    if (index == list->length - 1)
+        return list->tail;
 
     for (i = 0, nd = list->head; i < index; i++, nd = nd->next);
 
@@ -166,10 +176,14 @@ SingleLinkedList_Insert(p_sll list, size_t index,
 
     if (!list->head) {
         list->head = nd;
+        list->tail = nd;
     } else {
         if (index == 0) {
             nd->next = list->head;
             list->head = nd;
+        } else if (index == list->length) {
+            list->tail->next = nd;
+            list->tail = nd;
         } else {
             prev = FindPrev(list, index);
             
@@ -226,6 +240,8 @@ SingleLinkedList_Delete(p_sll list, size_t index, sll_data_t* re)
     if (index == 0) {
         nd = list->head;
         list->head = list->head->next;
+        if (!list->head)
+            list->tail = NULL;
     } else {
         prev = FindPrev(list, index);
 
@@ -233,6 +249,8 @@ SingleLinkedList_Delete(p_sll list, size_t index, sll_data_t* re)
 
         nd = prev->next;
         prev->next = prev->next->next;
+        if (nd == list->tail)
+            list->tail = prev;
     }
 
     assert(nd);
@@ -255,11 +273,15 @@ SingleLinkedList_DeleteHead(p_sll list, sll_data_t* re)
 }
 
 /* @fn
- * Delete the last node of a list.
+ * Delete the last node of a list. Nodes do not link back,
+ * so this walks the list.
  */
 ds_stat
 SingleLinkedList_DeleteTail(p_sll list, sll_data_t* re)
 {
+    if (!list)
+        return DS_ERROR;
+
     return SingleLinkedList_Delete(list, list->length - 1, re);
 }
 
@@ -582,55 +604,291 @@ SingleLinkedList_MinData(p_sll list, sll_comp_func cmp,
 }
 
 /* @fn
- * Sort a list in ascending order through bubble sort method.
+ * Sort a list in ascending order. Kept for existing callers,
+ * it is a merge sort now.
  */
 ds_stat
 SingleLinkedList_BubbleSort_A(p_sll list, sll_comp_func cmp) 
 {
-    psll_node iter, end = NULL;
+    return SingleLinkedList_MergeSort_A(list, cmp);
+}
 
+/* @fn
+ * Sort a list in descending order. Kept for existing callers,
+ * it is a merge sort now.
+ */
+ds_stat
+SingleLinkedList_BubbleSort_D(p_sll list, sll_comp_func cmp) 
+{
+    return SingleLinkedList_MergeSort_D(list, cmp);
+}
+
+/* @fn
+ * Sort a list in ascending order in O(n log n), keeping equal
+ * data in their original order. Nodes are relinked, not
+ * copied, and no extra memory is needed.
+ */
+ds_stat
+SingleLinkedList_MergeSort_A(p_sll list, sll_comp_func cmp)
+{
     if (SingleLinkedList_Empty(list) == DS_TRUE || !cmp)
         return DS_ERROR;
 
-    while (end != list->head) {
-        for (iter = list->head; iter->next != end; iter = iter->next) 
-            if (cmp(iter->data, iter->next->data) > 0) 
-                swap(&(iter->data), &(iter->next->data));
-        end = iter;
-    }
+    merge_sort(list, cmp, 1);
+    return DS_OK;
+}
 
+/* @fn
+ * Sort a list in descending order, see
+ * SingleLinkedList_MergeSort_A().
+ */
+ds_stat
+SingleLinkedList_MergeSort_D(p_sll list, sll_comp_func cmp)
+{
+    if (SingleLinkedList_Empty(list) == DS_TRUE || !cmp)
+        return DS_ERROR;
+
+    merge_sort(list, cmp, -1);
     return DS_OK;
 }
 
 /* @fn
- * Sort a list in descending order through bubble sort method.
+ * Move the nodes of "k" lists, each sorted in ascending order
+ * by "cmp", to the tail of "dst" so that they come out in
+ * ascending order. Equal data keep the order of "lists", then
+ * their order within a list. The source lists are left empty.
+ * Takes O(n log k) for n nodes in total.
  */
 ds_stat
-SingleLinkedList_BubbleSort_D(p_sll list, sll_comp_func cmp) 
+SingleLinkedList_MergeSorted(p_sll dst, p_sll lists[], size_t k,
+                             sll_comp_func cmp)
 {
-    psll_node iter, end = NULL;
+    size_t*    heap;
+    size_t     n = 0, i;
+    psll_node  nd;
+    p_sll      src;
 
-    if (SingleLinkedList_Empty(list) == DS_TRUE || !cmp)
+    if (!dst || (!lists && k) || !cmp)
+        return DS_ERROR;
+    if ((heap = malloc((k ? k : 1) * sizeof(size_t))) == NULL)
         return DS_ERROR;
 
-    while (end != list->head) {
-        for (iter = list->head; iter->next != end; iter = iter->next) 
-            if (cmp(iter->data, iter->next->data) < 0) 
-                swap(&(iter->data), &(iter->next->data));
-        end = iter;
+    for (i = 0; i < k; i++)
+        if (lists[i] && lists[i] != dst && lists[i]->head)
+            heap_push(heap, &n, i, lists, cmp);
+
+    while (n > 0) {
+        src = lists[heap[0]];
+        nd  = src->head;
+        src->head = nd->next;
+        if (!src->head)
+            src->tail = NULL;
+        src->length--;
+
+        nd->next = NULL;
+        if (dst->tail)
+            dst->tail->next = nd;
+        else
+            dst->head = nd;
+        dst->tail = nd;
+        dst->length++;
+
+        /* an exhausted list leaves the heap */
+        if (!src->head)
+            heap[0] = heap[--n];
+        heap_sift(heap, n, 0, lists, cmp);
     }
-
+    free(heap);
     return DS_OK;
 }
 
+/* @fn
+ * Bottom-up merge sort: merge runs of width 1, 2, 4, ... of
+ * "list" until one run is left. "sign" is 1 for ascending
+ * order and -1 for descending order.
+ */
 static void
-swap(sll_data_t* d1, sll_data_t* d2)
+merge_sort(p_sll list, sll_comp_func cmp, int sign)
+{
+    sll_node   head;
+    psll_node  rest, a, b, tail, run_tail;
+    size_t     width;
+
+    for (width = 1; width < list->length; width *= 2) {
+        rest = list->head;
+        tail = &head;
+        while (rest) {
+            a    = rest;
+            b    = split(a, width);
+            rest = split(b, width);
+            tail->next = merge(a, b, cmp, sign, &run_tail);
+            tail = run_tail;
+        }
+        list->head = head.next;
+        list->tail = tail;
+    }
+}
+
+/* @fn
+ * Cut the run of at most "n" nodes starting at "nd" from the
+ * rest of its list, and return the rest.
+ */
+static psll_node
+split(psll_node nd, size_t n)
 {
-    if (!d1 || !d2)
+    psll_node rest;
+
+    for (; nd && n > 1; n--)
+        nd = nd->next;
+    if (!nd)
+        return NULL;
+    rest = nd->next;
+    nd->next = NULL;
+    return rest;
+}
+
+/* @fn
+ * Merge two sorted runs. A node of "b" goes first only if it
+ * is strictly before the node of "a", which keeps the merge
+ * stable. The last node of the result is returned through
+ * "tail".
+ */
+static psll_node
+merge(psll_node a, psll_node b, sll_comp_func cmp, int sign,
+      psll_node* tail)
+{
+    sll_node   head;
+    psll_node  t = &head;
+    int        c;
+
+    while (a && b) {
+        c = cmp(b->data, a->data);
+        if (sign > 0 ? c < 0 : c > 0) {
+            t->next = b;
+            b = b->next;
+        } else {
+            t->next = a;
+            a = a->next;
+        }
+        t = t->next;
+    }
+    t->next = a ? a : b;
+    while (t->next)
+        t = t->next;
+    *tail = t;
+    return head.next;
+}
+
+/* @fn
+ * Order of two lists in the heap of SingleLinkedList_MergeSorted():
+ * by their first data, then by their position in "lists".
+ */
+static int
+head_before(p_sll lists[], size_t i, size_t j, sll_comp_func cmp)
+{
+    int   c = cmp(lists[i]->head->data, lists[j]->head->data);
+
+    return c < 0 || (c == 0 && i < j);
+}
+
+static void
+heap_push(size_t* heap, size_t* n, size_t i, p_sll lists[],
+          sll_comp_func cmp)
+{
+    size_t   at = (*n)++, up;
+
+    for (; at > 0; at = up) {
+        up = (at - 1) / 2;
+        if (!head_before(lists, i, heap[up], cmp))
+            break;
+        heap[at] = heap[up];
+    }
+    heap[at] = i;
+}
+
+static void
+heap_sift(size_t* heap, size_t n, size_t at, p_sll lists[],
+          sll_comp_func cmp)
+{
+    size_t   i = heap[at], child;
+
+    for (; (child = 2 * at + 1) < n; at = child) {
+        if (child + 1 < n && head_before(lists, heap[child + 1], heap[child], cmp))
+            child++;
+        if (!head_before(lists, heap[child], i, cmp))
+            break;
+        heap[at] = heap[child];
+    }
+    heap[at] = i;
+}
+
+/* @fn
+ * Place an iterator before the first element of "list".
+ * Changing the list while iterating is not supported, except
+ * for removing the current element through
+ * SingleLinkedList_RemoveCurrent().
+ */
+void
+SingleLinkedList_Begin(p_sll list, sll_iter* it)
+{
+    if (!it)
         return;
+    it->list = list;
+    it->prev = NULL;
+    it->cur  = NULL;
+}
 
-    sll_data_t   tmp = *d1;
+/* @fn
+ * Advance an iterator and return the data of the element it
+ * lands on through "re". DS_FALSE once the list is done.
+ */
+ds_bool
+SingleLinkedList_Next(sll_iter* it, sll_data_t* re)
+{
+    psll_node nd;
+
+    if (!it || !it->list)
+        return DS_FALSE;
+
+    if (it->cur) {
+        it->prev = it->cur;
+        nd = it->cur->next;
+    } else {
+        nd = it->prev ? it->prev->next : it->list->head;
+    }
+    it->cur = nd;
+    if (!nd)
+        return DS_FALSE;
+    if (re)
+        *re = nd->data;
+    return DS_TRUE;
+}
 
-    *d1 = *d2;
-    *d2 = tmp;
+/* @fn
+ * Delete the element last returned by SingleLinkedList_Next()
+ * in O(1). Its data is returned through "re" unless it is
+ * NULL; the next call to SingleLinkedList_Next() returns the
+ * element that followed it.
+ */
+ds_stat
+SingleLinkedList_RemoveCurrent(sll_iter* it, sll_data_t* re)
+{
+    psll_node nd;
+
+    if (!it || !it->list || !it->cur)
+        return DS_ERROR;
+
+    nd = it->cur;
+    if (it->prev)
+        it->prev->next = nd->next;
+    else
+        it->list->head = nd->next;
+    if (it->list->tail == nd)
+        it->list->tail = it->prev;
+    if (re)
+        *re = nd->data;
+    free(nd);
+    it->list->length--;
+    it->cur = NULL;
+    return DS_OK;
 }
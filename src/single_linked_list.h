@@ -24,6 +24,18 @@
  *
  * In this file, the prefix sll stands for 
  * single linked list.
+ *
+ * Indexed access walks the list; to visit every element
+ * use an iterator instead, which also removes the current
+ * element in O(1):
+ *
+ *     sll_iter     it;
+ *     sll_data_t   data;
+ *
+ *     SingleLinkedList_Begin(list, &it);
+ *     while (SingleLinkedList_Next(&it, &data) == DS_TRUE)
+ *         if (unwanted(data))
+ *             SingleLinkedList_RemoveCurrent(&it, NULL);
  */
 
 
@@ -31,6 +43,7 @@
 #define SINGLE_LINKED_LIST_H
 
 struct SingleLinkedList;
+struct SingleLinkedListNode;
 
 typedef struct SingleLinkedList*    p_sll;
 typedef void*                       sll_data_t;
@@ -38,6 +51,19 @@ typedef int (*sll_comp_func)(sll_data_t, sll_data_t);
 typedef void (*mapfunc)(sll_data_t*, void*);
 typedef void (*sll_clear_op)(sll_data_t*);
 
+/* @struct
+ * Cursor over a list. Its fields are private to the list.
+ * list - the list iterated
+ * prev - the node before the current one, NULL at the head
+ * cur  - the node last returned by SingleLinkedList_Next(),
+ *        NULL before the first one or after a removal
+ */
+typedef struct {
+    p_sll                           list;
+    struct SingleLinkedListNode*    prev;
+    struct SingleLinkedListNode*    cur;
+} sll_iter;
+
 extern ds_stat SingleLinkedList_Init(p_sll*);
 extern ds_stat SingleLinkedList_Insert(p_sll, size_t, sll_data_t);
 extern ds_stat SingleLinkedList_InsertHead(p_sll, sll_data_t);
@@ -62,6 +88,12 @@ extern ds_stat SingleLinkedList_Max(p_sll, sll_comp_func, size_t*);
 extern ds_stat SingleLinkedList_Min(p_sll, sll_comp_func, size_t*);
 extern ds_stat SingleLinkedList_BubbleSort_A(p_sll, sll_comp_func);
 extern ds_stat SingleLinkedList_BubbleSort_D(p_sll, sll_comp_func);
+extern ds_stat SingleLinkedList_MergeSort_A(p_sll, sll_comp_func);
+extern ds_stat SingleLinkedList_MergeSort_D(p_sll, sll_comp_func);
+extern ds_stat SingleLinkedList_MergeSorted(p_sll, p_sll[], size_t, sll_comp_func);
 extern ds_stat SingleLinkedList_MaxData(p_sll, sll_comp_func, sll_data_t*);
 extern ds_stat SingleLinkedList_MinData(p_sll, sll_comp_func, sll_data_t*);
+extern void    SingleLinkedList_Begin(p_sll, sll_iter*);
+extern ds_bool SingleLinkedList_Next(sll_iter*, sll_data_t*);
+extern ds_stat SingleLinkedList_RemoveCurrent(sll_iter*, sll_data_t*);
 #endif
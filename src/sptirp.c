@@ -20,27 +20,122 @@
 
 #include "sptirp.h"
 
+/* candidates evaluated per worker and round in parallel pruning */
+#define PRUNE_BATCH    4
+
+/* what parallel pruning knows of a candidate */
+enum { PRUNE_UNKNOWN, PRUNE_KEEP, PRUNE_REMOVE };
+
+/* @struct
+ * Parallel pruning, shared by the workers.
+ * pg, src, dsts, bounds, n
+ *           - what the trees of the workers are built from
+ * g         - the vertices of "pg", for the footprints
+ * cdl_at    - per vertex of "g", its index in "cdls", or
+ *             n_cdls if it is no candidate
+ * trees     - per worker, the hop counts over the CDLs left
+ *             after the first "caught" removals
+ * seen      - per worker, a mark per vertex of "g", and in
+ *             "marks" the last mark given
+ * removed   - indices in "cdls" of the removals committed
+ * batch     - indices in "cdls" evaluated in this round
+ * result    - per candidate, one of PRUNE_*
+ * stamp     - per candidate, "n_removed" when evaluated
+ * footprint - per candidate that can go, "n_cdls" flags
+ *             telling the candidates on the paths to the
+ *             destinations it leaves
+ * failed    - per worker, set if it ran out of memory
+ */
+typedef struct {
+    pt_ALGraph        pg;
+    gqrm_id_t         src;
+    gqrm_id_t*        dsts;
+    gqrm_hop_t*       bounds;
+    size_t            n;
+    pt_BFSGraph       g;
+    size_t*           cdl_at;
+    gqrm_id_t*        cdls;
+    size_t            n_cdls;
+    pt_DynamicSPT*    trees;
+    size_t*           caught;
+    size_t**          seen;
+    size_t*           marks;
+    size_t*           removed;
+    size_t            n_removed;
+    size_t*           batch;
+    char*             result;
+    size_t*           stamp;
+    char*             footprint;
+    char*             failed;
+} prune_arg;
+
+static pt_ALGraph sptirp(p_sll, pt_ThreadPool);
 static pt_ALGraph error_clear(pt_ALGraph*, pt_ALGraph*);
+static pt_ALGraph dynamic_clear(pt_ALGraph*, pt_ALGraph*, pt_DynamicSPT*);
+static ds_stat find_required(pt_ALGraph, gqrm_id_t, gqrm_id_t [], size_t, gqrm_id_t [], size_t, char []);
+static ds_stat required_clear(pt_BFSGraph*, size_t*, char*, char*);
+static ds_stat prune_parallel(pt_ALGraph, pt_ThreadPool, gqrm_id_t, gqrm_id_t [], gqrm_hop_t [], size_t,
+                              gqrm_id_t [], size_t, char []);
+static void prune_batch(size_t, size_t, size_t, void*);
+static pt_DynamicSPT prune_tree(prune_arg*);
+static ds_stat prune_footprint(prune_arg*, pt_DynamicSPT, size_t, size_t);
+static ds_bool prune_current(prune_arg*, size_t);
+static ds_stat prune_clear(prune_arg*, size_t);
 static ds_bool is_in(gqrm_id_t [], size_t, gqrm_id_t);
 
 pt_ALGraph
 SPTiRP(p_sll nodes)
+{
+    pt_ALGraph   pg;
+
+    METRIC_TIMER_BEGIN(t0);
+    pg = sptirp(nodes, NULL);
+    METRIC_TIMER_END(TIMER_SPTIRP, t0);
+    return pg;
+}
+
+/* @fn
+ * SPTiRP with the CDLs tried for pruning in parallel on the
+ * workers of "pool": each evaluates taking out a candidate
+ * against the CDLs selected so far, and the results are
+ * committed in the order SPTiRP() tries them, so that both
+ * select the same CDLs. A NULL pool, or one of a single
+ * worker, prunes sequentially.
+ */
+pt_ALGraph
+SPTiRP_Parallel(p_sll nodes, pt_ThreadPool pool)
+{
+    pt_ALGraph   pg;
+
+    METRIC_TIMER_BEGIN(t0);
+    pg = sptirp(nodes, pool);
+    METRIC_TIMER_END(TIMER_SPTIRP, t0);
+    return pg;
+}
+
+static pt_ALGraph
+sptirp(p_sll nodes, pt_ThreadPool pool)
 {
     pt_ALGraph      spt, pg;
 	pt_Node         pn;
 	pt_Vertex       pv, pv_pa;
 	gqrm_id_t       src = -1, id, parent;
 	gqrm_id_t       dsts[200], cdls[400];
-	size_t          n, i, size, n_cdls;
+	gqrm_hop_t      bounds[200];
+	char            required[400];
+	pt_DynamicSPT   t = NULL;
+	size_t          n, i, n_cdls;
+	sll_iter        it;
+	ds_bool         parallel;
+
+    parallel = pool && ThreadPool_Size(pool) > 1 ? DS_TRUE : DS_FALSE;
 
-    printf("get sns and gw\n");
     /* get all sensor nodes and gateway */
-	size = SingleLinkedList_Size(nodes);
-	for (i = 0, n = 0; i < size; i++) {
-	    if (SingleLinkedList_GetData(nodes, i, (sll_data_t*)&pn) == DS_ERROR)
-		    return NULL;
+	SingleLinkedList_Begin(nodes, &it);
+	for (n = 0; SingleLinkedList_Next(&it, (sll_data_t*)&pn) == DS_TRUE; ) {
 		if (Node_IsSN(pn) == DS_TRUE) {
-		    if (Node_GetID(pn, &dsts[n++]) == DS_ERROR)
+		    if (Node_GetID(pn, &dsts[n]) == DS_ERROR ||
+			    Node_GetHop(pn, &bounds[n++]) == DS_ERROR)
 			    return NULL;
 		} else if (Node_IsGW(pn) == DS_TRUE) {
 		    assert(src == -1);
@@ -49,21 +144,18 @@ SPTiRP(p_sll nodes)
 		}
 	}
 
-    printf("check feasibility\n");
     /* initialize pg and spt, and check feasibility */
 	if ((pg = ALGraph_Create()) == NULL)
 	    return NULL;
-	if (ALGraph_Init(pg, nodes, check_neighbor) == DS_ERROR)
+	if (Neighbor_InitGraph(pg, nodes, pool) == DS_ERROR)
 	    return error_clear(&pg, NULL);
 	if (check_feasibility(pg, src, dsts, n) == DS_FALSE)
 	    return error_clear(&pg, NULL);
-	if ((spt = ALGraph_ShortestPathTree(pg, src, dsts, n)) == NULL)
+	if ((spt = ALGraph_BFSTree(pg, src, dsts, n, NULL)) == NULL)
 	    return error_clear(&pg, &spt);
 
-    
-    printf("get cdls\n");
     /* get all CDLs on the original shortest path tree */
-	for (i = 0, n_cdls; i < n; i++) {
+	for (i = 0, n_cdls = 0; i < n; i++) {
 	    if (ALGraph_GetVertexByID(spt, dsts[i], &pv) == DS_ERROR)
 		    return error_clear(&pg, &spt);
 		if (Vertex_GetParent(pv, &parent) == DS_ERROR)
@@ -80,49 +172,339 @@ SPTiRP(p_sll nodes)
 		}
 	}
 
-    printf("unselecting\n");
-    /* unselect all CDLs not on the original shortest path tree */
-    for (i = 0; i < size; i++) {
-	    if (SingleLinkedList_GetData(nodes, i, (sll_data_t*)&pn) == DS_ERROR)
-		    return error_clear(&pg, &spt);
+    /*
+	 * unselect all CDLs not on the original shortest path tree;
+	 * the graph stays as it is, the CDLs are taken out of the
+	 * hop counts kept by "t" instead, or by the workers when
+	 * pruning in parallel
+	 */
+	if (parallel == DS_FALSE && (t = DynamicSPT_Create(pg, src, dsts, bounds, n)) == NULL)
+	    return error_clear(&pg, &spt);
+	SingleLinkedList_Begin(nodes, &it);
+	while (SingleLinkedList_Next(&it, (sll_data_t*)&pn) == DS_TRUE) {
 		if (Node_GetID(pn, &id) == DS_ERROR)
-		    return error_clear(&pg, &spt);
-		if (Node_IsCDL(pn) == DS_TRUE && is_in(dsts, n_cdls, id) == DS_FALSE)
+		    return dynamic_clear(&pg, &spt, &t);
+		if (Node_IsCDL(pn) == DS_TRUE && is_in(cdls, n_cdls, id) == DS_FALSE) {
 		    Node_SetUnselected(pn);
+			if (t && DynamicSPT_RemoveVertex(t, id) == DS_ERROR)
+		        return dynamic_clear(&pg, &spt, &t);
+		}
 	}
 
     ALGraph_Free(&spt);
+    TRACE_INFO(TRACE_SPTIRP, "%ld CDLs on the shortest path tree", n_cdls);
+	if (find_required(pg, src, dsts, n, cdls, n_cdls, required) == DS_ERROR)
+	    return dynamic_clear(&pg, NULL, &t);
 
-    printf("pruning\n");
-	/* prune redundant CDLs */
-	for (i = 0; i < n_cdls; i++) {
+	/*
+	 * prune redundant CDLs: taking a CDL out only searches
+	 * again the part of the tree below it, and a CDL that
+	 * cannot go is put back the same way; the CDLs found
+	 * required are not even tried
+	 */
+	if (parallel == DS_TRUE &&
+	    prune_parallel(pg, pool, src, dsts, bounds, n, cdls, n_cdls, required) == DS_ERROR)
+	    return error_clear(&pg, NULL);
+	for (i = 0; parallel == DS_FALSE && i < n_cdls; i++) {
+	    if (required[i]) {
+		    METRIC_INC(METRIC_PRUNE_SKIPS);
+			continue;
+		}
 	    if (ALGraph_GetVertexByID(pg, cdls[i], &pv) == DS_ERROR)
-		    return error_clear(&pg, NULL);
+		    return dynamic_clear(&pg, NULL, &t);
 		if (Vertex_GetData(pv, (graph_data_t*)&pn) == DS_ERROR)
-		    return error_clear(&pg, NULL);
+		    return dynamic_clear(&pg, NULL, &t);
 		if (Node_GetID(pn, &id) == DS_ERROR)
-		    return error_clear(&pg, NULL);
+		    return dynamic_clear(&pg, NULL, &t);
 		assert(cdls[i] == id);
+		METRIC_INC(METRIC_PRUNE_ATTEMPTS);
+		METRIC_INC(METRIC_FEASIBILITY_CHECKS);
 		Node_SetUnselected(pn);
-		ALGraph_Free(&pg);
-		if ((pg = ALGraph_Create()) == NULL)
-		    return NULL;
-		if (ALGraph_Init(pg, nodes, check_neighbor) == DS_ERROR)
-		    return error_clear(&pg, NULL);
-		if (check_feasibility(pg, src, dsts, n) == DS_FALSE) {
-		    ALGraph_Free(&pg);
+		if (DynamicSPT_RemoveVertex(t, id) == DS_ERROR)
+		    return dynamic_clear(&pg, NULL, &t);
+		if (DynamicSPT_Feasible(t) == DS_FALSE) {
 			Node_SetSelected(pn);
-			if ((pg = ALGraph_Create()) == NULL)
-			    return NULL;
-		    if (ALGraph_Init(pg, nodes, check_neighbor) == DS_ERROR)
-    		    return error_clear(&pg, NULL);
+			if (DynamicSPT_InsertVertex(t, id) == DS_ERROR)
+		        return dynamic_clear(&pg, NULL, &t);
 		} else {
-		    printf("delete %ld\n", cdls[i]);
+		    METRIC_INC(METRIC_PRUNE_REMOVALS);
+		    TRACE_INFO(TRACE_SPTIRP, "delete %ld", cdls[i]);
 		}
 	}
+	DynamicSPT_Free(&t);
+
+	/* the graph of the CDLs left */
+	ALGraph_Free(&pg);
+	if ((pg = ALGraph_Create()) == NULL)
+	    return NULL;
+	METRIC_INC(METRIC_SPTIRP_REBUILDS);
+	if (Neighbor_InitGraph(pg, nodes, pool) == DS_ERROR)
+	    return error_clear(&pg, NULL);
 	return pg;
 }
 
+/*
+ * Set required[i] if every path from "src" to a destination
+ * over the selected nodes goes through CDL cdls[i]: taking
+ * it out would cut the destination off, and as CDLs are only
+ * taken out from then on, it stays so.
+ */
+static ds_stat
+find_required(pt_ALGraph pg, gqrm_id_t src, gqrm_id_t dsts[], size_t n,
+              gqrm_id_t cdls[], size_t n_cdls, char required[])
+{
+    pt_BFSGraph   g;
+	pt_Vertex     pv;
+	pt_Node       pn;
+	size_t        size, s, i, k;
+	size_t*       idx;
+	char*         removed;
+	char*         sep;
+
+    if ((g = BFSGraph_Create(pg)) == NULL)
+		return DS_ERROR;
+	size    = BFSGraph_Size(g);
+	idx     = malloc((n ? n : 1) * sizeof(size_t));
+	removed = malloc((size ? size : 1) * sizeof(char));
+	sep     = malloc((size ? size : 1) * sizeof(char));
+	if (!idx || !removed || !sep || BFSGraph_IndexOf(g, src, &s) == DS_ERROR)
+		return required_clear(&g, idx, removed, sep);
+	/* the unselected CDLs are out */
+	for (k = 0; k < size; k++) {
+		if (ALGraph_GetVertex(pg, k, &pv) == DS_ERROR ||
+			Vertex_GetData(pv, (graph_data_t*)&pn) == DS_ERROR)
+			return required_clear(&g, idx, removed, sep);
+		removed[k] = Node_IsCDL(pn) == DS_TRUE && Node_IsSelected(pn) == DS_FALSE;
+	}
+	for (i = 0; i < n; i++)
+		if (BFSGraph_IndexOf(g, dsts[i], &idx[i]) == DS_ERROR)
+			return required_clear(&g, idx, removed, sep);
+	if (GraphAnalysis_Separators(g, s, idx, n, removed, sep) == DS_ERROR)
+		return required_clear(&g, idx, removed, sep);
+	for (i = 0; i < n_cdls; i++) {
+		if (BFSGraph_IndexOf(g, cdls[i], &k) == DS_ERROR)
+			return required_clear(&g, idx, removed, sep);
+		required[i] = sep[k];
+	}
+	required_clear(&g, idx, removed, sep);
+	return DS_OK;
+}
+
+/*
+ * Prune like the sequential loop of sptirp(), but a round
+ * at a time: the workers evaluate the next candidates whose
+ * result is not known against the CDLs selected, then the
+ * results are committed in order up to the first that no
+ * longer holds. A CDL that had to stay still has to after
+ * any removal, as the CDLs only get fewer, so only the
+ * results of CDLs that could go are ever evaluated again,
+ * and only if a removal since touched their footprint.
+ */
+static ds_stat
+prune_parallel(pt_ALGraph pg, pt_ThreadPool pool, gqrm_id_t src, gqrm_id_t dsts[],
+               gqrm_hop_t bounds[], size_t n, gqrm_id_t cdls[], size_t n_cdls, char required[])
+{
+    prune_arg   arg;
+	pt_Vertex   pv;
+	pt_Node     pn;
+	size_t      nworkers = ThreadPool_Size(pool), cap = PRUNE_BATCH * ThreadPool_Size(pool);
+	size_t      size, pos, j, k;
+
+    memset(&arg, 0, sizeof(prune_arg));
+	arg.pg     = pg;
+	arg.src    = src;
+	arg.dsts   = dsts;
+	arg.bounds = bounds;
+	arg.n      = n;
+	arg.cdls   = cdls;
+	arg.n_cdls = n_cdls;
+	if ((arg.g = BFSGraph_Create(pg)) == NULL)
+		return DS_ERROR;
+	size          = BFSGraph_Size(arg.g);
+	arg.cdl_at    = malloc((size ? size : 1) * sizeof(size_t));
+	arg.trees     = calloc(nworkers, sizeof(pt_DynamicSPT));
+	arg.caught    = calloc(nworkers, sizeof(size_t));
+	arg.seen      = calloc(nworkers, sizeof(size_t*));
+	arg.marks     = calloc(nworkers, sizeof(size_t));
+	arg.removed   = malloc((n_cdls ? n_cdls : 1) * sizeof(size_t));
+	arg.batch     = malloc(cap * sizeof(size_t));
+	arg.result    = calloc(n_cdls ? n_cdls : 1, sizeof(char));
+	arg.stamp     = malloc((n_cdls ? n_cdls : 1) * sizeof(size_t));
+	arg.footprint = malloc(n_cdls ? n_cdls * n_cdls : 1);
+	arg.failed    = calloc(nworkers, sizeof(char));
+	if (!arg.cdl_at || !arg.trees || !arg.caught || !arg.seen || !arg.marks ||
+		!arg.removed || !arg.batch || !arg.result || !arg.stamp || !arg.footprint ||
+		!arg.failed)
+		return prune_clear(&arg, nworkers);
+	for (k = 0; k < size; k++)
+		arg.cdl_at[k] = n_cdls;
+	for (j = 0; j < n_cdls; j++) {
+		if (BFSGraph_IndexOf(arg.g, cdls[j], &k) == DS_ERROR)
+			return prune_clear(&arg, nworkers);
+		arg.cdl_at[k] = j;
+	}
+
+	for (pos = 0; pos < n_cdls; ) {
+		/* the first candidate not known is always evaluated */
+		for (j = pos, k = 0; j < n_cdls && k < cap; j++)
+			if (!required[j] && prune_current(&arg, j) == DS_FALSE)
+				arg.batch[k++] = j;
+		if (k > 0 && ThreadPool_ParallelFor(pool, k, 1, prune_batch, &arg) == DS_ERROR)
+			return prune_clear(&arg, nworkers);
+		for (j = 0; j < nworkers; j++)
+			if (arg.failed[j])
+				return prune_clear(&arg, nworkers);
+
+		for (; pos < n_cdls; pos++) {
+			if (required[pos]) {
+				METRIC_INC(METRIC_PRUNE_SKIPS);
+				continue;
+			}
+			if (prune_current(&arg, pos) == DS_FALSE)
+				break;
+			METRIC_INC(METRIC_PRUNE_ATTEMPTS);
+			if (arg.result[pos] == PRUNE_KEEP)
+				continue;
+			if (ALGraph_GetVertexByID(pg, cdls[pos], &pv) == DS_ERROR ||
+				Vertex_GetData(pv, (graph_data_t*)&pn) == DS_ERROR)
+				return prune_clear(&arg, nworkers);
+			Node_SetUnselected(pn);
+			arg.removed[arg.n_removed++] = pos;
+			METRIC_INC(METRIC_PRUNE_REMOVALS);
+			TRACE_INFO(TRACE_SPTIRP, "delete %ld", cdls[pos]);
+		}
+	}
+	prune_clear(&arg, nworkers);
+	return DS_OK;
+}
+
+/*
+ * Evaluate candidates batch[begin, end) on the tree of
+ * "worker", after bringing it up to the removals committed.
+ * The tree is left as it was found.
+ */
+static void
+prune_batch(size_t begin, size_t end, size_t worker, void* p)
+{
+    prune_arg*      arg = (prune_arg*)p;
+	pt_DynamicSPT   t;
+	size_t          b, j;
+
+    if (!arg->trees[worker]) {
+		arg->trees[worker]  = prune_tree(arg);
+		arg->caught[worker] = arg->n_removed;
+	}
+	if (!arg->seen[worker])
+		arg->seen[worker] = calloc(BFSGraph_Size(arg->g) ? BFSGraph_Size(arg->g) : 1, sizeof(size_t));
+	if ((t = arg->trees[worker]) == NULL || !arg->seen[worker]) {
+		arg->failed[worker] = 1;
+		return;
+	}
+	while (arg->caught[worker] < arg->n_removed)
+		if (DynamicSPT_RemoveVertex(t, arg->cdls[arg->removed[arg->caught[worker]++]]) == DS_ERROR) {
+			arg->failed[worker] = 1;
+			return;
+		}
+
+	for (b = begin; b < end; b++) {
+		j = arg->batch[b];
+		METRIC_INC(METRIC_FEASIBILITY_CHECKS);
+		if (DynamicSPT_RemoveVertex(t, arg->cdls[j]) == DS_ERROR) {
+			arg->failed[worker] = 1;
+			return;
+		}
+		arg->result[j] = DynamicSPT_Feasible(t) == DS_TRUE ? PRUNE_REMOVE : PRUNE_KEEP;
+		arg->stamp[j]  = arg->n_removed;
+		if ((arg->result[j] == PRUNE_REMOVE &&
+			 prune_footprint(arg, t, worker, j) == DS_ERROR) ||
+			DynamicSPT_InsertVertex(t, arg->cdls[j]) == DS_ERROR) {
+			arg->failed[worker] = 1;
+			return;
+		}
+	}
+}
+
+/*
+ * A tree over the CDLs selected now. The nodes are only
+ * read, and only changed between rounds.
+ */
+static pt_DynamicSPT
+prune_tree(prune_arg* arg)
+{
+    pt_DynamicSPT   t;
+	pt_Vertex       pv;
+	pt_Node         pn;
+	gqrm_id_t       id;
+	size_t          k, size = ALGraph_Size(arg->pg);
+
+    if ((t = DynamicSPT_Create(arg->pg, arg->src, arg->dsts, arg->bounds, arg->n)) == NULL)
+		return NULL;
+	for (k = 0; k < size; k++) {
+		if (ALGraph_GetVertex(arg->pg, k, &pv) == DS_ERROR ||
+			Vertex_GetData(pv, (graph_data_t*)&pn) == DS_ERROR ||
+			Node_GetID(pn, &id) == DS_ERROR ||
+			(Node_IsCDL(pn) == DS_TRUE && Node_IsSelected(pn) == DS_FALSE &&
+			 DynamicSPT_RemoveVertex(t, id) == DS_ERROR)) {
+			DynamicSPT_Free(&t);
+			return NULL;
+		}
+	}
+	return t;
+}
+
+/*
+ * Flag in the footprint of candidate "j" the candidates on
+ * the tree paths from "src" to the destinations, with "j"
+ * taken out of "t". Removals off these paths leave the hop
+ * counts of the destinations, and so the result of "j", as
+ * they are.
+ */
+static ds_stat
+prune_footprint(prune_arg* arg, pt_DynamicSPT t, size_t worker, size_t j)
+{
+    char*       fp = arg->footprint + j * arg->n_cdls;
+	size_t*     seen = arg->seen[worker];
+	size_t      mark = ++arg->marks[worker], i, k;
+	gqrm_id_t   id;
+
+    memset(fp, 0, arg->n_cdls);
+	for (i = 0; i < arg->n; i++) {
+		for (id = arg->dsts[i]; id != -1; ) {
+			if (BFSGraph_IndexOf(arg->g, id, &k) == DS_ERROR)
+				return DS_ERROR;
+			if (seen[k] == mark)
+				break;
+			seen[k] = mark;
+			if (arg->cdl_at[k] < arg->n_cdls)
+				fp[arg->cdl_at[k]] = 1;
+			if (DynamicSPT_GetParent(t, id, &id) == DS_ERROR)
+				return DS_ERROR;
+		}
+	}
+	return DS_OK;
+}
+
+/*
+ * Whether the result of candidate "j" holds for the CDLs
+ * selected now; one that no longer does is forgotten.
+ */
+static ds_bool
+prune_current(prune_arg* arg, size_t j)
+{
+    char*    fp = arg->footprint + j * arg->n_cdls;
+	size_t   r;
+
+    if (arg->result[j] != PRUNE_REMOVE)
+		return arg->result[j] == PRUNE_KEEP ? DS_TRUE : DS_FALSE;
+	for (r = arg->stamp[j]; r < arg->n_removed; r++)
+		if (fp[arg->removed[r]]) {
+			arg->result[j] = PRUNE_UNKNOWN;
+			return DS_FALSE;
+		}
+	arg->stamp[j] = arg->n_removed;
+	return DS_TRUE;
+}
+
 static ds_bool is_in(gqrm_id_t ids[], size_t n, gqrm_id_t id)
 {
     size_t i;
@@ -140,3 +522,43 @@ static pt_ALGraph error_clear(pt_ALGraph* pg1, pt_ALGraph* pg2)
 	    ALGraph_Free(pg2);
 	return NULL;
 }
+
+static pt_ALGraph dynamic_clear(pt_ALGraph* pg1, pt_ALGraph* pg2, pt_DynamicSPT* t)
+{
+    DynamicSPT_Free(t);
+	return error_clear(pg1, pg2);
+}
+
+static ds_stat required_clear(pt_BFSGraph* g, size_t* idx, char* removed, char* sep)
+{
+    BFSGraph_Free(g);
+	free(idx);
+	free(removed);
+	free(sep);
+	return DS_ERROR;
+}
+
+static ds_stat prune_clear(prune_arg* arg, size_t nworkers)
+{
+    size_t   w;
+
+    for (w = 0; w < nworkers; w++) {
+	    if (arg->trees)
+		    DynamicSPT_Free(&arg->trees[w]);
+		if (arg->seen)
+		    free(arg->seen[w]);
+	}
+	BFSGraph_Free(&arg->g);
+	free(arg->cdl_at);
+	free(arg->trees);
+	free(arg->caught);
+	free(arg->seen);
+	free(arg->marks);
+	free(arg->removed);
+	free(arg->batch);
+	free(arg->result);
+	free(arg->stamp);
+	free(arg->footprint);
+	free(arg->failed);
+	return DS_ERROR;
+}
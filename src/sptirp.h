@@ -24,13 +24,21 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "header.h"
+#include "metrics.h"
+#include "trace.h"
 #include "node.h"
 #include "single_linked_list.h"
 #include "graph.h"
 #include "shortest_path_tree.h"
 #include "rnp_misc.h"
+#include "neighbor.h"
+#include "dynamic_spt.h"
+#include "graph_analysis.h"
+#include "thread_pool.h"
 
 pt_ALGraph SPTiRP(p_sll);
+pt_ALGraph SPTiRP_Parallel(p_sll, pt_ThreadPool);
 #endif
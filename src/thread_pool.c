@@ -0,0 +1,241 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "thread_pool.h"
+
+/* @struct
+ * Structure of a thread pool:
+ * size       - the number of workers, the caller included
+ * threads    - the size - 1 background threads
+ * lock, wake, idle
+ *            - protect and signal the fields below
+ * generation - incremented for every loop, workers wait for
+ *              it to change
+ * running    - background workers still inside current loop
+ * quit       - set when the pool is being destroyed
+ * n, grain, next, func, arg
+ *            - the current loop; "next" is claimed atomically
+ *              "grain" iterations at a time
+ */
+struct THREAD_POOL {
+    size_t             size;
+    pthread_t*         threads;
+    pthread_mutex_t    lock;
+    pthread_cond_t     wake;
+    pthread_cond_t     idle;
+    size_t             generation;
+    size_t             running;
+    int                quit;
+    size_t             n;
+    size_t             grain;
+    size_t             next;
+    pool_task          func;
+    void*              arg;
+};
+
+/* @struct
+ * Start argument of a background worker.
+ */
+typedef struct {
+    pt_ThreadPool   pool;
+    size_t          worker;
+} worker_arg;
+
+static void* worker_main(void*);
+static void  run_chunks(pt_ThreadPool, size_t);
+
+/* @fn
+ * Return the number of online processors, at least 1.
+ */
+size_t
+ThreadPool_DefaultSize(void)
+{
+    long   n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n > 0 ? (size_t)n : 1;
+}
+
+/* @fn
+ * Create a pool of "size" workers, the caller being one of
+ * them. A size of 0 means one worker per online processor.
+ */
+pt_ThreadPool
+ThreadPool_Create(size_t size)
+{
+    pt_ThreadPool   pool;
+    worker_arg*     args;
+    size_t          i;
+
+    if (size == 0)
+        size = ThreadPool_DefaultSize();
+    if ((pool = calloc(1, sizeof(ThreadPool))) == NULL)
+        return NULL;
+    pool->size = size;
+    if (size > 1 && (pool->threads = malloc((size - 1) * sizeof(pthread_t))) == NULL) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    for (i = 1; i < size; i++) {
+        if ((args = malloc(sizeof(worker_arg))) == NULL)
+            break;
+        args->pool   = pool;
+        args->worker = i;
+        if (pthread_create(&pool->threads[i - 1], NULL, worker_main, args) != 0) {
+            free(args);
+            break;
+        }
+    }
+    if (i < size) {
+        /* run with the threads we managed to start */
+        pool->size = i;
+    }
+    return pool;
+}
+
+size_t
+ThreadPool_Size(pt_ThreadPool pool)
+{
+    if (!pool)
+        return 1;
+    return pool->size;
+}
+
+/* @fn
+ * Claim chunks of the current loop until none is left.
+ */
+static void
+run_chunks(pt_ThreadPool pool, size_t worker)
+{
+    size_t   begin, end;
+
+    for (;;) {
+        begin = __sync_fetch_and_add(&pool->next, pool->grain);
+        if (begin >= pool->n)
+            return;
+        end = begin + pool->grain < pool->n ? begin + pool->grain : pool->n;
+        pool->func(begin, end, worker, pool->arg);
+    }
+}
+
+static void*
+worker_main(void* p)
+{
+    worker_arg*     args = (worker_arg*)p;
+    pt_ThreadPool   pool = args->pool;
+    size_t          worker = args->worker, seen = 0;
+
+    free(args);
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->quit && pool->generation == seen)
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->quit) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_chunks(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/* @fn
+ * Run "func" over iterations [0, n), handing out "grain"
+ * iterations at a time (0 picks a grain giving every worker
+ * several chunks). Return once all iterations are done.
+ * Chunks are scheduled dynamically, so "func" must not rely
+ * on which worker gets which chunk; results that need a
+ * deterministic order should be stored per iteration.
+ */
+ds_stat
+ThreadPool_ParallelFor(pt_ThreadPool pool, size_t n, size_t grain,
+                       pool_task func, void* arg)
+{
+    if (!func)
+        return DS_ERROR;
+    if (n == 0)
+        return DS_OK;
+    if (grain == 0) {
+        grain = n / (ThreadPool_Size(pool) * 8);
+        if (grain == 0)
+            grain = 1;
+    }
+    if (!pool || pool->size == 1) {
+        func(0, n, 0, arg);
+        return DS_OK;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->n       = n;
+    pool->grain   = grain;
+    pool->next    = 0;
+    pool->func    = func;
+    pool->arg     = arg;
+    pool->running = pool->size - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_chunks(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running)
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    return DS_OK;
+}
+
+void
+ThreadPool_Free(pt_ThreadPool* pool)
+{
+    size_t   i;
+
+    if (!pool || !*pool)
+        return;
+
+    pthread_mutex_lock(&(*pool)->lock);
+    (*pool)->quit = 1;
+    pthread_cond_broadcast(&(*pool)->wake);
+    pthread_mutex_unlock(&(*pool)->lock);
+    for (i = 1; i < (*pool)->size; i++)
+        pthread_join((*pool)->threads[i - 1], NULL);
+
+    pthread_mutex_destroy(&(*pool)->lock);
+    pthread_cond_destroy(&(*pool)->wake);
+    pthread_cond_destroy(&(*pool)->idle);
+    free((*pool)->threads);
+    free(*pool);
+    *pool = NULL;
+}
@@ -0,0 +1,52 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file thread_pool.h
+ *
+ * A fixed set of worker threads executing parallel loops.
+ *
+ * The calling thread takes part in every loop as worker 0,
+ * so a pool of size 1 runs everything inline and never
+ * creates a thread.
+ */
+
+#ifndef GQRM_THREAD_POOL_H
+#define GQRM_THREAD_POOL_H
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "header.h"
+
+typedef struct THREAD_POOL   ThreadPool;
+typedef ThreadPool*          pt_ThreadPool;
+
+/* 
+ * A loop body processing iterations [begin, end) on behalf
+ * of worker "worker" (0 <= worker < ThreadPool_Size()).
+ */
+typedef void (*pool_task)(size_t, size_t, size_t, void*);
+
+extern pt_ThreadPool ThreadPool_Create(size_t);
+extern size_t        ThreadPool_Size(pt_ThreadPool);
+extern size_t        ThreadPool_DefaultSize(void);
+extern ds_stat       ThreadPool_ParallelFor(pt_ThreadPool, size_t, size_t, pool_task, void*);
+extern void          ThreadPool_Free(pt_ThreadPool*);
+#endif
@@ -0,0 +1,187 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "trace.h"
+
+/* "seq" of a record being written */
+#define TRACE_BUSY   UINT64_MAX
+
+/* @struct
+ * A record of the ring buffer. "seq" is 0 while the slot
+ * was never written, TRACE_BUSY while its writer owns it and
+ * i + 1 once the i-th emitted record is complete, so that a
+ * reader can tell a stable record from one being overwritten.
+ */
+typedef struct {
+    volatile uint64_t   seq;
+    double              time;
+    int                 level;
+    unsigned            sub;
+    const char*         func;
+    int                 line;
+    char                msg[TRACE_MSG_SIZE];
+} trace_record;
+
+unsigned                   trace_mask = TRACE_ALL;
+
+static trace_record        ring[TRACE_RING_SIZE];
+static volatile uint64_t   head = 0;
+static FILE*               echo = NULL;
+
+static const char*  level_names[] = {"", "error", "info", "debug"};
+static const char*  sub_names[] = {"graph", "spt", "sim", "sptirp", "set", "tree"};
+
+static const char*  sub_name(unsigned);
+
+/* @fn
+ * Record a trace point. Writers never wait for each other:
+ * each claims the next slot of the ring with an atomic
+ * increment, overwriting the oldest record. A writer that
+ * finds its slot still owned by another one, a whole ring
+ * behind or ahead, drops its record instead of sharing it.
+ */
+void
+Trace_Emit(int level, unsigned sub, const char* func, int line,
+           const char* fmt, ...)
+{
+    uint64_t          idx = __sync_fetch_and_add(&head, 1);
+    trace_record*     rec = &ring[idx % TRACE_RING_SIZE];
+    uint64_t          old = rec->seq;
+    struct timespec   ts;
+    va_list           ap;
+
+    if (old == TRACE_BUSY || old > idx ||
+        !__sync_bool_compare_and_swap(&rec->seq, old, TRACE_BUSY))
+        return;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rec->time  = ts.tv_sec + ts.tv_nsec / 1e9;
+    rec->level = level;
+    rec->sub   = sub;
+    rec->func  = func;
+    rec->line  = line;
+    va_start(ap, fmt);
+    vsnprintf(rec->msg, TRACE_MSG_SIZE, fmt, ap);
+    va_end(ap);
+    __sync_synchronize();
+    rec->seq = idx + 1;
+
+    if (echo)
+        fprintf(echo, "[%s %s] %s:%d: %s\n", level_names[level],
+                sub_name(sub), func, line, rec->msg);
+}
+
+void
+Trace_SetMask(unsigned mask)
+{
+    trace_mask = mask;
+}
+
+/* @fn
+ * Turn a comma separated list of subsystem names, or "all",
+ * into a mask for Trace_SetMask(). Unknown names are
+ * ignored.
+ */
+unsigned
+Trace_ParseMask(const char* s)
+{
+    unsigned   mask = 0;
+    size_t     len, i;
+
+    while (s && *s) {
+        len = strcspn(s, ",");
+        if (len == 3 && strncmp(s, "all", 3) == 0)
+            mask |= TRACE_ALL;
+        for (i = 0; i < sizeof(sub_names) / sizeof(sub_names[0]); i++)
+            if (strlen(sub_names[i]) == len && strncmp(s, sub_names[i], len) == 0)
+                mask |= 1u << i;
+        s += len;
+        if (*s == ',')
+            s++;
+    }
+    return mask;
+}
+
+/* @fn
+ * Print every trace point to "fp" as it is emitted, NULL to
+ * stop. Meant for interactive debugging only: unlike the
+ * ring buffer, this goes through stdio locks.
+ */
+void
+Trace_SetEcho(FILE* fp)
+{
+    echo = fp;
+}
+
+/* @fn
+ * Print the records still in the ring, oldest first,
+ * skipping those overwritten while printing. Return the
+ * number of records printed.
+ */
+size_t
+Trace_Dump(FILE* fp)
+{
+    uint64_t       end = head, i;
+    trace_record   rec;
+    size_t         n = 0;
+
+    if (!fp)
+        return 0;
+    for (i = end > TRACE_RING_SIZE ? end - TRACE_RING_SIZE : 0; i < end; i++) {
+        if (ring[i % TRACE_RING_SIZE].seq != i + 1)
+            continue;
+        memcpy(&rec, (const void*)&ring[i % TRACE_RING_SIZE], sizeof(rec));
+        __sync_synchronize();
+        if (ring[i % TRACE_RING_SIZE].seq != i + 1)
+            continue;
+        fprintf(fp, "%.6f [%s %s] %s:%d: %s\n", rec.time, level_names[rec.level],
+                sub_name(rec.sub), rec.func, rec.line, rec.msg);
+        n++;
+    }
+    return n;
+}
+
+/* @fn
+ * Forget all records. Must not run concurrently with
+ * Trace_Emit().
+ */
+void
+Trace_Clear(void)
+{
+    memset(ring, 0, sizeof(ring));
+    head = 0;
+}
+
+static const char*
+sub_name(unsigned sub)
+{
+    size_t   i;
+
+    for (i = 0; i < sizeof(sub_names) / sizeof(sub_names[0]); i++)
+        if (sub == 1u << i)
+            return sub_names[i];
+    return "?";
+}
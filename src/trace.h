@@ -0,0 +1,100 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file trace.h
+ *
+ * Diagnostics that cost nothing unless asked for.
+ *
+ * Trace points are written as
+ *
+ *     TRACE_DEBUG(TRACE_SIM, "tick %ld", clk);
+ *
+ * and compiled out entirely unless GQRM_TRACE_LEVEL (0 by
+ * default) is at least the level of the point, e.g. with
+ * -DGQRM_TRACE_LEVEL=3 for everything. Compiled-in points
+ * are filtered at run time by subsystem (Trace_SetMask()),
+ * and recorded in a lock-free ring buffer keeping the last
+ * TRACE_RING_SIZE records, which Trace_Dump() prints. They
+ * are only formatted and printed on the spot when an echo
+ * stream is set.
+ */
+
+#ifndef GQRM_TRACE_H
+#define GQRM_TRACE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifndef GQRM_TRACE_LEVEL
+#define GQRM_TRACE_LEVEL    0
+#endif
+
+#define TRACE_LEVEL_ERROR   1
+#define TRACE_LEVEL_INFO    2
+#define TRACE_LEVEL_DEBUG   3
+
+#define TRACE_RING_SIZE     1024
+#define TRACE_MSG_SIZE      112
+
+typedef enum {
+    TRACE_GRAPH  = 1 << 0,
+    TRACE_SPT    = 1 << 1,
+    TRACE_SIM    = 1 << 2,
+    TRACE_SPTIRP = 1 << 3,
+    TRACE_SET    = 1 << 4,
+    TRACE_TREE   = 1 << 5,
+    TRACE_ALL    = (1 << 6) - 1
+} trace_subsystem;
+
+/* subsystems currently let through, read by the macros */
+extern unsigned      trace_mask;
+
+extern void          Trace_Emit(int, unsigned, const char*, int, const char*, ...);
+extern void          Trace_SetMask(unsigned);
+extern unsigned      Trace_ParseMask(const char*);
+extern void          Trace_SetEcho(FILE*);
+extern size_t        Trace_Dump(FILE*);
+extern void          Trace_Clear(void);
+
+#define TRACE_AT(level, sub, ...) \
+    do { \
+        if (trace_mask & (sub)) \
+            Trace_Emit((level), (sub), __func__, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+#if GQRM_TRACE_LEVEL >= TRACE_LEVEL_ERROR
+#define TRACE_ERROR(sub, ...)   TRACE_AT(TRACE_LEVEL_ERROR, sub, __VA_ARGS__)
+#else
+#define TRACE_ERROR(sub, ...)   ((void)0)
+#endif
+
+#if GQRM_TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(sub, ...)    TRACE_AT(TRACE_LEVEL_INFO, sub, __VA_ARGS__)
+#else
+#define TRACE_INFO(sub, ...)    ((void)0)
+#endif
+
+#if GQRM_TRACE_LEVEL >= TRACE_LEVEL_DEBUG
+#define TRACE_DEBUG(sub, ...)   TRACE_AT(TRACE_LEVEL_DEBUG, sub, __VA_ARGS__)
+#else
+#define TRACE_DEBUG(sub, ...)   ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* @file typed_containers.h
+ *
+ * Type-specialized containers generated by macros.
+ *
+ * The containers of vector.h, avl_tree.h or set.h store
+ * void* and compare through a function pointer, and every
+ * comparison of vertices goes through getters on top. The
+ * ones here store values of a single type inline and compare
+ * them with an expression the compiler sees, so the inner
+ * loops they sit in need neither an indirect call nor a
+ * pointer chase per element:
+ *
+ *     GQRM_VECTOR(name, type)            growable array
+ *     GQRM_HEAP(name, type, less)        binary min-heap
+ *     GQRM_SORTED_SET(name, type, less)  set kept as a sorted array
+ *
+ * "less(a, b)" is a macro or an inline function telling
+ * whether value "a" goes before value "b". A container is a
+ * plain struct the caller owns, and every function generated
+ * for it is static inline and named after it:
+ *
+ *     typedef struct { int weight; size_t vertex; } entry;
+ *     #define ENTRY_LESS(a, b)    ((a).weight < (b).weight)
+ *     GQRM_HEAP(EntryHeap, entry, ENTRY_LESS)
+ *
+ *     EntryHeap   q;
+ *     EntryHeap_Init(&q);
+ *     EntryHeap_Push(&q, e);
+ *     while (EntryHeap_Pop(&q, &e) == DS_OK)
+ *         ...
+ *     EntryHeap_Destroy(&q);
+ *
+ * IDVec and IDSet, over gqrm_id_t, are defined here for all.
+ */
+
+#ifndef GQRM_TYPED_CONTAINERS_H
+#define GQRM_TYPED_CONTAINERS_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "header.h"
+
+#define GQRM_LESS(a, b)    ((a) < (b))
+
+/* @fn
+ * Grow "*data", of "*cap" elements of "elem" bytes, to hold
+ * at least "n" elements, doubling from 16.
+ */
+static inline ds_stat
+gqrm_grow(void** data, size_t* cap, size_t n, size_t elem)
+{
+    void*    p;
+    size_t   c;
+
+    if (n <= *cap)
+        return DS_OK;
+    for (c = *cap ? *cap : 16; c < n; c *= 2) ;
+    if ((p = realloc(*data, c * elem)) == NULL)
+        return DS_ERROR;
+    *data = p;
+    *cap  = c;
+    return DS_OK;
+}
+
+#define GQRM_CONTAINER_BODY(name, type)                                 \
+typedef struct {                                                        \
+    type*    data;                                                      \
+    size_t   size;                                                      \
+    size_t   cap;                                                       \
+} name;                                                                 \
+                                                                        \
+static inline void                                                      \
+name##_Init(name* c)                                                    \
+{                                                                       \
+    c->data = NULL;                                                     \
+    c->size = 0;                                                        \
+    c->cap  = 0;                                                        \
+}                                                                       \
+                                                                        \
+static inline ds_stat                                                   \
+name##_Reserve(name* c, size_t n)                                       \
+{                                                                       \
+    return gqrm_grow((void**)&c->data, &c->cap, n, sizeof(type));       \
+}                                                                       \
+                                                                        \
+static inline size_t                                                    \
+name##_Size(const name* c)                                              \
+{                                                                       \
+    return c->size;                                                     \
+}                                                                       \
+                                                                        \
+static inline ds_bool                                                   \
+name##_Empty(const name* c)                                             \
+{                                                                       \
+    return c->size ? DS_FALSE : DS_TRUE;                                \
+}                                                                       \
+                                                                        \
+static inline void                                                      \
+name##_Clear(name* c)                                                   \
+{                                                                       \
+    c->size = 0;                                                        \
+}                                                                       \
+                                                                        \
+static inline void                                                      \
+name##_Destroy(name* c)                                                 \
+{                                                                       \
+    free(c->data);                                                      \
+    name##_Init(c);                                                     \
+}
+
+/* @fn
+ * A growable array of "type": data[0 .. size - 1] may be
+ * read and written directly.
+ */
+#define GQRM_VECTOR(name, type)                                         \
+GQRM_CONTAINER_BODY(name, type)                                         \
+                                                                        \
+static inline ds_stat                                                   \
+name##_PushBack(name* v, type x)                                        \
+{                                                                       \
+    if (v->size == v->cap && name##_Reserve(v, v->size + 1) == DS_ERROR) \
+        return DS_ERROR;                                                \
+    v->data[v->size++] = x;                                             \
+    return DS_OK;                                                       \
+}                                                                       \
+                                                                        \
+static inline ds_stat                                                   \
+name##_PopBack(name* v, type* re)                                       \
+{                                                                       \
+    if (!v->size)                                                       \
+        return DS_ERROR;                                                \
+    v->size--;                                                          \
+    if (re)                                                             \
+        *re = v->data[v->size];                                         \
+    return DS_OK;                                                       \
+}                                                                       \
+                                                                        \
+/* delete element "i", the last one taking its place */                \
+static inline void                                                      \
+name##_SwapRemove(name* v, size_t i)                                    \
+{                                                                       \
+    v->data[i] = v->data[--v->size];                                    \
+}
+
+/* @fn
+ * A binary min-heap of "type": Pop returns the element no
+ * other is "less" than. data[0] is the top.
+ */
+#define GQRM_HEAP(name, type, less)                                     \
+GQRM_CONTAINER_BODY(name, type)                                         \
+                                                                        \
+static inline ds_stat                                                   \
+name##_Push(name* h, type x)                                            \
+{                                                                       \
+    size_t   i, up;                                                     \
+                                                                        \
+    if (h->size == h->cap && name##_Reserve(h, h->size + 1) == DS_ERROR) \
+        return DS_ERROR;                                                \
+    for (i = h->size++; i > 0; i = up) {                                \
+        up = (i - 1) / 2;                                               \
+        if (!(less(x, h->data[up])))                                    \
+            break;                                                      \
+        h->data[i] = h->data[up];                                       \
+    }                                                                   \
+    h->data[i] = x;                                                     \
+    return DS_OK;                                                       \
+}                                                                       \
+                                                                        \
+static inline ds_stat                                                   \
+name##_Pop(name* h, type* re)                                           \
+{                                                                       \
+    type     last;                                                      \
+    size_t   i, c;                                                      \
+                                                                        \
+    if (!h->size)                                                       \
+        return DS_ERROR;                                                \
+    if (re)                                                             \
+        *re = h->data[0];                                               \
+    last = h->data[--h->size];                                          \
+    for (i = 0; (c = 2 * i + 1) < h->size; i = c) {                     \
+        if (c + 1 < h->size && (less(h->data[c + 1], h->data[c])))      \
+            c++;                                                        \
+        if (!(less(h->data[c], last)))                                  \
+            break;                                                      \
+        h->data[i] = h->data[c];                                        \
+    }                                                                   \
+    h->data[i] = last;                                                  \
+    return DS_OK;                                                       \
+}
+
+/* @fn
+ * A set of "type" kept sorted by "less": lookups are binary
+ * searches, insertions and deletions move the tail. Two
+ * values are the same when neither is "less". Fits sets
+ * built once and queried often; Build sorts in place by
+ * heapsort and drops duplicates.
+ */
+#define GQRM_SORTED_SET(name, type, less)                               \
+GQRM_CONTAINER_BODY(name, type)                                         \
+                                                                        \
+/* the first position whose value is not less than "x" */              \
+static inline size_t                                                    \
+name##_LowerBound(const name* s, type x)                                \
+{                                                                       \
+    size_t   lo = 0, hi = s->size, mid;                                 \
+                                                                        \
+    while (lo < hi) {                                                   \
+        mid = (lo + hi) / 2;                                            \
+        if (less(s->data[mid], x))                                      \
+            lo = mid + 1;                                               \
+        else                                                            \
+            hi = mid;                                                   \
+    }                                                                   \
+    return lo;                                                          \
+}                                                                       \
+                                                                        \
+static inline ds_bool                                                   \
+name##_Contain(const name* s, type x)                                   \
+{                                                                       \
+    size_t   i = name##_LowerBound(s, x);                               \
+                                                                        \
+    return i < s->size && !(less(x, s->data[i])) ? DS_TRUE : DS_FALSE;  \
+}                                                                       \
+                                                                        \
+/* DS_ERROR if "x" is already in the set */                             \
+static inline ds_stat                                                   \
+name##_Insert(name* s, type x)                                          \
+{                                                                       \
+    size_t   i = name##_LowerBound(s, x);                               \
+                                                                        \
+    if (i < s->size && !(less(x, s->data[i])))                          \
+        return DS_ERROR;                                                \
+    if (s->size == s->cap && name##_Reserve(s, s->size + 1) == DS_ERROR) \
+        return DS_ERROR;                                                \
+    memmove(&s->data[i + 1], &s->data[i], (s->size - i) * sizeof(type)); \
+    s->data[i] = x;                                                     \
+    s->size++;                                                          \
+    return DS_OK;                                                       \
+}                                                                       \
+                                                                        \
+/* DS_ERROR if "x" is not in the set */                                 \
+static inline ds_stat                                                   \
+name##_Delete(name* s, type x)                                          \
+{                                                                       \
+    size_t   i = name##_LowerBound(s, x);                               \
+                                                                        \
+    if (i == s->size || less(x, s->data[i]))                            \
+        return DS_ERROR;                                                \
+    s->size--;                                                          \
+    memmove(&s->data[i], &s->data[i + 1], (s->size - i) * sizeof(type)); \
+    return DS_OK;                                                       \
+}                                                                       \
+                                                                        \
+static inline void                                                      \
+name##_sift(type* a, size_t i, size_t n)                                \
+{                                                                       \
+    type     x = a[i];                                                  \
+    size_t   c;                                                         \
+                                                                        \
+    for (; (c = 2 * i + 1) < n; i = c) {                                \
+        if (c + 1 < n && (less(a[c], a[c + 1])))                        \
+            c++;                                                        \
+        if (!(less(x, a[c])))                                           \
+            break;                                                      \
+        a[i] = a[c];                                                    \
+    }                                                                   \
+    a[i] = x;                                                           \
+}                                                                       \
+                                                                        \
+/* replace the content with the "n" values of "xs" */                  \
+static inline ds_stat                                                   \
+name##_Build(name* s, const type xs[], size_t n)                        \
+{                                                                       \
+    type     t;                                                         \
+    size_t   i, k;                                                      \
+                                                                        \
+    if (n == 0) {                                                       \
+        s->size = 0;                                                    \
+        return DS_OK;                                                   \
+    }                                                                   \
+    if (name##_Reserve(s, n) == DS_ERROR)                               \
+        return DS_ERROR;                                                \
+    memcpy(s->data, xs, n * sizeof(type));                              \
+    for (i = n / 2; i > 0; i--)                                         \
+        name##_sift(s->data, i - 1, n);                                 \
+    for (i = n; i > 1; i--) {                                           \
+        t = s->data[0];                                                 \
+        s->data[0] = s->data[i - 1];                                    \
+        s->data[i - 1] = t;                                             \
+        name##_sift(s->data, 0, i - 1);                                 \
+    }                                                                   \
+    for (i = k = 0; i < n; i++)                                         \
+        if (k == 0 || less(s->data[k - 1], s->data[i]))                 \
+            s->data[k++] = s->data[i];                                  \
+    s->size = k;                                                        \
+    return DS_OK;                                                       \
+}
+
+GQRM_VECTOR(IDVec, gqrm_id_t)
+GQRM_SORTED_SET(IDSet, gqrm_id_t, GQRM_LESS)
+
+#endif
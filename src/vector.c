@@ -0,0 +1,325 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <assert.h>
+
+#include "vector.h"
+
+/* capacity of a vector on its first push */
+#define VECTOR_MIN_CAPACITY   8
+
+/* @struct
+ *
+ * Growable array of pointers.
+ */
+struct Vector {
+    /* the elements, "capacity" slots of which "size" are used */
+    vec_data_t*   data;
+    size_t        size;
+    size_t        capacity;
+};
+
+static ds_stat grow(p_vec, size_t);
+
+/* @fn
+ * Initialize a non-initialized vector. As for lists, a
+ * non-null "*vec" is assumed to be initialized already.
+ */
+ds_stat
+Vector_Init(p_vec* vec)
+{
+    if (!vec || *vec != NULL)
+        return DS_ERROR;
+    if ((*vec = malloc(sizeof(struct Vector))) == NULL)
+        return DS_ERROR;
+    (*vec)->data     = NULL;
+    (*vec)->size     = 0;
+    (*vec)->capacity = 0;
+    return DS_OK;
+}
+
+/* @fn
+ * Make room for at least "n" elements, so that the next
+ * pushes up to "n" do not reallocate.
+ */
+ds_stat
+Vector_Reserve(p_vec vec, size_t n)
+{
+    if (!vec)
+        return DS_ERROR;
+    if (n <= vec->capacity)
+        return DS_OK;
+    return grow(vec, n);
+}
+
+/* @fn
+ * Reallocate "vec" to hold at least "n" elements, doubling
+ * the capacity so that pushes are amortized O(1).
+ */
+static ds_stat
+grow(p_vec vec, size_t n)
+{
+    size_t        cap = vec->capacity ? vec->capacity : VECTOR_MIN_CAPACITY;
+    vec_data_t*   data;
+
+    while (cap < n)
+        cap *= 2;
+    if ((data = realloc(vec->data, cap * sizeof(vec_data_t))) == NULL)
+        return DS_ERROR;
+    vec->data     = data;
+    vec->capacity = cap;
+    return DS_OK;
+}
+
+size_t
+Vector_Size(p_vec vec)
+{
+    return vec ? vec->size : 0;
+}
+
+ds_bool
+Vector_Empty(p_vec vec)
+{
+    if (!vec || vec->size == 0)
+        return DS_TRUE;
+    return DS_FALSE;
+}
+
+/* @fn
+ * Return the elements as an array of Vector_Size() entries,
+ * valid until the vector next grows.
+ */
+vec_data_t*
+Vector_Data(p_vec vec)
+{
+    return vec ? vec->data : NULL;
+}
+
+ds_stat
+Vector_PushBack(p_vec vec, vec_data_t data)
+{
+    if (!vec)
+        return DS_ERROR;
+    if (vec->size == vec->capacity && grow(vec, vec->size + 1) == DS_ERROR)
+        return DS_ERROR;
+    vec->data[vec->size++] = data;
+    return DS_OK;
+}
+
+/* @fn
+ * Remove the last element, returned through "re" unless it
+ * is NULL.
+ */
+ds_stat
+Vector_PopBack(p_vec vec, vec_data_t* re)
+{
+    if (Vector_Empty(vec) == DS_TRUE)
+        return DS_ERROR;
+    vec->size--;
+    if (re)
+        *re = vec->data[vec->size];
+    return DS_OK;
+}
+
+/* @fn
+ * Insert "data" before the "index"th element, moving the
+ * following elements up. "index" may be Vector_Size().
+ */
+ds_stat
+Vector_Insert(p_vec vec, size_t index, vec_data_t data)
+{
+    if (!vec || index > vec->size)
+        return DS_ERROR;
+    if (vec->size == vec->capacity && grow(vec, vec->size + 1) == DS_ERROR)
+        return DS_ERROR;
+    memmove(&vec->data[index + 1], &vec->data[index],
+            (vec->size - index) * sizeof(vec_data_t));
+    vec->data[index] = data;
+    vec->size++;
+    return DS_OK;
+}
+
+/* @fn
+ * Delete the "index"th element keeping the order of the
+ * others. The element is returned through "re" unless it is
+ * NULL.
+ */
+ds_stat
+Vector_Delete(p_vec vec, size_t index, vec_data_t* re)
+{
+    if (!vec || index >= vec->size)
+        return DS_ERROR;
+    if (re)
+        *re = vec->data[index];
+    vec->size--;
+    memmove(&vec->data[index], &vec->data[index + 1],
+            (vec->size - index) * sizeof(vec_data_t));
+    return DS_OK;
+}
+
+/* @fn
+ * Delete the "index"th element in O(1) by moving the last
+ * element into its place.
+ */
+ds_stat
+Vector_SwapRemove(p_vec vec, size_t index, vec_data_t* re)
+{
+    if (!vec || index >= vec->size)
+        return DS_ERROR;
+    if (re)
+        *re = vec->data[index];
+    vec->data[index] = vec->data[--vec->size];
+    return DS_OK;
+}
+
+ds_stat
+Vector_GetData(p_vec vec, size_t index, vec_data_t* re)
+{
+    if (!vec || !re || index >= vec->size)
+        return DS_ERROR;
+    *re = vec->data[index];
+    return DS_OK;
+}
+
+ds_stat
+Vector_GetBackData(p_vec vec, vec_data_t* re)
+{
+    if (Vector_Empty(vec) == DS_TRUE || !re)
+        return DS_ERROR;
+    *re = vec->data[vec->size - 1];
+    return DS_OK;
+}
+
+ds_stat
+Vector_Replace(p_vec vec, size_t index, vec_data_t data)
+{
+    if (!vec || index >= vec->size)
+        return DS_ERROR;
+    vec->data[index] = data;
+    return DS_OK;
+}
+
+/* @fn
+ * Find the first element "cmp" reports equal to "data".
+ */
+ds_stat
+Vector_Index(p_vec vec, vec_data_t data, size_t* index, vec_comp_func cmp)
+{
+    size_t   i;
+
+    if (!vec || !cmp)
+        return DS_ERROR;
+    for (i = 0; i < vec->size; i++)
+        if (cmp(data, vec->data[i]) == 0) {
+            if (index)
+                *index = i;
+            return DS_OK;
+        }
+    return DS_ERROR;
+}
+
+ds_bool
+Vector_Contain(p_vec vec, vec_data_t data, vec_comp_func cmp)
+{
+    if (Vector_Index(vec, data, NULL, cmp) == DS_OK)
+        return DS_TRUE;
+    return DS_FALSE;
+}
+
+/* @fn
+ * Find the index of the minimum element, the first one if
+ * several compare equal.
+ */
+ds_stat
+Vector_Min(p_vec vec, vec_comp_func cmp, size_t* index)
+{
+    size_t   i, min;
+
+    if (Vector_Empty(vec) == DS_TRUE || !cmp || !index)
+        return DS_ERROR;
+    for (i = 1, min = 0; i < vec->size; i++)
+        if (cmp(vec->data[i], vec->data[min]) < 0)
+            min = i;
+    *index = min;
+    return DS_OK;
+}
+
+void
+Vector_Map(p_vec vec, vec_map_func map, void* vp)
+{
+    size_t   i;
+
+    if (!vec)
+        return;
+    assert(map);
+    for (i = 0; i < vec->size; i++)
+        map(&vec->data[i], vp);
+}
+
+/* @fn
+ * Copy the elements, not the data they point to.
+ */
+p_vec
+Vector_Copy(p_vec vec)
+{
+    p_vec   cpy = NULL;
+
+    if (!vec || Vector_Init(&cpy) == DS_ERROR)
+        return NULL;
+    if (Vector_Reserve(cpy, vec->size) == DS_ERROR) {
+        Vector_Destroy(&cpy, NULL);
+        return NULL;
+    }
+    if (vec->size)
+        memcpy(cpy->data, vec->data, vec->size * sizeof(vec_data_t));
+    cpy->size = vec->size;
+    return cpy;
+}
+
+/* @fn
+ * Remove all elements, passing each to "op" unless it is
+ * NULL. The capacity is kept.
+ */
+void
+Vector_Clear(p_vec vec, vec_clear_op op)
+{
+    size_t   i;
+
+    if (!vec)
+        return;
+    if (op)
+        for (i = 0; i < vec->size; i++)
+            op(&vec->data[i]);
+    vec->size = 0;
+}
+
+/* @fn
+ * Clear a vector, and destroy itself.
+ */
+void
+Vector_Destroy(p_vec* vec, vec_clear_op op)
+{
+    if (!vec || !*vec)
+        return;
+    Vector_Clear(*vec, op);
+    free((*vec)->data);
+    free(*vec);
+    *vec = NULL;
+}
@@ -0,0 +1,74 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* @file vector.h
+ *
+ * Growable array of pointers.
+ *
+ * Elements have the same semantics as in a single linked
+ * list: the vector stores them, and frees them only through
+ * a clear operation given by the caller. Indexing is O(1)
+ * and appending is amortized O(1); Vector_SwapRemove()
+ * deletes in O(1) when the order of elements does not
+ * matter. Vector_Data() exposes the elements for plain
+ * loops:
+ *
+ *     vec_data_t*  it = Vector_Data(vec);
+ *     for (i = 0; i < Vector_Size(vec); i++)
+ *         use(it[i]);
+ *
+ * The pointer is valid until the vector next grows.
+ */
+
+#ifndef GQRM_VECTOR_H
+#define GQRM_VECTOR_H
+
+#include <stdlib.h>
+
+#include "header.h"
+
+struct Vector;
+
+typedef struct Vector*    p_vec;
+typedef void*             vec_data_t;
+typedef int (*vec_comp_func)(vec_data_t, vec_data_t);
+typedef void (*vec_map_func)(vec_data_t*, void*);
+typedef void (*vec_clear_op)(vec_data_t*);
+
+extern ds_stat     Vector_Init(p_vec*);
+extern ds_stat     Vector_Reserve(p_vec, size_t);
+extern size_t      Vector_Size(p_vec);
+extern ds_bool     Vector_Empty(p_vec);
+extern vec_data_t* Vector_Data(p_vec);
+extern ds_stat     Vector_PushBack(p_vec, vec_data_t);
+extern ds_stat     Vector_PopBack(p_vec, vec_data_t*);
+extern ds_stat     Vector_Insert(p_vec, size_t, vec_data_t);
+extern ds_stat     Vector_Delete(p_vec, size_t, vec_data_t*);
+extern ds_stat     Vector_SwapRemove(p_vec, size_t, vec_data_t*);
+extern ds_stat     Vector_GetData(p_vec, size_t, vec_data_t*);
+extern ds_stat     Vector_GetBackData(p_vec, vec_data_t*);
+extern ds_stat     Vector_Replace(p_vec, size_t, vec_data_t);
+extern ds_stat     Vector_Index(p_vec, vec_data_t, size_t*, vec_comp_func);
+extern ds_bool     Vector_Contain(p_vec, vec_data_t, vec_comp_func);
+extern ds_stat     Vector_Min(p_vec, vec_comp_func, size_t*);
+extern void        Vector_Map(p_vec, vec_map_func, void*);
+extern p_vec       Vector_Copy(p_vec);
+extern void        Vector_Clear(p_vec, vec_clear_op);
+extern void        Vector_Destroy(p_vec*, vec_clear_op);
+#endif
@@ -3,14 +3,21 @@
 #include <time.h>
 
 #include "../src/avl_tree.h"
+#include "walk_check.h"
 
 int cmp(avlt_data_t, avlt_data_t);
 void print(avlt_data_t, size_t);
+size_t check_walks(size_t);
+void collect(avlt_data_t, size_t);
+size_t check_order_stats(size_t);
+
+int*     collected;
+size_t   n_collected;
 
 int main(int argc, char* argv[]) 
 {
     int           array[1000];
-	size_t        size, i;
+	size_t        size, i, fails;
 	pt_AVLTree    avl, cpy;
 	int           input;
 	srand((unsigned)time(0));
@@ -27,7 +34,7 @@ int main(int argc, char* argv[])
 	    array[i] = rand() % 1000;
 	
     printf("random over\n");
-	for (i = 0; i < size; i++) {
+	for (i = 0; i < size && i < 1000; i++) {
 	    printf("Insert %d\n", array[i]);
 	    AVLTree_Insert(avl, &array[i]);
 	}
@@ -46,8 +53,14 @@ int main(int argc, char* argv[])
 	AVLTree_InOrderMap(cpy, print);
 */
 
+	fails = check_order_stats(size);
+	printf("order statistics: %ld fails\n", fails);
+	fails += check_walks(size);
+	printf("walks and bulk build: %ld fails\n", fails);
+
 	printf("delete: ");
-	scanf("%d", &input);
+	if (scanf("%d", &input) != 1)
+	    return fails ? -1 : 0;
 
 	if (AVLTree_Delete(cpy, &input) == DS_ERROR)
 	    printf("fail to delete\n");
@@ -56,7 +69,98 @@ int main(int argc, char* argv[])
 	    AVLTree_InOrderMap(cpy, print);
 	}
 
-	return 0;
+	return fails ? -1 : 0;
+}
+
+/* 
+ * Insert the even keys below 2 * "size" in random order,
+ * delete a random part of them, and check select, rank,
+ * iteration, range count and range map against a membership
+ * table.
+ */
+size_t check_order_stats(size_t size)
+{
+    int*          keys;
+	char*         in;
+	size_t        i, j, k, n = 0, lo, hi, expect, fails = 0;
+	avlt_data_t   d;
+	avlt_iter     it;
+	pt_AVLTree    avl;
+
+	if ((keys = malloc((2 * size + 1) * sizeof(int))) == NULL ||
+	    (in = calloc(2 * size + 1, 1)) == NULL ||
+	    (collected = malloc((size + 1) * sizeof(int))) == NULL)
+	    exit(-1);
+	for (i = 0; i < 2 * size; i++)
+	    keys[i] = (int)i;
+	avl = AVLTree_Create(cmp);
+	for (i = 0; i < size; i++) {
+	    j = 2 * (rand() % size);
+		if (!in[j] && AVLTree_Insert(avl, &keys[j]) == DS_OK)
+		    in[j] = 1;
+	}
+	for (i = 0; i < size / 3; i++) {
+	    j = 2 * (rand() % size);
+		if (in[j] && AVLTree_Delete(avl, &keys[j]) == DS_OK)
+		    in[j] = 0;
+	}
+
+	/* rank of every key, present or not, and select back */
+	for (i = 0; i < 2 * size; i++) {
+	    if (AVLTree_Rank(avl, &keys[i]) != n)
+		    fails++;
+		if (in[i] && (AVLTree_Select(avl, n, &d) == DS_ERROR || *(int*)d != (int)i))
+		    fails++;
+		n += in[i];
+	}
+	if (n != AVLTree_Size(avl) || AVLTree_Select(avl, n, &d) != DS_ERROR)
+	    fails++;
+
+	/* ordered iteration, from the start and from a key */
+	AVLTree_Begin(avl, &it);
+	for (i = 0; i < 2 * size; i++)
+	    if (in[i] && (AVLTree_Next(&it, &d) == DS_FALSE || *(int*)d != (int)i))
+		    fails++;
+	if (AVLTree_Next(&it, &d) != DS_FALSE)
+	    fails++;
+	if (size) {
+	    j = rand() % (2 * size);
+		AVLTree_Seek(avl, &keys[j], &it);
+		for (i = j; i < 2 * size && !in[i]; i++)
+		    ;
+		if (i < 2 * size ? AVLTree_Next(&it, &d) == DS_FALSE || *(int*)d != (int)i :
+		    AVLTree_Next(&it, &d) != DS_FALSE)
+		    fails++;
+	}
+
+	/* random ranges */
+	for (k = 0; size && k < 100; k++) {
+	    lo = rand() % (2 * size);
+		hi = lo + rand() % (2 * size - lo);
+		for (expect = 0, i = lo; i <= hi; i++)
+		    expect += in[i];
+		if (AVLTree_RangeCount(avl, &keys[lo], &keys[hi]) != expect)
+		    fails++;
+		n_collected = 0;
+		AVLTree_RangeMap(avl, &keys[lo], &keys[hi], collect);
+		if (n_collected != expect)
+		    fails++;
+		for (i = 0; i < n_collected; i++)
+		    if (collected[i] < (int)lo || collected[i] > (int)hi || !in[collected[i]] ||
+			    (i && collected[i] <= collected[i - 1]))
+			    fails++;
+	}
+
+	AVLTree_Free(&avl);
+	free(keys);
+	free(in);
+	free(collected);
+	return fails;
+}
+
+void collect(avlt_data_t d, size_t depth)
+{
+    collected[n_collected++] = *(int*)d;
 }
 
 int cmp(avlt_data_t d1, avlt_data_t d2)
@@ -75,3 +179,41 @@ void print(avlt_data_t d, size_t depth)
 	    printf("  ");
 	printf("%3d\n", *pi);
 }
+
+/* 
+ * Build "size" sorted keys in bulk and compare the three
+ * walks, data and depth, against the median-split shape
+ * the bulk build produces.
+ */
+size_t check_walks(size_t size)
+{
+    int*         keys;
+	void**       sorted;
+	size_t       i, order, fails = 0;
+	pt_AVLTree   tree;
+
+	if ((keys = malloc((size + 1) * sizeof(int))) == NULL ||
+	    (sorted = malloc((size + 1) * sizeof(void*))) == NULL)
+	    exit(-1);
+	for (i = 0; i < size; i++) {
+	    keys[i] = (int)i;
+		sorted[i] = &keys[i];
+	}
+	tree = AVLTree_Create(cmp);
+	if (AVLTree_BuildFromSorted(tree, sorted, size) == DS_ERROR || AVLTree_Size(tree) != size)
+	    fails++;
+	for (order = 0; order < 3; order++) {
+	    walk_median(size, (int)order);
+		if (order == WALK_PRE)
+		    AVLTree_PreOrderMap(tree, walk_record);
+		else if (order == WALK_IN)
+		    AVLTree_InOrderMap(tree, walk_record);
+		else
+		    AVLTree_PostOrderMap(tree, walk_record);
+		fails += walk_compare();
+	}
+	AVLTree_Free(&tree);
+	free(keys);
+	free(sorted);
+	return fails;
+}
@@ -0,0 +1,225 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/shortest_path_tree.h"
+#include "../src/neighbor.h"
+#include "../src/thread_pool.h"
+#include "../src/bfs.h"
+
+/* @struct
+ * Input of search_task(): every worker searches "pg" from
+ * its share of "srcs" in its own workspace.
+ */
+typedef struct {
+    pt_ALGraph          pg;
+    size_t              size;
+    pt_SPTWorkspace*    ws;
+    vertex_weight_t*    hops;
+    size_t              failed;
+} search_arg;
+
+static void   search_task(size_t, size_t, size_t, void*);
+static size_t check_workspaces(pt_ALGraph, pt_BFSGraph, size_t);
+
+/* 
+ * Compare BFS_Run() against ALGraph_ShortestPathTree() on a
+ * random graph, and check that parents do not depend on the
+ * number of threads. Set the environment variable
+ * GQRM_BFS_DIRECTION to test a particular direction.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node            nd;
+    pt_ALGraph         pg, spt, tree;
+    pt_BFSGraph        g;
+    pt_ThreadPool      pool;
+    pt_Vertex          pv, pp;
+    p_sll              nodes = NULL;
+    size_t             size, i, t, n_dsts, mismatch = 0;
+    size_t             threads[3] = {1, 2, 4};
+    gqrm_id_t          dsts[10], parent;
+    vertex_weight_t    w, wp;
+    vertex_weight_t*   hops;
+    gqrm_id_t*         parents;
+    gqrm_id_t*         ref;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 10.0, 10)) == NULL)
+            exit(-1);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    pg = ALGraph_Create();
+    if (Neighbor_InitGraph(pg, nodes, NULL) == DS_ERROR)
+        exit(-1);
+    /* the last vertices, never the source itself */
+    n_dsts = size > 10 ? 10 : (size > 0 ? size - 1 : 0);
+    for (i = 0; i < n_dsts; i++)
+        dsts[i] = (gqrm_id_t)(size - 1 - i);
+
+    if ((spt = ALGraph_ShortestPathTree(pg, 0, dsts, n_dsts)) == NULL)
+        exit(-1);
+    if ((g = BFSGraph_Create(pg)) == NULL)
+        exit(-1);
+    hops    = malloc(size * sizeof(vertex_weight_t));
+    parents = malloc(size * sizeof(gqrm_id_t));
+    ref     = malloc(size * sizeof(gqrm_id_t));
+
+    for (t = 0; t < 3; t++) {
+        pool = ThreadPool_Create(threads[t]);
+        if (BFS_Run(g, 0, pool, hops, parents) == DS_ERROR)
+            exit(-1);
+        for (i = 0; i < size; i++) {
+            ALGraph_GetVertex(spt, i, &pv);
+            Vertex_GetWeight(pv, &w);
+            if (w != hops[i])
+                mismatch++;
+            if (t == 0)
+                ref[i] = parents[i];
+            else if (ref[i] != parents[i])
+                mismatch++;
+        }
+        printf("%ld threads, mismatches %ld\n", ThreadPool_Size(pool), mismatch);
+        ThreadPool_Free(&pool);
+    }
+
+    /* every kept vertex of the tree hangs one hop below its parent */
+    if ((tree = ALGraph_BFSTree(pg, 0, dsts, n_dsts, NULL)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(tree, i, &pv);
+        Vertex_GetParent(pv, &parent);
+        if (parent == -1)
+            continue;
+        ALGraph_GetVertexByID(tree, parent, &pp);
+        Vertex_GetWeight(pv, &w);
+        Vertex_GetWeight(pp, &wp);
+        if (w != wp + 1 || Vertex_IsNeighbor(pp, pv) == DS_FALSE)
+            mismatch++;
+    }
+    printf("tree mismatches %ld\n", mismatch);
+    mismatch += check_workspaces(pg, g, size);
+    printf("workspace mismatches %ld\n", mismatch);
+
+    free(hops);
+    free(parents);
+    free(ref);
+    BFSGraph_Free(&g);
+    ALGraph_Free(&tree);
+    ALGraph_Free(&spt);
+    ALGraph_Free(&pg);
+    return mismatch ? -1 : 0;
+}
+
+/* 
+ * Search "pg" from several sources at once with
+ * ALGraph_ShortestPaths(), one workspace per worker, and
+ * compare the hop counts with BFS_Run(); parents must be one
+ * hop closer. Return the number of mismatches.
+ */
+static size_t
+check_workspaces(pt_ALGraph pg, pt_BFSGraph g, size_t size)
+{
+    search_arg               arg;
+    pt_ThreadPool            pool;
+    vertex_weight_t*         hops;
+    gqrm_id_t*               parents;
+    const vertex_weight_t*   w;
+    const gqrm_id_t*         p;
+    size_t                   n = size < 16 ? size : 16, i, k, mismatch = 0;
+
+    if ((pool = ThreadPool_Create(4)) == NULL)
+        exit(-1);
+    arg.pg     = pg;
+    arg.size   = size;
+    arg.failed = 0;
+    arg.ws     = malloc(ThreadPool_Size(pool) * sizeof(pt_SPTWorkspace));
+    arg.hops   = malloc((n * size + 1) * sizeof(vertex_weight_t));
+    hops       = malloc(size * sizeof(vertex_weight_t));
+    parents    = malloc(size * sizeof(gqrm_id_t));
+    if (!arg.ws || !arg.hops || !hops || !parents)
+        exit(-1);
+    for (i = 0; i < ThreadPool_Size(pool); i++)
+        if ((arg.ws[i] = SPTWorkspace_Create()) == NULL)
+            exit(-1);
+
+    ThreadPool_ParallelFor(pool, n, 1, search_task, &arg);
+    mismatch += arg.failed;
+    for (k = 0; k < n; k++) {
+        if (BFS_Run(g, k * size / n, NULL, hops, parents) == DS_ERROR)
+            exit(-1);
+        for (i = 0; i < size; i++)
+            if (arg.hops[k * size + i] != hops[i])
+                mismatch++;
+    }
+
+    /* a workspace reused for the last source holds its tree */
+    if (n && ALGraph_ShortestPaths(pg, (n - 1) * size / n, arg.ws[0]) == DS_OK) {
+        w = SPTWorkspace_Weights(arg.ws[0]);
+        p = SPTWorkspace_Parents(arg.ws[0]);
+        for (i = 0; i < size; i++)
+            if (p[i] >= 0 ? w[p[i]] + 1 != w[i]
+                          : w[i] != 0 && w[i] != VERTEX_WEIGHT_INF)
+                mismatch++;
+    }
+
+    for (i = 0; i < ThreadPool_Size(pool); i++)
+        SPTWorkspace_Free(&arg.ws[i]);
+    ThreadPool_Free(&pool);
+    free(arg.ws);
+    free(arg.hops);
+    free(hops);
+    free(parents);
+    return mismatch;
+}
+
+/* 
+ * Search from sources [begin, end), the "k"th of which is
+ * vertex k * size / n, n being the number of sources.
+ */
+static void
+search_task(size_t begin, size_t end, size_t worker, void* p)
+{
+    search_arg*   arg = (search_arg*)p;
+    size_t        n = arg->size < 16 ? arg->size : 16, k, i;
+
+    for (k = begin; k < end; k++) {
+        if (ALGraph_ShortestPaths(arg->pg, k * arg->size / n, arg->ws[worker]) == DS_ERROR) {
+            arg->failed++;
+            continue;
+        }
+        for (i = 0; i < arg->size; i++)
+            arg->hops[k * arg->size + i] = SPTWorkspace_Weights(arg->ws[worker])[i];
+    }
+}
@@ -3,14 +3,17 @@
 #include <time.h>
 
 #include "../src/binary_search_tree.h"
+#include "walk_check.h"
 
 int cmp(bst_data_t, bst_data_t);
 void print(bst_data_t, size_t);
+size_t check_walks(size_t);
+size_t check_degenerate(size_t);
 
 int main(int argc, char* argv[]) 
 {
     int           array[1000];
-	size_t        size, i;
+	size_t        size, i, fails;
 	pt_BSTree     bst;
 	int           input;
 	srand((unsigned)time(0));
@@ -23,19 +26,23 @@ int main(int argc, char* argv[])
 	bst = BSTree_Create(cmp);
 
     printf("creat over\n");
-	for (i = 0; i < size; i++)
+	for (i = 0; i < size && i < 1000; i++)
 	    array[i] = rand() % 1000;
 	
     printf("random over\n");
-	for (i = 0; i < size; i++) 
+	for (i = 0; i < size && i < 1000; i++) 
 	    BSTree_Insert(bst, &array[i]);
 	
     printf("insert over, size %ld\n", BSTree_Size(bst));
 	BSTree_InOrderMap(bst, print);
     printf("print over\n");
 
+	fails = check_degenerate(size) + check_walks(size);
+	printf("walks and bulk build: %ld fails\n", fails);
+
 	printf("delete: ");
-	scanf("%d", &input);
+	if (scanf("%d", &input) != 1)
+	    return fails ? -1 : 0;
 
 	if (BSTree_Delete(bst, &input) == DS_ERROR)
 	    printf("fail to delete\n");
@@ -44,7 +51,40 @@ int main(int argc, char* argv[])
 	    BSTree_InOrderMap(bst, print);
 	}
 
-	return 0;
+	return fails ? -1 : 0;
+}
+
+/* 
+ * Insert "size" sorted keys one by one, which makes the tree
+ * a list "size" deep, and walk it: every walk must get to
+ * the bottom, where recursion would overflow the stack.
+ */
+size_t check_degenerate(size_t size)
+{
+    int*        keys;
+	size_t      i, fails = 0;
+	pt_BSTree   tree;
+
+	if ((keys = malloc((size + 1) * sizeof(int))) == NULL)
+	    exit(-1);
+	tree = BSTree_Create(cmp);
+	for (i = 0; i < size; i++) {
+	    keys[i] = (int)i;
+		BSTree_Insert(tree, &keys[i]);
+	}
+	walk_begin(size);
+	for (i = 0; i < size; i++)
+	    walk_want(i, i);
+	BSTree_InOrderMap(tree, walk_record);
+	fails += walk_compare();
+	walk_begin(size);
+	for (i = size; i-- > 0; )
+	    walk_want(i, i);
+	BSTree_PostOrderMap(tree, walk_record);
+	fails += walk_compare();
+	BSTree_Free(&tree);
+	free(keys);
+	return fails;
 }
 
 int cmp(bst_data_t d1, bst_data_t d2)
@@ -63,3 +103,41 @@ void print(bst_data_t d, size_t depth)
 	    printf("  ");
 	printf("%3d\n", *pi);
 }
+
+/* 
+ * Build "size" sorted keys in bulk and compare the three
+ * walks, data and depth, against the median-split shape
+ * the bulk build produces.
+ */
+size_t check_walks(size_t size)
+{
+    int*         keys;
+	void**       sorted;
+	size_t       i, order, fails = 0;
+	pt_BSTree    tree;
+
+	if ((keys = malloc((size + 1) * sizeof(int))) == NULL ||
+	    (sorted = malloc((size + 1) * sizeof(void*))) == NULL)
+	    exit(-1);
+	for (i = 0; i < size; i++) {
+	    keys[i] = (int)i;
+		sorted[i] = &keys[i];
+	}
+	tree = BSTree_Create(cmp);
+	if (BSTree_BuildFromSorted(tree, (bst_data_t*)sorted, size) == DS_ERROR || BSTree_Size(tree) != size)
+	    fails++;
+	for (order = 0; order < 3; order++) {
+	    walk_median(size, (int)order);
+		if (order == WALK_PRE)
+		    BSTree_PreOrderMap(tree, walk_record);
+		else if (order == WALK_IN)
+		    BSTree_InOrderMap(tree, walk_record);
+		else
+		    BSTree_PostOrderMap(tree, walk_record);
+		fails += walk_compare();
+	}
+	BSTree_Free(&tree);
+	free(keys);
+	free(sorted);
+	return fails;
+}
@@ -0,0 +1,202 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/bplus_tree.h"
+
+static size_t  check_tree(pt_BPTree, char*, size_t);
+static void    record(gqrm_id_t, bpt_data_t);
+
+static gqrm_id_t  last;
+static size_t     visited, order_fails;
+
+/* 
+ * Insert ids 0 .. "size" - 1 in random order into a B+ tree
+ * mapping each id to itself, delete a random half, then the
+ * rest, checking lookups, ranges and iteration against a
+ * membership table after every phase.
+ */
+int main(int argc, char* argv[])
+{
+    pt_BPTree    tree;
+    gqrm_id_t*   ids;
+    char*        in;
+    bpt_data_t   data;
+    size_t       size, i, j, fails = 0;
+    gqrm_id_t    t;
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    if ((ids = malloc((size + 1) * sizeof(gqrm_id_t))) == NULL ||
+        (in = calloc(size + 1, sizeof(char))) == NULL ||
+        (tree = BPTree_Create()) == NULL)
+        exit(-1);
+
+    srand(7);
+    for (i = 0; i < size; i++)
+        ids[i] = (gqrm_id_t)i;
+    for (i = size; i > 1; i--) {
+        j = rand() % i;
+        t = ids[i - 1];
+        ids[i - 1] = ids[j];
+        ids[j] = t;
+    }
+
+    fails += check_tree(tree, in, size);
+    for (i = 0; i < size; i++) {
+        if (BPTree_Insert(tree, ids[i], (bpt_data_t)ids[i]) == DS_ERROR)
+            fails++;
+        in[ids[i]] = 1;
+    }
+    if (size && BPTree_Insert(tree, ids[0], NULL) == DS_OK)
+        fails++;
+    fails += check_tree(tree, in, size);
+
+    /* the first half of the shuffled ids is a random half */
+    for (i = 0; i < size / 2; i++) {
+        if (BPTree_Delete(tree, ids[i], &data) == DS_ERROR ||
+            data != (bpt_data_t)ids[i])
+            fails++;
+        in[ids[i]] = 0;
+    }
+    if (size / 2 && BPTree_Delete(tree, ids[0], NULL) == DS_OK)
+        fails++;
+    fails += check_tree(tree, in, size);
+
+    /* put some back so deletes and inserts interleave */
+    for (i = 0; i < size / 4; i++) {
+        if (BPTree_Insert(tree, ids[i], (bpt_data_t)ids[i]) == DS_ERROR)
+            fails++;
+        in[ids[i]] = 1;
+    }
+    fails += check_tree(tree, in, size);
+
+    for (i = 0; i < size; i++) {
+        if (in[ids[i]] && BPTree_Delete(tree, ids[i], NULL) == DS_ERROR)
+            fails++;
+        in[ids[i]] = 0;
+    }
+    fails += check_tree(tree, in, size);
+
+    for (i = 0; i < size; i++)
+        BPTree_Insert(tree, ids[i], (bpt_data_t)ids[i]);
+    BPTree_Clear(tree);
+    if (BPTree_Size(tree) != 0 || BPTree_Height(tree) != 0 ||
+        (size && BPTree_Contain(tree, ids[0])))
+        fails++;
+    fails += check_tree(tree, in, size);
+
+    printf("%lu fails\n", (unsigned long)fails);
+    BPTree_Free(&tree);
+    free(ids);
+    free(in);
+    return fails ? -1 : 0;
+}
+
+/* @fn
+ * Compare "tree" with membership table "in" over ids
+ * 0 .. "size" - 1: size, lookups, iteration order, range
+ * counts and maps, and that the height stays within what a
+ * B+ tree of that size allows. Return the number of fails.
+ */
+static size_t
+check_tree(pt_BPTree tree, char* in, size_t size)
+{
+    bpt_iter     it;
+    bpt_data_t   data;
+    gqrm_id_t    id, lo, hi;
+    size_t       n = 0, cnt, i, fails = 0, leaves, height;
+
+    for (i = 0; i < size; i++) {
+        n += in[i];
+        if (BPTree_Contain(tree, (gqrm_id_t)i) != (in[i] ? DS_TRUE : DS_FALSE))
+            fails++;
+        if (in[i] && (BPTree_Find(tree, (gqrm_id_t)i, &data) == DS_ERROR ||
+                      data != (bpt_data_t)i))
+            fails++;
+    }
+    if (BPTree_Size(tree) != n)
+        fails++;
+
+    /* every node but the root is at least half full */
+    height = 0;
+    if (n) {
+        height = 1;
+        for (leaves = (n + BPT_KEYS - 1) / BPT_KEYS; leaves > 1; height++)
+            leaves = (leaves + BPT_KEYS) / (BPT_KEYS + 1);
+        if (BPTree_Height(tree) < height)
+            fails++;
+        for (height = 1, leaves = n / (BPT_KEYS / 2); leaves > 1; height++)
+            leaves /= BPT_KEYS / 2 + 1;
+        if (BPTree_Height(tree) > height + 1)
+            fails++;
+    } else if (BPTree_Height(tree) != 0)
+        fails++;
+
+    cnt = 0;
+    last = -1;
+    BPTree_Begin(tree, &it);
+    while (BPTree_Next(&it, &id, &data) == DS_TRUE) {
+        if (id <= last || id < 0 || (size_t)id >= size || !in[id] ||
+            data != (bpt_data_t)id)
+            fails++;
+        last = id;
+        cnt++;
+    }
+    if (cnt != n)
+        fails++;
+
+    for (i = 0; i < 16; i++) {
+        lo = size ? rand() % size : 0;
+        hi = lo + (size ? rand() % (size / 4 + 1) : 0);
+        for (cnt = 0, id = lo; id <= hi; id++)
+            if ((size_t)id < size && in[id])
+                cnt++;
+        if (BPTree_RangeCount(tree, lo, hi) != cnt)
+            fails++;
+        last = lo - 1;
+        visited = order_fails = 0;
+        BPTree_RangeMap(tree, lo, hi, record);
+        if (visited != cnt || order_fails)
+            fails++;
+        BPTree_Seek(tree, lo, &it);
+        for (id = lo; (size_t)id < size && !in[id]; id++) ;
+        if ((size_t)id < size) {
+            if (BPTree_Next(&it, &last, NULL) == DS_FALSE || last != id)
+                fails++;
+        } else if (BPTree_Next(&it, NULL, NULL) == DS_TRUE)
+            fails++;
+    }
+    if (BPTree_RangeCount(tree, 1, 0) != 0)
+        fails++;
+    return fails;
+}
+
+static void
+record(gqrm_id_t id, bpt_data_t data)
+{
+    if (id <= last || data != (bpt_data_t)id)
+        order_fails++;
+    last = id;
+    visited++;
+}
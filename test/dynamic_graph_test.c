@@ -0,0 +1,191 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "../src/header.h"
+#include "../src/metrics.h"
+#include "../src/coordinate.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/rnp_misc.h"
+#include "../src/neighbor.h"
+#include "../src/dynamic_graph.h"
+
+static pt_Node random_node(gqrm_id_t, double);
+static size_t  check(pt_ALGraph, pt_SpatialGrid);
+static double  elapsed(clock_t);
+
+/* 
+ * Grow a graph node by node, remove some nodes and flip the
+ * selection of others through a SpatialGrid, comparing the
+ * graph after each step with what check_neighbor() gives
+ * over every pair of nodes left.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node          nd;
+    pt_ALGraph       pg;
+    pt_SpatialGrid   g;
+    p_sll            nodes = NULL;
+    pt_Vertex        pv;
+    graph_data_t     data;
+    size_t           size, half, i, mismatch = 0;
+    double           side;
+    gqrm_id_t        id;
+    ds_bool          flip;
+    MetricsBlock     before, after;
+    clock_t          start;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    half = size / 2;
+    /* about 25 nodes per 100 x 100, whatever the size */
+    side = 20.0 * sqrt((double)size) + 1.0;
+
+    /* the first half is built in bulk */
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < half; i++) {
+        if ((nd = random_node(i, side)) == NULL)
+            exit(-1);
+        if (i % 5 == 0)
+            Node_SetUnselected(nd);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    pg = ALGraph_Create();
+    if (Neighbor_InitGraph(pg, nodes, NULL) == DS_ERROR)
+        exit(-1);
+    if ((g = SpatialGrid_Create(pg)) == NULL)
+        exit(-1);
+    printf("cell size %lf\n", SpatialGrid_CellSize(g));
+    mismatch += check(pg, g);
+
+    /* the second half node by node */
+    Metrics_Snapshot(&before);
+    start = clock();
+    for (i = half; i < size; i++) {
+        if ((nd = random_node(i, side)) == NULL)
+            exit(-1);
+        if (ALGraph_InsertNode(pg, g, nd, &id) == DS_ERROR || (size_t)id != i)
+            mismatch++;
+    }
+    Metrics_Snapshot(&after);
+    printf("%ld insertions: %lf s, %lu pair tests\n", size - half, elapsed(start),
+           (unsigned long)(after.counters[METRIC_PAIR_TESTS] -
+                           before.counters[METRIC_PAIR_TESTS]));
+    mismatch += check(pg, g);
+
+    /* remove every 7th node, flip every 3rd */
+    for (i = 0; i < size; i += 7)
+        if (ALGraph_RemoveNode(pg, g, i) == DS_ERROR)
+            mismatch++;
+    if (size && ALGraph_RemoveNode(pg, g, 0) == DS_OK)
+        mismatch++;
+    mismatch += check(pg, g);
+    for (i = 0; i < size; i += 3) {
+        ALGraph_GetVertex(pg, i, &pv);
+        Vertex_GetData(pv, &data);
+        flip = Node_IsSelected((pt_Node)data) == DS_TRUE ? DS_FALSE : DS_TRUE;
+        /* only the nodes left can be flipped */
+        if ((ALGraph_SetNodeSelected(pg, g, i, flip) == DS_OK) != SpatialGrid_Contain(g, i))
+            mismatch++;
+    }
+    mismatch += check(pg, g);
+    printf("nodes %ld, mismatches %ld\n", SpatialGrid_Size(g), mismatch);
+
+    for (i = 0; i < ALGraph_Size(pg); i++) {
+        ALGraph_GetVertex(pg, i, &pv);
+        Vertex_GetData(pv, &data);
+        nd = (pt_Node)data;
+        Node_Free(&nd);
+    }
+    SpatialGrid_Free(&g);
+    ALGraph_Free(&pg);
+    SingleLinkedList_Destroy(&nodes, NULL);
+    return mismatch ? 1 : 0;
+}
+
+/*
+ * A CDL at random in a "side" x "side" field.
+ */
+static pt_Node
+random_node(gqrm_id_t i, double side)
+{
+    pt_Node         nd;
+    pt_Coordinate   co;
+    double          x;
+
+    if ((nd = Node_CreateRandomCDL(i, 5.0 + rand() % 10, 10)) == NULL)
+        return NULL;
+    x = side * rand() / RAND_MAX;
+    if ((co = Coordinate_Create2D(x, side * rand() / RAND_MAX)) == NULL ||
+        Node_SetCoordinate(nd, co) == DS_ERROR) {
+        Node_Free(&nd);
+        return NULL;
+    }
+    return nd;
+}
+
+/*
+ * The number of pairs of vertices whose edge is not what a
+ * full rebuild would give. Removed nodes have no edges.
+ */
+static size_t
+check(pt_ALGraph pg, pt_SpatialGrid g)
+{
+    pt_Vertex       pv, pu;
+    graph_data_t    dv, du;
+    edge_weight_t   w1, w2;
+    size_t          n = ALGraph_Size(pg), i, j, mismatch = 0;
+
+    for (i = 0; i < n; i++) {
+        ALGraph_GetVertex(pg, i, &pv);
+        Vertex_GetData(pv, &dv);
+        if (SpatialGrid_Contain(g, i) == DS_FALSE) {
+            mismatch += Vertex_Degree(pv) != 0;
+            continue;
+        }
+        for (j = 0; j < n; j++) {
+            if (i == j)
+                continue;
+            ALGraph_GetVertex(pg, j, &pu);
+            Vertex_GetData(pu, &du);
+            w1 = SpatialGrid_Contain(g, j) == DS_TRUE ? check_neighbor(dv, du) : -1.0;
+            if (Vertex_GetEdgeWeight(pv, j, &w2) == DS_ERROR)
+                w2 = -1.0;
+            if ((w1 > 0.0) != (w2 > 0.0) || (w1 > 0.0 && w1 != w2))
+                mismatch++;
+        }
+    }
+    return mismatch;
+}
+
+static double
+elapsed(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,283 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "../src/header.h"
+#include "../src/coordinate.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/neighbor.h"
+#include "../src/bfs.h"
+#include "../src/dynamic_spt.h"
+
+#define MAX_DEAD    64
+
+static size_t check(pt_ALGraph, pt_DynamicSPT, gqrm_id_t, const char*,
+                    gqrm_id_t (*)[2], size_t, vertex_weight_t*, const char*,
+                    const gqrm_hop_t*);
+static double elapsed(clock_t);
+
+/* 
+ * Take random vertices and edges out of a random graph and
+ * put them back through a DynamicSPT, comparing after every
+ * update its hop counts, parents, changed destinations and
+ * feasibility with a BFS over the graph left.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node          nd;
+    pt_Coordinate    co;
+    pt_ALGraph       pg;
+    pt_DynamicSPT    t;
+    pt_Vertex        pv;
+    pt_Edge          pe;
+    p_vec            edges;
+    p_sll            nodes = NULL;
+    size_t           size, i, k, n_dead = 0, steps, mismatch = 0;
+    double           side, px;
+    char*            removed;
+    char*            is_dst;
+    gqrm_hop_t*      bounds;
+    gqrm_hop_t*      dst_bounds;
+    gqrm_id_t*       dsts;
+    gqrm_id_t        dead[MAX_DEAD][2], v, end;
+    vertex_weight_t* last;
+    size_t           n_dsts = 0;
+    clock_t          start;
+    double           t_update = 0.0;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    if (size < 2)
+        size = 2;
+    side = 20.0 * sqrt((double)size) + 1.0;
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 10.0, 10)) == NULL)
+            exit(-1);
+        px = side * rand() / RAND_MAX;
+        if ((co = Coordinate_Create2D(px, side * rand() / RAND_MAX)) == NULL ||
+            Node_SetCoordinate(nd, co) == DS_ERROR)
+            exit(-1);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    pg = ALGraph_Create();
+    if (Neighbor_InitGraph(pg, nodes, NULL) == DS_ERROR)
+        exit(-1);
+
+    removed = calloc(size, sizeof(char));
+    is_dst  = calloc(size, sizeof(char));
+    bounds  = malloc(size * sizeof(gqrm_hop_t));
+    dsts    = malloc(size * sizeof(gqrm_id_t));
+    dst_bounds = malloc(size * sizeof(gqrm_hop_t));
+    last    = malloc(size * sizeof(vertex_weight_t));
+    if (!removed || !is_dst || !bounds || !dsts || !dst_bounds || !last)
+        exit(-1);
+    /* a tenth of the vertices are destinations, bounds per vertex */
+    for (i = 0; i < size; i++) {
+        bounds[i] = -1;
+        if (i && rand() % 10 == 0) {
+            is_dst[i]            = 1;
+            bounds[i]            = 2 + rand() % 20;
+            dsts[n_dsts]         = (gqrm_id_t)i;
+            dst_bounds[n_dsts++] = bounds[i];
+        }
+    }
+    if ((t = DynamicSPT_Create(pg, 0, dsts, dst_bounds, n_dsts)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++)
+        DynamicSPT_GetHop(t, (gqrm_id_t)i, &last[i]);
+    mismatch += check(pg, t, 0, removed, dead, n_dead, last, is_dst, bounds);
+
+    steps = 2 * size;
+    for (i = 0; i < steps; i++) {
+        v = rand() % size;
+        start = clock();
+        switch (rand() % 4) {
+        case 0:
+            if (DynamicSPT_RemoveVertex(t, v) != (removed[v] ? DS_ERROR : DS_OK))
+                mismatch++;
+            removed[v] = 1;
+            break;
+        case 1:
+            if (DynamicSPT_InsertVertex(t, v) != (removed[v] ? DS_OK : DS_ERROR))
+                mismatch++;
+            removed[v] = 0;
+            break;
+        case 2:
+            ALGraph_GetVertex(pg, v, &pv);
+            /* no update, nothing to check */
+            if (n_dead == MAX_DEAD || Vertex_Degree(pv) == 0)
+                continue;
+            Vertex_GetEdges(pv, &edges);
+            pe = (pt_Edge)Vector_Data(edges)[rand() % Vertex_Degree(pv)];
+            Edge_GetEndID(pe, &end);
+            for (k = 0; k < n_dead; k++)
+                if (dead[k][0] == v && dead[k][1] == end)
+                    break;
+            if (DynamicSPT_RemoveEdge(t, v, end) != (k < n_dead ? DS_ERROR : DS_OK))
+                mismatch++;
+            if (k == n_dead) {
+                dead[n_dead][0]   = v;
+                dead[n_dead++][1] = end;
+            }
+            break;
+        default:
+            if (n_dead == 0)
+                continue;
+            k = rand() % n_dead;
+            if (DynamicSPT_InsertEdge(t, dead[k][0], dead[k][1]) == DS_ERROR)
+                mismatch++;
+            dead[k][0] = dead[n_dead - 1][0];
+            dead[k][1] = dead[--n_dead][1];
+            break;
+        }
+        t_update += elapsed(start);
+        mismatch += check(pg, t, 0, removed, dead, n_dead, last, is_dst, bounds);
+    }
+    if (DynamicSPT_RemoveEdge(t, 0, 0) == DS_OK)
+        mismatch++;
+    printf("%ld updates: %lf s\n", steps, t_update);
+    printf("destinations %ld, mismatches %ld\n", n_dsts, mismatch);
+
+    DynamicSPT_Free(&t);
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(pg, i, &pv);
+        Vertex_GetData(pv, (graph_data_t*)&nd);
+        Node_Free(&nd);
+    }
+    ALGraph_Free(&pg);
+    SingleLinkedList_Destroy(&nodes, NULL);
+    free(removed);
+    free(is_dst);
+    free(bounds);
+    free(dsts);
+    free(dst_bounds);
+    free(last);
+    return mismatch ? 1 : 0;
+}
+
+/*
+ * Compare "t" with a BFS from "src" over "pg" without the
+ * removed vertices and the "n_dead" edges of "dead", and its
+ * changed destinations with the hop counts in "last", which
+ * are then updated. Return the number of mismatches.
+ */
+static size_t
+check(pt_ALGraph pg, pt_DynamicSPT t, gqrm_id_t src, const char* removed,
+      gqrm_id_t (*dead)[2], size_t n_dead, vertex_weight_t* last,
+      const char* is_dst, const gqrm_hop_t* bounds)
+{
+    pt_ALGraph         ref;
+    pt_BFSGraph        g;
+    pt_Vertex          pv;
+    p_vec              edges;
+    size_t             size = ALGraph_Size(pg), i, j, k, n_changed, mismatch = 0;
+    vertex_weight_t*   hops;
+    gqrm_id_t*         parents;
+    const gqrm_id_t*   changed;
+    gqrm_id_t          end, parent;
+    vertex_weight_t    h, hp;
+    edge_weight_t      w;
+    ds_bool            feasible = DS_TRUE;
+
+    /* the graph left */
+    if ((ref = ALGraph_Copy(pg)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(ref, i, &pv);
+        if (removed[i]) {
+            Vertex_ClearEdge(pv);
+            continue;
+        }
+        Vertex_GetEdges(pv, &edges);
+        for (j = Vertex_Degree(pv); j > 0; j--) {
+            Edge_GetEndID((pt_Edge)Vector_Data(edges)[j - 1], &end);
+            for (k = 0; k < n_dead; k++)
+                if (dead[k][0] == (gqrm_id_t)i && dead[k][1] == end)
+                    break;
+            if (removed[end] || k < n_dead) {
+                Vertex_DeleteEdge(pv, end);
+                Vertex_GetEdges(pv, &edges);
+            }
+        }
+    }
+    g       = BFSGraph_Create(ref);
+    hops    = malloc(size * sizeof(vertex_weight_t));
+    parents = malloc(size * sizeof(gqrm_id_t));
+    if (!g || !hops || !parents || BFS_Run(g, src, NULL, hops, parents) == DS_ERROR)
+        exit(-1);
+    /* a removed source reaches nobody */
+    for (i = 0; i < size; i++)
+        if (removed[src] || removed[i])
+            hops[i] = VERTEX_WEIGHT_INF;
+
+    for (i = 0; i < size; i++) {
+        DynamicSPT_GetHop(t, i, &h);
+        DynamicSPT_GetParent(t, i, &parent);
+        if (h != hops[i])
+            mismatch++;
+        /* any parent one hop closer over an edge left will do */
+        if (h != VERTEX_WEIGHT_INF && (gqrm_id_t)i != src) {
+            if (parent < 0 || ALGraph_GetVertex(ref, parent, &pv) == DS_ERROR ||
+                DynamicSPT_GetHop(t, parent, &hp) == DS_ERROR || hp + 1 != h ||
+                Vertex_GetEdgeWeight(pv, i, &w) == DS_ERROR)
+                mismatch++;
+        }
+        if (is_dst[i] && (h == VERTEX_WEIGHT_INF || h > bounds[i]))
+            feasible = DS_FALSE;
+    }
+    if (DynamicSPT_Feasible(t) != feasible)
+        mismatch++;
+
+    /* exactly the destinations whose hop count changed */
+    n_changed = DynamicSPT_Changed(t, &changed);
+    for (k = 0; k < n_changed; k++)
+        if (!is_dst[changed[k]] || last[changed[k]] == hops[changed[k]])
+            mismatch++;
+    for (i = 0, j = 0; i < size; i++)
+        if (is_dst[i] && last[i] != hops[i])
+            j++;
+    if (j != n_changed)
+        mismatch++;
+    for (i = 0; i < size; i++)
+        last[i] = hops[i];
+
+    BFSGraph_Free(&g);
+    ALGraph_Free(&ref);
+    free(hops);
+    free(parents);
+    return mismatch;
+}
+
+static double
+elapsed(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
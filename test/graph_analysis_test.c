@@ -0,0 +1,216 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "../src/header.h"
+#include "../src/coordinate.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/neighbor.h"
+#include "../src/bfs.h"
+#include "../src/graph_analysis.h"
+
+static size_t reach(pt_BFSGraph, size_t, const char*, ds_bool, char*);
+
+/* 
+ * Check articulation points, dominators and separators of a
+ * sparse random graph, with some vertices removed, against
+ * searches with every vertex removed in turn.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node          nd;
+    pt_Coordinate    co;
+    pt_ALGraph       pg;
+    pt_BFSGraph      g;
+    p_sll            nodes = NULL;
+    size_t           size, i, x, v, n_dsts = 0, n_cut = 0, n_sep = 0, mismatch = 0;
+    size_t           parts, parts_x, src = 0;
+    size_t*          dsts;
+    double           side, px;
+    char*            removed;
+    char*            cut;
+    char*            sep;
+    char*            seen;
+    char*            seen_x;
+    char*            dom;
+    gqrm_id_t*       idom;
+    gqrm_id_t        d;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    if (size < 1)
+        size = 1;
+    /* about 8 neighbors per node */
+    side = 40.0 * sqrt((double)size) + 1.0;
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 8.0 + rand() % 5, 10)) == NULL)
+            exit(-1);
+        px = side * rand() / RAND_MAX;
+        if ((co = Coordinate_Create2D(px, side * rand() / RAND_MAX)) == NULL ||
+            Node_SetCoordinate(nd, co) == DS_ERROR)
+            exit(-1);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    pg = ALGraph_Create();
+    if (Neighbor_InitGraph(pg, nodes, NULL) == DS_ERROR || (g = BFSGraph_Create(pg)) == NULL)
+        exit(-1);
+
+    removed = calloc(size, sizeof(char));
+    cut     = malloc(size * sizeof(char));
+    sep     = malloc(size * sizeof(char));
+    seen    = malloc(size * sizeof(char));
+    seen_x  = malloc(size * sizeof(char));
+    dom     = calloc(size * size, sizeof(char));
+    idom    = malloc(size * sizeof(gqrm_id_t));
+    dsts    = malloc(size * sizeof(size_t));
+    if (!removed || !cut || !sep || !seen || !seen_x || !dom || !idom || !dsts)
+        exit(-1);
+    for (i = 1; i < size; i++) {
+        if (rand() % 20 == 0)
+            removed[i] = 1;
+        else if (rand() % 10 == 0)
+            dsts[n_dsts++] = i;
+    }
+
+    /* a cut vertex splits its component */
+    if (GraphAnalysis_ArticulationPoints(g, removed, cut) == DS_ERROR)
+        exit(-1);
+    parts = reach(g, size, removed, DS_FALSE, seen);
+    for (x = 0; x < size; x++) {
+        n_cut += cut[x];
+        if (removed[x]) {
+            mismatch += cut[x] != 0;
+            continue;
+        }
+        removed[x] = 1;
+        parts_x = reach(g, size, removed, DS_FALSE, seen_x);
+        removed[x] = 0;
+        if ((parts_x > parts) != (cut[x] != 0))
+            mismatch++;
+    }
+
+    /* dom[v * size + x]: every path from "src" to "v" goes through "x" */
+    reach(g, src, removed, DS_TRUE, seen);
+    for (x = 0; x < size; x++) {
+        if (removed[x] || x == src || !seen[x])
+            continue;
+        removed[x] = 1;
+        reach(g, src, removed, DS_TRUE, seen_x);
+        removed[x] = 0;
+        for (v = 0; v < size; v++)
+            if (v != x && seen[v] && !seen_x[v])
+                dom[v * size + x] = 1;
+    }
+    if (GraphAnalysis_Dominators(g, src, removed, idom) == DS_ERROR)
+        exit(-1);
+    /* the chain of immediate dominators is all dominators */
+    for (v = 0; v < size; v++) {
+        if (!seen[v] || v == src) {
+            mismatch += idom[v] != -1;
+            continue;
+        }
+        memset(seen_x, 0, size);
+        for (d = idom[v]; d >= 0 && (size_t)d != src; d = idom[d]) {
+            seen_x[d] = 1;
+            if (!dom[v * size + d])
+                mismatch++;
+        }
+        if (d != (gqrm_id_t)src)
+            mismatch++;
+        for (x = 0; x < size; x++)
+            if (dom[v * size + x] && !seen_x[x])
+                mismatch++;
+    }
+
+    if (GraphAnalysis_Separators(g, src, dsts, n_dsts, removed, sep) == DS_ERROR)
+        exit(-1);
+    for (x = 0; x < size; x++) {
+        for (i = 0, v = 0; i < n_dsts; i++)
+            v |= dom[dsts[i] * size + x];
+        if ((v != 0) != (sep[x] != 0))
+            mismatch++;
+        n_sep += sep[x];
+    }
+    printf("cut vertices %ld, separators %ld, mismatches %ld\n", n_cut, n_sep, mismatch);
+
+    BFSGraph_Free(&g);
+    ALGraph_Free(&pg);
+    free(removed);
+    free(cut);
+    free(sep);
+    free(seen);
+    free(seen_x);
+    free(dom);
+    free(idom);
+    free(dsts);
+    return mismatch ? 1 : 0;
+}
+
+/*
+ * With "directed", mark in "seen" the vertices reached from
+ * "from" over out-edges. Otherwise, with links taken both
+ * ways, count the connected components of all the vertices
+ * below "from". Removed vertices are skipped.
+ */
+static size_t
+reach(pt_BFSGraph g, size_t from, const char* removed, ds_bool directed, char* seen)
+{
+    const size_t*   cols;
+    size_t*         queue;
+    size_t          n = BFSGraph_Size(g), head, tail, r, v, j, deg, parts = 0;
+    int             dir;
+
+    if ((queue = malloc((n ? n : 1) * sizeof(size_t))) == NULL)
+        exit(-1);
+    memset(seen, 0, n);
+    for (r = 0; r < (directed == DS_TRUE ? 1 : from); r++) {
+        v = directed == DS_TRUE ? from : r;
+        if (removed[v] || seen[v])
+            continue;
+        parts++;
+        seen[v] = 1;
+        queue[0] = v;
+        for (head = 0, tail = 1; head < tail; head++) {
+            for (dir = 0; dir < (directed == DS_TRUE ? 1 : 2); dir++) {
+                deg = dir == 0 ? BFSGraph_OutEdges(g, queue[head], &cols, NULL)
+                               : BFSGraph_InEdges(g, queue[head], &cols);
+                for (j = 0; j < deg; j++)
+                    if (!removed[cols[j]] && !seen[cols[j]]) {
+                        seen[cols[j]] = 1;
+                        queue[tail++] = cols[j];
+                    }
+            }
+        }
+    }
+    free(queue);
+    return parts;
+}
@@ -0,0 +1,101 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/metrics.h"
+#include "../src/prr.h"
+#include "../src/thread_pool.h"
+
+static void count(size_t, size_t, size_t, void*);
+
+/* 
+ * Count from several threads and check that a snapshot sums
+ * the blocks of all of them, that prr() calls are counted
+ * and that a reset zeroes everything. Then count from pools
+ * created and freed in turn, whose counts must survive their
+ * threads while their blocks are reused.
+ */
+int main(int argc, char* argv[])
+{
+    pt_ThreadPool   pool = ThreadPool_Create(4), tmp;
+    MetricsBlock    sum;
+    size_t          i, fails = 0;
+
+    if (!pool)
+        exit(-1);
+
+    ThreadPool_ParallelFor(pool, 10000, 1, count, NULL);
+    Metrics_Snapshot(&sum);
+    if (sum.counters[METRIC_PAIR_TESTS] != 10000 ||
+        sum.counters[METRIC_SIM_EVENTS] != 20000 ||
+        sum.calls[TIMER_SPT] != 10000)
+        fails++;
+    printf("10000 counted, %llu summed\n",
+           (unsigned long long)sum.counters[METRIC_PAIR_TESTS]);
+
+    for (i = 0; i < 100; i++)
+        prr(20.0, (double)i);
+    Metrics_Snapshot(&sum);
+    if (sum.counters[METRIC_PRR_CALLS] != 100)
+        fails++;
+    printf("100 prr() calls, %llu counted\n",
+           (unsigned long long)sum.counters[METRIC_PRR_CALLS]);
+    Metrics_Report(stdout);
+
+    Metrics_Reset();
+    Metrics_Snapshot(&sum);
+    for (i = 0; i < METRIC_COUNT; i++)
+        if (sum.counters[i] != 0)
+            fails++;
+    for (i = 0; i < TIMER_COUNT; i++)
+        if (sum.cycles[i] != 0 || sum.calls[i] != 0)
+            fails++;
+    Metrics_ReportJSON(stdout);
+
+    for (i = 0; i < 20; i++) {
+        if ((tmp = ThreadPool_Create(4)) == NULL)
+            exit(-1);
+        ThreadPool_ParallelFor(tmp, 1000, 1, count, NULL);
+        ThreadPool_Free(&tmp);
+    }
+    Metrics_Snapshot(&sum);
+    if (sum.counters[METRIC_PAIR_TESTS] != 20000 || Metrics_Blocks() > 8)
+        fails++;
+    printf("20 pools, %llu counted in %ld blocks\n",
+           (unsigned long long)sum.counters[METRIC_PAIR_TESTS], Metrics_Blocks());
+
+    ThreadPool_Free(&pool);
+    return fails ? -1 : 0;
+}
+
+static void
+count(size_t begin, size_t end, size_t worker, void* arg)
+{
+    size_t   i;
+
+    for (i = begin; i < end; i++) {
+        METRIC_TIMER_BEGIN(t0);
+        METRIC_INC(METRIC_PAIR_TESTS);
+        METRIC_ADD(METRIC_SIM_EVENTS, 2);
+        METRIC_TIMER_END(TIMER_SPT, t0);
+    }
+}
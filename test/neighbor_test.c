@@ -0,0 +1,108 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/rnp_misc.h"
+#include "../src/neighbor.h"
+
+static double elapsed(clock_t);
+
+/* 
+ * Build the same graph through ALGraph_Init() and the bulk
+ * kernel, and compare them edge by edge. Set the environment
+ * variable GQRM_NEIGHBOR_KERNEL to test a particular kernel.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node        nd;
+    pt_ALGraph     pg1, pg2;
+    pt_Vertex      pv1, pv2;
+    p_sll          nodes = NULL;
+    p_vec          edges;
+    pt_Edge        pe;
+    size_t         size, i, j, mismatch = 0, nnz = 0;
+    gqrm_id_t      id;
+    edge_weight_t  w1, w2;
+    clock_t        start;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 10.0, 10)) == NULL)
+            exit(-1);
+        if (i % 5 == 0)
+            Node_SetUnselected(nd);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    printf("kernel: %s, range at 10.0: %lf\n",
+           Neighbor_KernelName(), Neighbor_Range(10.0));
+
+    pg1 = ALGraph_Create();
+    start = clock();
+    if (ALGraph_Init(pg1, nodes, check_neighbor) == DS_ERROR)
+        exit(-1);
+    printf("ALGraph_Init:       %lf s\n", elapsed(start));
+
+    pg2 = ALGraph_Create();
+    start = clock();
+    if (Neighbor_InitGraph(pg2, nodes, NULL) == DS_ERROR)
+        exit(-1);
+    printf("Neighbor_InitGraph: %lf s\n", elapsed(start));
+
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(pg1, i, &pv1);
+        ALGraph_GetVertex(pg2, i, &pv2);
+        if (Vertex_Degree(pv1) != Vertex_Degree(pv2)) {
+            mismatch++;
+            continue;
+        }
+        Vertex_GetEdges(pv1, &edges);
+        for (j = 0; j < Vertex_Degree(pv1); j++, nnz++) {
+            Vector_GetData(edges, j, (vec_data_t*)&pe);
+            Edge_GetEndID(pe, &id);
+            Edge_GetWeight(pe, &w1);
+            if (Vertex_GetEdgeWeight(pv2, id, &w2) == DS_ERROR || w1 != w2)
+                mismatch++;
+        }
+    }
+    printf("edges %ld, mismatches %ld\n", nnz, mismatch);
+
+    ALGraph_Free(&pg1);
+    ALGraph_Free(&pg2);
+    return 0;
+}
+
+static double
+elapsed(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
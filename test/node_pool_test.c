@@ -0,0 +1,153 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/node_pool.h"
+#include "../src/avl_tree.h"
+#include "../src/rb_tree.h"
+
+static int  int_cmp(void*, void*);
+static void check_order(avlt_data_t, size_t);
+
+static int     last;
+static size_t  visited, order_fails;
+
+/* 
+ * Allocate, release and clear nodes of a pool, then insert
+ * "size" integers into an AVL tree, delete half, copy and
+ * clear it, checking the pool accounting and tree order at
+ * every step.
+ */
+int main(int argc, char* argv[])
+{
+    pt_NodePool   pool;
+    pt_AVLTree    avl, cpy;
+    pt_RBTree     rb;
+    void**        nds;
+    void*         nd;
+    int*          keys;
+    size_t        size, i, fails = 0;
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    if ((keys = malloc((size + 1) * sizeof(int))) == NULL ||
+        (nds = malloc((size + 1) * sizeof(void*))) == NULL)
+        exit(-1);
+
+    /* pool: released nodes are handed out again first */
+    if ((pool = NodePool_Create(sizeof(int) * 3)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++)
+        if ((nds[i] = NodePool_Alloc(pool)) == NULL)
+            exit(-1);
+    if (NodePool_Used(pool) != size)
+        fails++;
+    if (size) {
+        nd = nds[size / 2];
+        NodePool_Release(pool, nd);
+        if (NodePool_Alloc(pool) != nd || NodePool_Used(pool) != size)
+            fails++;
+    }
+    NodePool_Clear(pool);
+    if (NodePool_Used(pool) != 0)
+        fails++;
+    if (NodePool_Reserve(pool, size) == DS_ERROR)
+        fails++;
+    for (i = 0; i < size; i++)
+        ((int*)NodePool_Alloc(pool))[2] = (int)i;
+    if (NodePool_Used(pool) != size)
+        fails++;
+    NodePool_Free(&pool);
+    if (pool)
+        fails++;
+
+    /* AVL tree on top of its pool */
+    if ((avl = AVLTree_Create(int_cmp)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        keys[i] = (int)i;
+        AVLTree_Insert(avl, &keys[i]);
+    }
+    for (i = 0; i < size; i += 2)
+        AVLTree_Delete(avl, &keys[i]);
+    if (AVLTree_Size(avl) != size / 2)
+        fails++;
+    for (i = 0; i < size; i++)
+        if (AVLTree_Contain(avl, &keys[i]) != (i % 2 ? DS_TRUE : DS_FALSE))
+            fails++;
+    if ((cpy = AVLTree_Copy(avl)) == NULL || AVLTree_Size(cpy) != size / 2)
+        fails++;
+    last = -1;
+    visited = 0;
+    AVLTree_InOrderMap(cpy, check_order);
+    if (visited != size / 2)
+        fails++;
+    AVLTree_Clear(avl);
+    if (AVLTree_Size(avl) != 0 || AVLTree_Contain(avl, &keys[1]))
+        fails++;
+    /* refill after clear reuses the kept slab */
+    for (i = 0; i < size; i++)
+        AVLTree_Insert(avl, &keys[i]);
+    last = -1;
+    visited = 0;
+    AVLTree_InOrderMap(avl, check_order);
+    if (visited != size)
+        fails++;
+    AVLTree_Free(&avl);
+    AVLTree_Free(&cpy);
+    if (avl || cpy)
+        fails++;
+
+    /* red-black tree on top of its pool */
+    if ((rb = RBTree_Create(int_cmp)) == NULL)
+        exit(-1);
+    for (i = 0; i < size; i++)
+        RBTree_Insert(rb, &keys[i]);
+    if (RBTree_Size(rb) != size)
+        fails++;
+    RBTree_Clear(rb);
+    if (RBTree_Size(rb) != 0)
+        fails++;
+    RBTree_Free(&rb);
+
+    fails += order_fails;
+    printf("%ld nodes, %ld fails\n", size, fails);
+    free(keys);
+    free(nds);
+    return fails ? -1 : 0;
+}
+
+static int
+int_cmp(void* d1, void* d2)
+{
+    return *(int*)d1 - *(int*)d2;
+}
+
+static void
+check_order(avlt_data_t d, size_t depth)
+{
+    if (*(int*)d <= last)
+        order_fails++;
+    last = *(int*)d;
+    visited++;
+}
@@ -0,0 +1,94 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+
+int main(int argc, char* argv[])
+{
+    pt_Node        nd, view1, view2;
+    pt_NodeTable   tbl;
+    p_sll          nodes = NULL;
+    sll_iter       it;
+    size_t         size, i, j, mismatch = 0, neighbors = 0;
+    double         prr1, prr2;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2) {
+        printf("parameter error!\n");
+        exit(-1);
+    }
+    size = atoi(argv[1]);
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if (i % 3 == 0)
+            nd = Node_CreateRandomSN(i, 10.0, 10);
+        else
+            nd = Node_CreateRandomCDL(i, 10.0, 10);
+        if (i % 7 == 0)
+            Node_SetUnselected(nd);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+
+    if ((tbl = NodeTable_CreateFromList(nodes)) == NULL)
+        exit(-1);
+    printf("table size %ld\n", NodeTable_Size(tbl));
+
+    /* row kernels must agree with the pt_Node API */
+    for (i = 0; i < size; i++)
+        for (j = 0; j < size; j++) {
+            if (i == j)
+                continue;
+            SingleLinkedList_GetData(nodes, i, (sll_data_t*)&view1);
+            SingleLinkedList_GetData(nodes, j, (sll_data_t*)&view2);
+            if (
+                Node_IsNeighbor(view1, view2, &prr1) !=
+                NodeTable_IsNeighbor(tbl, i, j, &prr2)
+               )
+                mismatch++;
+            else if (NodeTable_IsNeighbor(tbl, i, j, &prr2) == DS_TRUE)
+                neighbors++;
+        }
+    printf("neighbor pairs %ld, mismatches %ld\n", neighbors, mismatch);
+
+    /* setters on a view write through to the table */
+    NodeTable_GetNode(tbl, 0, &view1);
+    Node_SetUnselected(view1);
+    printf("view unselected -> table %s\n",
+           NodeTable_IsSelected(tbl, 0) == DS_TRUE ? "selected" : "unselected");
+    Node_SetCoordinate(view1, Coordinate_Create2D(1.0, 2.0));
+    printf("view moved -> table (%4.2lf, %4.2lf)\n",
+           NodeTable_Xs(tbl)[0], NodeTable_Ys(tbl)[0]);
+    Node_2DPrint(view1, stdout); printf("\n");
+
+    NodeTable_Free(&tbl);
+    SingleLinkedList_Begin(nodes, &it);
+    while (SingleLinkedList_Next(&it, (sll_data_t*)&nd) == DS_TRUE)
+        Node_Free(&nd);
+    SingleLinkedList_Destroy(&nodes, NULL);
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/rnp_misc.h"
+#include "../src/neighbor.h"
+#include "../src/thread_pool.h"
+
+static size_t compare(pt_ALGraph, pt_ALGraph, size_t);
+static size_t check_adjacency(pt_ALGraph, size_t);
+static size_t check_copy(pt_ALGraph, size_t);
+
+/* 
+ * Build the same graph sequentially and with 1, 2, 4 and
+ * ThreadPool_DefaultSize() threads through both parallel
+ * builders, and compare them edge by edge. Then rebuild it
+ * pushing edges in reverse, which must sort them the same,
+ * and check that copies share edges only until changed.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node        nd;
+    pt_ALGraph     ref, pg;
+    pt_ThreadPool  pool;
+    p_sll          nodes = NULL;
+    size_t         size, i, t, mismatch = 0;
+    size_t         threads[4] = {1, 2, 4, 0};
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 10.0, 10)) == NULL)
+            exit(-1);
+        if (i % 5 == 0)
+            Node_SetUnselected(nd);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+
+    ref = ALGraph_Create();
+    if (Neighbor_InitGraph(ref, nodes, NULL) == DS_ERROR)
+        exit(-1);
+
+    for (t = 0; t < 4; t++) {
+        if ((pool = ThreadPool_Create(threads[t])) == NULL)
+            exit(-1);
+
+        pg = ALGraph_Create();
+        if (ALGraph_ParallelInit(pg, nodes, check_neighbor, pool) == DS_ERROR)
+            exit(-1);
+        mismatch += compare(ref, pg, size);
+        ALGraph_Free(&pg);
+
+        pg = ALGraph_Create();
+        if (Neighbor_InitGraph(pg, nodes, pool) == DS_ERROR)
+            exit(-1);
+        mismatch += compare(ref, pg, size);
+        ALGraph_Free(&pg);
+
+        printf("%ld threads, mismatches %ld\n", ThreadPool_Size(pool), mismatch);
+        ThreadPool_Free(&pool);
+    }
+
+    mismatch += check_adjacency(ref, size);
+    mismatch += check_copy(ref, size);
+    printf("adjacency mismatches %ld\n", mismatch);
+
+    ALGraph_Free(&ref);
+    return mismatch ? -1 : 0;
+}
+
+/* 
+ * Count the vertices whose edges differ in order or weight.
+ */
+static size_t
+compare(pt_ALGraph pg1, pt_ALGraph pg2, size_t size)
+{
+    pt_Vertex      pv1, pv2;
+    p_vec          e1, e2;
+    pt_Edge        pe1, pe2;
+    gqrm_id_t      id1, id2;
+    edge_weight_t  w1, w2;
+    size_t         i, j, mismatch = 0;
+
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(pg1, i, &pv1);
+        ALGraph_GetVertex(pg2, i, &pv2);
+        if (Vertex_Degree(pv1) != Vertex_Degree(pv2)) {
+            mismatch++;
+            continue;
+        }
+        Vertex_GetEdges(pv1, &e1);
+        Vertex_GetEdges(pv2, &e2);
+        for (j = 0; j < Vertex_Degree(pv1); j++) {
+            Vector_GetData(e1, j, (vec_data_t*)&pe1);
+            Vector_GetData(e2, j, (vec_data_t*)&pe2);
+            Edge_GetEndID(pe1, &id1);
+            Edge_GetEndID(pe2, &id2);
+            Edge_GetWeight(pe1, &w1);
+            Edge_GetWeight(pe2, &w2);
+            if (id1 != id2 || w1 != w2) {
+                mismatch++;
+                break;
+            }
+        }
+    }
+    return mismatch;
+}
+
+/* 
+ * Copy "pg" pushing every edge in reverse order, check that
+ * the copy has the same sorted edges, that pushing an edge
+ * again fails, and that lookups agree after deleting every
+ * other edge. Return the number of mismatches.
+ */
+static size_t
+check_adjacency(pt_ALGraph pg, size_t size)
+{
+    pt_ALGraph     cpy;
+    pt_Vertex      pv, pc, end;
+    p_vec          edges;
+    pt_Edge        pe;
+    gqrm_id_t      id, prev;
+    edge_weight_t  w, w1;
+    size_t         i, j, deg, mismatch = 0;
+
+    cpy = ALGraph_Create();
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(pg, i, &pv);
+        if (ALGraph_PushVertex(cpy, Vertex_ShallowCopy(pv)) == DS_ERROR)
+            exit(-1);
+    }
+    for (i = size; i-- > 0;) {
+        ALGraph_GetVertex(pg, i, &pv);
+        ALGraph_GetVertex(cpy, i, &pc);
+        Vertex_GetEdges(pv, &edges);
+        for (j = Vertex_Degree(pv); j-- > 0;) {
+            Vector_GetData(edges, j, (vec_data_t*)&pe);
+            Edge_GetEndID(pe, &id);
+            Edge_GetWeight(pe, &w);
+            ALGraph_GetVertexByID(cpy, id, &end);
+            if (Vertex_PushNeighbor(pc, end, w) == DS_ERROR)
+                mismatch++;
+        }
+        if (Vertex_Degree(pv) && Vertex_PushNeighbor(pc, end, w) == DS_OK)
+            mismatch++;
+    }
+    mismatch += compare(pg, cpy, size);
+
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(cpy, i, &pc);
+        Vertex_GetEdges(pc, &edges);
+        deg = Vertex_Degree(pc);
+        for (j = deg; j-- > 0;)
+            if (j % 2) {
+                Vector_GetData(edges, j, (vec_data_t*)&pe);
+                Edge_GetEndID(pe, &id);
+                if (Vertex_DeleteEdge(pc, id) == DS_ERROR)
+                    mismatch++;
+            }
+        ALGraph_GetVertex(pg, i, &pv);
+        Vertex_GetEdges(pv, &edges);
+        for (j = 0; j < deg; j++) {
+            Vector_GetData(edges, j, (vec_data_t*)&pe);
+            Edge_GetEndID(pe, &id);
+            Edge_GetWeight(pe, &w);
+            ALGraph_GetVertexByID(cpy, id, &end);
+            if ((Vertex_IsNeighbor(pc, end) == DS_TRUE) != (j % 2 == 0) ||
+                (Vertex_GetEdgeWeight(pc, id, &w1) == DS_OK) != (j % 2 == 0) ||
+                (j % 2 == 0 && w1 != w))
+                mismatch++;
+        }
+        Vertex_GetEdges(pc, &edges);
+        for (j = 0, prev = -1; j < Vertex_Degree(pc); j++) {
+            Vector_GetData(edges, j, (vec_data_t*)&pe);
+            Edge_GetEndID(pe, &id);
+            if (id <= prev)
+                mismatch++;
+            prev = id;
+        }
+    }
+    ALGraph_Free(&cpy);
+    return mismatch;
+}
+
+/* 
+ * Copy "pg" twice over, change the edges and weights of the
+ * second copy and free the first, then check that "pg" kept
+ * everything and the second copy everything it did not
+ * change. Return the number of mismatches.
+ */
+static size_t
+check_copy(pt_ALGraph pg, size_t size)
+{
+    pt_ALGraph       base, cpy;
+    pt_Vertex        pv, pc;
+    p_vec            edges;
+    pt_Edge          pe;
+    gqrm_id_t        id;
+    vertex_weight_t  w;
+    size_t           i, mismatch = 0;
+
+    if ((base = ALGraph_Copy(pg)) == NULL || (cpy = ALGraph_Copy(base)) == NULL)
+        exit(-1);
+    mismatch += compare(pg, cpy, size);
+
+    /* odd vertices lose their edges, even ones get weight 1 */
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(cpy, i, &pc);
+        if (i % 2)
+            Vertex_ClearEdge(pc);
+        else
+            Vertex_SetWeight(pc, 1);
+    }
+    /* and vertex 0 loses its first edge */
+    ALGraph_GetVertex(cpy, 0, &pc);
+    Vertex_GetEdges(pc, &edges);
+    if (Vector_GetData(edges, 0, (vec_data_t*)&pe) == DS_OK) {
+        Edge_GetEndID(pe, &id);
+        Vertex_DeleteEdge(pc, id);
+    }
+    mismatch += compare(pg, base, size);
+    ALGraph_Free(&base);
+
+    for (i = 0; i < size; i++) {
+        ALGraph_GetVertex(pg, i, &pv);
+        ALGraph_GetVertex(cpy, i, &pc);
+        Vertex_GetWeight(pv, &w);
+        if (w != VERTEX_WEIGHT_INF)
+            mismatch++;
+        Vertex_GetWeight(pc, &w);
+        if (w != (i % 2 ? VERTEX_WEIGHT_INF : 1))
+            mismatch++;
+        if (Vertex_Degree(pc) != (i % 2 ? 0 : Vertex_Degree(pv) - (i == 0 && Vertex_Degree(pv))))
+            mismatch++;
+    }
+    /* the edges left are still those of "pg" */
+    ALGraph_GetVertex(cpy, 2 % size, &pc);
+    ALGraph_GetVertex(pg, 2 % size, &pv);
+    Vertex_GetEdges(pv, &edges);
+    for (i = 0; i < Vertex_Degree(pc); i++) {
+        Vector_GetData(edges, i, (vec_data_t*)&pe);
+        Edge_GetEndID(pe, &id);
+        if (ALGraph_GetVertexByID(cpy, id, &pv) == DS_ERROR ||
+            Vertex_IsNeighbor(pc, pv) == DS_FALSE)
+            mismatch++;
+    }
+    ALGraph_Free(&cpy);
+    return mismatch;
+}
@@ -3,14 +3,18 @@
 #include <time.h>
 
 #include "../src/rb_tree.h"
+#include "walk_check.h"
 
 int cmp(rbt_data_t, rbt_data_t);
 void print(rbt_data_t, size_t);
+size_t check_walks(size_t);
+size_t check_tree(size_t);
+size_t check_content(pt_RBTree, char[], int[], size_t);
 
 int main(int argc, char* argv[]) 
 {
     int           array[1000];
-	size_t        size, i;
+	size_t        size, i, fails;
 	pt_RBTree    rb;
 	int           input;
 	srand((unsigned)time(0));
@@ -23,11 +27,11 @@ int main(int argc, char* argv[])
 	rb = RBTree_Create(cmp);
 
     printf("creat over\n");
-	for (i = 0; i < size; i++)
+	for (i = 0; i < size && i < 1000; i++)
 	    array[i] = rand() % 1000;
 	
     printf("random over\n");
-	for (i = 0; i < size; i++) {
+	for (i = 0; i < size && i < 1000; i++) {
 	    printf("Insert %d\n", array[i]);
 	    RBTree_Insert(rb, &array[i]);
 	}
@@ -46,7 +50,117 @@ int main(int argc, char* argv[])
 	    RBTree_InOrderMap(rb, print);
 	}
 */
-	return 0;
+	RBTree_Free(&rb);
+	fails = check_tree(size) + check_walks(size);
+	printf("%ld fails\n", fails);
+	return fails ? -1 : 0;
+}
+
+/* 
+ * Insert "size" distinct keys in random order, delete a
+ * random half and check search, bounds, min/max, ordered
+ * iteration, the height bound 2 log2(n + 1) and a copy
+ * after every phase.
+ */
+size_t check_tree(size_t size)
+{
+    int*         keys;
+	size_t*      order;
+	char*        in;
+	size_t       i, j, t, fails = 0;
+	pt_RBTree    rb, cpy;
+
+	if ((keys = malloc((size + 1) * sizeof(int))) == NULL ||
+	    (order = malloc((size + 1) * sizeof(size_t))) == NULL ||
+	    (in = calloc(size + 1, 1)) == NULL)
+	    exit(-1);
+	for (i = 0; i < size; i++) {
+	    keys[i] = (int)i;
+		order[i] = i;
+	}
+	rb = RBTree_Create(cmp);
+	/* insert in a random order */
+	for (i = size; i > 1; i--) {
+	    j = rand() % i;
+		t = order[i - 1];
+		order[i - 1] = order[j];
+		order[j] = t;
+	}
+	for (i = 0; i < size; i++) {
+	    if (RBTree_Insert(rb, &keys[order[i]]) == DS_ERROR)
+		    fails++;
+		in[order[i]] = 1;
+	}
+	if (size && RBTree_Insert(rb, &keys[0]) != DS_ERROR)
+	    fails++;
+	fails += check_content(rb, in, keys, size);
+
+	/* delete a random half, some twice */
+	for (i = 0; i < size / 2; i++) {
+	    j = rand() % size;
+		if (RBTree_Delete(rb, &keys[j]) != (in[j] ? DS_OK : DS_ERROR))
+		    fails++;
+		in[j] = 0;
+	}
+	fails += check_content(rb, in, keys, size);
+	cpy = RBTree_Copy(rb);
+	fails += check_content(cpy, in, keys, size);
+
+	/* drain the copy completely */
+	for (i = 0; i < size; i++)
+	    if (in[i] && RBTree_Delete(cpy, &keys[i]) == DS_ERROR)
+		    fails++;
+	if (RBTree_Size(cpy) != 0 || RBTree_Height(cpy) != 0)
+	    fails++;
+
+	RBTree_Free(&cpy);
+	RBTree_Free(&rb);
+	free(keys);
+	free(order);
+	free(in);
+	return fails;
+}
+
+size_t check_content(pt_RBTree rb, char in[], int keys[], size_t size)
+{
+    rbt_iter     it;
+	rbt_data_t   d;
+	size_t       i, n = 0, lg, fails = 0;
+	int          last = -1, next = -1;
+
+	for (i = size; i > 0; i--) {
+	    n += in[i - 1];
+		if (RBTree_Contain(rb, &keys[i - 1]) != (in[i - 1] ? DS_TRUE : DS_FALSE))
+		    fails++;
+		/* lower bound of a key is the next present one */
+		next = in[i - 1] ? (int)(i - 1) : next;
+		if (RBTree_LowerBound(rb, &keys[i - 1], &d) == DS_ERROR ?
+		    next != -1 : *(int*)d != next)
+		    fails++;
+	}
+	if (RBTree_Size(rb) != n)
+	    fails++;
+	for (lg = 0; ((size_t)1 << lg) < n + 1; lg++)
+	    ;
+	if (RBTree_Height(rb) > 2 * lg)
+	    fails++;
+
+	i = 0;
+	RBTree_Begin(rb, &it);
+	while (RBTree_Next(&it, &d) == DS_TRUE) {
+	    if (*(int*)d <= last || !in[*(int*)d])
+		    fails++;
+		last = *(int*)d;
+		i++;
+	}
+	if (i != n)
+	    fails++;
+	if (n && (RBTree_GetMin(rb, &d) == DS_ERROR || !in[*(int*)d] ||
+	          RBTree_GetMax(rb, &d) == DS_ERROR || *(int*)d != last))
+	    fails++;
+	if (n && RBTree_UpperBound(rb, &keys[last], &d) != DS_ERROR)
+	    fails++;
+	return fails;
 }
 
 int cmp(rbt_data_t d1, rbt_data_t d2)
@@ -65,3 +179,41 @@ void print(rbt_data_t d, size_t depth)
 	    printf("  ");
 	printf("%3d\n", *pi);
 }
+
+/* 
+ * Build "size" sorted keys in bulk and compare the three
+ * walks, data and depth, against the median-split shape
+ * the bulk build produces.
+ */
+size_t check_walks(size_t size)
+{
+    int*         keys;
+	void**       sorted;
+	size_t       i, order, fails = 0;
+	pt_RBTree    tree;
+
+	if ((keys = malloc((size + 1) * sizeof(int))) == NULL ||
+	    (sorted = malloc((size + 1) * sizeof(void*))) == NULL)
+	    exit(-1);
+	for (i = 0; i < size; i++) {
+	    keys[i] = (int)i;
+		sorted[i] = &keys[i];
+	}
+	tree = RBTree_Create(cmp);
+	if (RBTree_BuildFromSorted(tree, sorted, size) == DS_ERROR || RBTree_Size(tree) != size)
+	    fails++;
+	for (order = 0; order < 3; order++) {
+	    walk_median(size, (int)order);
+		if (order == WALK_PRE)
+		    RBTree_PreOrderMap(tree, walk_record);
+		else if (order == WALK_IN)
+		    RBTree_InOrderMap(tree, walk_record);
+		else
+		    RBTree_PostOrderMap(tree, walk_record);
+		fails += walk_compare();
+	}
+	RBTree_Free(&tree);
+	free(keys);
+	free(sorted);
+	return fails;
+}
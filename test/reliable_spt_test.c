@@ -0,0 +1,195 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/shortest_path_tree.h"
+#include "../src/neighbor.h"
+#include "../src/bfs.h"
+
+static double path_cost(pt_ALGraph, pt_ALGraph, gqrm_id_t, gqrm_hop_t*);
+static double best_cost(pt_BFSGraph, size_t, size_t, gqrm_hop_t);
+
+/* 
+ * Check ALGraph_ReliableShortestPathTree() on a random graph:
+ * with a single destination the tree path must be optimal,
+ * which is checked against a Bellman-Ford over hop counts;
+ * with several, every path must be valid and within bound.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node            nd;
+    pt_ALGraph         pg, spt;
+    pt_BFSGraph        g;
+    p_sll              nodes = NULL;
+    size_t             size, i, k, n_dsts, mismatch = 0;
+    gqrm_id_t          dsts[10];
+    gqrm_hop_t         bounds[10], hop;
+    vertex_weight_t*   hops;
+    gqrm_id_t*         parents;
+    double             cost;
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if ((nd = Node_CreateRandomCDL(i, 10.0, 10)) == NULL)
+            exit(-1);
+        SingleLinkedList_InsertTail(nodes, nd);
+    }
+    pg = ALGraph_Create();
+    if (Neighbor_InitGraph(pg, nodes, NULL) == DS_ERROR)
+        exit(-1);
+    g       = BFSGraph_Create(pg);
+    hops    = malloc(size * sizeof(vertex_weight_t));
+    parents = malloc(size * sizeof(gqrm_id_t));
+    BFS_Run(g, 0, NULL, hops, parents);
+
+    /* the last vertices, never the source itself, allowing
+     * one hop more than the fewest possible */
+    n_dsts = size > 10 ? 10 : (size > 0 ? size - 1 : 0);
+    for (i = 0; i < n_dsts; i++) {
+        dsts[i]   = (gqrm_id_t)(size - 1 - i);
+        bounds[i] = hops[dsts[i]] + 1;
+    }
+
+    for (i = 0; i < n_dsts; i++) {
+        if (hops[dsts[i]] == VERTEX_WEIGHT_INF)
+            continue;
+        if ((spt = ALGraph_ReliableShortestPathTree(pg, 0, &dsts[i], &bounds[i], 1)) == NULL)
+            exit(-1);
+        cost = path_cost(pg, spt, dsts[i], &hop);
+        if (hop > bounds[i] ||
+            fabs(cost - best_cost(g, 0, (size_t)dsts[i], bounds[i])) > 1e-9)
+            mismatch++;
+        ALGraph_Free(&spt);
+    }
+    printf("single destination mismatches %ld\n", mismatch);
+
+    /* the tree fails on a destination it cannot reach */
+    for (i = 0, k = 0; i < n_dsts; i++)
+        if (hops[dsts[i]] != VERTEX_WEIGHT_INF) {
+            dsts[k]     = dsts[i];
+            bounds[k++] = bounds[i];
+        }
+    n_dsts = k;
+    if ((spt = ALGraph_ReliableShortestPathTree(pg, 0, dsts, bounds, n_dsts)) == NULL)
+        exit(-1);
+    for (i = 0; i < n_dsts; i++) {
+        cost = path_cost(pg, spt, dsts[i], &hop);
+        if (isnan(cost) || hop > bounds[i])
+            mismatch++;
+        printf("dst %ld: %ld hops (bound %ld), PRR %lf\n",
+               dsts[i], hop, bounds[i], exp(-cost));
+    }
+    printf("mismatches %ld\n", mismatch);
+
+    free(hops);
+    free(parents);
+    BFSGraph_Free(&g);
+    ALGraph_Free(&spt);
+    ALGraph_Free(&pg);
+    return mismatch ? -1 : 0;
+}
+
+/* 
+ * Walk the tree from "dst" to the root, checking that every
+ * tree edge exists in "pg" and that hop counts are
+ * consistent. Return the sum of -log(PRR), NAN on error.
+ */
+static double
+path_cost(pt_ALGraph pg, pt_ALGraph spt, gqrm_id_t dst, gqrm_hop_t* hop)
+{
+    pt_Vertex        pv, pp;
+    gqrm_id_t        parent;
+    vertex_weight_t  w, wp;
+    edge_weight_t    prr;
+    double           cost = 0.0;
+
+    ALGraph_GetVertexByID(spt, dst, &pv);
+    Vertex_GetWeight(pv, &w);
+    *hop = w;
+    for (Vertex_GetParent(pv, &parent); parent != -1; Vertex_GetParent(pv, &parent)) {
+        ALGraph_GetVertexByID(pg, parent, &pp);
+        if (Vertex_GetEdgeWeight(pp, dst, &prr) == DS_ERROR)
+            return NAN;
+        cost -= log(prr);
+        ALGraph_GetVertexByID(spt, parent, &pv);
+        Vertex_GetWeight(pv, &wp);
+        if (wp + 1 != w)
+            return NAN;
+        w   = wp;
+        dst = parent;
+    }
+    return w == 0 ? cost : NAN;
+}
+
+/* 
+ * Cheapest path from "src" to "dst" within "bound" hops, by
+ * Bellman-Ford over hop counts.
+ */
+static double
+best_cost(pt_BFSGraph g, size_t src, size_t dst, gqrm_hop_t bound)
+{
+    size_t                size = BFSGraph_Size(g), u, j, deg;
+    double*               cur = malloc(size * sizeof(double));
+    double*               nxt = malloc(size * sizeof(double));
+    double*               tmp;
+    double                re;
+    const size_t*         cols;
+    const edge_weight_t*  ws;
+    gqrm_hop_t            h;
+
+    for (u = 0; u < size; u++)
+        cur[u] = INFINITY;
+    cur[src] = 0.0;
+    re = src == dst ? 0.0 : INFINITY;
+    for (h = 1; h <= bound; h++) {
+        for (u = 0; u < size; u++)
+            nxt[u] = INFINITY;
+        for (u = 0; u < size; u++) {
+            if (cur[u] == INFINITY)
+                continue;
+            deg = BFSGraph_OutEdges(g, u, &cols, &ws);
+            for (j = 0; j < deg; j++)
+                if (cur[u] - log(ws[j]) < nxt[cols[j]])
+                    nxt[cols[j]] = cur[u] - log(ws[j]);
+        }
+        if (nxt[dst] < re)
+            re = nxt[dst];
+        tmp = cur;
+        cur = nxt;
+        nxt = tmp;
+    }
+    free(cur);
+    free(nxt);
+    return re;
+}
@@ -6,11 +6,13 @@
 
 int cmp(set_data_t, set_data_t);
 void map(set_data_t, size_t);
+size_t check_ops(size_t);
+size_t check_set(pt_Set, char[], int[]);
 
 int main(int argc, char* argv[])
 {
     int          array[1000];
-	size_t       size, i;
+	size_t       size, i, fails;
 	pt_Set       rhs, lhs, res;
 	srand((unsigned)time(0));
 
@@ -57,7 +59,100 @@ int main(int argc, char* argv[])
 	Set_Map(res, map);
 	printf("\n");
 */
-return 0;
+	Set_Free(&rhs);
+	Set_Free(&lhs);
+	fails = check_ops(size);
+	printf("%ld fails\n", fails);
+	return fails ? -1 : 0;
+}
+
+/* 
+ * Check every set operation, new and in-place, against
+ * membership tables of two random sets of values below
+ * 1000, the first one built in bulk from sorted input.
+ */
+size_t check_ops(size_t size)
+{
+    static int   keys[1000];
+	set_data_t   sorted[1000];
+	char         in1[1000], in2[1000], exp[1000];
+	pt_Set       s1, s2, res;
+	size_t       i, n = 0, op, fails = 0;
+
+	for (i = 0; i < 1000; i++) {
+	    keys[i] = (int)i;
+		in1[i] = rand() % 1000 < (int)size % 1000;
+		in2[i] = rand() % 2;
+		if (in1[i])
+		    sorted[n++] = &keys[i];
+	}
+	s1 = Set_Create(cmp, 1);
+	s2 = Set_Create(cmp, 2);
+	if (Set_Init(s1, sorted, n) == DS_ERROR)
+	    fails++;
+	for (i = 0; i < 1000; i++)
+	    if (in2[(i * 7) % 1000])
+		    Set_Insert(s2, &keys[(i * 7) % 1000]);
+	fails += check_set(s1, in1, keys);
+
+	for (op = 0; op < 8; op++) {
+	    for (i = 0; i < 1000; i++)
+		    switch (op % 4) {
+			case 0: exp[i] = in1[i] || in2[i]; break;
+			case 1: exp[i] = in1[i] && !in2[i]; break;
+			case 2: exp[i] = in1[i] && in2[i]; break;
+			default: exp[i] = in1[i] != in2[i]; break;
+			}
+		if (op < 4) {
+		    res = op == 0 ? Set_Union(s1, s2) : op == 1 ? Set_Minus(s1, s2) :
+			      op == 2 ? Set_Intersect(s1, s2) : Set_SymDiff(s1, s2);
+		} else {
+		    res = Set_Union(s1, s1);
+			if (op == 4)
+			    Set_InSetUnion(res, s2);
+			else if (op == 5)
+			    Set_InSetMinus(res, s2);
+			else if (op == 6)
+			    Set_InSetIntersect(res, s2);
+			else
+			    Set_InSetSymDiff(res, s2);
+		}
+		fails += check_set(res, exp, keys);
+		Set_Free(&res);
+	}
+
+	/* a single data is added and removed element-wise */
+	res = Set_Create(cmp, 3);
+	Set_Insert(res, &keys[0]);
+	Set_InSetUnion(s1, res);
+	in1[0] = 1;
+	fails += check_set(s1, in1, keys);
+	Set_InSetMinus(s1, res);
+	in1[0] = 0;
+	fails += check_set(s1, in1, keys);
+
+	/* an empty set changes nothing */
+	Set_Delete(res, &keys[0]);
+	if (Set_InSetUnion(s1, res) == DS_ERROR || Set_InSetMinus(s1, res) == DS_ERROR)
+	    fails++;
+	fails += check_set(s1, in1, keys);
+
+	Set_Free(&res);
+	Set_Free(&s1);
+	Set_Free(&s2);
+	return fails;
+}
+
+size_t check_set(pt_Set st, char in[], int keys[])
+{
+    size_t   i, n = 0, fails = 0;
+
+	for (i = 0; i < 1000; i++) {
+	    n += in[i];
+		if (Set_Contain(st, &keys[i]) != (in[i] ? DS_TRUE : DS_FALSE))
+		    fails++;
+	}
+	return fails + (Set_Size(st) != n);
 }
 
 int cmp(set_data_t d1, set_data_t d2)
@@ -0,0 +1,184 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/single_linked_list.h"
+
+static size_t check(p_sll, int*, size_t);
+static size_t check_sorted(p_sll, size_t, int, int);
+static int    key_cmp(sll_data_t, sll_data_t);
+
+/* values are key * key_base + position */
+static int    key_base;
+
+/* 
+ * Append "size" integers, remove the odd ones through an
+ * iterator, then append again to check that the tail is
+ * still right. Then sort random keys both ways and merge
+ * several sorted lists, checking order and stability.
+ */
+int main(int argc, char* argv[])
+{
+    p_sll        list = NULL;
+    sll_iter     it;
+    sll_data_t   d;
+    int*         vals;
+    int*         ref;
+    size_t       size, n, i, fails = 0;
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    vals = malloc((size + 2) * sizeof(int));
+    ref  = malloc((size + 2) * sizeof(int));
+    if (!vals || !ref || SingleLinkedList_Init(&list) == DS_ERROR)
+        exit(-1);
+
+    for (i = 0; i < size; i++) {
+        vals[i] = ref[i] = (int)i;
+        SingleLinkedList_InsertTail(list, &vals[i]);
+    }
+    fails += check(list, ref, size);
+
+    SingleLinkedList_Begin(list, &it);
+    for (n = 0; SingleLinkedList_Next(&it, &d) == DS_TRUE; )
+        if (*(int*)d % 2)
+            SingleLinkedList_RemoveCurrent(&it, NULL);
+        else
+            ref[n++] = *(int*)d;
+    if (SingleLinkedList_RemoveCurrent(&it, NULL) != DS_ERROR)
+        fails++;
+    fails += check(list, ref, n);
+
+    /* the tail survives removals, including of the last node */
+    vals[size] = ref[n] = -1;
+    SingleLinkedList_InsertTail(list, &vals[size]);
+    fails += check(list, ref, ++n);
+    SingleLinkedList_DeleteTail(list, NULL);
+    vals[size + 1] = ref[n - 1] = -2;
+    SingleLinkedList_InsertTail(list, &vals[size + 1]);
+    fails += check(list, ref, n);
+    if (SingleLinkedList_GetTailData(list, &d) == DS_ERROR || *(int*)d != -2)
+        fails++;
+
+    /* empty the list through the iterator and append again */
+    SingleLinkedList_Begin(list, &it);
+    while (SingleLinkedList_Next(&it, NULL) == DS_TRUE)
+        SingleLinkedList_RemoveCurrent(&it, NULL);
+    fails += check(list, ref, 0);
+    SingleLinkedList_InsertTail(list, &vals[0]);
+    ref[0] = vals[0];
+    fails += check(list, ref, 1);
+
+    /* keys in [0, 16) so that many compare equal */
+    SingleLinkedList_Clear(list, NULL);
+    key_base = (int)size + 2;
+    for (i = 0; i < size; i++) {
+        vals[i] = (rand() % 16) * key_base + (int)i;
+        SingleLinkedList_InsertTail(list, &vals[i]);
+    }
+    SingleLinkedList_MergeSort_A(list, key_cmp);
+    fails += check_sorted(list, size, 1, 1);
+    SingleLinkedList_MergeSort_D(list, key_cmp);
+    fails += check_sorted(list, size, -1, 1);
+    SingleLinkedList_MergeSort_A(list, key_cmp);
+    if (size && (SingleLinkedList_GetTailData(list, &d) == DS_ERROR ||
+                 key_cmp(d, &vals[0]) < 0))
+        fails++;
+
+    /* split into 3 sorted lists by position and merge them back */
+    {
+        p_sll   parts[3] = {NULL, NULL, NULL};
+
+        for (n = 0; n < 3; n++)
+            SingleLinkedList_Init(&parts[n]);
+        for (i = 0; SingleLinkedList_DeleteHead(list, &d) == DS_OK; i++)
+            SingleLinkedList_InsertTail(parts[i % 3], d);
+        if (SingleLinkedList_MergeSorted(list, parts, 3, key_cmp) == DS_ERROR)
+            fails++;
+        fails += check_sorted(list, size, 1, 0);
+        for (n = 0; n < 3; n++) {
+            if (SingleLinkedList_Size(parts[n]) != 0)
+                fails++;
+            SingleLinkedList_Destroy(&parts[n], NULL);
+        }
+    }
+
+    printf("%ld elements, %ld fails\n", size, fails);
+    SingleLinkedList_Destroy(&list, NULL);
+    free(vals);
+    free(ref);
+    return fails ? -1 : 0;
+}
+
+/* 
+ * Compare a list with "n" expected values, both by index and
+ * through an iterator.
+ */
+static size_t
+check(p_sll list, int* ref, size_t n)
+{
+    sll_iter     it;
+    sll_data_t   d;
+    size_t       i, fails = 0;
+
+    if (SingleLinkedList_Size(list) != n)
+        fails++;
+    for (i = 0; i < n; i++)
+        if (SingleLinkedList_GetData(list, i, &d) == DS_ERROR || *(int*)d != ref[i])
+            fails++;
+    SingleLinkedList_Begin(list, &it);
+    for (i = 0; SingleLinkedList_Next(&it, &d) == DS_TRUE; i++)
+        if (i >= n || *(int*)d != ref[i])
+            fails++;
+    return fails + (i != n);
+}
+
+/* 
+ * Check that a list of "n" values is sorted by key in the
+ * order given by "sign" and, if "stable", that equal keys
+ * keep ascending positions (the low part of each value).
+ */
+static size_t
+check_sorted(p_sll list, size_t n, int sign, int stable)
+{
+    sll_iter     it;
+    sll_data_t   d;
+    int          prev = 0, c;
+    size_t       i, fails = 0;
+
+    SingleLinkedList_Begin(list, &it);
+    for (i = 0; SingleLinkedList_Next(&it, &d) == DS_TRUE; i++, prev = *(int*)d) {
+        if (i == 0)
+            continue;
+        c = key_cmp(&prev, d);
+        if (sign * c > 0 || (stable && c == 0 && prev > *(int*)d))
+            fails++;
+    }
+    return fails + (i != n) + (SingleLinkedList_Size(list) != n);
+}
+
+static int
+key_cmp(sll_data_t d1, sll_data_t d2)
+{
+    return *(int*)d1 / key_base - *(int*)d2 / key_base;
+}
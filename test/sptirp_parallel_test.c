@@ -0,0 +1,149 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../src/header.h"
+#include "../src/node.h"
+#include "../src/graph.h"
+#include "../src/rnp_misc.h"
+#include "../src/neighbor.h"
+#include "../src/sptirp.h"
+#include "../src/thread_pool.h"
+
+static size_t take_selection(p_sll, char*);
+static size_t count_edges(pt_ALGraph);
+
+/* 
+ * Run SPTiRP on random nodes, then SPTiRP_Parallel with 1,
+ * 2, 4 and ThreadPool_DefaultSize() threads on the same
+ * nodes, and compare the CDLs they keep one by one and the
+ * size of the graphs they return.
+ */
+int main(int argc, char* argv[])
+{
+    pt_Node        nd;
+    pt_ALGraph     pg;
+    pt_ThreadPool  pool;
+    p_sll          nodes = NULL;
+    char*          ref;
+    char*          sel;
+    gqrm_hop_t     hop;
+    size_t         size, n, i, t, kept, edges, mismatch = 0;
+    size_t         threads[4] = {1, 2, 4, 0};
+
+    srand((unsigned)time(0));
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    /*
+     * few sensors, bounded by about the hops across the field,
+     * so that the sensors alone cannot relay and CDLs are kept
+     */
+    n = size > 10 ? 10 : size - 1;
+    hop = (gqrm_hop_t)(sqrt(2.0) * (UPPER_RIGHT - LOWER_LEFT) /
+                       Neighbor_Range(35.0)) + 1;
+
+    if (SingleLinkedList_Init(&nodes) == DS_ERROR)
+        exit(-1);
+    for (i = 0; i < size; i++) {
+        if (i == 0)
+            nd = Node_CreateRandomGW(i, 35.0, hop);
+        else if (i <= n)
+            nd = Node_CreateRandomSN(i, 35.0, hop);
+        else
+            nd = Node_CreateRandomCDL(i, 35.0, hop);
+        if (!nd || SingleLinkedList_InsertTail(nodes, nd) == DS_ERROR)
+            exit(-1);
+    }
+    if ((ref = calloc(size, sizeof(char))) == NULL ||
+        (sel = calloc(size, sizeof(char))) == NULL)
+        exit(-1);
+
+    pg = SPTiRP(nodes);
+    kept = take_selection(nodes, ref);
+    edges = count_edges(pg);
+    printf("sequential %s, %ld CDLs kept\n", pg ? "feasible" : "infeasible", kept);
+    if (pg)
+        ALGraph_Free(&pg);
+
+    for (t = 0; t < 4; t++) {
+        if ((pool = ThreadPool_Create(threads[t])) == NULL)
+            exit(-1);
+        pg = SPTiRP_Parallel(nodes, pool);
+        if (take_selection(nodes, sel) != kept)
+            mismatch++;
+        for (i = 0; i < size; i++)
+            if (sel[i] != ref[i])
+                mismatch++;
+        if (count_edges(pg) != edges)
+            mismatch++;
+        if (pg)
+            ALGraph_Free(&pg);
+        printf("%ld threads, mismatches %ld\n", ThreadPool_Size(pool), mismatch);
+        ThreadPool_Free(&pool);
+    }
+
+    free(ref);
+    free(sel);
+    return mismatch ? -1 : 0;
+}
+
+/* 
+ * Record which CDLs are selected, select them all again for
+ * the next run, and return how many were.
+ */
+static size_t
+take_selection(p_sll nodes, char* sel)
+{
+    pt_Node     nd;
+    gqrm_id_t   id;
+    sll_iter    it;
+    size_t      kept = 0;
+
+    SingleLinkedList_Begin(nodes, &it);
+    while (SingleLinkedList_Next(&it, (sll_data_t*)&nd) == DS_TRUE) {
+        Node_GetID(nd, &id);
+        sel[id] = Node_IsCDL(nd) == DS_TRUE && Node_IsSelected(nd) == DS_TRUE;
+        kept += sel[id];
+        if (Node_IsCDL(nd) == DS_TRUE)
+            Node_SetSelected(nd);
+    }
+    return kept;
+}
+
+/* 
+ * The number of edges of "pg", 0 for none.
+ */
+static size_t
+count_edges(pt_ALGraph pg)
+{
+    pt_Vertex   pv;
+    size_t      i, edges = 0;
+
+    for (i = 0; pg && i < ALGraph_Size(pg); i++)
+        if (ALGraph_GetVertex(pg, i, &pv) == DS_OK)
+            edges += Vertex_Degree(pv);
+    return edges;
+}
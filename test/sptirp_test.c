@@ -100,6 +100,7 @@ int main(int argc, char* argv[])
 	else
 	    printf("pg mysql done\n");
 
+	Metrics_Report(stdout);
 	return 0;
 }
 
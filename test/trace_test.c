@@ -0,0 +1,89 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define GQRM_TRACE_LEVEL   TRACE_LEVEL_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/trace.h"
+#include "../src/thread_pool.h"
+
+static void emit(size_t, size_t, size_t, void*);
+
+/* 
+ * Emit trace points from several threads, then check that
+ * the ring keeps the last TRACE_RING_SIZE of them and that
+ * filtered subsystems are not recorded. Writers a whole ring
+ * apart may drop records, so the full ring is only checked
+ * after emitting from a single thread.
+ */
+int main(int argc, char* argv[])
+{
+    pt_ThreadPool   pool = ThreadPool_Create(4);
+    FILE*           fp = tmpfile();
+    size_t          n, fails = 0;
+
+    if (!pool || !fp)
+        exit(-1);
+    if (Trace_ParseMask("sim,spt") != (TRACE_SIM | TRACE_SPT) ||
+        Trace_ParseMask("all") != TRACE_ALL)
+        fails++;
+
+    ThreadPool_ParallelFor(pool, 100, 1, emit, NULL);
+    if ((n = Trace_Dump(fp)) != 100)
+        fails++;
+    printf("100 emitted, %ld dumped\n", n);
+
+    ThreadPool_ParallelFor(pool, 5000, 0, emit, NULL);
+    if ((n = Trace_Dump(fp)) == 0 || n > TRACE_RING_SIZE)
+        fails++;
+    printf("5100 emitted, %ld dumped\n", n);
+
+    emit(0, TRACE_RING_SIZE, 0, NULL);
+    if ((n = Trace_Dump(fp)) != TRACE_RING_SIZE)
+        fails++;
+    printf("%d more from one thread, %ld dumped\n", TRACE_RING_SIZE, n);
+
+    Trace_Clear();
+    Trace_SetMask(TRACE_SPT);
+    ThreadPool_ParallelFor(pool, 100, 1, emit, NULL);
+    if ((n = Trace_Dump(fp)) != 0)
+        fails++;
+    printf("100 filtered out, %ld dumped\n", n);
+
+    Trace_SetMask(TRACE_ALL);
+    TRACE_INFO(TRACE_SIM, "last %d", 1);
+    Trace_Dump(stdout);
+
+    fclose(fp);
+    ThreadPool_Free(&pool);
+    return fails ? -1 : 0;
+}
+
+static void
+emit(size_t begin, size_t end, size_t worker, void* arg)
+{
+    size_t   i;
+
+    for (i = begin; i < end; i++)
+        TRACE_DEBUG(TRACE_SIM, "worker %ld, point %ld", worker, i);
+}
@@ -0,0 +1,144 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/typed_containers.h"
+
+/* @struct
+ * Entries of the heap under test, ordered by weight only so
+ * that equal weights exercise ties.
+ */
+typedef struct {
+    int      weight;
+    size_t   tag;
+} entry;
+
+#define ENTRY_LESS(a, b)    ((a).weight < (b).weight)
+GQRM_HEAP(EntryHeap, entry, ENTRY_LESS)
+
+/* 
+ * Fill IDVec, EntryHeap and IDSet with "size" random values
+ * and check them against a membership table: the vector
+ * keeps what was pushed, the heap pops by non-decreasing
+ * weight, and the set agrees with the table after a build,
+ * random insertions and deletions.
+ */
+int main(int argc, char* argv[])
+{
+    IDVec       vec;
+    EntryHeap   heap;
+    IDSet       set;
+    entry       e;
+    gqrm_id_t*  ids;
+    gqrm_id_t   id;
+    char*       in;
+    size_t      size, range, i, n, fails = 0;
+    int         last;
+
+    if (argc != 2)
+        exit(-1);
+    size  = atoi(argv[1]);
+    range = 2 * size + 1;
+    if ((ids = malloc((size + 1) * sizeof(gqrm_id_t))) == NULL ||
+        (in = calloc(range, sizeof(char))) == NULL)
+        exit(-1);
+    srand(11);
+    for (i = 0; i < size; i++)
+        ids[i] = rand() % range;
+
+    /* vector */
+    IDVec_Init(&vec);
+    for (i = 0; i < size; i++)
+        if (IDVec_PushBack(&vec, ids[i]) == DS_ERROR)
+            fails++;
+    if (IDVec_Size(&vec) != size)
+        fails++;
+    for (i = 0; i < size; i++)
+        if (vec.data[i] != ids[i])
+            fails++;
+    if (size > 2) {
+        IDVec_SwapRemove(&vec, 0);
+        if (IDVec_PopBack(&vec, &id) == DS_ERROR ||
+            vec.data[0] != ids[size - 1] || id != ids[size - 2])
+            fails++;
+    }
+    IDVec_Clear(&vec);
+    if (IDVec_Empty(&vec) != DS_TRUE || IDVec_PopBack(&vec, NULL) == DS_OK)
+        fails++;
+    IDVec_Destroy(&vec);
+
+    /* heap */
+    EntryHeap_Init(&heap);
+    for (i = 0; i < size; i++) {
+        e.weight = (int)(ids[i] % 97);
+        e.tag    = i;
+        if (EntryHeap_Push(&heap, e) == DS_ERROR)
+            fails++;
+    }
+    for (n = 0, last = -1; EntryHeap_Pop(&heap, &e) == DS_OK; n++) {
+        if (e.weight < last || e.weight != (int)(ids[e.tag] % 97))
+            fails++;
+        last = e.weight;
+    }
+    if (n != size || EntryHeap_Empty(&heap) != DS_TRUE)
+        fails++;
+    EntryHeap_Destroy(&heap);
+
+    /* sorted set: building nothing leaves it empty */
+    IDSet_Init(&set);
+    if (IDSet_Build(&set, ids, 0) == DS_ERROR || IDSet_Size(&set) != 0)
+        fails++;
+    /* build from the first half, then churn */
+    if (IDSet_Build(&set, ids, size / 2) == DS_ERROR)
+        fails++;
+    for (i = 0; i < size / 2; i++)
+        in[ids[i]] = 1;
+    for (i = size / 2; i < size; i++) {
+        if (rand() % 2) {
+            if ((IDSet_Insert(&set, ids[i]) == DS_OK) == (in[ids[i]] == 1))
+                fails++;
+            in[ids[i]] = 1;
+        } else {
+            if ((IDSet_Delete(&set, ids[i]) == DS_OK) != (in[ids[i]] == 1))
+                fails++;
+            in[ids[i]] = 0;
+        }
+    }
+    for (i = n = 0; i < range; i++) {
+        n += in[i];
+        if (IDSet_Contain(&set, (gqrm_id_t)i) != (in[i] ? DS_TRUE : DS_FALSE))
+            fails++;
+    }
+    if (IDSet_Size(&set) != n)
+        fails++;
+    for (i = 1; i < IDSet_Size(&set); i++)
+        if (set.data[i - 1] >= set.data[i])
+            fails++;
+    if (IDSet_Contain(&set, -1) == DS_TRUE)
+        fails++;
+    IDSet_Destroy(&set);
+
+    printf("%lu fails\n", (unsigned long)fails);
+    free(ids);
+    free(in);
+    return fails ? -1 : 0;
+}
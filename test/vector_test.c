@@ -0,0 +1,110 @@
+/*
+ * GQRM
+ * Copyright (C) 2019-2025 Chaofan Ma <chaofanma@hotmail.com>
+ *
+ * This file is part of GQRM.
+ *
+ * GQRM is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GQRM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GQRM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/header.h"
+#include "../src/vector.h"
+
+static int  int_cmp(vec_data_t, vec_data_t);
+static void int_clear(vec_data_t*);
+
+/* 
+ * Push, index, delete and swap-remove on a vector of
+ * "size" integers, checking its content against a plain
+ * array after every step.
+ */
+int main(int argc, char* argv[])
+{
+    p_vec        vec = NULL, cpy;
+    vec_data_t   d;
+    int*         ref;
+    int*         pi;
+    size_t       size, n, i, index, fails = 0;
+
+    if (argc != 2)
+        exit(-1);
+    size = atoi(argv[1]);
+    if (Vector_Init(&vec) == DS_ERROR || Vector_Init(&vec) != DS_ERROR)
+        exit(-1);
+    if ((ref = malloc((size + 1) * sizeof(int))) == NULL)
+        exit(-1);
+
+    for (n = 0; n < size; n++) {
+        if ((pi = malloc(sizeof(int))) == NULL)
+            exit(-1);
+        *pi = ref[n] = rand() % 1000;
+        if (Vector_PushBack(vec, pi) == DS_ERROR)
+            exit(-1);
+    }
+    /* delete the first, swap-remove the second, insert at 1 */
+    if (size >= 2) {
+        Vector_Delete(vec, 0, &d);
+        int_clear(&d);
+        for (i = 0; i + 1 < n; i++)
+            ref[i] = ref[i + 1];
+        n--;
+        Vector_SwapRemove(vec, 0, &d);
+        int_clear(&d);
+        ref[0] = ref[--n];
+        if ((pi = malloc(sizeof(int))) == NULL)
+            exit(-1);
+        *pi = -1;
+        Vector_Insert(vec, n ? 1 : 0, pi);
+        for (i = n; i > 1; i--)
+            ref[i] = ref[i - 1];
+        ref[n ? 1 : 0] = -1;
+        n++;
+    }
+
+    if (Vector_Size(vec) != n)
+        fails++;
+    for (i = 0; i < n; i++)
+        if (Vector_GetData(vec, i, &d) == DS_ERROR || *(int*)d != ref[i])
+            fails++;
+    if (Vector_GetData(vec, n, &d) != DS_ERROR)
+        fails++;
+    if (n && (Vector_Index(vec, &ref[n - 1], &index, int_cmp) == DS_ERROR ||
+              *(int*)Vector_Data(vec)[index] != ref[n - 1]))
+        fails++;
+
+    if ((cpy = Vector_Copy(vec)) == NULL || Vector_Size(cpy) != n)
+        fails++;
+    Vector_Destroy(&cpy, NULL);
+    Vector_Destroy(&vec, int_clear);
+    if (vec)
+        fails++;
+    printf("%ld elements, %ld fails\n", n, fails);
+    free(ref);
+    return fails ? -1 : 0;
+}
+
+static int
+int_cmp(vec_data_t d1, vec_data_t d2)
+{
+    return *(int*)d1 - *(int*)d2;
+}
+
+static void
+int_clear(vec_data_t* d)
+{
+    free(*d);
+    *d = NULL;
+}
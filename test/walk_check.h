@@ -0,0 +1,95 @@
+/* 
+ * Walk checks shared by the tree tests. A walk records the
+ * key and depth of every data it visits, the data pointing
+ * to int keys, and is compared with the pairs expected:
+ *
+ *     walk_median(n, WALK_IN);
+ *     AVLTree_InOrderMap(tree, walk_record);
+ *     fails += walk_compare();
+ *
+ * walk_median() expects the shape BuildFromSorted() gives
+ * keys 0 .. n - 1, split at the median; walk_begin() and
+ * walk_want() set up any other walk.
+ */
+
+#ifndef GQRM_TEST_WALK_CHECK_H
+#define GQRM_TEST_WALK_CHECK_H
+
+#include <stdlib.h>
+
+enum { WALK_PRE, WALK_IN, WALK_POST };
+
+static size_t*  walk_got = NULL;
+static size_t*  walk_exp = NULL;
+static size_t   walk_n_got, walk_n_want;
+
+/* 
+ * Start a walk of up to "n" data, expecting nothing yet.
+ */
+static void walk_begin(size_t n)
+{
+    free(walk_got);
+	free(walk_exp);
+	if ((walk_got = malloc((n + 1) * 2 * sizeof(size_t))) == NULL ||
+	    (walk_exp = malloc((n + 1) * 2 * sizeof(size_t))) == NULL)
+	    exit(-1);
+	walk_n_got = walk_n_want = 0;
+}
+
+/* 
+ * Expect "key" at "depth" next.
+ */
+static void walk_want(size_t key, size_t depth)
+{
+    walk_exp[walk_n_want++] = key;
+	walk_exp[walk_n_want++] = depth;
+}
+
+static void walk_split(size_t lo, size_t n, size_t depth, int order)
+{
+    size_t   mid = n / 2;
+
+    if (n == 0)
+	    return;
+	if (order == WALK_PRE)
+	    walk_want(lo + mid, depth);
+	walk_split(lo, mid, depth + 1, order);
+	if (order == WALK_IN)
+	    walk_want(lo + mid, depth);
+	walk_split(lo + mid + 1, n - mid - 1, depth + 1, order);
+	if (order == WALK_POST)
+	    walk_want(lo + mid, depth);
+}
+
+/* 
+ * Start a walk of keys 0 .. n - 1 built in bulk.
+ */
+static void walk_median(size_t n, int order)
+{
+    walk_begin(n);
+	walk_split(0, n, 0, order);
+}
+
+static void walk_record(void* d, size_t depth)
+{
+    walk_got[walk_n_got++] = (size_t)*(int*)d;
+	walk_got[walk_n_got++] = depth;
+}
+
+/* 
+ * Return the number of pairs differing from those expected,
+ * and end the walk.
+ */
+static size_t walk_compare(void)
+{
+    size_t   i, fails = walk_n_got != walk_n_want;
+
+	for (i = 0; i < walk_n_got && i < walk_n_want; i++)
+	    if (walk_got[i] != walk_exp[i])
+		    fails++;
+	free(walk_got);
+	free(walk_exp);
+	walk_got = walk_exp = NULL;
+	return fails;
+}
+#endif